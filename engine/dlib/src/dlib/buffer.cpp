@@ -32,6 +32,14 @@
 #include <malloc.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define DM_BUFFER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define DM_BUFFER_NEON
+#endif
+
 #include <stdio.h>
 
 namespace dmBuffer
@@ -667,4 +675,189 @@ namespace dmBuffer
         return RESULT_OK;
     }
 
+    /////////////////////////////////////////////////////////////////
+    // Stream kernels
+
+#if defined(DM_BUFFER_SSE2)
+    typedef __m128 SimdFloat4;
+    static inline SimdFloat4 SimdLoad(const float* p)                               { return _mm_loadu_ps(p); }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { _mm_storeu_ps(p, v); }
+    static inline SimdFloat4 SimdSplat(float f)                                     { return _mm_set1_ps(f); }
+    static inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b)                    { return _mm_mul_ps(a, b); }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)   { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#elif defined(DM_BUFFER_NEON)
+    typedef float32x4_t SimdFloat4;
+    static inline SimdFloat4 SimdLoad(const float* p)                               { return vld1q_f32(p); }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { vst1q_f32(p, v); }
+    static inline SimdFloat4 SimdSplat(float f)                                     { return vdupq_n_f32(f); }
+    static inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b)                    { return vmulq_f32(a, b); }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)   { return vmlaq_f32(c, a, b); }
+#else
+    struct SimdFloat4 { float v[4]; };
+    static inline SimdFloat4 SimdLoad(const float* p)                               { SimdFloat4 r; memcpy(r.v, p, sizeof(r.v)); return r; }
+    static inline void       SimdStore(float* p, SimdFloat4 v)                      { memcpy(p, v.v, sizeof(v.v)); }
+    static inline SimdFloat4 SimdSplat(float f)                                     { SimdFloat4 r = {{f, f, f, f}}; return r; }
+    static inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b)
+    {
+        SimdFloat4 r = {{a.v[0]*b.v[0], a.v[1]*b.v[1], a.v[2]*b.v[2], a.v[3]*b.v[3]}};
+        return r;
+    }
+    static inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c)
+    {
+        SimdFloat4 r = {{a.v[0]*b.v[0] + c.v[0], a.v[1]*b.v[1] + c.v[1], a.v[2]*b.v[2] + c.v[2], a.v[3]*b.v[3] + c.v[3]}};
+        return r;
+    }
+#endif
+
+    // Gets the first element of a range in a float32 stream. The stride is measured in floats.
+    static Result GetFloatStreamRange(HBuffer hbuffer, dmhash_t stream_name, uint32_t start, uint32_t count, float** out_data, uint32_t* out_components, uint32_t* out_stride)
+    {
+        Buffer* buffer = g_BufferContext->Get(hbuffer);
+        if (!buffer) {
+            return RESULT_BUFFER_INVALID;
+        }
+
+        Buffer::Stream* stream = GetStream(buffer, stream_name);
+        if (stream == 0x0) {
+            return RESULT_STREAM_MISSING;
+        }
+        if (stream->m_ValueType != VALUE_TYPE_FLOAT32) {
+            return RESULT_STREAM_TYPE_MISMATCH;
+        }
+        if (start > buffer->m_Count || count > buffer->m_Count - start) {
+            return RESULT_BUFFER_SIZE_ERROR;
+        }
+
+        uint32_t stride = buffer->m_Stride / sizeof(float);
+        *out_data = (float*)((uintptr_t)buffer->m_Data + stream->m_Offset) + start * stride;
+        *out_components = stream->m_ValueCount;
+        *out_stride = stride;
+        return RESULT_OK;
+    }
+
+    // The matrix is given as 16 floats, column major
+    static void TransformKernel(float* data, uint32_t stride, uint32_t count, uint32_t components, const float* m)
+    {
+        const SimdFloat4 c0 = SimdLoad(m + 0);
+        const SimdFloat4 c1 = SimdLoad(m + 4);
+        const SimdFloat4 c2 = SimdLoad(m + 8);
+        const SimdFloat4 c3 = SimdLoad(m + 12);
+
+        if (components == 4)
+        {
+            for (uint32_t i = 0; i < count; ++i, data += stride)
+            {
+                SimdFloat4 r = SimdMul(c0, SimdSplat(data[0]));
+                r = SimdMulAdd(c1, SimdSplat(data[1]), r);
+                r = SimdMulAdd(c2, SimdSplat(data[2]), r);
+                r = SimdMulAdd(c3, SimdSplat(data[3]), r);
+                SimdStore(data, r);
+            }
+        }
+        else
+        {
+            // The fourth lane can't be stored directly, as it belongs to the next value in the buffer
+            float out[4];
+            for (uint32_t i = 0; i < count; ++i, data += stride)
+            {
+                SimdFloat4 r = SimdMulAdd(c0, SimdSplat(data[0]), c3);
+                r = SimdMulAdd(c1, SimdSplat(data[1]), r);
+                r = SimdMulAdd(c2, SimdSplat(data[2]), r);
+                SimdStore(out, r);
+                data[0] = out[0];
+                data[1] = out[1];
+                data[2] = out[2];
+            }
+        }
+    }
+
+    static void ScaleBiasKernel(float* data, uint32_t stride, uint32_t count, uint32_t components, const float* scale, const float* bias)
+    {
+        if (stride == components && components <= 4)
+        {
+            // The values are tightly packed, and for up to 4 components the scale
+            // and bias repeat every 12 values, which is 3 full simd registers
+            float s[12];
+            float b[12];
+            for (uint32_t i = 0; i < 12; ++i)
+            {
+                s[i] = scale[i % components];
+                b[i] = bias[i % components];
+            }
+            const SimdFloat4 s0 = SimdLoad(s + 0), s1 = SimdLoad(s + 4), s2 = SimdLoad(s + 8);
+            const SimdFloat4 b0 = SimdLoad(b + 0), b1 = SimdLoad(b + 4), b2 = SimdLoad(b + 8);
+
+            uint32_t n = count * components;
+            uint32_t i = 0;
+            for (; i + 12 <= n; i += 12)
+            {
+                float* p = data + i;
+                SimdStore(p + 0, SimdMulAdd(SimdLoad(p + 0), s0, b0));
+                SimdStore(p + 4, SimdMulAdd(SimdLoad(p + 4), s1, b1));
+                SimdStore(p + 8, SimdMulAdd(SimdLoad(p + 8), s2, b2));
+            }
+            for (; i < n; ++i)
+            {
+                data[i] = data[i] * s[i % 12] + b[i % 12];
+            }
+        }
+        else if (components == 4)
+        {
+            const SimdFloat4 s = SimdLoad(scale);
+            const SimdFloat4 b = SimdLoad(bias);
+            for (uint32_t i = 0; i < count; ++i, data += stride)
+            {
+                SimdStore(data, SimdMulAdd(SimdLoad(data), s, b));
+            }
+        }
+        else
+        {
+            for (uint32_t i = 0; i < count; ++i, data += stride)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    data[c] = data[c] * scale[c] + bias[c];
+                }
+            }
+        }
+    }
+
+    Result TransformStream(HBuffer hbuffer, dmhash_t stream_name, uint32_t start, uint32_t count, const dmVMath::Matrix4& transform)
+    {
+        float* data;
+        uint32_t components;
+        uint32_t stride;
+        Result r = GetFloatStreamRange(hbuffer, stream_name, start, count, &data, &components, &stride);
+        if (r != RESULT_OK) {
+            return r;
+        }
+        if (components != 3 && components != 4) {
+            return RESULT_STREAM_TYPE_MISMATCH;
+        }
+
+        float m[16];
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            dmVMath::Vector4 col = transform.getCol(i);
+            m[i*4 + 0] = col.getX();
+            m[i*4 + 1] = col.getY();
+            m[i*4 + 2] = col.getZ();
+            m[i*4 + 3] = col.getW();
+        }
+        TransformKernel(data, stride, count, components, m);
+        return RESULT_OK;
+    }
+
+    Result ScaleBiasStream(HBuffer hbuffer, dmhash_t stream_name, uint32_t start, uint32_t count, const float* scale, const float* bias)
+    {
+        float* data;
+        uint32_t components;
+        uint32_t stride;
+        Result r = GetFloatStreamRange(hbuffer, stream_name, start, count, &data, &components, &stride);
+        if (r != RESULT_OK) {
+            return r;
+        }
+        ScaleBiasKernel(data, stride, count, components, scale, bias);
+        return RESULT_OK;
+    }
 }
@@ -16,6 +16,7 @@
 #define DM_BUFFER
 
 #include <dmsdk/dlib/buffer.h>
+#include <dmsdk/dlib/vmath.h>
 
 namespace dmBuffer
 {
@@ -79,6 +80,44 @@ namespace dmBuffer
     Result Clone(const HBuffer src_buffer, HBuffer* out_buffer);
 
     Result CalcStructSize(uint32_t num_streams, const StreamDeclaration* streams, uint32_t* size, uint32_t* offsets);
+
+    /*# transform the elements of a stream
+     *
+     * Multiplies a range of elements in a stream with a matrix, in place.
+     * The stream must be of type float32 with 3 or 4 components. Elements with
+     * 3 components are transformed as points (w = 1).
+     * Uses SSE2 or NEON when available.
+     *
+     * @name dmBuffer::TransformStream
+     * @param buffer [type:dmBuffer::HBuffer] The buffer
+     * @param stream_name [type:dmhash_t] The name of the stream
+     * @param start [type:uint32_t] The first element to transform
+     * @param count [type:uint32_t] The number of elements to transform
+     * @param transform [type:dmVMath::Matrix4] The transform
+     * @return result [type:dmBuffer::Result] RESULT_OK on success,
+     *         RESULT_STREAM_TYPE_MISMATCH if the stream type isn't supported,
+     *         RESULT_BUFFER_SIZE_ERROR if the range is outside the buffer
+    */
+    Result TransformStream(HBuffer buffer, dmhash_t stream_name, uint32_t start, uint32_t count, const dmVMath::Matrix4& transform);
+
+    /*# scale and bias the elements of a stream
+     *
+     * Sets each component of a range of elements in a stream to `value * scale + bias`, in place.
+     * The stream must be of type float32.
+     * Uses SSE2 or NEON when available.
+     *
+     * @name dmBuffer::ScaleBiasStream
+     * @param buffer [type:dmBuffer::HBuffer] The buffer
+     * @param stream_name [type:dmhash_t] The name of the stream
+     * @param start [type:uint32_t] The first element to modify
+     * @param count [type:uint32_t] The number of elements to modify
+     * @param scale [type:const float*] The scale, one value per stream component
+     * @param bias [type:const float*] The bias, one value per stream component
+     * @return result [type:dmBuffer::Result] RESULT_OK on success,
+     *         RESULT_STREAM_TYPE_MISMATCH if the stream type isn't float32,
+     *         RESULT_BUFFER_SIZE_ERROR if the range is outside the buffer
+    */
+    Result ScaleBiasStream(HBuffer buffer, dmhash_t stream_name, uint32_t start, uint32_t count, const float* scale, const float* bias);
 }
 
 #endif
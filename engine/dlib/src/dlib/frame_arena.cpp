@@ -0,0 +1,160 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdlib.h>
+#include <assert.h>
+#include <dlib/spinlock.h>
+#include "frame_arena.h"
+
+namespace dmFrameArena
+{
+    struct Block
+    {
+        Block*   m_Next;
+        uint32_t m_Size;
+        uint32_t m_Offset;
+
+        uint8_t* Data() { return (uint8_t*) (this + 1); }
+    };
+
+    struct Arena
+    {
+        dmSpinlock::Spinlock m_Lock;
+        // The block currently allocated from. Previous blocks of the frame follow m_Next.
+        Block*               m_Current;
+        uint32_t             m_BlockSize;
+        uint32_t             m_BlockCount;
+        uint32_t             m_Capacity;
+        // Bytes used in the previous (full) blocks of the frame
+        uint32_t             m_PreviousUsed;
+        uint32_t             m_FrameUsed;
+        uint32_t             m_HighWater;
+    };
+
+    static Block* NewBlock(uint32_t size)
+    {
+        Block* block = (Block*) malloc(sizeof(Block) + size);
+        assert(block);
+        block->m_Next = 0;
+        block->m_Size = size;
+        block->m_Offset = 0;
+        return block;
+    }
+
+    static void FreeBlocks(Block* block)
+    {
+        while (block)
+        {
+            Block* next = block->m_Next;
+            free(block);
+            block = next;
+        }
+    }
+
+    HArena New(uint32_t block_size)
+    {
+        Arena* arena = new Arena;
+        dmSpinlock::Create(&arena->m_Lock);
+        arena->m_BlockSize = block_size;
+        arena->m_Current = NewBlock(block_size);
+        arena->m_BlockCount = 1;
+        arena->m_Capacity = block_size;
+        arena->m_PreviousUsed = 0;
+        arena->m_FrameUsed = 0;
+        arena->m_HighWater = 0;
+        return arena;
+    }
+
+    void Delete(HArena arena)
+    {
+        FreeBlocks(arena->m_Current);
+        dmSpinlock::Destroy(&arena->m_Lock);
+        delete arena;
+    }
+
+    void* Alloc(HArena arena, uint32_t size, uint32_t align)
+    {
+        assert(align > 0 && (align & (align - 1)) == 0);
+
+        // The mask must be pointer sized
+        uintptr_t align_mask = (uintptr_t) align - 1;
+
+        DM_SPINLOCK_SCOPED_LOCK(arena->m_Lock);
+
+        Block* block = arena->m_Current;
+        uintptr_t begin = (uintptr_t) block->Data();
+        uintptr_t p = (begin + block->m_Offset + align_mask) & ~align_mask;
+        if (p + size > begin + block->m_Size)
+        {
+            // The block is full. Allocate a new one that fits the allocation, and keep the
+            // full block until the next reset since its memory is still in use
+            arena->m_PreviousUsed += block->m_Offset;
+
+            uint32_t block_size = arena->m_BlockSize;
+            if (block_size < size + align)
+                block_size = size + align;
+            Block* new_block = NewBlock(block_size);
+            new_block->m_Next = block;
+            arena->m_Current = new_block;
+            arena->m_BlockCount++;
+            arena->m_Capacity += block_size;
+
+            block = new_block;
+            begin = (uintptr_t) block->Data();
+            p = (begin + align_mask) & ~align_mask;
+        }
+
+        block->m_Offset = (uint32_t) (p + size - begin);
+        return (void*) p;
+    }
+
+    void Reset(HArena arena)
+    {
+        DM_SPINLOCK_SCOPED_LOCK(arena->m_Lock);
+
+        uint32_t used = arena->m_PreviousUsed + arena->m_Current->m_Offset;
+        arena->m_FrameUsed = used;
+        if (used > arena->m_HighWater)
+            arena->m_HighWater = used;
+
+        if (arena->m_Current->m_Next)
+        {
+            // More than one block was needed. Replace them with a block that fits the whole frame.
+            // Each allocation might waste up to its alignment, hence the extra margin.
+            uint32_t block_size = arena->m_HighWater + arena->m_HighWater / 8;
+            if (block_size < arena->m_BlockSize)
+                block_size = arena->m_BlockSize;
+            arena->m_BlockSize = block_size;
+
+            FreeBlocks(arena->m_Current);
+            arena->m_Current = NewBlock(block_size);
+            arena->m_BlockCount = 1;
+            arena->m_Capacity = block_size;
+        }
+
+        arena->m_Current->m_Offset = 0;
+        arena->m_PreviousUsed = 0;
+    }
+
+    void GetStats(HArena arena, Stats* stats)
+    {
+        DM_SPINLOCK_SCOPED_LOCK(arena->m_Lock);
+
+        stats->m_Used = arena->m_PreviousUsed + arena->m_Current->m_Offset;
+        stats->m_FrameUsed = arena->m_FrameUsed;
+        stats->m_HighWater = arena->m_HighWater;
+        stats->m_Capacity = arena->m_Capacity;
+        stats->m_BlockCount = arena->m_BlockCount;
+    }
+}
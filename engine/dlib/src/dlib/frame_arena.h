@@ -0,0 +1,127 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_FRAME_ARENA_H
+#define DM_FRAME_ARENA_H
+
+#include <stdint.h>
+#include <string.h>
+#include <dlib/array.h>
+
+/**
+ * Linear allocator for transient data that only lives until the end of the frame.
+ *
+ * Individual allocations are not freeable. Instead all memory is released at once by Reset(),
+ * which the engine calls after each frame. Allocations may be made from any thread, but
+ * Reset() must not run concurrently with Alloc().
+ *
+ * When a frame needs more memory than the current block holds, more blocks are allocated.
+ * On Reset() they are merged into one block large enough for the highest usage so far,
+ * so that a steady state frame never allocates from the heap.
+ */
+namespace dmFrameArena
+{
+    /**
+     * Arena handle
+     */
+    typedef struct Arena* HArena;
+
+    /**
+     * Arena statistics
+     */
+    struct Stats
+    {
+        /// Bytes allocated since the last reset
+        uint32_t m_Used;
+        /// Bytes allocated during the last frame, i.e. between the last two resets
+        uint32_t m_FrameUsed;
+        /// The highest number of bytes allocated during a frame
+        uint32_t m_HighWater;
+        /// Total size of the allocated blocks
+        uint32_t m_Capacity;
+        /// Number of allocated blocks
+        uint32_t m_BlockCount;
+    };
+
+    /**
+     * Create a new arena
+     * @param block_size Initial block size in bytes
+     * @return arena handle
+     */
+    HArena New(uint32_t block_size);
+
+    /**
+     * Delete arena and free all memory
+     * @param arena arena handle
+     */
+    void Delete(HArena arena);
+
+    /**
+     * Allocate memory that is valid until the next Reset(). Thread safe.
+     * @param arena arena handle
+     * @param size size in bytes
+     * @param align alignment, must be a power of two
+     * @return pointer to memory
+     */
+    void* Alloc(HArena arena, uint32_t size, uint32_t align = 16);
+
+    /**
+     * Release all allocations. Merges the blocks if more than one was needed during the frame.
+     * @param arena arena handle
+     */
+    void Reset(HArena arena);
+
+    /**
+     * Get arena statistics
+     * @param arena arena handle
+     * @param stats [out] statistics
+     */
+    void GetStats(HArena arena, Stats* stats);
+
+    /**
+     * Set the capacity of an array, with the storage allocated from the arena.
+     * The elements are copied to the new storage, and any heap storage owned by the array is freed.
+     * The array becomes user allocated, i.e. it can't grow by itself and must be grown with this function.
+     * The storage is only valid until the next Reset(). Arrays kept between frames must be
+     * emptied with SetSize(0) before they are given new storage.
+     * @param arena arena handle
+     * @param array array
+     * @param capacity new capacity
+     */
+    template <typename T>
+    void SetCapacity(HArena arena, dmArray<T>& array, uint32_t capacity)
+    {
+        uint32_t size = array.Size() < capacity ? array.Size() : capacity;
+        T* data = (T*) Alloc(arena, capacity * sizeof(T));
+        if (size > 0)
+        {
+            memcpy(data, array.Begin(), size * sizeof(T));
+        }
+        array.Set(data, size, capacity, true);
+    }
+
+    /**
+     * Equivalent to SetCapacity(arena, array, array.Capacity() + offset)
+     * @param arena arena handle
+     * @param array array
+     * @param offset capacity offset
+     */
+    template <typename T>
+    void OffsetCapacity(HArena arena, dmArray<T>& array, int32_t offset)
+    {
+        SetCapacity(arena, array, (uint32_t)((int32_t)array.Capacity() + offset));
+    }
+}
+
+#endif // DM_FRAME_ARENA_H
@@ -23,6 +23,8 @@
 #include <dlib/mutex.h>
 #include <dlib/dstrings.h>
 #include <dlib/hashtable.h>
+#include <dlib/endian.h>
+#include <dlib/math.h>
 
 struct ReverseHashEntry
 {
@@ -245,29 +247,38 @@ uint32_t dmHashBuffer32(const void * key, uint32_t len)
     return h;
 }
 
-// Based on MurmurHash2A but endian neutral
-uint64_t dmHashBufferNoReverse64(const void * key, uint32_t len)
+static inline uint64_t ReadUInt64(const unsigned char* data)
 {
-    const uint64_t m = 0xc6a4a7935bd1e995ULL;
-    const int r = 47;
-    uint64_t l = len;
+#if DM_ENDIAN == DM_ENDIAN_LITTLE
+    uint64_t k;
+    memcpy(&k, data, sizeof(k));
+    return k;
+#else
+    uint64_t k;
+    k  = uint64_t(data[0]);
+    k |= uint64_t(data[1]) << 8;
+    k |= uint64_t(data[2]) << 16;
+    k |= uint64_t(data[3]) << 24;
+    k |= uint64_t(data[4]) << 32;
+    k |= uint64_t(data[5]) << 40;
+    k |= uint64_t(data[6]) << 48;
+    k |= uint64_t(data[7]) << 56;
+    return k;
+#endif
+}
 
-    const unsigned char * data = (const unsigned char *)key;
+static const uint64_t HASH64_M = 0xc6a4a7935bd1e995ULL;
+static const int      HASH64_R = 47;
 
-    uint64_t h = /*seed*/ 0;
+// Hashes the remaining blocks and the tail, and finalizes the hash
+static inline uint64_t HashFinish64(uint64_t h, const unsigned char* data, uint32_t len, uint64_t l)
+{
+    const uint64_t m = HASH64_M;
+    const int r = HASH64_R;
 
     while(len >= 8)
     {
-        uint64_t k;
-
-        k  = uint64_t(data[0]);
-        k |= uint64_t(data[1]) << 8;
-        k |= uint64_t(data[2]) << 16;
-        k |= uint64_t(data[3]) << 24;
-        k |= uint64_t(data[4]) << 32;
-        k |= uint64_t(data[5]) << 40;
-        k |= uint64_t(data[6]) << 48;
-        k |= uint64_t(data[7]) << 56;
+        uint64_t k = ReadUInt64(data);
 
         mmix(h,k);
 
@@ -298,6 +309,75 @@ uint64_t dmHashBufferNoReverse64(const void * key, uint32_t len)
     return h;
 }
 
+// Based on MurmurHash2A but endian neutral
+uint64_t dmHashBufferNoReverse64(const void * key, uint32_t len)
+{
+    return HashFinish64(/*seed*/ 0, (const unsigned char *)key, len, len);
+}
+
+void dmHashBuffersNoReverse64(const void** buffers, const uint32_t* buffer_lens, uint32_t count, uint64_t* out_hashes)
+{
+    const uint64_t m = HASH64_M;
+    const int r = HASH64_R;
+
+    // Each hash is a chain of dependent multiplications. Hashing four buffers in lock step
+    // lets the cpu overlap the chains, instead of waiting for each multiplication in turn.
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const unsigned char* d0 = (const unsigned char*) buffers[i + 0];
+        const unsigned char* d1 = (const unsigned char*) buffers[i + 1];
+        const unsigned char* d2 = (const unsigned char*) buffers[i + 2];
+        const unsigned char* d3 = (const unsigned char*) buffers[i + 3];
+        uint32_t l0 = buffer_lens[i + 0];
+        uint32_t l1 = buffer_lens[i + 1];
+        uint32_t l2 = buffer_lens[i + 2];
+        uint32_t l3 = buffer_lens[i + 3];
+        uint64_t h0 = 0, h1 = 0, h2 = 0, h3 = 0;
+
+        uint32_t min_len = dmMath::Min(dmMath::Min(l0, l1), dmMath::Min(l2, l3));
+        uint32_t offset = 0;
+        for (; offset + 8 <= min_len; offset += 8)
+        {
+            uint64_t k0 = ReadUInt64(d0 + offset);
+            uint64_t k1 = ReadUInt64(d1 + offset);
+            uint64_t k2 = ReadUInt64(d2 + offset);
+            uint64_t k3 = ReadUInt64(d3 + offset);
+            mmix(h0,k0);
+            mmix(h1,k1);
+            mmix(h2,k2);
+            mmix(h3,k3);
+        }
+
+        out_hashes[i + 0] = HashFinish64(h0, d0 + offset, l0 - offset, l0);
+        out_hashes[i + 1] = HashFinish64(h1, d1 + offset, l1 - offset, l1);
+        out_hashes[i + 2] = HashFinish64(h2, d2 + offset, l2 - offset, l2);
+        out_hashes[i + 3] = HashFinish64(h3, d3 + offset, l3 - offset, l3);
+    }
+
+    for (; i < count; ++i)
+    {
+        out_hashes[i] = dmHashBufferNoReverse64(buffers[i], buffer_lens[i]);
+    }
+}
+
+// Must be called with the container mutex held
+static void AddReverseHash64(uint64_t h, const void* key, uint32_t len)
+{
+    dmHashTable64<ReverseHashEntry>* hash_table = &dmHashContainer().m_HashTable64Entries;
+    if (hash_table->Get(h) == 0)
+    {
+        if (hash_table->Full())
+        {
+            hash_table->SetCapacity(dmHashContainer().m_HashTableSize, hash_table->Capacity() + dmHashContainer().m_HashTableCapacityIncrement);
+        }
+        char* copy = (char*) malloc(len + 1);
+        memcpy(copy, key, len);
+        copy[len] = '\0';
+        hash_table->Put(h, ReverseHashEntry(copy, len));
+    }
+}
+
 uint64_t dmHashBuffer64(const void * key, uint32_t len)
 {
     uint64_t h = dmHashBufferNoReverse64(key, len);
@@ -305,21 +385,42 @@ uint64_t dmHashBuffer64(const void * key, uint32_t len)
     if (dmHashContainer().m_Enabled && len <= DMHASH_MAX_REVERSE_LENGTH)
     {
         DM_MUTEX_SCOPED_LOCK(dmHashContainer().m_Mutex);
-        dmHashTable64<ReverseHashEntry>* hash_table = &dmHashContainer().m_HashTable64Entries;
-        if (hash_table->Get(h) == 0)
+        AddReverseHash64(h, key, len);
+    }
+
+    return h;
+}
+
+void dmHashBuffers64(const void** buffers, const uint32_t* buffer_lens, uint32_t count, uint64_t* out_hashes)
+{
+    dmHashBuffersNoReverse64(buffers, buffer_lens, count, out_hashes);
+
+    if (dmHashContainer().m_Enabled)
+    {
+        DM_MUTEX_SCOPED_LOCK(dmHashContainer().m_Mutex);
+        for (uint32_t i = 0; i < count; ++i)
         {
-            if (hash_table->Full())
+            if (buffer_lens[i] <= DMHASH_MAX_REVERSE_LENGTH)
             {
-                hash_table->SetCapacity(dmHashContainer().m_HashTableSize, hash_table->Capacity() + dmHashContainer().m_HashTableCapacityIncrement);
+                AddReverseHash64(out_hashes[i], buffers[i], buffer_lens[i]);
             }
-            char* copy = (char*) malloc(len + 1);
-            memcpy(copy, key, len);
-            copy[len] = '\0';
-            hash_table->Put(h, ReverseHashEntry(copy, len));
         }
     }
+}
 
-    return h;
+void dmHashStrings64(const char** strings, uint32_t count, uint64_t* out_hashes)
+{
+    const uint32_t batch_size = 64;
+    uint32_t lens[batch_size];
+    for (uint32_t i = 0; i < count; i += batch_size)
+    {
+        uint32_t n = dmMath::Min(batch_size, count - i);
+        for (uint32_t j = 0; j < n; ++j)
+        {
+            lens[j] = (uint32_t) strlen(strings[i + j]);
+        }
+        dmHashBuffers64((const void**) (strings + i), lens, n, out_hashes + i);
+    }
 }
 
 uint32_t DM_DLLEXPORT dmHashString32(const char* string)
@@ -529,15 +630,7 @@ void dmHashUpdateBuffer64(HashState64* hash_state, const void* buffer, uint32_t
 
     while(len >= 8)
     {
-        uint64_t k;
-        k  = uint64_t(data[0]);
-        k |= uint64_t(data[1]) << 8;
-        k |= uint64_t(data[2]) << 16;
-        k |= uint64_t(data[3]) << 24;
-        k |= uint64_t(data[4]) << 32;
-        k |= uint64_t(data[5]) << 40;
-        k |= uint64_t(data[6]) << 48;
-        k |= uint64_t(data[7]) << 56;
+        uint64_t k = ReadUInt64(data);
 
         mmix(hash_state->m_Hash, k);
 
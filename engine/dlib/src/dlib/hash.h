@@ -34,6 +34,15 @@ extern "C"
  */
 DM_DLLEXPORT uint64_t dmHashBufferNoReverse64(const void* buffer, uint32_t buffer_len);
 
+/**
+ * Calculate 64-bit hash values for several buffers. Special version of dmHashBuffers64 with reverse always disabled.
+ * @param buffers Buffers
+ * @param buffer_lens Length of each buffer
+ * @param count Number of buffers
+ * @param out_hashes Array of count hash values
+ */
+DM_DLLEXPORT void dmHashBuffersNoReverse64(const void** buffers, const uint32_t* buffer_lens, uint32_t count, uint64_t* out_hashes);
+
 /**
  * Calculate 32-bit hash value from buffer. Special version of dmHashBuffer32 with reverse always disabled.
  * Used in situations when no memory allocations can occur, eg profiling scenarios.
@@ -0,0 +1,1132 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "http_multi.h"
+#include "array.h"
+#include "atomic.h"
+#include "connection_pool.h"
+#include "dstrings.h"
+#include "file_descriptor.h"
+#include "http_client.h"
+#include "job_thread.h"
+#include "log.h"
+#include "math.h"
+#include "socket.h"
+#include "sslsocket.h"
+#include "thread.h"
+#include "time.h"
+#include "uri.h"
+
+namespace dmHttpMulti
+{
+    // Receive buffer per active request. Holds the response headers, so it also limits their size.
+    const uint32_t RECV_BUFFER_SIZE = 16 * 1024;
+
+    // Max number of reads per request and update, so that one fast response doesn't starve the others
+    const uint32_t MAX_READS_PER_UPDATE = 8;
+
+    // See http_client.cpp
+    const uint32_t MAX_HTTPS_POST_CHUNK_SIZE = 16384;
+    const uint32_t MAXIMUM_CACHE_AGE = 30U * 24U * 60U * 60U; // 30 days
+
+    // Timeout for the tls layer when it waits for the rest of a record. The sockets are polled
+    // before they are read, so this only applies to records split over several packets.
+    const uint64_t SSL_RECEIVE_TIMEOUT = 1000;
+
+    // Max time in us to wait for socket events while a connection is being established on a dial thread
+    const uint64_t DIAL_POLL_INTERVAL = 5000;
+
+    enum State
+    {
+        STATE_QUEUED,
+        STATE_CONNECTING,
+        STATE_SENDING,
+        STATE_RECEIVING_HEADERS,
+        STATE_RECEIVING_CONTENT,
+        STATE_DONE,
+    };
+
+    enum ChunkState
+    {
+        CHUNK_STATE_SIZE,
+        CHUNK_STATE_DATA,
+        CHUNK_STATE_DATA_END,
+        CHUNK_STATE_TRAILER,
+    };
+
+    struct Request
+    {
+        HRequest                        m_Handle;
+        State                           m_State;
+
+        dmURI::Parts                    m_Url;
+        char                            m_CacheURI[dmURI::MAX_URI_LEN];
+        char*                           m_Method;
+        dmArray<char>                   m_SendBuffer;
+        uint32_t                        m_SendOffset;
+
+        // Response data not yet handled. NOTE: Extra byte for null-termination
+        char*                           m_Buffer;
+        uint32_t                        m_BufferSize;
+
+        dmConnectionPool::HConnection   m_Connection;
+        dmSocket::Socket                m_Socket;
+        dmSSLSocket::Socket             m_SSLSocket;
+        uint32_t                        m_Attempts;
+
+        // Written by the dial thread, and read by the update thread once the dial has finished
+        dmConnectionPool::HConnection   m_DialConnection;
+        int                             m_DialTimeout;
+        // Set by the update thread to abort the name lookup of a dial in progress
+        int32_atomic_t                  m_DialCancel;
+
+        uint64_t                        m_StartTime;
+        uint64_t                        m_Timeout;
+
+        int                             m_Status;
+        int64_t                         m_ContentLength;
+        int64_t                         m_Remaining;
+        ChunkState                      m_ChunkState;
+        char                            m_ETag[64];
+        uint32_t                        m_MaxAge;
+        dmHttpCache::HCacheCreator      m_CacheCreator;
+        Result                          m_Result;
+
+        HttpHeader                      m_HttpHeader;
+        HttpContent                     m_HttpContent;
+        HttpDone                        m_HttpDone;
+        void*                           m_Userdata;
+
+        uint32_t                        m_UseCache : 1;
+        uint32_t                        m_Chunked : 1;
+        uint32_t                        m_UntilClose : 1;
+        uint32_t                        m_CloseConnection : 1;
+        uint32_t                        m_Received : 1;
+        uint32_t                        m_Paused : 1;
+        // Data may be buffered by the tls layer, or reading was interrupted. Read without waiting for the socket.
+        uint32_t                        m_ReadPending : 1;
+        uint32_t                        m_Canceled : 1;
+        // A dial job refers to the request, so it can't be deleted yet
+        uint32_t                        m_Dialing : 1;
+    };
+
+    struct Multi
+    {
+        dmConnectionPool::HPool         m_Pool;
+        dmHttpCache::HCache             m_HttpCache;
+        // Establishes new connections (name lookup, connect and tls handshake). Zero to dial on the update thread.
+        dmJobThread::HContext           m_DialThreads;
+        // Unfinished requests in the order they were added
+        dmArray<Request*>               m_Requests;
+        dmFileDescriptor::Poller        m_Poller;
+        uint32_t                        m_MaxActiveRequests;
+        uint32_t                        m_ActiveCount;
+        uint32_t                        m_NextHandle;
+        Statistics                      m_Statistics;
+    };
+
+    NewParams::NewParams()
+    {
+        m_MaxActiveRequests = 16;
+        m_MaxConnections = 32;
+        m_DialThreadCount = 2;
+        m_HttpCache = 0;
+    }
+
+    RequestParams::RequestParams()
+    {
+        memset(this, 0, sizeof(*this));
+        m_Method = "GET";
+    }
+
+    Result New(const NewParams* params, HMulti* out_multi)
+    {
+        dmConnectionPool::Params pool_params;
+        pool_params.m_MaxConnections = dmMath::Max(params->m_MaxConnections, params->m_MaxActiveRequests);
+        dmConnectionPool::HPool pool;
+        if (dmConnectionPool::New(&pool_params, &pool) != dmConnectionPool::RESULT_OK)
+        {
+            return RESULT_SOCKET_ERROR;
+        }
+
+        Multi* multi = new Multi;
+        multi->m_Pool = pool;
+        multi->m_HttpCache = params->m_HttpCache;
+        multi->m_DialThreads = 0;
+        if (params->m_DialThreadCount > 0 && dmThread::PlatformHasThreadSupport())
+        {
+            dmJobThread::JobThreadCreationParams thread_params;
+            thread_params.m_ThreadCount = dmMath::Min(params->m_DialThreadCount, (uint32_t) dmJobThread::DM_MAX_JOB_THREAD_COUNT);
+            for (uint32_t i = 0; i < thread_params.m_ThreadCount; ++i)
+            {
+                thread_params.m_ThreadNames[i] = "HttpDial";
+            }
+            multi->m_DialThreads = dmJobThread::Create(thread_params);
+        }
+        multi->m_MaxActiveRequests = dmMath::Max(1U, params->m_MaxActiveRequests);
+        multi->m_ActiveCount = 0;
+        multi->m_NextHandle = 1;
+        memset(&multi->m_Statistics, 0, sizeof(multi->m_Statistics));
+        *out_multi = multi;
+        return RESULT_OK;
+    }
+
+    static void ReleaseConnection(Multi* multi, Request* request, bool keep_alive)
+    {
+        if (request->m_Connection)
+        {
+            if (keep_alive)
+            {
+                dmSocket::SetBlocking(request->m_Socket, true);
+                dmConnectionPool::Return(multi->m_Pool, request->m_Connection);
+            }
+            else
+            {
+                dmConnectionPool::Close(multi->m_Pool, request->m_Connection);
+            }
+            request->m_Connection = 0;
+            request->m_Socket = dmSocket::INVALID_SOCKET_HANDLE;
+            request->m_SSLSocket = 0;
+        }
+        if (request->m_State != STATE_QUEUED && request->m_State != STATE_DONE)
+        {
+            multi->m_ActiveCount--;
+        }
+    }
+
+    static void DeleteRequest(Request* request)
+    {
+        free(request->m_Method);
+        free(request->m_Buffer);
+        delete request;
+    }
+
+    void Delete(HMulti multi)
+    {
+        // Waits for the dials in progress. Queued dials are dropped.
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            dmAtomicStore32(&multi->m_Requests[i]->m_DialCancel, 1);
+        }
+        dmJobThread::Destroy(multi->m_DialThreads);
+
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (request->m_DialConnection)
+            {
+                dmConnectionPool::Close(multi->m_Pool, request->m_DialConnection);
+            }
+            if (request->m_CacheCreator)
+            {
+                dmHttpCache::SetError(multi->m_HttpCache, request->m_CacheCreator);
+                dmHttpCache::End(multi->m_HttpCache, request->m_CacheCreator);
+            }
+            ReleaseConnection(multi, request, false);
+            DeleteRequest(request);
+        }
+        dmConnectionPool::Delete(multi->m_Pool);
+        delete multi;
+    }
+
+    static void Append(dmArray<char>& buffer, const char* data, uint32_t size)
+    {
+        if (buffer.Remaining() < size)
+        {
+            buffer.OffsetCapacity(dmMath::Max(size, 1024U));
+        }
+        buffer.PushArray(data, size);
+    }
+
+    static void Append(dmArray<char>& buffer, const char* string)
+    {
+        Append(buffer, string, strlen(string));
+    }
+
+    static bool HasBody(const char* method)
+    {
+        return strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0 || strcmp(method, "PATCH") == 0;
+    }
+
+    // The whole request is formatted up front, and sent as the socket accepts it
+    static void FormatRequest(Request* request, const RequestParams* params, const char* etag)
+    {
+        dmArray<char>& b = request->m_SendBuffer;
+        Append(b, request->m_Method);
+        Append(b, " ");
+        Append(b, request->m_Url.m_Path);
+        Append(b, " HTTP/1.1\r\nHost: ");
+        Append(b, request->m_Url.m_Hostname);
+        Append(b, "\r\n");
+
+        const char* headers = params->m_Headers;
+        while (headers && *headers)
+        {
+            const char* end = strchr(headers, '\n');
+            uint32_t len = end ? (uint32_t) (end - headers) : (uint32_t) strlen(headers);
+            if (len > 0 && headers[len - 1] == '\r')
+            {
+                --len;
+            }
+            if (len > 0)
+            {
+                Append(b, headers, len);
+                Append(b, "\r\n");
+            }
+            headers = end ? end + 1 : 0;
+        }
+
+        if (etag)
+        {
+            Append(b, "If-None-Match: ");
+            Append(b, etag);
+            Append(b, "\r\n");
+        }
+
+        const char* body = (const char*) params->m_Body;
+        uint32_t body_size = params->m_Body ? params->m_BodySize : 0;
+        bool has_body = HasBody(request->m_Method);
+        bool chunked = has_body && params->m_ChunkedTransfer && strcmp(request->m_Url.m_Scheme, "https") == 0 && body_size > MAX_HTTPS_POST_CHUNK_SIZE;
+        char buf[64];
+        if (chunked)
+        {
+            Append(b, "Transfer-Encoding: chunked\r\n");
+        }
+        else if (has_body || body_size > 0)
+        {
+            dmSnPrintf(buf, sizeof(buf), "Content-Length: %u\r\n", body_size);
+            Append(b, buf);
+        }
+        Append(b, "\r\n");
+
+        if (chunked)
+        {
+            // https://en.wikipedia.org/wiki/Chunked_transfer_encoding
+            for (uint32_t offset = 0; offset < body_size; offset += MAX_HTTPS_POST_CHUNK_SIZE)
+            {
+                uint32_t length = dmMath::Min(body_size - offset, MAX_HTTPS_POST_CHUNK_SIZE);
+                dmSnPrintf(buf, sizeof(buf), "%x\r\n", length);
+                Append(b, buf);
+                Append(b, body + offset, length);
+                Append(b, "\r\n");
+            }
+            Append(b, "0\r\n\r\n");
+        }
+        else if (body_size > 0)
+        {
+            Append(b, body, body_size);
+        }
+    }
+
+    Result AddRequest(HMulti multi, const RequestParams* params, HRequest* out_request)
+    {
+        Request* request = new Request;
+        memset((void*) request, 0, sizeof(*request));
+
+        if (params->m_Url == 0 || dmURI::Parse(params->m_Url, &request->m_Url) != dmURI::RESULT_OK || request->m_Url.m_Port < 0)
+        {
+            delete request;
+            return RESULT_INVAL;
+        }
+        if (request->m_Url.m_Path[0] == '\0')
+        {
+            // NOTE: Default to / for empty path
+            request->m_Url.m_Path[0] = '/';
+            request->m_Url.m_Path[1] = '\0';
+        }
+
+        request->m_Handle = multi->m_NextHandle++;
+        if (multi->m_NextHandle == 0)
+            multi->m_NextHandle = 1;
+        request->m_State = STATE_QUEUED;
+        request->m_Method = strdup(params->m_Method ? params->m_Method : "GET");
+        request->m_Socket = dmSocket::INVALID_SOCKET_HANDLE;
+        request->m_Buffer = (char*) malloc(RECV_BUFFER_SIZE + 1);
+        request->m_StartTime = dmTime::GetTime();
+        request->m_Timeout = params->m_Timeout;
+        request->m_HttpHeader = params->m_HttpHeader;
+        request->m_HttpContent = params->m_HttpContent;
+        request->m_HttpDone = params->m_HttpDone;
+        request->m_Userdata = params->m_Userdata;
+        request->m_Result = RESULT_OK;
+
+        // Same uri format as dmHttpClient, to share cache entries with it
+        dmSnPrintf(request->m_CacheURI, sizeof(request->m_CacheURI), "%s://%s:%d/%s", request->m_Url.m_Scheme, request->m_Url.m_Hostname, request->m_Url.m_Port, request->m_Url.m_Path);
+        request->m_UseCache = multi->m_HttpCache != 0 && !params->m_IgnoreCache && strcmp(request->m_Method, "GET") == 0;
+
+        char etag[64];
+        bool has_etag = request->m_UseCache && dmHttpCache::GetETag(multi->m_HttpCache, request->m_CacheURI, etag, sizeof(etag)) == dmHttpCache::RESULT_OK;
+        FormatRequest(request, params, has_etag ? etag : 0);
+
+        if (multi->m_Requests.Full())
+        {
+            multi->m_Requests.OffsetCapacity(16);
+        }
+        multi->m_Requests.Push(request);
+        *out_request = request->m_Handle;
+        return RESULT_OK;
+    }
+
+    static Request* FindRequest(HMulti multi, HRequest handle)
+    {
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (request->m_Handle == handle && request->m_State != STATE_DONE)
+                return request;
+        }
+        return 0;
+    }
+
+    void CancelRequest(HMulti multi, HRequest handle)
+    {
+        Request* request = FindRequest(multi, handle);
+        if (request)
+            request->m_Canceled = 1;
+    }
+
+    void PauseRequest(HMulti multi, HRequest handle)
+    {
+        Request* request = FindRequest(multi, handle);
+        if (request)
+            request->m_Paused = 1;
+    }
+
+    void ResumeRequest(HMulti multi, HRequest handle)
+    {
+        Request* request = FindRequest(multi, handle);
+        if (request && request->m_Paused)
+        {
+            request->m_Paused = 0;
+            // There may be unhandled data in the buffer
+            request->m_ReadPending = 1;
+        }
+    }
+
+    uint32_t GetRequestCount(HMulti multi)
+    {
+        return multi->m_Requests.Size();
+    }
+
+    void GetStatistics(HMulti multi, Statistics* statistics)
+    {
+        *statistics = multi->m_Statistics;
+    }
+
+    static void Finish(Multi* multi, Request* request, Result result)
+    {
+        if (request->m_State == STATE_DONE)
+            return;
+
+        if (request->m_CacheCreator)
+        {
+            if (result != RESULT_OK)
+            {
+                dmHttpCache::SetError(multi->m_HttpCache, request->m_CacheCreator);
+            }
+            dmHttpCache::End(multi->m_HttpCache, request->m_CacheCreator);
+            request->m_CacheCreator = 0;
+        }
+
+        // The connection can only be reused if the response was read exactly
+        bool keep_alive = result == RESULT_OK && !request->m_CloseConnection && request->m_BufferSize == 0;
+        ReleaseConnection(multi, request, keep_alive);
+        if (request->m_Dialing)
+        {
+            dmAtomicStore32(&request->m_DialCancel, 1);
+        }
+        request->m_State = STATE_DONE;
+        request->m_Result = result;
+
+        if (request->m_HttpDone)
+        {
+            request->m_HttpDone(request->m_Handle, request->m_Userdata, result, request->m_Status);
+        }
+    }
+
+    static void Content(Request* request, const void* data, uint32_t size)
+    {
+        if (request->m_HttpContent)
+        {
+            request->m_HttpContent(request->m_Handle, request->m_Userdata, request->m_Status, data, size);
+        }
+    }
+
+    // Serve the cached content of the request uri, with status 304
+    static Result ServeFromCache(Multi* multi, Request* request, const char* etag)
+    {
+        FILE* file = 0;
+        uint64_t checksum;
+        if (dmHttpCache::Get(multi->m_HttpCache, request->m_CacheURI, etag, &file, &checksum) != dmHttpCache::RESULT_OK)
+        {
+            return RESULT_IO_ERROR;
+        }
+
+        request->m_Status = 304;
+        size_t nread;
+        do
+        {
+            nread = fread(request->m_Buffer, 1, RECV_BUFFER_SIZE, file);
+            request->m_Buffer[nread] = '\0';
+            Content(request, request->m_Buffer, (uint32_t) nread);
+        }
+        while (nread > 0);
+        dmHttpCache::Release(multi->m_HttpCache, request->m_CacheURI, etag, file);
+        return RESULT_OK;
+    }
+
+    static bool TryDirectFromCache(Multi* multi, Request* request)
+    {
+        dmHttpCache::EntryInfo info;
+        if (dmHttpCache::GetInfo(multi->m_HttpCache, request->m_CacheURI, &info) != dmHttpCache::RESULT_OK)
+            return false;
+
+        bool trusted = info.m_Verified && dmHttpCache::GetConsistencyPolicy(multi->m_HttpCache) == dmHttpCache::CONSISTENCY_POLICY_TRUST_CACHE;
+        if (!trusted && !info.m_Valid)
+            return false;
+
+        if (ServeFromCache(multi, request, info.m_ETag) != RESULT_OK)
+            return false;
+
+        multi->m_Statistics.m_DirectFromCache++;
+        Finish(multi, request, RESULT_OK);
+        return true;
+    }
+
+    static void Connected(Multi* multi, Request* request)
+    {
+        request->m_Socket = dmConnectionPool::GetSocket(multi->m_Pool, request->m_Connection);
+        request->m_SSLSocket = dmConnectionPool::GetSSLSocket(multi->m_Pool, request->m_Connection);
+        dmSocket::SetBlocking(request->m_Socket, false);
+        if (request->m_SSLSocket)
+        {
+            dmSSLSocket::SetReceiveTimeout(request->m_SSLSocket, SSL_RECEIVE_TIMEOUT);
+        }
+
+        multi->m_Statistics.m_Requests++;
+        if (dmConnectionPool::GetReuseCount(multi->m_Pool, request->m_Connection) > 0)
+        {
+            multi->m_Statistics.m_ReusedConnections++;
+        }
+        request->m_Attempts++;
+        request->m_State = STATE_SENDING;
+        request->m_SendOffset = 0;
+        request->m_BufferSize = 0;
+        request->m_Received = 0;
+        request->m_ReadPending = 0;
+    }
+
+    // Runs on a dial thread
+    static int DialJob(void* context, void* data)
+    {
+        Multi* multi = (Multi*) context;
+        Request* request = (Request*) data;
+        if (dmAtomicGet32(&request->m_DialCancel))
+        {
+            return (int) dmConnectionPool::RESULT_SOCKET_ERROR;
+        }
+        dmSocket::Result sock_res = dmSocket::RESULT_OK;
+        bool secure = strcmp(request->m_Url.m_Scheme, "https") == 0;
+        dmConnectionPool::HConnection connection = 0;
+        dmConnectionPool::Result r = dmConnectionPool::Dial(multi->m_Pool, request->m_Url.m_Hostname, (uint16_t) request->m_Url.m_Port, secure, request->m_DialTimeout, (int*) &request->m_DialCancel, &connection, &sock_res);
+        request->m_DialConnection = r == dmConnectionPool::RESULT_OK ? connection : 0;
+        return (int) r;
+    }
+
+    // Called from Update() on the update thread
+    static void DialDone(void* context, void* data, int result)
+    {
+        Multi* multi = (Multi*) context;
+        Request* request = (Request*) data;
+        request->m_Dialing = 0;
+
+        dmConnectionPool::HConnection connection = request->m_DialConnection;
+        request->m_DialConnection = 0;
+
+        if (request->m_State != STATE_CONNECTING)
+        {
+            // Canceled or timed out while dialing
+            if (connection)
+            {
+                dmConnectionPool::Return(multi->m_Pool, connection);
+            }
+            return;
+        }
+
+        if (result != dmConnectionPool::RESULT_OK)
+        {
+            Finish(multi, request, RESULT_SOCKET_ERROR);
+            return;
+        }
+        request->m_Connection = connection;
+        Connected(multi, request);
+    }
+
+    static void StartRequest(Multi* multi, Request* request)
+    {
+        if (request->m_UseCache && request->m_Attempts == 0 && TryDirectFromCache(multi, request))
+        {
+            return;
+        }
+
+        request->m_DialTimeout = 0;
+        dmAtomicStore32(&request->m_DialCancel, 0);
+        if (request->m_Timeout)
+        {
+            uint64_t elapsed = dmTime::GetTime() - request->m_StartTime;
+            request->m_DialTimeout = (int) dmMath::Max((int64_t) 1, (int64_t) request->m_Timeout - (int64_t) elapsed);
+        }
+
+        multi->m_ActiveCount++;
+        request->m_State = STATE_CONNECTING;
+
+        if (multi->m_DialThreads)
+        {
+            request->m_Dialing = 1;
+            dmJobThread::PushJob(multi->m_DialThreads, DialJob, DialDone, multi, request);
+        }
+        else
+        {
+            DialDone(multi, request, DialJob(multi, request));
+        }
+    }
+
+    // A reused connection may have been closed by the server. If nothing was received
+    // the request is sent again on a new connection.
+    static void FailOrRetry(Multi* multi, Request* request, Result result)
+    {
+        uint32_t reuse_count = dmConnectionPool::GetReuseCount(multi->m_Pool, request->m_Connection);
+        if (!request->m_Received && reuse_count > 0 && request->m_Attempts <= multi->m_MaxActiveRequests)
+        {
+            multi->m_Statistics.m_Reconnections++;
+            ReleaseConnection(multi, request, false);
+            request->m_State = STATE_QUEUED;
+            return;
+        }
+        Finish(multi, request, result);
+    }
+
+    static void HandleVersion(void* user_data, int major, int minor, int status, const char* status_str)
+    {
+        Request* request = (Request*) user_data;
+        request->m_Status = status;
+        if ((major << 16 | minor) < (1 << 16 | 1))
+        {
+            // Close connection for HTTP protocol version < 1.1
+            request->m_CloseConnection = 1;
+        }
+    }
+
+    static void HandleHeader(void* user_data, const char* key, const char* value)
+    {
+        Request* request = (Request*) user_data;
+        if (dmStrCaseCmp(key, "Content-Length") == 0)
+        {
+            request->m_ContentLength = strtol(value, 0, 10);
+        }
+        else if (dmStrCaseCmp(key, "Transfer-Encoding") == 0 && dmStrCaseCmp(value, "chunked") == 0)
+        {
+            request->m_Chunked = 1;
+        }
+        else if (dmStrCaseCmp(key, "Connection") == 0 && dmStrCaseCmp(value, "close") == 0)
+        {
+            request->m_CloseConnection = 1;
+        }
+        else if (dmStrCaseCmp(key, "ETag") == 0)
+        {
+            dmStrlCpy(request->m_ETag, value, sizeof(request->m_ETag));
+        }
+        else if (dmStrCaseCmp(key, "Cache-Control") == 0)
+        {
+            const char* max_age = strstr(value, "max-age=");
+            if (max_age)
+            {
+                request->m_MaxAge = dmMath::Min((uint32_t) dmMath::Max(0, atoi(max_age + 8)), MAXIMUM_CACHE_AGE);
+            }
+        }
+
+        if (request->m_HttpHeader)
+        {
+            request->m_HttpHeader(request->m_Handle, request->m_Userdata, request->m_Status, key, value);
+        }
+    }
+
+    static void HandleContentOffset(void* user_data, int offset)
+    {
+        Request* request = (Request*) user_data;
+        request->m_Remaining = offset; // Temporary, the header size
+    }
+
+    static void Consume(Request* request, uint32_t size)
+    {
+        assert(size <= request->m_BufferSize);
+        memmove(request->m_Buffer, request->m_Buffer + size, request->m_BufferSize - size);
+        request->m_BufferSize -= size;
+    }
+
+    // Delivers up to m_Remaining bytes of content from the buffer
+    static void DeliverContent(Multi* multi, Request* request)
+    {
+        uint32_t n = (uint32_t) dmMath::Min((int64_t) request->m_BufferSize, request->m_Remaining);
+        if (n == 0)
+            return;
+        Content(request, request->m_Buffer, n);
+        if (request->m_CacheCreator)
+        {
+            dmHttpCache::Add(multi->m_HttpCache, request->m_CacheCreator, request->m_Buffer, n);
+        }
+        request->m_Remaining -= n;
+        Consume(request, n);
+    }
+
+    static Result HandleNotModified(Multi* multi, Request* request)
+    {
+        if (!request->m_UseCache)
+        {
+            return RESULT_OK;
+        }
+        multi->m_Statistics.m_CachedResponses++;
+
+        char cache_etag[64];
+        if (dmHttpCache::GetETag(multi->m_HttpCache, request->m_CacheURI, cache_etag, sizeof(cache_etag)) != dmHttpCache::RESULT_OK)
+        {
+            dmLogWarning("Got HTTP response NOT MODIFIED (304) but no ETag present. Returning no cached data.");
+            return RESULT_OK;
+        }
+        if (request->m_ETag[0] != '\0' && strcmp(cache_etag, request->m_ETag) != 0)
+        {
+            dmLogError("ETag mismatch (%s vs %s)", cache_etag, request->m_ETag);
+            return RESULT_IO_ERROR;
+        }
+        Result r = ServeFromCache(multi, request, cache_etag);
+        if (r == RESULT_OK)
+        {
+            dmHttpCache::SetVerified(multi->m_HttpCache, request->m_CacheURI, true);
+        }
+        return r;
+    }
+
+    // Returns false if more data is needed
+    static bool ParseHeaders(Multi* multi, Request* request)
+    {
+        request->m_Buffer[request->m_BufferSize] = '\0';
+        request->m_ContentLength = -1;
+        request->m_Remaining = -1;
+        dmHttpClient::ParseResult parse_res = dmHttpClient::ParseHeader(request->m_Buffer, request, false, &HandleVersion, &HandleHeader, &HandleContentOffset);
+        if (parse_res == dmHttpClient::PARSE_RESULT_NEED_MORE_DATA)
+        {
+            if (request->m_BufferSize >= RECV_BUFFER_SIZE - 1)
+            {
+                dmLogError("HTTP response headers from '%s' are too large", request->m_Url.m_Hostname);
+                Finish(multi, request, RESULT_HTTP_HEADERS_ERROR);
+            }
+            return false;
+        }
+        if (parse_res != dmHttpClient::PARSE_RESULT_OK || request->m_Remaining < 0)
+        {
+            request->m_CloseConnection = 1;
+            Finish(multi, request, RESULT_HTTP_HEADERS_ERROR);
+            return false;
+        }
+        Consume(request, (uint32_t) request->m_Remaining);
+
+        // Start of response
+        Content(request, 0, 0);
+
+        if (strcmp(request->m_Method, "HEAD") == 0 || request->m_Status == 204 || request->m_Status == 304)
+        {
+            request->m_ContentLength = 0;
+            request->m_Chunked = 0;
+        }
+
+        if (request->m_Status == 304)
+        {
+            Result r = HandleNotModified(multi, request);
+            if (r != RESULT_OK)
+            {
+                Finish(multi, request, r);
+                return false;
+            }
+        }
+        else if (request->m_UseCache && request->m_Status == 200)
+        {
+            dmHttpCache::Begin(multi->m_HttpCache, request->m_CacheURI, request->m_ETag, request->m_MaxAge, &request->m_CacheCreator);
+        }
+
+        if (request->m_Chunked)
+        {
+            request->m_ChunkState = CHUNK_STATE_SIZE;
+            request->m_Remaining = 0;
+        }
+        else if (request->m_ContentLength >= 0)
+        {
+            request->m_Remaining = request->m_ContentLength;
+        }
+        else
+        {
+            // No content length, read until the server closes the connection
+            request->m_UntilClose = 1;
+            request->m_CloseConnection = 1;
+            request->m_Remaining = INT64_MAX;
+        }
+        request->m_State = STATE_RECEIVING_CONTENT;
+        return true;
+    }
+
+    // Finds the end of a line in the buffer, returns the line length or -1
+    static int FindLine(Request* request)
+    {
+        for (uint32_t i = 0; i + 1 < request->m_BufferSize; ++i)
+        {
+            if (request->m_Buffer[i] == '\r' && request->m_Buffer[i + 1] == '\n')
+                return (int) i;
+        }
+        return -1;
+    }
+
+    static void ParseChunked(Multi* multi, Request* request)
+    {
+        while (request->m_State == STATE_RECEIVING_CONTENT && !request->m_Paused)
+        {
+            switch (request->m_ChunkState)
+            {
+            case CHUNK_STATE_SIZE:
+                {
+                    int len = FindLine(request);
+                    if (len < 0)
+                    {
+                        if (request->m_BufferSize >= RECV_BUFFER_SIZE - 1)
+                            Finish(multi, request, RESULT_INVALID_RESPONSE);
+                        return;
+                    }
+                    request->m_Buffer[len] = '\0';
+                    unsigned int chunk_size = 0;
+                    if (sscanf(request->m_Buffer, "%x", &chunk_size) != 1)
+                    {
+                        Finish(multi, request, RESULT_INVALID_RESPONSE);
+                        return;
+                    }
+                    Consume(request, len + 2);
+                    request->m_Remaining = chunk_size;
+                    request->m_ChunkState = chunk_size == 0 ? CHUNK_STATE_TRAILER : CHUNK_STATE_DATA;
+                }
+                break;
+
+            case CHUNK_STATE_DATA:
+                DeliverContent(multi, request);
+                if (request->m_Remaining > 0)
+                    return;
+                request->m_ChunkState = CHUNK_STATE_DATA_END;
+                break;
+
+            case CHUNK_STATE_DATA_END:
+                if (request->m_BufferSize < 2)
+                    return;
+                if (request->m_Buffer[0] != '\r' || request->m_Buffer[1] != '\n')
+                {
+                    Finish(multi, request, RESULT_INVALID_RESPONSE);
+                    return;
+                }
+                Consume(request, 2);
+                request->m_ChunkState = CHUNK_STATE_SIZE;
+                break;
+
+            case CHUNK_STATE_TRAILER:
+                {
+                    // Trailer headers (ignored) until an empty line
+                    int len = FindLine(request);
+                    if (len < 0)
+                    {
+                        if (request->m_BufferSize >= RECV_BUFFER_SIZE - 1)
+                            Finish(multi, request, RESULT_INVALID_RESPONSE);
+                        return;
+                    }
+                    Consume(request, len + 2);
+                    if (len == 0)
+                    {
+                        Finish(multi, request, request->m_BufferSize == 0 ? RESULT_OK : RESULT_INVALID_RESPONSE);
+                        return;
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    static void ProcessBuffer(Multi* multi, Request* request)
+    {
+        if (request->m_State == STATE_RECEIVING_HEADERS)
+        {
+            if (!ParseHeaders(multi, request))
+                return;
+        }
+
+        if (request->m_State != STATE_RECEIVING_CONTENT || request->m_Paused)
+            return;
+
+        if (request->m_Chunked)
+        {
+            ParseChunked(multi, request);
+        }
+        else
+        {
+            DeliverContent(multi, request);
+            if (request->m_Remaining == 0)
+            {
+                // Extra bytes after the content means we can't trust the response
+                Finish(multi, request, request->m_BufferSize == 0 ? RESULT_OK : RESULT_INVALID_RESPONSE);
+            }
+        }
+    }
+
+    static void HandleEndOfStream(Multi* multi, Request* request)
+    {
+        if (request->m_State == STATE_RECEIVING_CONTENT && request->m_UntilClose)
+        {
+            request->m_CloseConnection = 1;
+            Finish(multi, request, RESULT_OK);
+            return;
+        }
+        request->m_CloseConnection = 1;
+        FailOrRetry(multi, request, RESULT_UNEXPECTED_EOF);
+    }
+
+    static void Send(Multi* multi, Request* request)
+    {
+        while (request->m_SendOffset < request->m_SendBuffer.Size())
+        {
+            const char* data = request->m_SendBuffer.Begin() + request->m_SendOffset;
+            int size = (int) (request->m_SendBuffer.Size() - request->m_SendOffset);
+            int sent = 0;
+            dmSocket::Result r;
+            if (request->m_SSLSocket)
+                r = dmSSLSocket::Send(request->m_SSLSocket, data, dmMath::Min(size, (int) MAX_HTTPS_POST_CHUNK_SIZE), &sent);
+            else
+                r = dmSocket::Send(request->m_Socket, data, size, &sent);
+
+            if (r == dmSocket::RESULT_WOULDBLOCK || r == dmSocket::RESULT_TRY_AGAIN)
+                return;
+            if (r != dmSocket::RESULT_OK)
+            {
+                FailOrRetry(multi, request, RESULT_SOCKET_ERROR);
+                return;
+            }
+            request->m_SendOffset += sent;
+        }
+        request->m_State = STATE_RECEIVING_HEADERS;
+        // The response may already be waiting
+        request->m_ReadPending = 1;
+    }
+
+    static void Receive(Multi* multi, Request* request)
+    {
+        request->m_ReadPending = 0;
+
+        // Handle data left in the buffer, eg after a resume
+        ProcessBuffer(multi, request);
+
+        for (uint32_t i = 0; i < MAX_READS_PER_UPDATE; ++i)
+        {
+            if (request->m_State != STATE_RECEIVING_HEADERS && request->m_State != STATE_RECEIVING_CONTENT)
+                return;
+            if (request->m_Paused)
+                return;
+
+            // NOTE: The tls layer reads at most size-1 bytes, and null terminates
+            uint32_t space = RECV_BUFFER_SIZE - request->m_BufferSize;
+            if (space < 2)
+            {
+                Finish(multi, request, RESULT_INVALID_RESPONSE);
+                return;
+            }
+
+            int received = 0;
+            dmSocket::Result r;
+            if (request->m_SSLSocket)
+                r = dmSSLSocket::Receive(request->m_SSLSocket, request->m_Buffer + request->m_BufferSize, (int) space, &received);
+            else
+                r = dmSocket::Receive(request->m_Socket, request->m_Buffer + request->m_BufferSize, (int) space, &received);
+
+            if (r == dmSocket::RESULT_WOULDBLOCK || r == dmSocket::RESULT_TRY_AGAIN)
+                return;
+            if (r == dmSocket::RESULT_CONNRESET)
+            {
+                HandleEndOfStream(multi, request);
+                return;
+            }
+            if (r != dmSocket::RESULT_OK)
+            {
+                request->m_CloseConnection = 1;
+                FailOrRetry(multi, request, RESULT_SOCKET_ERROR);
+                return;
+            }
+            if (received == 0)
+            {
+                HandleEndOfStream(multi, request);
+                return;
+            }
+
+            request->m_Received = 1;
+            request->m_BufferSize += received;
+            ProcessBuffer(multi, request);
+        }
+
+        // More data may be available
+        request->m_ReadPending = 1;
+    }
+
+    static bool IsActive(Request* request)
+    {
+        return request->m_State == STATE_SENDING || request->m_State == STATE_RECEIVING_HEADERS || request->m_State == STATE_RECEIVING_CONTENT;
+    }
+
+    uint32_t Update(HMulti multi, uint64_t timeout)
+    {
+        uint64_t now = dmTime::GetTime();
+
+        // Cancellations and timeouts
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (request->m_State == STATE_DONE)
+                continue;
+            if (request->m_Canceled)
+            {
+                Finish(multi, request, RESULT_CANCELED);
+            }
+            else if (request->m_Timeout && now - request->m_StartTime >= request->m_Timeout)
+            {
+                request->m_CloseConnection = 1;
+                Finish(multi, request, RESULT_TIMEOUT);
+            }
+        }
+
+        // Requests whose connection was established since the last update
+        if (multi->m_DialThreads)
+        {
+            dmJobThread::Update(multi->m_DialThreads);
+        }
+
+        // Start queued requests. New requests may be added from the callbacks, hence Size() every iteration.
+        for (uint32_t i = 0; i < multi->m_Requests.Size() && multi->m_ActiveCount < multi->m_MaxActiveRequests; ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (request->m_State == STATE_QUEUED && !request->m_Canceled)
+            {
+                StartRequest(multi, request);
+            }
+        }
+
+        // Wait for socket events
+        bool pending = false;
+        bool dialing = false;
+        dmFileDescriptor::PollerReset(&multi->m_Poller);
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            dialing |= request->m_Dialing != 0;
+            if (request->m_State == STATE_SENDING)
+            {
+                dmFileDescriptor::PollerSetEvent(&multi->m_Poller, dmFileDescriptor::EVENT_WRITE, request->m_Socket);
+            }
+            else if (IsActive(request) && !request->m_Paused)
+            {
+                dmFileDescriptor::PollerSetEvent(&multi->m_Poller, dmFileDescriptor::EVENT_READ, request->m_Socket);
+                pending |= request->m_ReadPending != 0;
+            }
+        }
+
+        // There is no socket to wake up on when a dial has finished
+        if (dialing)
+        {
+            timeout = dmMath::Min(timeout, DIAL_POLL_INTERVAL);
+        }
+
+        if (multi->m_Poller.m_Pollfds.Size() > 0)
+        {
+            int timeout_ms = pending ? 0 : (int) ((timeout + 999) / 1000);
+            dmFileDescriptor::Wait(&multi->m_Poller, timeout_ms);
+        }
+        else if (timeout > 0 && multi->m_Requests.Size() > 0)
+        {
+            // Only paused, queued or connecting requests
+            dmTime::Sleep((uint32_t) dmMath::Min(timeout, (uint64_t) 1000));
+        }
+
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (!IsActive(request) || request->m_Paused)
+                continue;
+
+            dmFileDescriptor::Poller* poller = &multi->m_Poller;
+            bool error = dmFileDescriptor::PollerHasEvent(poller, dmFileDescriptor::EVENT_ERROR, request->m_Socket);
+            if (request->m_State == STATE_SENDING)
+            {
+                if (error || dmFileDescriptor::PollerHasEvent(poller, dmFileDescriptor::EVENT_WRITE, request->m_Socket))
+                {
+                    Send(multi, request);
+                }
+            }
+            if (request->m_State == STATE_RECEIVING_HEADERS || request->m_State == STATE_RECEIVING_CONTENT)
+            {
+                if (error || request->m_ReadPending || dmFileDescriptor::PollerHasEvent(poller, dmFileDescriptor::EVENT_READ, request->m_Socket))
+                {
+                    Receive(multi, request);
+                }
+            }
+        }
+
+        // Remove finished requests
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < multi->m_Requests.Size(); ++i)
+        {
+            Request* request = multi->m_Requests[i];
+            if (request->m_State == STATE_DONE && !request->m_Dialing)
+            {
+                DeleteRequest(request);
+            }
+            else
+            {
+                multi->m_Requests[count++] = request;
+            }
+        }
+        multi->m_Requests.SetSize(count);
+        return count;
+    }
+
+#define DM_HTTPMULTI_RESULT_TO_STRING_CASE(x) case RESULT_##x: return #x;
+    const char* ResultToString(Result r)
+    {
+        switch (r)
+        {
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(OK);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(SOCKET_ERROR);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(HTTP_HEADERS_ERROR);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(INVALID_RESPONSE);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(UNEXPECTED_EOF);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(TIMEOUT);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(CANCELED);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(IO_ERROR);
+            DM_HTTPMULTI_RESULT_TO_STRING_CASE(INVAL);
+        }
+        return "RESULT_UNDEFINED";
+    }
+#undef DM_HTTPMULTI_RESULT_TO_STRING_CASE
+}
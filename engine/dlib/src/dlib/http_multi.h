@@ -0,0 +1,233 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_HTTP_MULTI_H
+#define DM_HTTP_MULTI_H
+
+#include <stdint.h>
+#include <dlib/http_cache.h>
+
+/**
+ * Event driven http client running many concurrent requests on one thread.
+ *
+ * Requests are added with AddRequest() and progressed by calling Update() from the thread
+ * that owns the client. Update() waits for socket events on all active requests at once
+ * (poll), sends and receives without blocking and invokes the request callbacks.
+ * Connections are kept alive and reused through a connection pool. New connections
+ * (name lookup, connect and TLS handshake) are established on a small pool of dial threads,
+ * so that a slow server doesn't hold up the other requests.
+ */
+namespace dmHttpMulti
+{
+    /**
+     * Result values
+     */
+    enum Result
+    {
+        RESULT_OK                               = 0,
+        RESULT_SOCKET_ERROR                     = -1,
+        RESULT_HTTP_HEADERS_ERROR               = -2,
+        RESULT_INVALID_RESPONSE                 = -3,
+        RESULT_UNEXPECTED_EOF                   = -4,
+        RESULT_TIMEOUT                          = -5,
+        RESULT_CANCELED                         = -6,
+        RESULT_IO_ERROR                         = -7,
+        RESULT_INVAL                            = -8,
+    };
+
+    /**
+     * Client handle
+     */
+    typedef struct Multi* HMulti;
+
+    /**
+     * Request handle. Zero is never a valid request.
+     */
+    typedef uint32_t HRequest;
+
+    /**
+     * Response header callback
+     * @param request Request handle
+     * @param user_data User data
+     * @param status_code Status code, eg 200
+     * @param key Header key, eg "Content-Length"
+     * @param value Header value
+     */
+    typedef void (*HttpHeader)(HRequest request, void* user_data, int status_code, const char* key, const char* value);
+
+    /**
+     * Response content callback. Called as soon as content is received.
+     * Called with both content_data and content_data_size set to 0 to indicate the start of a response.
+     * This might occur more than once, if the request is retried on a new connection.
+     * @param request Request handle
+     * @param user_data User data
+     * @param status_code Status code, eg 200
+     * @param content_data Content data
+     * @param content_data_size Content data size
+     */
+    typedef void (*HttpContent)(HRequest request, void* user_data, int status_code, const void* content_data, uint32_t content_data_size);
+
+    /**
+     * Request finished callback. Called exactly once for each request, unless the client is deleted first.
+     * The request handle is invalid after the callback.
+     * @param request Request handle
+     * @param user_data User data
+     * @param result RESULT_OK if a response was received
+     * @param status_code Status code, eg 200. 304 if the content was served from the http cache.
+     */
+    typedef void (*HttpDone)(HRequest request, void* user_data, Result result, int status_code);
+
+    /**
+     * Client parameters
+     */
+    struct NewParams
+    {
+        /// Maximum number of requests running at the same time. Further requests are queued.
+        uint32_t            m_MaxActiveRequests;
+        /// Maximum number of pooled connections. Should be at least m_MaxActiveRequests.
+        uint32_t            m_MaxConnections;
+        /// Number of threads establishing new connections. With zero, or on platforms without threads, connections are established by Update().
+        uint32_t            m_DialThreadCount;
+        /// Http cache used for GET requests. Optional.
+        dmHttpCache::HCache m_HttpCache;
+
+        NewParams();
+    };
+
+    /**
+     * Request parameters. All data is copied.
+     */
+    struct RequestParams
+    {
+        /// Http method, eg "GET"
+        const char*     m_Method;
+        /// Full url, eg "http://localhost:8080/index.html"
+        const char*     m_Url;
+        /// Request headers, "Name: value" lines separated by '\n'. Optional.
+        const char*     m_Headers;
+        /// Request body. Optional.
+        const void*     m_Body;
+        uint32_t        m_BodySize;
+        /// Request timeout in us. 0 for no timeout.
+        uint64_t        m_Timeout;
+
+        HttpHeader      m_HttpHeader;
+        HttpContent     m_HttpContent;
+        HttpDone        m_HttpDone;
+        void*           m_Userdata;
+
+        /// Don't use the http cache
+        uint8_t         m_IgnoreCache : 1;
+        /// Use chunked transfer encoding for https bodies larger than 16k
+        uint8_t         m_ChunkedTransfer : 1;
+
+        RequestParams();
+    };
+
+    /**
+     * Client statistics
+     */
+    struct Statistics
+    {
+        /// Number of requests sent, including retries
+        uint32_t m_Requests;
+        /// Number of requests sent on a reused connection
+        uint32_t m_ReusedConnections;
+        /// Number of retries after a reused connection was closed by the server
+        uint32_t m_Reconnections;
+        /// Number of 304 responses served from the cache
+        uint32_t m_CachedResponses;
+        /// Number of requests served from the cache without a request
+        uint32_t m_DirectFromCache;
+    };
+
+    /**
+     * Create a new client
+     * @param params Parameters
+     * @param multi [out] The client
+     * @return RESULT_OK on success
+     */
+    Result New(const NewParams* params, HMulti* multi);
+
+    /**
+     * Delete the client. Active requests are aborted without calling their callbacks.
+     * Waits for the connections being established on the dial threads.
+     * @param multi Client
+     */
+    void Delete(HMulti multi);
+
+    /**
+     * Add a request. The request is started by the next Update().
+     * @param multi Client
+     * @param params Request parameters
+     * @param request [out] Request handle
+     * @return RESULT_OK on success. RESULT_INVAL if the url can't be parsed.
+     */
+    Result AddRequest(HMulti multi, const RequestParams* params, HRequest* request);
+
+    /**
+     * Cancel a request. The done callback is called with RESULT_CANCELED by the next Update().
+     * @param multi Client
+     * @param request Request handle
+     */
+    void CancelRequest(HMulti multi, HRequest request);
+
+    /**
+     * Stop reading the response of a request, eg when the receiver can't keep up.
+     * The server is throttled by the tcp flow control until the request is resumed.
+     * Can be called from the content callback.
+     * @param multi Client
+     * @param request Request handle
+     */
+    void PauseRequest(HMulti multi, HRequest request);
+
+    /**
+     * Resume reading the response of a paused request
+     * @param multi Client
+     * @param request Request handle
+     */
+    void ResumeRequest(HMulti multi, HRequest request);
+
+    /**
+     * Start queued requests, wait for socket events and progress all active requests.
+     * Callbacks are invoked from this function.
+     * @param multi Client
+     * @param timeout Maximum time to wait for socket events in us
+     * @return Number of unfinished requests
+     */
+    uint32_t Update(HMulti multi, uint64_t timeout);
+
+    /**
+     * Get number of unfinished requests, queued or active
+     * @param multi Client
+     * @return Number of requests
+     */
+    uint32_t GetRequestCount(HMulti multi);
+
+    /**
+     * Get client statistics
+     * @param multi Client
+     * @param statistics [out] Statistics
+     */
+    void GetStatistics(HMulti multi, Statistics* statistics);
+
+    /**
+     * Convert result value to string
+     * @param result Result to convert
+     * @return Result as string
+     */
+    const char* ResultToString(Result result);
+}
+
+#endif // DM_HTTP_MULTI_H
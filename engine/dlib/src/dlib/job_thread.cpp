@@ -14,6 +14,7 @@
 
 
 #include <stdio.h> // printf
+#include <stdlib.h> // malloc
 
 #include <dmsdk/dlib/array.h>
 
@@ -36,6 +37,15 @@
 namespace dmJobThread
 {
 
+struct JobGroup
+{
+    Job*            m_Jobs;
+    int32_atomic_t* m_Started;      // One flag per job, set by the thread that runs it
+    uint32_t        m_JobCount;
+    uint32_t        m_Remaining;    // Jobs not yet finished. Protected by the context mutex
+    int32_atomic_t  m_RefCount;     // The waiting thread, and each queued item
+};
+
 struct JobItem
 {
     void*       m_Context;
@@ -43,6 +53,7 @@ struct JobItem
     FProcess    m_Process;
     FCallback   m_Callback;
     int         m_Result;
+    JobGroup*   m_Group;            // If set, the item helps running the jobs of the group
 };
 
 struct JobThreadContext
@@ -53,6 +64,7 @@ struct JobThreadContext
 #if defined(DM_HAS_THREADS)
     dmMutex::HMutex                         m_Mutex;
     dmConditionVariable::HConditionVariable m_WakeupCond;
+    dmConditionVariable::HConditionVariable m_GroupCond;
     int32_atomic_t                          m_Run;
 #endif
 };
@@ -85,6 +97,31 @@ static void PutDone(JobThreadContext* ctx, JobItem* item)
     ctx->m_Done.Push(*item);
 }
 
+static void ReleaseGroup(JobGroup* group)
+{
+    if (dmAtomicDecrement32(&group->m_RefCount) == 1)
+        free(group);
+}
+
+// Returns false if another thread has already started the job
+static bool RunGroupJob(JobThreadContext* ctx, JobGroup* group, uint32_t index)
+{
+    if (dmAtomicCompareStore32(&group->m_Started[index], 1, 0) != 0)
+        return false;
+
+    Job& job = group->m_Jobs[index];
+    job.m_Result = job.m_Process(job.m_Context, job.m_Data);
+
+#if defined(DM_HAS_THREADS)
+    DM_MUTEX_SCOPED_LOCK(ctx->m_Mutex);
+    if (--group->m_Remaining == 0)
+        dmConditionVariable::Broadcast(ctx->m_GroupCond);
+#else
+    --group->m_Remaining;
+#endif
+    return true;
+}
+
 #if defined(DM_HAS_THREADS)
 static void JobThread(void* _ctx)
 {
@@ -104,6 +141,14 @@ static void JobThread(void* _ctx)
             item = ctx->m_Work.Pop();
         }
 
+        if (item.m_Group)
+        {
+            DM_PROFILE("JobThreadGroup");
+            for (uint32_t i = 0; i < item.m_Group->m_JobCount; ++i)
+                RunGroupJob(ctx, item.m_Group, i);
+            ReleaseGroup(item.m_Group);
+        }
+        else
         {
             DM_PROFILE("JobThread");
             item.m_Result = item.m_Process(item.m_Context, item.m_Data);
@@ -130,6 +175,7 @@ HContext Create(const JobThreadCreationParams& create_params)
 #if defined(DM_HAS_THREADS)
     context->m_ThreadContext.m_Mutex = dmMutex::New();
     context->m_ThreadContext.m_WakeupCond = dmConditionVariable::New();
+    context->m_ThreadContext.m_GroupCond = dmConditionVariable::New();
     context->m_ThreadContext.m_Run = 1;
 
     uint32_t thread_count = dmMath::Min(create_params.m_ThreadCount, DM_MAX_JOB_THREAD_COUNT);
@@ -166,10 +212,20 @@ void Destroy(HContext context)
     {
         dmThread::Join(context->m_Threads[i]);
     }
+    dmConditionVariable::Delete(context->m_ThreadContext.m_GroupCond);
     dmConditionVariable::Delete(context->m_ThreadContext.m_WakeupCond);
     dmMutex::Delete(context->m_ThreadContext.m_Mutex);
 #endif // DM_HAS_THREADS
 
+    // Items of groups that have already been waited for
+    jc::RingBuffer<JobItem>& work = context->m_ThreadContext.m_Work;
+    while (!work.Empty())
+    {
+        JobItem item = work.Pop();
+        if (item.m_Group)
+            ReleaseGroup(item.m_Group);
+    }
+
     delete context;
 }
 
@@ -181,6 +237,7 @@ void PushJob(HContext context, FProcess process, FCallback callback, void* user_
     item.m_Process = process;
     item.m_Callback = callback;
     item.m_Result = 0;
+    item.m_Group = 0;
 
     PutWork(&context->m_ThreadContext, &item);
 #if defined(DM_HAS_THREADS)
@@ -188,6 +245,65 @@ void PushJob(HContext context, FProcess process, FCallback callback, void* user_
 #endif
 }
 
+HGroup PushGroup(HContext context, Job* jobs, uint32_t job_count)
+{
+    JobGroup* group = (JobGroup*)malloc(sizeof(JobGroup) + sizeof(int32_atomic_t) * job_count);
+    group->m_Jobs = jobs;
+    group->m_Started = (int32_atomic_t*)(group + 1);
+    group->m_JobCount = job_count;
+    group->m_Remaining = job_count;
+    group->m_RefCount = 1;
+    for (uint32_t i = 0; i < job_count; ++i)
+        group->m_Started[i] = 0;
+
+#if defined(DM_HAS_THREADS)
+    JobThreadContext* ctx = &context->m_ThreadContext;
+    // No need to queue more items than there are threads to pick them up
+    uint32_t item_count = dmMath::Min(job_count, context->m_Threads.Size());
+    if (item_count == 0)
+        return group;
+
+    dmAtomicAdd32(&group->m_RefCount, (int32_t)item_count);
+    {
+        DM_MUTEX_SCOPED_LOCK(ctx->m_Mutex);
+        if (ctx->m_Work.Capacity() - ctx->m_Work.Size() < item_count)
+            ctx->m_Work.SetCapacity(ctx->m_Work.Size() + item_count + 8);
+        for (uint32_t i = 0; i < item_count; ++i)
+        {
+            JobItem item;
+            item.m_Context = 0;
+            item.m_Data = 0;
+            item.m_Process = 0;
+            item.m_Callback = 0;
+            item.m_Result = 0;
+            item.m_Group = group;
+            ctx->m_Work.Push(item);
+        }
+        dmConditionVariable::Broadcast(ctx->m_WakeupCond);
+    }
+#endif
+    return group;
+}
+
+void WaitGroup(HContext context, HGroup group)
+{
+    JobThreadContext* ctx = &context->m_ThreadContext;
+    // Start from the back, since the workers start from the front
+    for (uint32_t i = group->m_JobCount; i > 0; --i)
+    {
+        RunGroupJob(ctx, group, i - 1);
+    }
+
+#if defined(DM_HAS_THREADS)
+    {
+        DM_MUTEX_SCOPED_LOCK(ctx->m_Mutex);
+        while (group->m_Remaining > 0)
+            dmConditionVariable::Wait(ctx->m_GroupCond, ctx->m_Mutex);
+    }
+#endif
+    ReleaseGroup(group);
+}
+
 void Update(HContext context)
 {
     DM_PROFILE("Update");
@@ -20,6 +20,7 @@
 namespace dmJobThread
 {
     typedef struct JobContext* HContext;
+    typedef struct JobGroup* HGroup;
     typedef int (*FProcess)(void* context, void* data);
     typedef void (*FCallback)(void* context, void* data, int result);
 
@@ -31,11 +32,27 @@ namespace dmJobThread
         uint8_t     m_ThreadCount;
     };
 
+    // A job that is part of a group, see PushGroup()
+    struct Job
+    {
+        FProcess    m_Process;
+        void*       m_Context;
+        void*       m_Data;
+        int         m_Result;   // Written when the job has run
+    };
+
     HContext Create(const JobThreadCreationParams& create_params);
     void     Destroy(HContext context);
     void     Update(HContext context); // Flushes any items and calls PostProcess
     void     PushJob(HContext context, FProcess process, FCallback callback, void* user_context, void* data);
     bool     PlatformHasThreadSupport();
+
+    // Queues a group of jobs for the worker threads. The jobs must stay alive until WaitGroup() returns.
+    // No callbacks are invoked, and nothing is passed on to Update().
+    HGroup   PushGroup(HContext context, Job* jobs, uint32_t job_count);
+    // Runs the jobs of the group that no worker has started on the calling thread, and waits for the rest.
+    // The calling thread never waits for jobs outside of the group.
+    void     WaitGroup(HContext context, HGroup group);
 }
 
 #endif // DM_JOB_THREAD_H
@@ -47,20 +47,37 @@ namespace dmMemProfile
 {
     struct InternalData
     {
-        Stats* m_Stats;
-        bool*  m_IsEnabled;
+        Stats*      m_Stats;
+        TagStats*   m_TagStats;
+        bool*       m_IsEnabled;
         void (*m_AddCounter)(const char*, uint32_t);
+        Tag  (*m_GetTag)();
     };
 }
 
 
 #ifndef DM_LIBMEMPROFILE
 
+#include "thread.h"
+
 namespace dmMemProfile
 {
     // Common code and data
     Stats g_Stats = {0};
+    TagStats g_TagStats[MAX_TAG_COUNT] = {};
     bool g_IsEnabled = false;
+    dmThread::TlsKey g_TagKey;
+
+    static const char* TAG_NAMES[MAX_TAG_COUNT] =
+    {
+        "none",
+        "resource",
+        "component",
+        "lua",
+        "render",
+        "sound",
+        "physics",
+    };
 
     void Initialize()
     {
@@ -70,10 +87,15 @@ namespace dmMemProfile
         void (*init)(dmMemProfile::InternalData*) = (void (*)(dmMemProfile::InternalData*)) dlsym(RTLD_DEFAULT, "dmMemProfileInitializeLibrary");
         if (init)
         {
+            // The key is never freed, since the library might allocate after Finalize()
+            g_TagKey = dmThread::AllocTls();
+
             dmMemProfile::InternalData data;
             data.m_Stats = &dmMemProfile::g_Stats;
+            data.m_TagStats = dmMemProfile::g_TagStats;
             data.m_IsEnabled = &dmMemProfile::g_IsEnabled;
             data.m_AddCounter = dmProfile::AddCounter;
+            data.m_GetTag = dmMemProfile::GetTag;
 
             init(&data);
         }
@@ -93,6 +115,34 @@ namespace dmMemProfile
     {
         *stats = g_Stats;
     }
+
+    Tag SetTag(Tag tag)
+    {
+        if (!g_IsEnabled)
+            return TAG_NONE;
+
+        Tag previous = GetTag();
+        dmThread::SetTlsValue(g_TagKey, (void*)(uintptr_t)tag);
+        return previous;
+    }
+
+    Tag GetTag()
+    {
+        if (!g_IsEnabled)
+            return TAG_NONE;
+        return (Tag)(uintptr_t)dmThread::GetTlsValue(g_TagKey);
+    }
+
+    void GetTagStats(Tag tag, TagStats* stats)
+    {
+        assert(tag < MAX_TAG_COUNT);
+        *stats = g_TagStats[tag];
+    }
+
+    const char* GetTagName(Tag tag)
+    {
+        return tag < MAX_TAG_COUNT ? TAG_NAMES[tag] : "unknown";
+    }
 }
 
 #endif
@@ -174,7 +224,26 @@ namespace dmMemProfile
 
     pthread_mutex_t* g_Mutex = 0;
     Stats* g_ExtStats = 0;
+    TagStats* g_ExtTagStats = 0;
     void (*g_AddCounter)(const char*, uint32_t) = 0;
+    Tag (*g_GetTag)() = 0;
+
+    // Open addressing table with the tag of each tagged allocation. Allocations made
+    // without a tag aren't stored. Protected by g_Mutex.
+    struct TagEntry
+    {
+        uintptr_t m_Ptr;
+        uint32_t  m_Tag;
+    };
+
+    static const uintptr_t TAG_ENTRY_EMPTY = 0;
+    static const uintptr_t TAG_ENTRY_DELETED = 1;
+    static const uint32_t  TAG_TABLE_MIN_CAPACITY = 4096;
+
+    TagEntry*       g_TagTable = 0;
+    uint32_t        g_TagTableCapacity = 0;
+    uint32_t        g_TagTableUsed = 0; // Including deleted entries
+    int32_atomic_t  g_TagTableCount = 0;
 
     int g_TraceFile = -1;
 
@@ -196,7 +265,9 @@ namespace dmMemProfile
 
         *internal_data->m_IsEnabled = true;
         g_ExtStats = internal_data->m_Stats;
+        g_ExtTagStats = internal_data->m_TagStats;
         g_AddCounter = internal_data->m_AddCounter;
+        g_GetTag = internal_data->m_GetTag;
 
         char* trace = getenv("DMMEMPROFILE_TRACE");
         if (trace && strlen(trace) > 0 && trace[0] != '0')
@@ -269,6 +340,134 @@ namespace dmMemProfile
         ret = pthread_mutex_unlock(dmMemProfile::g_Mutex);
         assert(ret == 0);
     }
+
+    static inline uint32_t TagTableHash(uintptr_t ptr)
+    {
+        uint64_t h = (uint64_t) ptr;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return (uint32_t) h;
+    }
+
+    static void TagTableInsert(TagEntry* table, uint32_t capacity, uintptr_t ptr, uint32_t tag)
+    {
+        uint32_t mask = capacity - 1;
+        uint32_t i = TagTableHash(ptr) & mask;
+        while (table[i].m_Ptr != TAG_ENTRY_EMPTY && table[i].m_Ptr != TAG_ENTRY_DELETED)
+        {
+            i = (i + 1) & mask;
+        }
+        table[i].m_Ptr = ptr;
+        table[i].m_Tag = tag;
+    }
+
+    static void TagTableRehash()
+    {
+        uint32_t count = (uint32_t) g_TagTableCount;
+        uint32_t capacity = TAG_TABLE_MIN_CAPACITY;
+        while (capacity < (count + 1) * 4)
+            capacity *= 2;
+
+        // The real allocator is used to avoid recursion
+        TagEntry* table = (TagEntry*) mallocp(capacity * sizeof(TagEntry));
+        if (!table)
+            return;
+        memset(table, 0, capacity * sizeof(TagEntry));
+
+        for (uint32_t i = 0; i < g_TagTableCapacity; ++i)
+        {
+            uintptr_t p = g_TagTable[i].m_Ptr;
+            if (p != TAG_ENTRY_EMPTY && p != TAG_ENTRY_DELETED)
+                TagTableInsert(table, capacity, p, g_TagTable[i].m_Tag);
+        }
+
+        freep(g_TagTable);
+        g_TagTable = table;
+        g_TagTableCapacity = capacity;
+        g_TagTableUsed = count;
+    }
+
+    static void TagAllocation(void* ptr, uint32_t size, Tag tag)
+    {
+        if (tag == TAG_NONE || tag >= MAX_TAG_COUNT || !g_ExtTagStats || !g_Mutex)
+            return;
+
+        int ret = pthread_mutex_lock(g_Mutex);
+        assert(ret == 0);
+
+        if ((g_TagTableUsed + 1) * 2 > g_TagTableCapacity)
+            TagTableRehash();
+
+        bool stored = (g_TagTableUsed + 1) * 2 <= g_TagTableCapacity;
+        if (stored)
+        {
+            TagTableInsert(g_TagTable, g_TagTableCapacity, (uintptr_t) ptr, (uint32_t) tag);
+            g_TagTableUsed++;
+            dmAtomicIncrement32(&g_TagTableCount);
+        }
+
+        ret = pthread_mutex_unlock(g_Mutex);
+        assert(ret == 0);
+
+        if (!stored)
+            return;
+
+        TagStats* stats = &g_ExtTagStats[tag];
+        int32_t active = dmAtomicAdd32(&stats->m_Active, (int32_t) size) + (int32_t) size;
+        dmAtomicAdd32(&stats->m_TotalAllocated, (int32_t) size);
+        dmAtomicIncrement32(&stats->m_AllocationCount);
+
+        int32_t peak = dmAtomicGet32(&stats->m_Peak);
+        while (active > peak)
+        {
+            int32_t prev = dmAtomicCompareStore32(&stats->m_Peak, active, peak);
+            if (prev == peak)
+                break;
+            peak = prev;
+        }
+    }
+
+    static void TagAllocation(void* ptr, uint32_t size)
+    {
+        if (g_GetTag)
+            TagAllocation(ptr, size, g_GetTag());
+    }
+
+    // Removes the allocation from the tag table and returns its tag
+    static Tag UntagAllocation(void* ptr, uint32_t size)
+    {
+        if (!ptr || dmAtomicGet32(&g_TagTableCount) == 0)
+            return TAG_NONE;
+
+        int ret = pthread_mutex_lock(g_Mutex);
+        assert(ret == 0);
+
+        Tag tag = TAG_NONE;
+        if (g_TagTableCapacity > 0)
+        {
+            uint32_t mask = g_TagTableCapacity - 1;
+            uint32_t i = TagTableHash((uintptr_t) ptr) & mask;
+            while (g_TagTable[i].m_Ptr != TAG_ENTRY_EMPTY)
+            {
+                if (g_TagTable[i].m_Ptr == (uintptr_t) ptr)
+                {
+                    tag = (Tag) g_TagTable[i].m_Tag;
+                    g_TagTable[i].m_Ptr = TAG_ENTRY_DELETED;
+                    dmAtomicDecrement32(&g_TagTableCount);
+                    break;
+                }
+                i = (i + 1) & mask;
+            }
+        }
+
+        ret = pthread_mutex_unlock(g_Mutex);
+        assert(ret == 0);
+
+        if (tag != TAG_NONE)
+            dmAtomicSub32(&g_ExtTagStats[tag].m_Active, (int32_t) size);
+        return tag;
+    }
 }
 
 extern "C"
@@ -293,6 +492,7 @@ DM_DLLEXPORT void *malloc(size_t size)
 #endif
 
         dmMemProfile::DumpBacktrace('M', ptr, usable_size);
+        dmMemProfile::TagAllocation(ptr, (uint32_t) usable_size);
 
         if (dmMemProfile::g_ExtStats)
         {
@@ -337,6 +537,7 @@ DM_DLLEXPORT void *memalign(size_t alignment, size_t size)
 #endif
 
         dmMemProfile::DumpBacktrace('M', ptr, usable_size);
+        dmMemProfile::TagAllocation(ptr, (uint32_t) usable_size);
 
         if (dmMemProfile::g_ExtStats)
         {
@@ -378,6 +579,7 @@ DM_DLLEXPORT int posix_memalign(void **memptr, size_t alignment, size_t size)
 #endif
 
         dmMemProfile::DumpBacktrace('M', *memptr, usable_size);
+        dmMemProfile::TagAllocation(*memptr, (uint32_t) usable_size);
 
         if (dmMemProfile::g_ExtStats)
         {
@@ -418,6 +620,7 @@ DM_DLLEXPORT void *calloc(size_t count, size_t size)
 #endif
 
         dmMemProfile::DumpBacktrace('M', ptr, usable_size);
+        dmMemProfile::TagAllocation(ptr, (uint32_t) usable_size);
 
         if (dmMemProfile::g_ExtStats)
         {
@@ -457,6 +660,9 @@ DM_DLLEXPORT void *realloc(void* ptr, size_t size)
 #error "Unsupported platform"
 #endif
 
+    // Untag before the real realloc, since the address might be reused by another thread
+    dmMemProfile::Tag tag = dmMemProfile::UntagAllocation(ptr, (uint32_t) old_usable_size);
+
     void* old_ptr = ptr;
     ptr = reallocp(ptr, size);
     if (ptr)
@@ -473,6 +679,12 @@ DM_DLLEXPORT void *realloc(void* ptr, size_t size)
         dmMemProfile::DumpBacktrace('F', old_ptr, old_usable_size);
         dmMemProfile::DumpBacktrace('M', ptr, usable_size);
 
+        // The memory keeps its tag when reallocated
+        if (tag != dmMemProfile::TAG_NONE)
+            dmMemProfile::TagAllocation(ptr, (uint32_t) usable_size, tag);
+        else
+            dmMemProfile::TagAllocation(ptr, (uint32_t) usable_size);
+
         if (dmMemProfile::g_ExtStats)
         {
             dmAtomicSub32(&dmMemProfile::g_ExtStats->m_TotalActive, (uint32_t) old_usable_size);
@@ -487,7 +699,9 @@ DM_DLLEXPORT void *realloc(void* ptr, size_t size)
     }
     else
     {
-        // Nothing happended
+        // Nothing happended, unless the memory was released by realloc(ptr, 0)
+        if (size != 0)
+            dmMemProfile::TagAllocation(old_ptr, (uint32_t) old_usable_size, tag);
     }
     return ptr;
 }
@@ -522,6 +736,8 @@ DM_DLLEXPORT void free(void *ptr)
         dmAtomicSub32(&dmMemProfile::g_ExtStats->m_TotalActive, (uint32_t) usable_size);
     }
 
+    dmMemProfile::UntagAllocation(ptr, (uint32_t) usable_size);
+
     if (ptr)
         dmMemProfile::DumpBacktrace('F', ptr, usable_size);
     freep(ptr);
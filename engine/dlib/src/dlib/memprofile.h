@@ -34,6 +34,41 @@ namespace dmMemProfile
         int32_atomic_t m_AllocationCount;
     };
 
+    /**
+     * Allocation tags. Allocations made while a tag is set are accounted to the tag,
+     * and the memory is accounted to the tag until it's freed.
+     * Allocations made without a tag are only part of the totals in Stats.
+     */
+    enum Tag
+    {
+        TAG_NONE,
+        TAG_RESOURCE,
+        TAG_COMPONENT,
+        TAG_LUA,
+        TAG_RENDER,
+        TAG_SOUND,
+        TAG_PHYSICS,
+        MAX_TAG_COUNT
+    };
+
+    /**
+     * Memory statistics for a tag
+     */
+    struct TagStats
+    {
+        /// Active memory allocated with the tag
+        int32_atomic_t m_Active;
+
+        /// Highest active memory allocated with the tag
+        int32_atomic_t m_Peak;
+
+        /// Total memory allocated with the tag
+        int32_atomic_t m_TotalAllocated;
+
+        /// Total number of allocations with the tag
+        int32_atomic_t m_AllocationCount;
+    };
+
     /**
      * Initialize memory profiler
      */
@@ -55,6 +90,52 @@ namespace dmMemProfile
      * @param stats Pointer to memory stats struct
      */
     void GetStats(Stats* stats);
+
+    /**
+     * Set the allocation tag of the calling thread. Does nothing unless memory profiling is enabled.
+     * @param tag Tag to set
+     * @return The previous tag, to restore when the tagged allocations are done
+     */
+    Tag SetTag(Tag tag);
+
+    /**
+     * Get the allocation tag of the calling thread
+     * @return The current tag
+     */
+    Tag GetTag();
+
+    /**
+     * Get memory allocation statistics for a tag
+     * @param tag Tag
+     * @param stats Pointer to tag stats struct
+     */
+    void GetTagStats(Tag tag, TagStats* stats);
+
+    /**
+     * Get the name of a tag
+     * @param tag Tag
+     * @return The name, e.g. "lua"
+     */
+    const char* GetTagName(Tag tag);
+
+    /**
+     * Sets the allocation tag of the calling thread for the lifetime of the scope
+     */
+    struct TagScope
+    {
+        Tag m_Previous;
+        TagScope(Tag tag) : m_Previous(SetTag(tag)) {}
+        ~TagScope() { SetTag(m_Previous); }
+    };
 }
 
+#define _DM_MEMPROFILE_PASTE(x, y) x ## y
+#define _DM_MEMPROFILE_PASTE2(x, y) _DM_MEMPROFILE_PASTE(x, y)
+
+/**
+ * Account the allocations in the current scope to a tag
+ * @param tag [type:dmMemProfile::Tag] The tag, e.g. dmMemProfile::TAG_LUA
+ */
+#define DM_MEMPROFILE_TAG_SCOPE(tag) dmMemProfile::TagScope _DM_MEMPROFILE_PASTE2(memprofile_tag_scope, __LINE__)(tag)
+
 #endif // DM_MEMPROFILE_H
@@ -430,10 +430,9 @@ namespace dmMessage
         url->m_Fragment = fragment;
     }
 
-    Result Post(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
-                    uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
+    static Result InternalPost(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
+                    uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback, bool external)
     {
-        DM_PROFILE("Post");
         //Currently called out by the Thread Sanitizer: DM_PROPERTY_ADD_U32(rmtp_Messages, 1);
 
         if (receiver == 0x0)
@@ -450,7 +449,8 @@ namespace dmMessage
         dmMutex::Lock(s->m_Mutex);
 
         MemoryAllocator* allocator = &s->m_Allocator;
-        uint32_t data_size = sizeof(Message) + message_data_size;
+        // An external message only stores the pointer to the data
+        uint32_t data_size = sizeof(Message) + (external ? sizeof(const void*) : message_data_size);
         Message *new_message = (Message *) AllocateMessage(allocator, data_size);
         if (sender != 0x0)
         {
@@ -466,9 +466,17 @@ namespace dmMessage
         new_message->m_UserData2 = user_data2;
         new_message->m_Descriptor = descriptor;
         new_message->m_DataSize = message_data_size;
+        new_message->m_External = external ? 1 : 0;
         new_message->m_Next = 0;
         new_message->m_DestroyCallback = destroy_callback;
-        memcpy(&new_message->m_Data[0], message_data, message_data_size);
+        if (external)
+        {
+            *(const void**) &new_message->m_Data[0] = message_data;
+        }
+        else
+        {
+            memcpy(&new_message->m_Data[0], message_data, message_data_size);
+        }
 
         bool is_first_message = !s->m_Header;
 
@@ -494,6 +502,35 @@ namespace dmMessage
         return RESULT_OK;
     }
 
+    Result Post(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
+                    uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
+    {
+        DM_PROFILE("Post");
+        return InternalPost(sender, receiver, message_id, user_data1, user_data2, descriptor, message_data, message_data_size, destroy_callback, false);
+    }
+
+    Result PostExternal(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
+                    uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
+    {
+        DM_PROFILE("PostExternal");
+        assert(((uintptr_t)message_data % DM_MESSAGE_ALIGNMENT) == 0);
+        return InternalPost(sender, receiver, message_id, user_data1, user_data2, descriptor, message_data, message_data_size, destroy_callback, true);
+    }
+
+    const void* GetData(const Message* message)
+    {
+        if (message->m_External)
+        {
+            return *(const void* const*) &message->m_Data[0];
+        }
+        return (const void*)&message->m_Data[0];
+    }
+
+    bool IsExternal(const Message* message)
+    {
+        return message->m_External != 0;
+    }
+
     Result Post(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t descriptor,
                     const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
     {
@@ -527,7 +564,7 @@ namespace dmMessage
         return buffer;
     }
 
-    uint32_t InternalDispatch(HSocket socket, DispatchCallback dispatch_callback, void* user_ptr, bool blocking)
+    uint32_t InternalDispatch(HSocket socket, DispatchCallback dispatch_callback, DispatchEndCallback end_callback, void* user_ptr, bool blocking)
     {
         MessageSocket* s = AcquireSocket(socket);
         if (s == 0)
@@ -577,6 +614,11 @@ namespace dmMessage
             dispatch_count++;
         }
 
+        if (end_callback)
+        {
+            end_callback(user_ptr);
+        }
+
         // Reclaim all full pages active when dispatch started
         dmMutex::Lock(s->m_Mutex);
         MemoryPage* p = full_pages;
@@ -596,12 +638,17 @@ namespace dmMessage
 
     uint32_t Dispatch(HSocket socket, DispatchCallback dispatch_callback, void* user_ptr)
     {
-        return InternalDispatch(socket, dispatch_callback, user_ptr, false);
+        return InternalDispatch(socket, dispatch_callback, 0, user_ptr, false);
+    }
+
+    uint32_t Dispatch(HSocket socket, DispatchCallback dispatch_callback, DispatchEndCallback end_callback, void* user_ptr)
+    {
+        return InternalDispatch(socket, dispatch_callback, end_callback, user_ptr, false);
     }
 
     uint32_t DispatchBlocking(HSocket socket, DispatchCallback dispatch_callback, void* user_ptr)
     {
-        return InternalDispatch(socket, dispatch_callback, user_ptr, true);
+        return InternalDispatch(socket, dispatch_callback, 0, user_ptr, true);
     }
 
     static void ConsumeCallback(dmMessage::Message*, void*)
@@ -33,6 +33,11 @@ namespace dmMessage
      */
     typedef void(*DispatchCallback)(dmMessage::Message *message, void* user_ptr);
 
+    /**
+     * @see #Dispatch
+     */
+    typedef void(*DispatchEndCallback)(void* user_ptr);
+
 
     /**
      * Create a new socket
@@ -80,6 +85,18 @@ namespace dmMessage
      */
     uint32_t Dispatch(HSocket socket, DispatchCallback dispatch_callback, void* user_ptr);
 
+    /**
+     * Dispatch messages, and call end_callback when all messages have been passed to dispatch_callback.
+     * The messages are still valid when end_callback is called, which allows the dispatch callback to
+     * defer the handling of messages without a destroy callback until then.
+     * @param socket Socket handle of the socket of which messages to dispatch.
+     * @param dispatch_callback Callback function that will be called for each message
+     * @param end_callback Callback function that will be called after the last message. Not called if there were no messages
+     * @param user_ptr User data passed to the callbacks
+     * @return Number of dispatched messages
+     */
+    uint32_t Dispatch(HSocket socket, DispatchCallback dispatch_callback, DispatchEndCallback end_callback, void* user_ptr);
+
     /**
      * Dispatch messages blocking. The function will return as soon at least one message
      * is dispatched.
@@ -19,6 +19,14 @@ namespace dmProfile
 {
 
 // Unit test only
+Options::Options()
+: m_Port(0)
+, m_SleepBetweenServerUpdates(0)
+, m_TraceFile(0)
+, m_TraceFrames(0)
+{
+}
+
 static void PrintIndent(int indent)
 {
     for (int i = 0; i < indent; ++i) {
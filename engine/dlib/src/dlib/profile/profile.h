@@ -32,6 +32,13 @@ namespace dmProfile
     {
         uint32_t m_Port;
         uint32_t m_SleepBetweenServerUpdates;
+        // Path of a Chrome trace event (json) file to capture the samples and properties to. Optional.
+        // The file can be opened in chrome://tracing or https://ui.perfetto.dev
+        const char* m_TraceFile;
+        // Number of frames to capture. 0 captures until Finalize()
+        uint32_t m_TraceFrames;
+
+        Options();
     };
 
     /**
@@ -72,6 +79,18 @@ namespace dmProfile
 
     bool IsInitialized();
 
+    /**
+     * Check if the trace capture requested with Options::m_TraceFile was started
+     * @return false if the file couldn't be opened, or if the profiler isn't available (e.g. the null implementation)
+     */
+    bool IsTraceCaptureStarted();
+
+    /**
+     * Check if the trace capture requested with Options::m_TraceFile is finished and written to file
+     * @return true if the capture is finished
+     */
+    bool IsTraceCaptureFinished();
+
     void ScopeBegin(const char* name, uint64_t* name_hash);
     void ScopeEnd();
 
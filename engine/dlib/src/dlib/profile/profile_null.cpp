@@ -29,6 +29,16 @@ namespace dmProfile
         return false;
     }
 
+    bool IsTraceCaptureStarted()
+    {
+        return false;
+    }
+
+    bool IsTraceCaptureFinished()
+    {
+        return false;
+    }
+
     void SetThreadName(const char* name)
     {
     }
@@ -19,6 +19,18 @@ namespace dmProfile
 {
 // For unit tests only
 void PrintProperty(dmProfile::HProperty property, int indent);
+
+// Chrome trace event capture, fed from the sample and property tree callbacks
+typedef struct TraceCapture* HTraceCapture;
+
+// Must be created right before the profiler, since the time of the properties is measured from the creation
+// Returns 0 if the file couldn't be opened
+HTraceCapture NewTraceCapture(const char* path, uint32_t max_frames);
+// Finishes the file if the capture isn't already finished
+void DeleteTraceCapture(HTraceCapture capture);
+void TraceCaptureSampleTree(HTraceCapture capture, const char* thread_name, dmProfile::HSample root);
+void TraceCapturePropertyTree(HTraceCapture capture, dmProfile::HProperty root);
+bool IsTraceCaptureFinished(HTraceCapture capture);
 }
 
 #endif // DM_PROFILE_PRIVATE_H
@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "profile.h"
+#include "profile_private.h"
 
 #include <stdio.h> // vsnprintf
 #include <stdarg.h> // va_start et al
@@ -31,6 +32,7 @@ namespace dmProfile
     static void*                    g_SampleTreeCallbackCtx = 0;
     static FPropertyTreeCallback    g_PropertyTreeCallback = 0;
     static void*                    g_PropertyTreeCallbackCtx = 0;
+    static HTraceCapture            g_TraceCapture = 0;
 
     static inline rmtSample* SampleFromHandle(HSample sample)
     {
@@ -51,17 +53,28 @@ namespace dmProfile
 
     static void SampleTreeCallback(void* ctx, rmtSampleTree* sample_tree)
     {
-        if (g_SampleTreeCallback)
+        if (g_SampleTreeCallback || g_TraceCapture)
         {
             const char* thread_name = rmt_SampleTreeGetThreadName(sample_tree);
             rmtSample* root = rmt_SampleTreeGetRootSample(sample_tree);
 
-            g_SampleTreeCallback(g_SampleTreeCallbackCtx, thread_name, SampleToHandle(root));
+            if (g_TraceCapture)
+            {
+                TraceCaptureSampleTree(g_TraceCapture, thread_name, SampleToHandle(root));
+            }
+            if (g_SampleTreeCallback)
+            {
+                g_SampleTreeCallback(g_SampleTreeCallbackCtx, thread_name, SampleToHandle(root));
+            }
         }
     }
 
     static void PropertyTreeCallback(void* ctx, rmtProperty* root)
     {
+        if (g_TraceCapture)
+        {
+            TraceCapturePropertyTree(g_TraceCapture, PropertyToHandle(root));
+        }
         if (g_PropertyTreeCallback)
         {
             g_PropertyTreeCallback(g_PropertyTreeCallbackCtx, PropertyToHandle(root));
@@ -93,10 +106,18 @@ namespace dmProfile
         settings->reuse_open_port = true;
         settings->enableThreadSampler = false;
 
+        if (options && options->m_TraceFile && options->m_TraceFile[0] != 0)
+        {
+            g_TraceCapture = NewTraceCapture(options->m_TraceFile, options->m_TraceFrames);
+        }
+
         rmtError result = rmt_CreateGlobalInstance(&g_Remotery);
         if (result != RMT_ERROR_NONE)
         {
             dmLogError("Failed to initialize profile library %d", result);
+            if (g_TraceCapture)
+                DeleteTraceCapture(g_TraceCapture);
+            g_TraceCapture = 0;
             return;
         }
 
@@ -110,6 +131,11 @@ namespace dmProfile
         if (g_Remotery)
             rmt_DestroyGlobalInstance(g_Remotery);
         g_Remotery = 0;
+
+        // The profiler thread is stopped, so no more callbacks
+        if (g_TraceCapture)
+            DeleteTraceCapture(g_TraceCapture);
+        g_TraceCapture = 0;
     }
 
     bool IsInitialized()
@@ -117,6 +143,16 @@ namespace dmProfile
         return g_Remotery != 0;
     }
 
+    bool IsTraceCaptureStarted()
+    {
+        return g_TraceCapture != 0;
+    }
+
+    bool IsTraceCaptureFinished()
+    {
+        return g_TraceCapture != 0 && IsTraceCaptureFinished(g_TraceCapture);
+    }
+
     HProfile BeginFrame()
     {
         if (!g_Remotery)
@@ -0,0 +1,268 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+// Writes the profile samples and properties as Chrome trace events
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+// Samples are written as complete events ("X"), properties as counter events ("C")
+// and thread names as metadata events ("M").
+// The sample trees come from the profiler thread and the property trees from the main thread.
+
+#include "profile.h"
+#include "profile_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dlib/atomic.h"
+#include "dlib/hash.h"
+#include "dlib/hashtable.h"
+#include "dlib/log.h"
+#include "dlib/mutex.h"
+#include "dlib/time.h"
+
+namespace dmProfile
+{
+    static const char* MAIN_THREAD_NAME = "Main";
+    static const char* PROFILER_THREAD_NAME = "Remotery";
+
+    struct TraceCapture
+    {
+        dmMutex::HMutex         m_Mutex;
+        FILE*                   m_File;
+        char*                   m_Path;
+        dmHashTable32<uint32_t> m_ThreadIds;
+        uint64_t                m_StartTime;    // Approximately the start of the profiler timer, which the samples are relative to
+        uint32_t                m_MaxFrames;
+        uint32_t                m_Frames;
+        uint32_t                m_EventCount;
+        int32_atomic_t          m_Finished;
+    };
+
+    static void WriteString(FILE* file, const char* str)
+    {
+        fputc('"', file);
+        for (const char* c = str; *c; ++c)
+        {
+            switch (*c)
+            {
+            case '"':  fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:
+                if ((unsigned char)*c < 0x20)
+                    fprintf(file, "\\u%04x", (unsigned char)*c);
+                else
+                    fputc(*c, file);
+                break;
+            }
+        }
+        fputc('"', file);
+    }
+
+    // Writes the start of an event, the caller writes the rest of the fields and the closing brace
+    static void BeginEvent(TraceCapture* capture, const char* name, const char* phase, uint32_t thread_id)
+    {
+        FILE* file = capture->m_File;
+        fputs(capture->m_EventCount++ == 0 ? "\n" : ",\n", file);
+        fputs("{\"name\":", file);
+        WriteString(file, name);
+        fprintf(file, ",\"ph\":\"%s\",\"pid\":1,\"tid\":%u", phase, thread_id);
+    }
+
+    static uint32_t GetThreadId(TraceCapture* capture, const char* thread_name)
+    {
+        uint32_t name_hash = dmHashString32(thread_name);
+        uint32_t* id = capture->m_ThreadIds.Get(name_hash);
+        if (id)
+        {
+            return *id;
+        }
+
+        if (capture->m_ThreadIds.Full())
+        {
+            uint32_t capacity = capture->m_ThreadIds.Capacity() + 8;
+            capture->m_ThreadIds.SetCapacity(capacity, capacity);
+        }
+        uint32_t thread_id = capture->m_ThreadIds.Size() + 1;
+        capture->m_ThreadIds.Put(name_hash, thread_id);
+
+        BeginEvent(capture, "thread_name", "M", thread_id);
+        fputs(",\"args\":{\"name\":", capture->m_File);
+        WriteString(capture->m_File, thread_name);
+        fputs("}}", capture->m_File);
+        return thread_id;
+    }
+
+    static void WriteSample(TraceCapture* capture, uint32_t thread_id, HSample sample)
+    {
+        const char* name = SampleGetName(sample);
+        uint32_t call_count = SampleGetCallCount(sample);
+
+        BeginEvent(capture, name ? name : "<empty_sample_name>", "X", thread_id);
+        fprintf(capture->m_File, ",\"ts\":%llu,\"dur\":%llu", (unsigned long long)SampleGetStart(sample), (unsigned long long)SampleGetTime(sample));
+        if (call_count > 1)
+        {
+            // Samples with the same name in the same scope are merged into one
+            fprintf(capture->m_File, ",\"args\":{\"calls\":%u}", call_count);
+        }
+        fputc('}', capture->m_File);
+
+        SampleIterator iter;
+        SampleIterateChildren(sample, &iter);
+        while (SampleIterateNext(&iter))
+        {
+            WriteSample(capture, thread_id, iter.m_Sample);
+        }
+    }
+
+    static void WriteProperty(TraceCapture* capture, uint64_t time, const char* group_name, HProperty property)
+    {
+        const char* name = PropertyGetName(property);
+        if (!name)
+        {
+            name = "<empty_property_name>";
+        }
+
+        PropertyType type = PropertyGetType(property);
+        if (type == PROPERTY_TYPE_GROUP)
+        {
+            PropertyIterator iter;
+            PropertyIterateChildren(property, &iter);
+            while (PropertyIterateNext(&iter))
+            {
+                WriteProperty(capture, time, name, iter.m_Property);
+            }
+            return;
+        }
+
+        char full_name[128];
+        if (group_name)
+            snprintf(full_name, sizeof(full_name), "%s.%s", group_name, name);
+        else
+            snprintf(full_name, sizeof(full_name), "%s", name);
+
+        // Counters are placed on the process track
+        BeginEvent(capture, full_name, "C", 0);
+        fprintf(capture->m_File, ",\"ts\":%llu,\"args\":{\"value\":", (unsigned long long)time);
+
+        PropertyValue value = PropertyGetValue(property);
+        switch (type)
+        {
+        case PROPERTY_TYPE_BOOL: fprintf(capture->m_File, "%d", value.m_Bool ? 1 : 0); break;
+        case PROPERTY_TYPE_S32:  fprintf(capture->m_File, "%d", value.m_S32); break;
+        case PROPERTY_TYPE_U32:  fprintf(capture->m_File, "%u", value.m_U32); break;
+        case PROPERTY_TYPE_F32:  fprintf(capture->m_File, "%g", value.m_F32); break;
+        case PROPERTY_TYPE_S64:  fprintf(capture->m_File, "%lld", (long long)value.m_S64); break;
+        case PROPERTY_TYPE_U64:  fprintf(capture->m_File, "%llu", (unsigned long long)value.m_U64); break;
+        case PROPERTY_TYPE_F64:  fprintf(capture->m_File, "%g", value.m_F64); break;
+        default:                 fputc('0', capture->m_File); break;
+        }
+        fputs("}}", capture->m_File);
+    }
+
+    static void FinishTraceCapture(TraceCapture* capture)
+    {
+        fputs("\n]}\n", capture->m_File);
+        fclose(capture->m_File);
+        capture->m_File = 0;
+
+        dmLogInfo("Wrote %u frames of profile trace to '%s'", capture->m_Frames, capture->m_Path);
+        dmAtomicStore32(&capture->m_Finished, 1);
+    }
+
+    HTraceCapture NewTraceCapture(const char* path, uint32_t max_frames)
+    {
+        FILE* file = fopen(path, "wb");
+        if (!file)
+        {
+            dmLogError("Failed to open profile trace file '%s'", path);
+            return 0;
+        }
+
+        TraceCapture* capture = new TraceCapture;
+        capture->m_Mutex = dmMutex::New();
+        capture->m_File = file;
+        capture->m_Path = strdup(path);
+        capture->m_ThreadIds.SetCapacity(7, 8);
+        capture->m_StartTime = dmTime::GetTime();
+        capture->m_MaxFrames = max_frames;
+        capture->m_Frames = 0;
+        capture->m_EventCount = 0;
+        capture->m_Finished = 0;
+
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+        return capture;
+    }
+
+    void DeleteTraceCapture(HTraceCapture capture)
+    {
+        if (capture->m_File)
+        {
+            FinishTraceCapture(capture);
+        }
+        free(capture->m_Path);
+        dmMutex::Delete(capture->m_Mutex);
+        delete capture;
+    }
+
+    void TraceCaptureSampleTree(HTraceCapture capture, const char* thread_name, HSample root)
+    {
+        DM_MUTEX_SCOPED_LOCK(capture->m_Mutex);
+        // Skip the overhead of the profiler itself
+        if (!capture->m_File || strcmp(thread_name, PROFILER_THREAD_NAME) == 0)
+        {
+            return;
+        }
+
+        uint32_t thread_id = GetThreadId(capture, thread_name);
+        WriteSample(capture, thread_id, root);
+
+        // Each root sample on the main thread is a frame
+        if (strcmp(thread_name, MAIN_THREAD_NAME) == 0)
+        {
+            ++capture->m_Frames;
+            if (capture->m_MaxFrames != 0 && capture->m_Frames >= capture->m_MaxFrames)
+            {
+                FinishTraceCapture(capture);
+            }
+        }
+    }
+
+    void TraceCapturePropertyTree(HTraceCapture capture, HProperty root)
+    {
+        DM_MUTEX_SCOPED_LOCK(capture->m_Mutex);
+        if (!capture->m_File)
+        {
+            return;
+        }
+
+        // The properties are snapshotted at the end of the frame, on the main thread
+        uint64_t time = dmTime::GetTime() - capture->m_StartTime;
+
+        PropertyIterator iter;
+        PropertyIterateChildren(root, &iter);
+        while (PropertyIterateNext(&iter))
+        {
+            WriteProperty(capture, time, 0, iter.m_Property);
+        }
+    }
+
+    bool IsTraceCaptureFinished(HTraceCapture capture)
+    {
+        return dmAtomicGet32(&capture->m_Finished) != 0;
+    }
+}
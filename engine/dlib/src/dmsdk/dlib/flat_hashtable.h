@@ -0,0 +1,505 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DMSDK_FLAT_HASHTABLE_H
+#define DMSDK_FLAT_HASHTABLE_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define DM_FLAT_HASHTABLE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define DM_FLAT_HASHTABLE_NEON
+#endif
+
+/*# Flat hash table
+ *
+ * Open addressing hash table
+ *
+ * @document
+ * @name Flat Hashtable
+ * @namespace dmFlatHashTable
+ * @path engine/dlib/src/dmsdk/dlib/flat_hashtable.h
+ */
+
+/*# flat hashtable
+ * Hashtable with open addressing, memcpy-copy semantics (POD types) and automatic growth.
+ *
+ * The entries are stored in a single array. Each entry has a control byte holding 7 bits of the key hash,
+ * and lookups compare the control bytes of 16 entries at a time (SSE2/NEON when available).
+ * Compared to [ref:dmHashTable], lookups touch fewer cache lines and there is no table size to tune,
+ * but the entries move when the table grows.
+ *
+ * @note The key type needs to be an integer type
+ * @note Pointers returned by Get() are invalidated by Put() and SetCapacity()
+ * @type class
+ * @name dmFlatHashTable
+ */
+template <typename KEY, typename T>
+class dmFlatHashTable
+{
+    // Control byte values. Full entries store the 7 lowest bits of the hash (0x00-0x7f)
+    static const int8_t  CTRL_EMPTY     = -128; // 0x80
+    static const int8_t  CTRL_DELETED   = -2;   // 0xfe
+    static const uint32_t GROUP_SIZE    = 16;
+    static const uint32_t MIN_CAPACITY  = GROUP_SIZE;
+
+public:
+    struct Entry
+    {
+        KEY m_Key;
+        T   m_Value;
+    };
+
+    /**
+     * Constructor. Create an empty hashtable with zero capacity
+     * @name dmFlatHashTable
+     */
+    dmFlatHashTable()
+    {
+        memset(this, 0, sizeof(*this));
+    }
+
+    /**
+     * Destructor.
+     * @name ~dmFlatHashTable
+     */
+    ~dmFlatHashTable()
+    {
+        free(m_Ctrl);
+    }
+
+    /**
+     * Removes all the entries from the table. The capacity is kept.
+     * @name Clear
+     */
+    void Clear()
+    {
+        if (m_Ctrl)
+            memset(m_Ctrl, CTRL_EMPTY, m_TableSize);
+        m_Count = 0;
+        m_Deleted = 0;
+    }
+
+    /**
+     * Number of entries stored in table
+     * @name Size
+     * @return Number of entries.
+     */
+    uint32_t Size() const
+    {
+        return m_Count;
+    }
+
+    /**
+     * Number of entries that can be stored before the table grows
+     * @name Capacity
+     * @return Capacity of the table
+     */
+    uint32_t Capacity() const
+    {
+        return MaxLoad(m_TableSize);
+    }
+
+    /**
+     * Check if the table is empty
+     * @name Empty
+     * @return true if the table is empty
+     */
+    bool Empty() const
+    {
+        return m_Count == 0;
+    }
+
+    /**
+     * Make room for a number of entries, so that the table doesn't grow until it holds more entries.
+     * The capacity is never decreased.
+     * @name SetCapacity
+     * @param capacity Number of entries
+     */
+    void SetCapacity(uint32_t capacity)
+    {
+        uint32_t table_size = MIN_CAPACITY;
+        while (MaxLoad(table_size) < capacity)
+        {
+            table_size *= 2;
+        }
+        if (table_size > m_TableSize)
+        {
+            Rehash(table_size);
+        }
+    }
+
+    /**
+     * Swaps the contents of two hash tables
+     * @name Swap
+     * @param other the other table
+     */
+    void Swap(dmFlatHashTable<KEY, T>& other)
+    {
+        char buf[sizeof(*this)];
+        memcpy(buf, &other, sizeof(buf));
+        memcpy(&other, this, sizeof(buf));
+        memcpy(this, buf, sizeof(buf));
+    }
+
+    /**
+     * Put key/value pair in hash table. If the key already exists, the value is replaced.
+     * The table grows if needed.
+     * @name Put
+     * @param key Key
+     * @param value Value
+     */
+    void Put(KEY key, const T& value)
+    {
+        uint64_t hash = Hash(key);
+        Entry* entry = Find(key, hash);
+        if (entry != 0)
+        {
+            entry->m_Value = value;
+            return;
+        }
+
+        if (m_Count + m_Deleted >= MaxLoad(m_TableSize))
+        {
+            // Grow, unless there are enough deleted entries to make room for
+            Rehash(m_Count >= MaxLoad(m_TableSize) / 2 ? (m_TableSize ? m_TableSize * 2 : MIN_CAPACITY) : m_TableSize);
+        }
+
+        uint32_t index = FindInsertIndex(hash);
+        if (m_Ctrl[index] == CTRL_DELETED)
+        {
+            --m_Deleted;
+        }
+        m_Ctrl[index] = (int8_t)(hash & 0x7f);
+        m_Entries[index].m_Key = key;
+        m_Entries[index].m_Value = value;
+        ++m_Count;
+    }
+
+    /**
+     * Get pointer to value from key
+     * @name Get
+     * @param key Key
+     * @return value Pointer to value. NULL if the key/value pair doesn't exist.
+     */
+    T* Get(KEY key)
+    {
+        Entry* e = Find(key, Hash(key));
+        return e ? &e->m_Value : 0;
+    }
+
+    /**
+     * Get pointer to value from key. "const" version.
+     * @name Get
+     * @param key Key
+     * @return value Pointer to value. NULL if the key/value pair doesn't exist.
+     */
+    const T* Get(KEY key) const
+    {
+        Entry* e = Find(key, Hash(key));
+        return e ? &e->m_Value : 0;
+    }
+
+    /**
+     * Remove key/value pair. NOTE: Only valid if key exists in table.
+     * @name Erase
+     * @param key Key to remove
+     */
+    void Erase(KEY key)
+    {
+        Entry* e = Find(key, Hash(key));
+        assert(e != 0x0 && "Key not found (erase)");
+        uint32_t index = (uint32_t)(e - m_Entries);
+        // A probe only continues past a group that has no empty entries. If this group has one,
+        // no probe depends on the entry being occupied and it can be marked as empty.
+        uint32_t group = index & ~(GROUP_SIZE - 1);
+        if (MatchEmpty(m_Ctrl + group))
+        {
+            m_Ctrl[index] = CTRL_EMPTY;
+        }
+        else
+        {
+            m_Ctrl[index] = CTRL_DELETED;
+            ++m_Deleted;
+        }
+        --m_Count;
+    }
+
+    /**
+     * Iterate over all entries in table
+     * @name Iterate
+     * @param call_back Call-back called for every entry
+     * @param context Context
+     */
+    template <typename CONTEXT>
+    void Iterate(void (*call_back)(CONTEXT *context, const KEY* key, T* value), CONTEXT* context) const
+    {
+        for (uint32_t i = 0; i < m_TableSize; ++i)
+        {
+            if (m_Ctrl[i] >= 0)
+            {
+                call_back(context, &m_Entries[i].m_Key, &m_Entries[i].m_Value);
+            }
+        }
+    }
+
+    /*#
+     * Iterator to the key/value pairs of a hash table
+     * @struct
+     * @name Iterator
+     * @member GetKey()
+     * @member GetValue()
+     */
+    struct Iterator
+    {
+        // public
+        const KEY&  GetKey()    { return m_Table.m_Entries[m_Index].m_Key; }
+        const T&    GetValue()  { return m_Table.m_Entries[m_Index].m_Value; }
+
+        Iterator(dmFlatHashTable<KEY, T>& table)
+            : m_Table(table)
+            , m_Index(0xFFFFFFFF)
+        {
+        }
+
+        bool Next()
+        {
+            while (++m_Index < m_Table.m_TableSize)
+            {
+                if (m_Table.m_Ctrl[m_Index] >= 0)
+                    return true;
+            }
+            m_Index = m_Table.m_TableSize;
+            return false;
+        }
+
+        // private
+        dmFlatHashTable<KEY, T>&    m_Table;
+        uint32_t                    m_Index;
+    };
+
+    /*#
+     * Get an iterator for the key/value pairs
+     * @name GetIterator
+     * @return iterator [type: dmFlatHashTable<T>::Iterator] the iterator
+     * @examples
+     * ```cpp
+     * dmFlatHashTable<dmhash_t, int>::Iterator iter = ht.GetIterator();
+     * while(iter.Next())
+     * {
+     *     printf("%s: %d\n", dmHashReverseSafe64(iter.GetKey()), iter.GetValue());
+     * }
+     * ```
+     */
+    Iterator GetIterator()
+    {
+        return Iterator(*this);
+    }
+
+    /**
+     * Verify internal structure. "assert" if invalid. For unit testing
+     */
+    void Verify()
+    {
+        uint32_t count = 0;
+        uint32_t deleted = 0;
+        for (uint32_t i = 0; i < m_TableSize; ++i)
+        {
+            if (m_Ctrl[i] == CTRL_DELETED)
+            {
+                ++deleted;
+            }
+            else if (m_Ctrl[i] >= 0)
+            {
+                ++count;
+                assert(Find(m_Entries[i].m_Key, Hash(m_Entries[i].m_Key)) == &m_Entries[i]);
+            }
+            else
+            {
+                assert(m_Ctrl[i] == CTRL_EMPTY);
+            }
+        }
+        assert(count == m_Count);
+        assert(deleted == m_Deleted);
+    }
+
+private:
+    // Only allow for POD types
+    dmFlatHashTable(const dmFlatHashTable<KEY, T>&);
+    const dmFlatHashTable<KEY, T>& operator=(const dmFlatHashTable<KEY, T>&);
+
+    // Max load factor 7/8
+    static uint32_t MaxLoad(uint32_t table_size)
+    {
+        return table_size - table_size / 8;
+    }
+
+    static uint64_t Hash(KEY key)
+    {
+        // The keys are often hashes already, but small integer keys need their bits spread out
+        uint64_t h = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+    // Bit mask with one bit per matching control byte in a group
+    static uint32_t Match(const int8_t* group, int8_t value)
+    {
+#if defined(DM_FLAT_HASHTABLE_SSE2)
+        __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value)));
+#elif defined(DM_FLAT_HASHTABLE_NEON)
+        static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+        uint8x16_t eq = vceqq_s8(vld1q_s8(group), vdupq_n_s8(value));
+        uint8x16_t masked = vandq_u8(eq, vld1q_u8(bits));
+        uint8x8_t sum = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
+        sum = vpadd_u8(sum, sum);
+        sum = vpadd_u8(sum, sum);
+        return (uint32_t)vget_lane_u8(sum, 0) | ((uint32_t)vget_lane_u8(sum, 1) << 8);
+#else
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            mask |= (uint32_t)(group[i] == value) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static uint32_t MatchEmpty(const int8_t* group)
+    {
+        return Match(group, CTRL_EMPTY);
+    }
+
+    // Bit mask with one bit per empty or deleted control byte in a group
+    static uint32_t MatchFree(const int8_t* group)
+    {
+#if defined(DM_FLAT_HASHTABLE_SSE2)
+        // Empty and deleted are the only negative values
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+        return Match(group, CTRL_EMPTY) | Match(group, CTRL_DELETED);
+#endif
+    }
+
+    static uint32_t LowestBit(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (uint32_t)index;
+#else
+        return (uint32_t)__builtin_ctz(mask);
+#endif
+    }
+
+    // The groups are probed in triangular order, which visits all groups when their count is a power of two
+    Entry* Find(KEY key, uint64_t hash) const
+    {
+        if (m_TableSize == 0)
+            return 0;
+
+        int8_t h2 = (int8_t)(hash & 0x7f);
+        uint32_t group_mask = m_TableSize / GROUP_SIZE - 1;
+        uint32_t group = (uint32_t)(hash >> 7) & group_mask;
+        for (uint32_t step = 1; ; ++step)
+        {
+            const int8_t* ctrl = m_Ctrl + group * GROUP_SIZE;
+            uint32_t match = Match(ctrl, h2);
+            while (match)
+            {
+                Entry* e = &m_Entries[group * GROUP_SIZE + LowestBit(match)];
+                if (e->m_Key == key)
+                    return e;
+                match &= match - 1;
+            }
+            if (MatchEmpty(ctrl))
+                return 0;
+            if (step > group_mask)
+                return 0;
+            group = (group + step) & group_mask;
+        }
+    }
+
+    uint32_t FindInsertIndex(uint64_t hash) const
+    {
+        uint32_t group_mask = m_TableSize / GROUP_SIZE - 1;
+        uint32_t group = (uint32_t)(hash >> 7) & group_mask;
+        for (uint32_t step = 1; ; ++step)
+        {
+            uint32_t free = MatchFree(m_Ctrl + group * GROUP_SIZE);
+            if (free)
+                return group * GROUP_SIZE + LowestBit(free);
+            group = (group + step) & group_mask;
+        }
+    }
+
+    void Rehash(uint32_t table_size)
+    {
+        int8_t* old_ctrl = m_Ctrl;
+        Entry* old_entries = m_Entries;
+        uint32_t old_table_size = m_TableSize;
+
+        // One allocation, the control bytes followed by the entries
+        uint32_t ctrl_size = (table_size + 15) & ~15u;
+        int8_t* ctrl = (int8_t*) malloc(ctrl_size + table_size * sizeof(Entry));
+        assert(ctrl != 0 && "Rehash could not allocate memory");
+        m_Ctrl = ctrl;
+        m_Entries = (Entry*) (m_Ctrl + ctrl_size);
+        m_TableSize = table_size;
+        memset(m_Ctrl, CTRL_EMPTY, table_size);
+        m_Deleted = 0;
+
+        for (uint32_t i = 0; i < old_table_size; ++i)
+        {
+            if (old_ctrl[i] >= 0)
+            {
+                uint64_t hash = Hash(old_entries[i].m_Key);
+                uint32_t index = FindInsertIndex(hash);
+                m_Ctrl[index] = (int8_t)(hash & 0x7f);
+                m_Entries[index] = old_entries[i];
+            }
+        }
+        free(old_ctrl);
+    }
+
+    int8_t*     m_Ctrl;
+    Entry*      m_Entries;
+    uint32_t    m_TableSize;    // Number of entries, a power of two and a multiple of GROUP_SIZE
+    uint32_t    m_Count;
+    uint32_t    m_Deleted;
+};
+
+/*#
+ * Specialized flat hash table with [type:uint32_t] as keys
+ * @type class
+ * @name dmFlatHashTable32
+ */
+template <typename T>
+class dmFlatHashTable32 : public dmFlatHashTable<uint32_t, T> {};
+
+/*#
+ * Specialized flat hash table with [type:uint64_t] as keys
+ * @type class
+ * @name dmFlatHashTable64
+ */
+template <typename T>
+class dmFlatHashTable64 : public dmFlatHashTable<uint64_t, T> {};
+
+#endif // DMSDK_FLAT_HASHTABLE_H
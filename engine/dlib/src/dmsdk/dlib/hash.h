@@ -92,6 +92,30 @@ DM_DLLEXPORT uint32_t dmHashString32(const char* string);
  */
 DM_DLLEXPORT uint64_t dmHashString64(const char* string);
 
+/*# calculate 64-bit hash values for several buffers
+ *
+ * Produces the same values as calling [ref:dmHashBuffer64] for each buffer, but hashes
+ * several buffers at a time, which is faster when hashing many short buffers such as paths or ids.
+ *
+ * @name dmHashBuffers64
+ * @param buffers [type:const void**] Buffers
+ * @param buffer_lens [type:const uint32_t*] Length of each buffer
+ * @param count [type:uint32_t] Number of buffers
+ * @param out_hashes [type:uint64_t*] Array of count hash values
+ */
+DM_DLLEXPORT void dmHashBuffers64(const void** buffers, const uint32_t* buffer_lens, uint32_t count, uint64_t* out_hashes);
+
+/*# calculate 64-bit hash values for several strings
+ *
+ * Produces the same values as calling [ref:dmHashString64] for each string.
+ *
+ * @name dmHashStrings64
+ * @param strings [type:const char**] Null terminated strings
+ * @param count [type:uint32_t] Number of strings
+ * @param out_hashes [type:uint64_t*] Array of count hash values
+ */
+DM_DLLEXPORT void dmHashStrings64(const char** strings, uint32_t count, uint64_t* out_hashes);
+
 
 /*# get string value from hash
  *
@@ -279,6 +303,61 @@ DM_DLLEXPORT uint64_t dmHashFinal64(HashState64* hash_state);
  */
 DM_DLLEXPORT void dmHashRelease64(HashState64* hash_state);
 
+namespace dmHashConstInternal
+{
+    // Compile time version of dmHashBufferNoReverse64 (MurmurHash2A, 64-bit), written as
+    // single expression functions to be valid C++11 constexpr functions.
+    static const uint64_t M = 0xc6a4a7935bd1e995ULL;
+    static const int R = 47;
+
+    constexpr uint64_t MixK(uint64_t k)
+    {
+        return (k ^ (k >> R)) * M;
+    }
+
+    constexpr uint64_t Mix(uint64_t h, uint64_t k)
+    {
+        return (h * M) ^ MixK(k * M);
+    }
+
+    constexpr uint64_t Read(const char* s, uint32_t i, uint32_t n)
+    {
+        return n == 0 ? 0 : (uint64_t((unsigned char)s[i + n - 1]) << (8 * (n - 1))) | Read(s, i, n - 1);
+    }
+
+    constexpr uint64_t Final(uint64_t h)
+    {
+        return ((h ^ (h >> R)) * M) ^ (((h ^ (h >> R)) * M) >> R);
+    }
+
+    constexpr uint64_t Hash(const char* s, uint32_t len, uint32_t i, uint64_t h)
+    {
+        return len - i >= 8 ? Hash(s, len, i + 8, Mix(h, Read(s, i, 8)))
+                            : Final(Mix(Mix(h, Read(s, i, len - i)), len));
+    }
+}
+
+/*# calculate 64-bit hash value from a string literal at compile time
+ *
+ * Produces the same value as [ref:dmHashString64], but can be evaluated by the compiler,
+ * which avoids hashing constant ids at startup.
+ * The string is not stored for reverse hashing.
+ *
+ * @name dmHashConstString64
+ * @param string [type:const char*] String literal
+ * @return hash [type:uint64_t] hash value
+ * @examples
+ *
+ * ```cpp
+ * static const dmhash_t PROP_POSITION = dmHashConstString64("position");
+ * ```
+ */
+template <uint32_t N>
+constexpr uint64_t dmHashConstString64(const char (&string)[N])
+{
+    return dmHashConstInternal::Hash(string, N - 1, 0, 0);
+}
+
 #endif // __cplusplus
 
 #endif // DMSDK_HASH_H
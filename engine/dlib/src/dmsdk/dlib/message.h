@@ -209,6 +209,7 @@ namespace dmMessage
      * @member m_UserData2 [type: uintptr_t] User data pointer
      * @member m_Descriptor [type: uintptr_t] User specified descriptor of the message data
      * @member m_DataSize [type: uint32_t] Size of message data in bytes
+     * @member m_External [type: uint32_t] Set if the message data is referenced rather than copied. See #dmMessage::IsExternal
      * @member m_Next [type: dmMessage::Message*] Ptr to next message (or 0 if last)
      * @member m_DestroyCallback [type: dmMessage::MessageDestroyCallback] If set, will be called after each dispatch
      * @member m_Data [type: uint8_t*] Payload
@@ -222,6 +223,7 @@ namespace dmMessage
         uintptr_t              m_UserData2;         //! User data pointer
         uintptr_t              m_Descriptor;        //! User specified descriptor of the message data
         uint32_t               m_DataSize;          //! Size of message data in bytes
+        uint32_t               m_External : 1;      //! Set if the message data is referenced rather than copied
         struct Message*        m_Next;              //! Ptr to next message (or 0 if last)
         MessageDestroyCallback m_DestroyCallback;   //! If set, will be called after each dispatch
         uint8_t DM_ALIGNED(16) m_Data[0];           //! Payload
@@ -245,6 +247,46 @@ namespace dmMessage
     Result Post(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
                 uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback);
 
+    /*#
+     * Post a message to a socket without copying the message data
+     * The message references the data until it has been dispatched (or the socket is deleted), at which
+     * point the destroy callback is invoked. The caller is responsible for keeping the data alive until then,
+     * and typically releases it from the destroy callback.
+     * Unlike #dmMessage::Post, the data size isn't limited by the message page size.
+     * @note Use #dmMessage::GetData to access the payload of a received message. The m_Data member of the
+     *       posted message holds a pointer to the data, and #dmMessage::IsExternal returns true for the message
+     * @name PostExternal
+     * @param sender [type: dmMessage::URL*] The sender URL if the receiver wants to respond. 0x0 is accepted
+     * @param receiver [type: dmMessage::URL*] The receiver URL, must not be 0x0
+     * @param message_id [type: dmhash_t] Message id
+     * @param user_data1 [type: uintptr_t] User data that can be used when both the sender and receiver are known
+     * @param user_data2 [type: uintptr_t] User data that can be used when both the sender and receiver are known.
+     * @param descriptor [type: uintptr_t] User specified descriptor of the message data
+     * @param message_data [type: void*] Message data reference. Must be DM_ALIGNED(16)
+     * @param message_data_size [type: uint32_t] Message data size in bytes
+     * @param destroy_callback [type: dmMessage::MessageDestroyCallback] if set, will be called after each message dispatch
+     * @return RESULT_OK if the message was posted
+     */
+    Result PostExternal(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data1, uintptr_t user_data2,
+                        uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback);
+
+    /*#
+     * Get the payload of a message, regardless of whether it was posted by value or by reference
+     * @name GetData
+     * @param message [type: dmMessage::Message*] The message
+     * @return data [type: const void*] The message payload
+     */
+    const void* GetData(const Message* message);
+
+    /*#
+     * Check if the message data is referenced by the message, as posted by #dmMessage::PostExternal.
+     * Messages posted with #dmMessage::Post always hold a copy of the data in m_Data.
+     * @name IsExternal
+     * @param message [type: dmMessage::Message*] The message
+     * @return external [type: bool] true if the message data is referenced rather than copied
+     */
+    bool IsExternal(const Message* message);
+
     /** post a ddf message to a socket
      * Post a DDF message to a socket. A helper wrapper for Post()'ing a DDF message
      * @note Message data is copied by value
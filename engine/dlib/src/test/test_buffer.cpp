@@ -764,6 +764,141 @@ const AlignmentTestParams valid_stream_setups[] = {
 
 INSTANTIATE_TEST_CASE_P(AlignmentSequence, AlignmentTest, jc_test_values_in(valid_stream_setups));
 
+TEST_F(BufferTest, TransformStream)
+{
+    // Interleaved with another stream, and tightly packed
+    const dmBuffer::StreamDeclaration interleaved_decl[] = {
+        {dmHashString64("position"), dmBuffer::VALUE_TYPE_FLOAT32, 3},
+        {dmHashString64("color"), dmBuffer::VALUE_TYPE_FLOAT32, 4},
+        {dmHashString64("index"), dmBuffer::VALUE_TYPE_UINT16, 1},
+    };
+    const dmBuffer::StreamDeclaration packed_decl[] = {
+        {dmHashString64("position"), dmBuffer::VALUE_TYPE_FLOAT32, 3},
+    };
+    const dmBuffer::StreamDeclaration* decls[] = {interleaved_decl, packed_decl};
+    const uint8_t decl_counts[] = {3, 1};
+
+    dmVMath::Matrix4 transform = dmVMath::Matrix4::rotationZ(0.5f) * dmVMath::Matrix4::scale(dmVMath::Vector3(2.0f, 3.0f, 4.0f));
+    transform.setTranslation(dmVMath::Vector3(1.0f, -2.0f, 3.0f));
+
+    const uint32_t count = 17;
+    for (uint32_t d = 0; d < 2; ++d)
+    {
+        dmBuffer::HBuffer buffer = 0;
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::Create(count, decls[d], decl_counts[d], &buffer));
+
+        float* positions;
+        uint32_t stride;
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(buffer, dmHashString64("position"), (void**)&positions, 0, 0, &stride));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            positions[i*stride + 0] = (float)i;
+            positions[i*stride + 1] = (float)i * 0.5f;
+            positions[i*stride + 2] = -(float)i;
+        }
+
+        // Leave the first and last element unchanged
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::TransformStream(buffer, dmHashString64("position"), 1, count - 2, transform));
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(buffer));
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmVMath::Point3 p((float)i, (float)i * 0.5f, -(float)i);
+            if (i > 0 && i < count - 1)
+            {
+                dmVMath::Vector4 expected = transform * p;
+                p = dmVMath::Point3(expected.getX(), expected.getY(), expected.getZ());
+            }
+            ASSERT_NEAR(p.getX(), positions[i*stride + 0], RIG_EPSILON);
+            ASSERT_NEAR(p.getY(), positions[i*stride + 1], RIG_EPSILON);
+            ASSERT_NEAR(p.getZ(), positions[i*stride + 2], RIG_EPSILON);
+        }
+
+        if (d == 0)
+        {
+            float* colors;
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(buffer, dmHashString64("color"), (void**)&colors, 0, 0, &stride));
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    colors[i*stride + c] = (float)(i + c);
+                }
+            }
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::TransformStream(buffer, dmHashString64("color"), 0, count, transform));
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                dmVMath::Vector4 expected = transform * dmVMath::Vector4((float)i, (float)(i + 1), (float)(i + 2), (float)(i + 3));
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    ASSERT_NEAR(expected.getElem(c), colors[i*stride + c], RIG_EPSILON);
+                }
+            }
+
+            ASSERT_EQ(dmBuffer::RESULT_STREAM_TYPE_MISMATCH, dmBuffer::TransformStream(buffer, dmHashString64("index"), 0, count, transform));
+        }
+
+        ASSERT_EQ(dmBuffer::RESULT_BUFFER_SIZE_ERROR, dmBuffer::TransformStream(buffer, dmHashString64("position"), 1, count, transform));
+        ASSERT_EQ(dmBuffer::RESULT_STREAM_MISSING, dmBuffer::TransformStream(buffer, dmHashString64("missing"), 0, count, transform));
+        ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(buffer));
+        dmBuffer::Destroy(buffer);
+    }
+}
+
+TEST_F(BufferTest, ScaleBiasStream)
+{
+    const float scale[] = {2.0f, -1.0f, 0.5f, 4.0f};
+    const float bias[] = {1.0f, 2.0f, 3.0f, 4.0f};
+
+    // Every component count up to 4, both interleaved and tightly packed
+    for (uint8_t components = 1; components <= 4; ++components)
+    {
+        for (uint32_t interleaved = 0; interleaved < 2; ++interleaved)
+        {
+            const dmBuffer::StreamDeclaration streams_decl[] = {
+                {dmHashString64("data"), dmBuffer::VALUE_TYPE_FLOAT32, components},
+                {dmHashString64("other"), dmBuffer::VALUE_TYPE_UINT8, 1},
+            };
+            const uint32_t count = 23;
+            dmBuffer::HBuffer buffer = 0;
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::Create(count, streams_decl, interleaved ? 2 : 1, &buffer));
+
+            float* data;
+            uint32_t stride;
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::GetStream(buffer, dmHashString64("data"), (void**)&data, 0, 0, &stride));
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    data[i*stride + c] = (float)(i * components + c);
+                }
+            }
+
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ScaleBiasStream(buffer, dmHashString64("data"), 2, count - 3, scale, bias));
+            ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(buffer));
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    float expected = (float)(i * components + c);
+                    if (i >= 2 && i < count - 1)
+                    {
+                        expected = expected * scale[c] + bias[c];
+                    }
+                    ASSERT_EQ(expected, data[i*stride + c]);
+                }
+            }
+
+            if (interleaved)
+            {
+                ASSERT_EQ(dmBuffer::RESULT_STREAM_TYPE_MISMATCH, dmBuffer::ScaleBiasStream(buffer, dmHashString64("other"), 0, count, scale, bias));
+            }
+            dmBuffer::Destroy(buffer);
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
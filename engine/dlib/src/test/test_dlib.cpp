@@ -55,6 +55,67 @@ TEST_F(dlib, Hash)
     ASSERT_EQ(0x97b476b3e71147f7LL, h2_i);
 }
 
+TEST_F(dlib, HashConst)
+{
+    static const uint64_t h = dmHashConstString64("foo");
+    ASSERT_EQ(0x97b476b3e71147f7LL, h);
+    ASSERT_EQ(dmHashString64(""), dmHashConstString64(""));
+    ASSERT_EQ(dmHashString64("position"), dmHashConstString64("position"));
+    ASSERT_EQ(dmHashString64("/main/main.collectionc"), dmHashConstString64("/main/main.collectionc"));
+
+    // Non-ascii characters
+    ASSERT_EQ(dmHashString64("\xe5\xe4\xf6\xff"), dmHashConstString64("\xe5\xe4\xf6\xff"));
+
+    // Must be a compile time constant
+    char buffer[dmHashConstString64("foo") == 0x97b476b3e71147f7LL ? 1 : -1];
+    (void) buffer;
+}
+
+TEST_F(dlib, HashBuffers)
+{
+    const uint32_t count = 1000;
+    std::string strings[count];
+    const char* string_ptrs[count];
+    const void* buffers[count];
+    uint32_t lens[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t n = rand() % 80;
+        for (uint32_t j = 0; j < n; ++j)
+        {
+            strings[i] += (char)((rand() % ('z' - '0')) + '0');
+        }
+        string_ptrs[i] = strings[i].c_str();
+        buffers[i] = strings[i].c_str();
+        lens[i] = strings[i].size();
+    }
+
+    // All counts up to a few multiples of the internal batch sizes
+    for (uint32_t n = 0; n < 140; ++n)
+    {
+        uint64_t hashes[140];
+        dmHashBuffers64(buffers, lens, n, hashes);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            ASSERT_EQ(dmHashBufferNoReverse64(buffers[i], lens[i]), hashes[i]);
+        }
+    }
+
+    uint64_t hashes[count];
+    dmHashStrings64(string_ptrs, count, hashes);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(dmHashString64(string_ptrs[i]), hashes[i]);
+        ASSERT_STREQ(string_ptrs[i], dmHashReverseSafe64(hashes[i]));
+    }
+
+    dmHashBuffersNoReverse64(buffers, lens, count, hashes);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(dmHashBufferNoReverse64(buffers[i], lens[i]), hashes[i]);
+    }
+}
+
 TEST_F(dlib, HashIncremental32)
 {
     for (uint32_t i = 0; i < 1000; ++i)
@@ -0,0 +1,370 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+
+#include "dlib/flat_hashtable.h"
+#include "dlib/hashtable.h"
+#include "dlib/hash.h"
+#include "dlib/log.h"
+#include "dlib/time.h"
+
+static bool g_RunBenchmarks = false;
+
+TEST(dmFlatHashTable, EmptyConstructor)
+{
+    dmFlatHashTable32<int> ht;
+
+    EXPECT_EQ(0U, ht.Size());
+    EXPECT_EQ(0U, ht.Capacity());
+    EXPECT_TRUE(ht.Empty());
+    EXPECT_EQ(0, ht.Get(1));
+}
+
+TEST(dmFlatHashTable, SimplePut)
+{
+    dmFlatHashTable<uint32_t, uint32_t> ht;
+    ht.Put(12, 23);
+
+    uint32_t* val = ht.Get(12);
+    ASSERT_NE((uintptr_t) 0, (uintptr_t) val);
+    EXPECT_EQ(23U, *val);
+    EXPECT_EQ(1U, ht.Size());
+    EXPECT_EQ(0, ht.Get(13));
+
+    // Replace the value of an existing key
+    ht.Put(12, 24);
+    EXPECT_EQ(24U, *ht.Get(12));
+    EXPECT_EQ(1U, ht.Size());
+    ht.Verify();
+}
+
+TEST(dmFlatHashTable, SimpleErase)
+{
+    dmFlatHashTable<uint32_t, uint32_t> ht;
+    ht.Put(1, 10);
+    ht.Put(2, 20);
+
+    ht.Verify();
+    ht.Erase(1);
+    ht.Verify();
+
+    EXPECT_EQ(0, ht.Get(1));
+    ASSERT_NE((uintptr_t) 0, (uintptr_t) ht.Get(2));
+    EXPECT_EQ(20U, *ht.Get(2));
+    EXPECT_EQ(1U, ht.Size());
+
+    ht.Erase(2);
+    ht.Verify();
+    EXPECT_TRUE(ht.Empty());
+}
+
+TEST(dmFlatHashTable, SetCapacity)
+{
+    dmFlatHashTable64<int> ht;
+    ht.SetCapacity(100);
+    uint32_t capacity = ht.Capacity();
+    EXPECT_GE(capacity, 100U);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ht.Put(dmHashBuffer64(&i, sizeof(i)), i);
+    }
+    // No growth within the requested capacity
+    EXPECT_EQ(capacity, ht.Capacity());
+
+    // Capacity is never decreased
+    ht.SetCapacity(10);
+    EXPECT_EQ(capacity, ht.Capacity());
+    ht.Verify();
+}
+
+TEST(dmFlatHashTable, Grow)
+{
+    dmFlatHashTable32<uint32_t> ht;
+    const uint32_t count = 10000;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ht.Put(i, i * 3);
+        ASSERT_LE(ht.Size(), ht.Capacity());
+    }
+    ht.Verify();
+    EXPECT_EQ(count, ht.Size());
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t* val = ht.Get(i);
+        ASSERT_NE((uintptr_t) 0, (uintptr_t) val);
+        EXPECT_EQ(i * 3, *val);
+    }
+    EXPECT_EQ(0, ht.Get(count));
+}
+
+TEST(dmFlatHashTable, ReuseDeleted)
+{
+    // Put/Erase cycles at a fixed size should not make the table grow
+    dmFlatHashTable32<uint32_t> ht;
+    ht.SetCapacity(64);
+    uint32_t capacity = ht.Capacity();
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        ht.Put(i, i);
+    }
+    for (uint32_t i = 64; i < 100000; ++i)
+    {
+        ht.Erase(i - 64);
+        ht.Put(i, i);
+    }
+    ht.Verify();
+    EXPECT_EQ(64U, ht.Size());
+    EXPECT_EQ(capacity, ht.Capacity());
+}
+
+TEST(dmFlatHashTable, Clear)
+{
+    dmFlatHashTable32<uint32_t> ht;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        ht.Put(i, i);
+    }
+    ht.Clear();
+    ht.Verify();
+    EXPECT_TRUE(ht.Empty());
+    EXPECT_EQ(0, ht.Get(10));
+    ht.Put(10, 11);
+    EXPECT_EQ(11U, *ht.Get(10));
+}
+
+TEST(dmFlatHashTable, Swap)
+{
+    dmFlatHashTable32<uint32_t> a;
+    dmFlatHashTable32<uint32_t> b;
+    a.Put(1, 10);
+    b.Put(2, 20);
+    b.Put(3, 30);
+    a.Swap(b);
+    EXPECT_EQ(2U, a.Size());
+    EXPECT_EQ(1U, b.Size());
+    EXPECT_EQ(20U, *a.Get(2));
+    EXPECT_EQ(10U, *b.Get(1));
+    EXPECT_EQ(0, a.Get(1));
+}
+
+static void IterateCallback(std::map<uint32_t, uint32_t>* context, const uint32_t* key, uint32_t* value)
+{
+    (*context)[*key] = *value;
+}
+
+TEST(dmFlatHashTable, Iterate)
+{
+    dmFlatHashTable32<uint32_t> ht;
+    std::map<uint32_t, uint32_t> expected;
+    for (uint32_t i = 0; i < 1000; i += 3)
+    {
+        ht.Put(i, i + 1);
+        expected[i] = i + 1;
+    }
+
+    std::map<uint32_t, uint32_t> iterated;
+    ht.Iterate(IterateCallback, &iterated);
+    EXPECT_TRUE(expected == iterated);
+
+    iterated.clear();
+    dmFlatHashTable32<uint32_t>::Iterator iter = ht.GetIterator();
+    while (iter.Next())
+    {
+        iterated[iter.GetKey()] = iter.GetValue();
+    }
+    EXPECT_TRUE(expected == iterated);
+
+    dmFlatHashTable32<uint32_t> empty;
+    dmFlatHashTable32<uint32_t>::Iterator empty_iter = empty.GetIterator();
+    EXPECT_FALSE(empty_iter.Next());
+}
+
+TEST(dmFlatHashTable, Exhaustive)
+{
+    srand(0);
+    dmFlatHashTable64<uint32_t> ht;
+    std::map<uint64_t, uint32_t> map;
+    std::vector<uint64_t> keys;
+
+    for (uint32_t i = 0; i < 200000; ++i)
+    {
+        int op = rand() % 3;
+        if (op < 2 || keys.empty())
+        {
+            // Few distinct keys to get both hits and misses
+            uint64_t key = rand() % 5000;
+            if (map.find(key) == map.end())
+            {
+                ht.Put(key, i);
+                map[key] = i;
+                keys.push_back(key);
+            }
+            else
+            {
+                ASSERT_EQ(map[key], *ht.Get(key));
+            }
+        }
+        else
+        {
+            uint32_t index = rand() % keys.size();
+            uint64_t key = keys[index];
+            keys[index] = keys.back();
+            keys.pop_back();
+            ht.Erase(key);
+            map.erase(key);
+            ASSERT_EQ(0, ht.Get(key));
+        }
+        ASSERT_EQ(map.size(), ht.Size());
+    }
+    ht.Verify();
+
+    for (std::map<uint64_t, uint32_t>::iterator it = map.begin(); it != map.end(); ++it)
+    {
+        uint32_t* val = ht.Get(it->first);
+        ASSERT_NE((uintptr_t) 0, (uintptr_t) val);
+        ASSERT_EQ(it->second, *val);
+    }
+}
+
+// Benchmark against dmHashTable, logging the timings. The dmHashTable is given the
+// same number of buckets as the flat table has entries, to get comparable load factors.
+
+template <typename TABLE>
+static void SetupTable(TABLE& ht, uint32_t table_size, uint32_t count);
+
+template <>
+void SetupTable(dmHashTable64<uint32_t>& ht, uint32_t table_size, uint32_t count)
+{
+    ht.SetCapacity(table_size, count);
+}
+
+template <>
+void SetupTable(dmFlatHashTable64<uint32_t>& ht, uint32_t table_size, uint32_t count)
+{
+    // Reserve the full table, so that the load factor is count / table_size
+    ht.SetCapacity(table_size - table_size / 8);
+}
+
+template <typename TABLE>
+static void Benchmark(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& misses, uint32_t table_size, uint32_t count)
+{
+    const uint32_t iterations = 20;
+    uint64_t insert_time = 0;
+    uint64_t hit_time = 0;
+    uint64_t miss_time = 0;
+    uint64_t erase_time = 0;
+    uint32_t found = 0;
+
+    for (uint32_t iter = 0; iter < iterations; ++iter)
+    {
+        TABLE ht;
+        SetupTable(ht, table_size, count);
+
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ht.Put(keys[i], i);
+        }
+        uint64_t end = dmTime::GetTime();
+        insert_time += end - start;
+
+        start = end;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            found += ht.Get(keys[i]) != 0;
+        }
+        end = dmTime::GetTime();
+        hit_time += end - start;
+
+        start = end;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            found += ht.Get(misses[i]) != 0;
+        }
+        end = dmTime::GetTime();
+        miss_time += end - start;
+
+        start = end;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ht.Erase(keys[i]);
+        }
+        end = dmTime::GetTime();
+        erase_time += end - start;
+    }
+
+    ASSERT_EQ(count * iterations, found);
+    double scale = 1000.0 / (double)(count * iterations); // ns per operation
+    dmLogInfo("  %-16s insert: %6.1f  get (hit): %6.1f  get (miss): %6.1f  erase: %6.1f ns/op", name,
+            insert_time * scale, hit_time * scale, miss_time * scale, erase_time * scale);
+}
+
+// The benchmark is only run when the test is started with --benchmark
+TEST(dmFlatHashTable, Benchmark)
+{
+    if (!g_RunBenchmarks)
+    {
+        SKIP();
+    }
+
+    const uint32_t table_size = 1 << 16;
+    const uint32_t load_factors[] = {25, 50, 75, 87};
+
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> misses;
+    for (uint32_t i = 0; i < table_size; ++i)
+    {
+        uint32_t key = i;
+        keys.push_back(dmHashBuffer64(&key, sizeof(key)));
+        key = i + table_size;
+        misses.push_back(dmHashBuffer64(&key, sizeof(key)));
+    }
+
+    for (uint32_t i = 0; i < sizeof(load_factors) / sizeof(load_factors[0]); ++i)
+    {
+        uint32_t count = table_size * load_factors[i] / 100;
+        dmLogInfo("%u entries, load factor %u%%", count, load_factors[i]);
+        Benchmark<dmHashTable64<uint32_t> >("dmHashTable", keys, misses, table_size, count);
+        Benchmark<dmFlatHashTable64<uint32_t> >("dmFlatHashTable", keys, misses, table_size, count);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            g_RunBenchmarks = true;
+            // Remove the argument before the test framework parses the command line
+            for (int j = i; j < argc - 1; ++j)
+                argv[j] = argv[j + 1];
+            --argc;
+            break;
+        }
+    }
+
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -0,0 +1,193 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include "../dlib/frame_arena.h"
+#include "../dlib/thread.h"
+
+TEST(dmFrameArena, Alloc)
+{
+    dmFrameArena::HArena arena = dmFrameArena::New(1024);
+
+    uint8_t* a = (uint8_t*) dmFrameArena::Alloc(arena, 100);
+    uint8_t* b = (uint8_t*) dmFrameArena::Alloc(arena, 3, 1);
+    uint8_t* c = (uint8_t*) dmFrameArena::Alloc(arena, 64, 64);
+    ASSERT_EQ(0U, ((uintptr_t) a) % 16);
+    ASSERT_EQ(0U, ((uintptr_t) c) % 64);
+    ASSERT_LE(a + 100, b);
+    ASSERT_LE(b + 3, c);
+
+    memset(a, 1, 100);
+    memset(b, 2, 3);
+    memset(c, 3, 64);
+    ASSERT_EQ(1, a[99]);
+    ASSERT_EQ(2, b[0]);
+
+    dmFrameArena::Stats stats;
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_GE(stats.m_Used, 167U);
+    ASSERT_EQ(1U, stats.m_BlockCount);
+    ASSERT_EQ(1024U, stats.m_Capacity);
+
+    dmFrameArena::Reset(arena);
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_EQ(0U, stats.m_Used);
+    ASSERT_GE(stats.m_FrameUsed, 167U);
+    ASSERT_EQ(stats.m_FrameUsed, stats.m_HighWater);
+
+    // The memory is reused after a reset
+    ASSERT_EQ(a, dmFrameArena::Alloc(arena, 100));
+
+    dmFrameArena::Delete(arena);
+}
+
+TEST(dmFrameArena, Grow)
+{
+    dmFrameArena::HArena arena = dmFrameArena::New(256);
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        void* p = dmFrameArena::Alloc(arena, 200);
+        memset(p, i, 200);
+    }
+    // Larger than the block size
+    void* large = dmFrameArena::Alloc(arena, 1000);
+    memset(large, 0xff, 1000);
+
+    dmFrameArena::Stats stats;
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_EQ(11U, stats.m_BlockCount);
+    ASSERT_GE(stats.m_Used, 3000U);
+
+    // The blocks are merged into one that fits the whole frame
+    dmFrameArena::Reset(arena);
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_EQ(1U, stats.m_BlockCount);
+    ASSERT_GE(stats.m_HighWater, 3000U);
+    ASSERT_GE(stats.m_Capacity, stats.m_HighWater);
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        dmFrameArena::Alloc(arena, 200);
+    }
+    dmFrameArena::Alloc(arena, 1000);
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_EQ(1U, stats.m_BlockCount);
+
+    // The high water mark is kept for smaller frames
+    uint32_t high_water = stats.m_Used;
+    dmFrameArena::Reset(arena);
+    dmFrameArena::Alloc(arena, 16);
+    dmFrameArena::Reset(arena);
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_EQ(16U, stats.m_FrameUsed);
+    ASSERT_EQ(high_water, stats.m_HighWater);
+
+    dmFrameArena::Delete(arena);
+}
+
+TEST(dmFrameArena, Array)
+{
+    dmFrameArena::HArena arena = dmFrameArena::New(1024);
+
+    dmArray<uint32_t> array;
+    array.SetCapacity(4);
+    for (uint32_t i = 0; i < 4; ++i)
+        array.Push(i);
+
+    // The elements move from the heap to the arena
+    dmFrameArena::SetCapacity(arena, array, 8);
+    ASSERT_EQ(4U, array.Size());
+    ASSERT_EQ(8U, array.Capacity());
+    for (uint32_t i = 4; i < 8; ++i)
+        array.Push(i);
+
+    dmFrameArena::OffsetCapacity(arena, array, 8);
+    ASSERT_EQ(16U, array.Capacity());
+    for (uint32_t i = 8; i < 16; ++i)
+        array.Push(i);
+
+    for (uint32_t i = 0; i < 16; ++i)
+        ASSERT_EQ(i, array[i]);
+
+    dmFrameArena::Stats stats;
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_GE(stats.m_Used, 24 * sizeof(uint32_t));
+
+    dmFrameArena::Delete(arena);
+}
+
+struct ThreadContext
+{
+    dmFrameArena::HArena m_Arena;
+    uint8_t*             m_Allocations[1000];
+    uint8_t              m_Value;
+};
+
+static void AllocThread(void* arg)
+{
+    ThreadContext* ctx = (ThreadContext*) arg;
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        uint8_t* p = (uint8_t*) dmFrameArena::Alloc(ctx->m_Arena, 32);
+        memset(p, ctx->m_Value, 32);
+        ctx->m_Allocations[i] = p;
+    }
+}
+
+TEST(dmFrameArena, Threads)
+{
+    dmFrameArena::HArena arena = dmFrameArena::New(4096);
+
+    const uint32_t thread_count = 4;
+    ThreadContext contexts[thread_count];
+    dmThread::Thread threads[thread_count];
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        contexts[i].m_Arena = arena;
+        contexts[i].m_Value = (uint8_t) (i + 1);
+        threads[i] = dmThread::New(AllocThread, 0x80000, &contexts[i], "arena");
+    }
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        dmThread::Join(threads[i]);
+    }
+
+    // No allocation was overwritten by another thread
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        for (uint32_t j = 0; j < 1000; ++j)
+        {
+            uint8_t* p = contexts[i].m_Allocations[j];
+            ASSERT_EQ(contexts[i].m_Value, p[0]);
+            ASSERT_EQ(contexts[i].m_Value, p[31]);
+        }
+    }
+
+    dmFrameArena::Stats stats;
+    dmFrameArena::GetStats(arena, &stats);
+    ASSERT_GE(stats.m_Used, thread_count * 1000 * 32);
+
+    dmFrameArena::Delete(arena);
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
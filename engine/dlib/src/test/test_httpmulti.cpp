@@ -0,0 +1,465 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include "../dlib/atomic.h"
+#include "../dlib/time.h"
+#include "../dlib/socket.h"
+#include "../dlib/math.h"
+#include "../dlib/thread.h"
+#include "../dlib/dstrings.h"
+#include "../dlib/http_server.h"
+#include "../dlib/http_multi.h"
+#include "../dlib/hash.h"
+#include "../dlib/network_constants.h"
+
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+
+struct Response
+{
+    std::string         m_Content;
+    std::string         m_ContentType;
+    int                 m_Status;
+    dmHttpMulti::Result m_Result;
+    uint32_t            m_DoneCount;
+    bool                m_PauseOnContent;
+    bool                m_Paused;
+
+    Response()
+    {
+        m_Status = 0;
+        m_Result = dmHttpMulti::RESULT_OK;
+        m_DoneCount = 0;
+        m_PauseOnContent = false;
+        m_Paused = false;
+    }
+};
+
+class dmHttpMultiTest: public jc_test_base_class
+{
+public:
+    dmHttpServer::HServer   m_Server;
+    dmThread::Thread        m_ServerThread;
+    uint16_t                m_Port;
+    int32_atomic_t          m_Quit;
+    dmHttpMulti::HMulti     m_Multi;
+    std::map<dmHttpMulti::HRequest, Response> m_Responses;
+
+    static void ServerHttpResponse(void* user_data, const dmHttpServer::Request* request)
+    {
+        const char* resource = request->m_Resource;
+        if (strstr(resource, "/respond_with_n/"))
+        {
+            int n;
+            sscanf(resource, "/respond_with_n/%d", &n);
+
+            char buf[1024];
+            for (int i = 0; i < (int) sizeof(buf); ++i)
+            {
+                buf[i] = 'a' + (char) (i % ('z' - 'a'));
+            }
+            while (n > 0)
+            {
+                int n_to_send = dmMath::Min((int) sizeof(buf), n);
+                dmHttpServer::Send(request, buf, n_to_send);
+                n -= n_to_send;
+            }
+        }
+        else if (strstr(resource, "/add/"))
+        {
+            int a, b;
+            sscanf(resource, "/add/%d/%d", &a, &b);
+            char buf[16];
+            dmSnPrintf(buf, sizeof(buf), "%d", a + b);
+            dmHttpServer::SendAttribute(request, "Content-Type", "text/plain");
+            dmHttpServer::Send(request, buf, strlen(buf));
+        }
+        else if (strstr(resource, "/post"))
+        {
+            HashState64 hash_state;
+            dmHashInit64(&hash_state, false);
+            uint32_t total = 0;
+            while (total < request->m_ContentLength)
+            {
+                char recv_buf[1024];
+                uint32_t recv_bytes = 0;
+                uint32_t to_recv = dmMath::Min((uint32_t) sizeof(recv_buf), (uint32_t) (request->m_ContentLength - total));
+                if (dmHttpServer::Receive(request, recv_buf, to_recv, &recv_bytes) != dmHttpServer::RESULT_OK)
+                {
+                    dmHttpServer::SetStatusCode(request, 500);
+                    return;
+                }
+                dmHashUpdateBuffer64(&hash_state, recv_buf, recv_bytes);
+                total += recv_bytes;
+            }
+
+            char buf[32];
+            dmSnPrintf(buf, sizeof(buf), "%llu", (unsigned long long) dmHashFinal64(&hash_state));
+            dmHttpServer::Send(request, buf, strlen(buf));
+        }
+        else
+        {
+            dmHttpServer::SetStatusCode(request, 404);
+        }
+    }
+
+    static void ServerThread(void* user_data)
+    {
+        dmHttpMultiTest* self = (dmHttpMultiTest*) user_data;
+        while (!dmAtomicGet32(&self->m_Quit))
+        {
+            dmHttpServer::Update(self->m_Server);
+            dmTime::Sleep(1000);
+        }
+    }
+
+    static void HttpHeader(dmHttpMulti::HRequest request, void* user_data, int status_code, const char* key, const char* value)
+    {
+        dmHttpMultiTest* self = (dmHttpMultiTest*) user_data;
+        if (dmStrCaseCmp(key, "Content-Type") == 0)
+        {
+            self->m_Responses[request].m_ContentType = value;
+        }
+    }
+
+    static void HttpContent(dmHttpMulti::HRequest request, void* user_data, int status_code, const void* content_data, uint32_t content_data_size)
+    {
+        dmHttpMultiTest* self = (dmHttpMultiTest*) user_data;
+        Response& response = self->m_Responses[request];
+        if (content_data == 0 && content_data_size == 0)
+        {
+            response.m_Content.clear();
+            return;
+        }
+        response.m_Content.append((const char*) content_data, content_data_size);
+        if (response.m_PauseOnContent && !response.m_Paused)
+        {
+            dmHttpMulti::PauseRequest(self->m_Multi, request);
+            response.m_Paused = true;
+        }
+    }
+
+    static void HttpDone(dmHttpMulti::HRequest request, void* user_data, dmHttpMulti::Result result, int status_code)
+    {
+        dmHttpMultiTest* self = (dmHttpMultiTest*) user_data;
+        Response& response = self->m_Responses[request];
+        response.m_Result = result;
+        response.m_Status = status_code;
+        response.m_DoneCount++;
+    }
+
+    dmHttpMulti::HRequest Add(const char* method, const char* path, const void* body = 0, uint32_t body_size = 0)
+    {
+        char url[256];
+        dmSnPrintf(url, sizeof(url), "http://%s:%d%s", DM_LOOPBACK_ADDRESS_IPV4, m_Port, path);
+
+        dmHttpMulti::RequestParams params;
+        params.m_Method = method;
+        params.m_Url = url;
+        params.m_Body = body;
+        params.m_BodySize = body_size;
+        params.m_Timeout = 10 * 1000000;
+        params.m_HttpHeader = HttpHeader;
+        params.m_HttpContent = HttpContent;
+        params.m_HttpDone = HttpDone;
+        params.m_Userdata = this;
+
+        dmHttpMulti::HRequest request = 0;
+        dmHttpMulti::Result r = dmHttpMulti::AddRequest(m_Multi, &params, &request);
+        EXPECT_EQ(dmHttpMulti::RESULT_OK, r);
+        EXPECT_NE(0U, request);
+        m_Responses[request] = Response();
+        return request;
+    }
+
+    void UpdateAll()
+    {
+        uint64_t start = dmTime::GetTime();
+        while (dmHttpMulti::Update(m_Multi, 10 * 1000) > 0)
+        {
+            ASSERT_LT(dmTime::GetTime() - start, 20 * 1000000U);
+        }
+    }
+
+    void NewMulti(uint32_t max_active_requests, uint32_t dial_thread_count = 2)
+    {
+        if (m_Multi)
+            dmHttpMulti::Delete(m_Multi);
+        dmHttpMulti::NewParams params;
+        params.m_MaxActiveRequests = max_active_requests;
+        params.m_DialThreadCount = dial_thread_count;
+        ASSERT_EQ(dmHttpMulti::RESULT_OK, dmHttpMulti::New(&params, &m_Multi));
+    }
+
+    virtual void SetUp()
+    {
+        m_Quit = 0;
+        m_Multi = 0;
+        dmHttpServer::NewParams params;
+        params.m_ConnectionTimeout = 30;
+        params.m_Userdata = this;
+        params.m_HttpResponse = ServerHttpResponse;
+        ASSERT_EQ(dmHttpServer::RESULT_OK, dmHttpServer::New(&params, 0, &m_Server));
+        dmSocket::Address address;
+        dmHttpServer::GetName(m_Server, &address, &m_Port);
+        m_ServerThread = dmThread::New(&ServerThread, 0x8000, this, "server");
+        NewMulti(8);
+    }
+
+    virtual void TearDown()
+    {
+        dmHttpMulti::Delete(m_Multi);
+        dmAtomicStore32(&m_Quit, 1);
+        dmThread::Join(m_ServerThread);
+        dmHttpServer::Delete(m_Server);
+    }
+};
+
+TEST_F(dmHttpMultiTest, Get)
+{
+    dmHttpMulti::HRequest request = Add("GET", "/add/10/20");
+    UpdateAll();
+
+    Response& response = m_Responses[request];
+    ASSERT_EQ(1U, response.m_DoneCount);
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+    ASSERT_EQ(200, response.m_Status);
+    ASSERT_STREQ("30", response.m_Content.c_str());
+    ASSERT_STREQ("text/plain", response.m_ContentType.c_str());
+}
+
+TEST_F(dmHttpMultiTest, ConcurrentGet)
+{
+    const int count = 32;
+    dmHttpMulti::HRequest requests[count];
+    for (int i = 0; i < count; ++i)
+    {
+        char path[64];
+        dmSnPrintf(path, sizeof(path), "/respond_with_n/%d", i * 1013);
+        requests[i] = Add("GET", path);
+    }
+    ASSERT_EQ((uint32_t) count, dmHttpMulti::GetRequestCount(m_Multi));
+    UpdateAll();
+
+    for (int i = 0; i < count; ++i)
+    {
+        Response& response = m_Responses[requests[i]];
+        ASSERT_EQ(1U, response.m_DoneCount);
+        ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+        ASSERT_EQ(200, response.m_Status);
+        ASSERT_EQ(i * 1013, (int) response.m_Content.size());
+    }
+    ASSERT_EQ(0U, dmHttpMulti::GetRequestCount(m_Multi));
+}
+
+TEST_F(dmHttpMultiTest, Post)
+{
+    const uint32_t size = 256 * 1024 + 17;
+    char* body = (char*) malloc(size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        body[i] = (char) (rand() % 255);
+    }
+    dmHttpMulti::HRequest request = Add("POST", "/post", body, size);
+    UpdateAll();
+
+    char expected[32];
+    dmSnPrintf(expected, sizeof(expected), "%llu", (unsigned long long) dmHashBuffer64(body, size));
+    free(body);
+
+    Response& response = m_Responses[request];
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+    ASSERT_EQ(200, response.m_Status);
+    ASSERT_STREQ(expected, response.m_Content.c_str());
+}
+
+TEST_F(dmHttpMultiTest, NotFound)
+{
+    dmHttpMulti::HRequest request = Add("GET", "/does_not_exist");
+    UpdateAll();
+
+    Response& response = m_Responses[request];
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+    ASSERT_EQ(404, response.m_Status);
+}
+
+TEST_F(dmHttpMultiTest, KeepAlive)
+{
+    NewMulti(1);
+    const int count = 10;
+    for (int i = 0; i < count; ++i)
+    {
+        char path[64];
+        dmSnPrintf(path, sizeof(path), "/add/%d/%d", i, i);
+        Add("GET", path);
+    }
+    UpdateAll();
+
+    for (std::map<dmHttpMulti::HRequest, Response>::iterator it = m_Responses.begin(); it != m_Responses.end(); ++it)
+    {
+        ASSERT_EQ(dmHttpMulti::RESULT_OK, it->second.m_Result);
+    }
+
+    dmHttpMulti::Statistics stats;
+    dmHttpMulti::GetStatistics(m_Multi, &stats);
+    ASSERT_EQ((uint32_t) count, stats.m_Requests);
+    // All requests but the first on the same connection
+    ASSERT_EQ((uint32_t) count - 1, stats.m_ReusedConnections);
+}
+
+TEST_F(dmHttpMultiTest, PauseResume)
+{
+    const int size = 1024 * 1024;
+    char path[64];
+    dmSnPrintf(path, sizeof(path), "/respond_with_n/%d", size);
+    dmHttpMulti::HRequest request = Add("GET", path);
+    Response& response = m_Responses[request];
+    response.m_PauseOnContent = true;
+
+    uint64_t start = dmTime::GetTime();
+    while (!response.m_Paused)
+    {
+        dmHttpMulti::Update(m_Multi, 10 * 1000);
+        ASSERT_LT(dmTime::GetTime() - start, 10 * 1000000U);
+    }
+
+    // No content is delivered while paused
+    size_t paused_size = response.m_Content.size();
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(1U, dmHttpMulti::Update(m_Multi, 1000));
+    }
+    ASSERT_EQ(paused_size, response.m_Content.size());
+    ASSERT_EQ(0U, response.m_DoneCount);
+
+    dmHttpMulti::ResumeRequest(m_Multi, request);
+    UpdateAll();
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+    ASSERT_EQ(size, (int) response.m_Content.size());
+}
+
+TEST_F(dmHttpMultiTest, Cancel)
+{
+    dmHttpMulti::HRequest request = Add("GET", "/respond_with_n/1000000");
+    dmHttpMulti::Update(m_Multi, 0);
+    dmHttpMulti::CancelRequest(m_Multi, request);
+    UpdateAll();
+
+    Response& response = m_Responses[request];
+    ASSERT_EQ(1U, response.m_DoneCount);
+    ASSERT_EQ(dmHttpMulti::RESULT_CANCELED, response.m_Result);
+}
+
+TEST_F(dmHttpMultiTest, ConnectionRefused)
+{
+    dmHttpMulti::RequestParams params;
+    params.m_Url = "http://" DM_LOOPBACK_ADDRESS_IPV4 ":1/";
+    params.m_HttpDone = HttpDone;
+    params.m_Userdata = this;
+    dmHttpMulti::HRequest request;
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, dmHttpMulti::AddRequest(m_Multi, &params, &request));
+    UpdateAll();
+
+    Response& response = m_Responses[request];
+    ASSERT_EQ(1U, response.m_DoneCount);
+    ASSERT_EQ(dmHttpMulti::RESULT_SOCKET_ERROR, response.m_Result);
+}
+
+TEST_F(dmHttpMultiTest, DialOnUpdateThread)
+{
+    NewMulti(4, 0);
+    const uint32_t count = 8;
+    dmHttpMulti::HRequest requests[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        requests[i] = Add("GET", "/respond_with_n/1000");
+    }
+    UpdateAll();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Response& response = m_Responses[requests[i]];
+        ASSERT_EQ(1U, response.m_DoneCount);
+        ASSERT_EQ(dmHttpMulti::RESULT_OK, response.m_Result);
+        ASSERT_EQ(1000U, response.m_Content.size());
+    }
+}
+
+// A server that accepts the tcp connection but never answers the tls handshake
+// must not hold up the requests to other servers
+TEST_F(dmHttpMultiTest, SlowConnect)
+{
+    if (!dmThread::PlatformHasThreadSupport())
+        SKIP();
+
+    dmSocket::Socket server_socket;
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::New(dmSocket::DOMAIN_IPV4, dmSocket::TYPE_STREAM, dmSocket::PROTOCOL_TCP, &server_socket));
+    dmSocket::Address address;
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::GetHostByName(DM_LOOPBACK_ADDRESS_IPV4, &address, true, false));
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::Bind(server_socket, address, 0));
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::Listen(server_socket, 8));
+    uint16_t port;
+    ASSERT_EQ(dmSocket::RESULT_OK, dmSocket::GetName(server_socket, &address, &port));
+
+    char url[256];
+    dmSnPrintf(url, sizeof(url), "https://%s:%d/", DM_LOOPBACK_ADDRESS_IPV4, port);
+    dmHttpMulti::RequestParams params;
+    params.m_Url = url;
+    params.m_Timeout = 2 * 1000000;
+    params.m_HttpDone = HttpDone;
+    params.m_Userdata = this;
+    dmHttpMulti::HRequest slow;
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, dmHttpMulti::AddRequest(m_Multi, &params, &slow));
+    m_Responses[slow] = Response();
+
+    dmHttpMulti::HRequest fast = Add("GET", "/respond_with_n/1000");
+
+    uint64_t start = dmTime::GetTime();
+    while (m_Responses[fast].m_DoneCount == 0)
+    {
+        dmHttpMulti::Update(m_Multi, 10 * 1000);
+        ASSERT_LT(dmTime::GetTime() - start, 1000000U);
+    }
+    ASSERT_EQ(dmHttpMulti::RESULT_OK, m_Responses[fast].m_Result);
+    ASSERT_EQ(0U, m_Responses[slow].m_DoneCount);
+
+    dmHttpMulti::CancelRequest(m_Multi, slow);
+    UpdateAll();
+    ASSERT_EQ(1U, m_Responses[slow].m_DoneCount);
+    ASSERT_EQ(dmHttpMulti::RESULT_CANCELED, m_Responses[slow].m_Result);
+
+    dmSocket::Delete(server_socket);
+}
+
+TEST_F(dmHttpMultiTest, InvalidUrl)
+{
+    dmHttpMulti::RequestParams params;
+    params.m_Url = "not a url";
+    dmHttpMulti::HRequest request;
+    ASSERT_EQ(dmHttpMulti::RESULT_INVAL, dmHttpMulti::AddRequest(m_Multi, &params, &request));
+    ASSERT_EQ(0U, dmHttpMulti::GetRequestCount(m_Multi));
+}
+
+int main(int argc, char **argv)
+{
+    dmSocket::Initialize();
+    jc_test_init(&argc, argv);
+    int ret = jc_test_run_all();
+    dmSocket::Finalize();
+    return ret;
+}
@@ -14,6 +14,8 @@
 
 #include "dlib/job_thread.h"
 #include "dlib/array.h"
+#include "dlib/atomic.h"
+#include "dlib/thread.h"
 #include "dlib/time.h"
 
 #define JC_TEST_IMPLEMENTATION
@@ -82,6 +84,139 @@ TEST(dmJobThread, PushJobsMultipleThreads)
     ASSERT_TRUE(tests_done);
 }
 
+struct GroupTestContext
+{
+    int32_atomic_t      m_Running;
+    int32_atomic_t      m_Release;
+    dmThread::Thread    m_MainThread;
+    int32_atomic_t      m_WorkerJobs;
+};
+
+// Waits for (at most a second for) another job of the group to run at the same time
+static int ProcessConcurrentGroupJob(void* context, void* data)
+{
+    GroupTestContext* ctx = (GroupTestContext*) context;
+    if (dmThread::GetCurrentThread() != ctx->m_MainThread)
+        dmAtomicIncrement32(&ctx->m_WorkerJobs);
+    dmAtomicIncrement32(&ctx->m_Running);
+
+    uint64_t stop_time = dmTime::GetTime() + 1*1e6;
+    while (dmAtomicGet32(&ctx->m_Running) < 2 && dmTime::GetTime() < stop_time)
+        dmTime::Sleep(1000);
+    return 1 + (int)(uintptr_t)data;
+}
+
+TEST(dmJobThread, GroupRunsConcurrently)
+{
+    dmJobThread::JobThreadCreationParams job_thread_create_params;
+    job_thread_create_params.m_ThreadNames[0] = "DefoldTestJobThread1";
+    job_thread_create_params.m_ThreadNames[1] = "DefoldTestJobThread2";
+    job_thread_create_params.m_ThreadCount    = 2;
+
+    dmJobThread::HContext ctx = dmJobThread::Create(job_thread_create_params);
+
+    GroupTestContext test_ctx;
+    test_ctx.m_Running = 0;
+    test_ctx.m_Release = 0;
+    test_ctx.m_MainThread = dmThread::GetCurrentThread();
+    test_ctx.m_WorkerJobs = 0;
+
+    dmJobThread::Job jobs[4];
+    for (int i = 0; i < DM_ARRAY_SIZE(jobs); ++i)
+    {
+        jobs[i].m_Process = ProcessConcurrentGroupJob;
+        jobs[i].m_Context = &test_ctx;
+        jobs[i].m_Data = (void*)(uintptr_t)i;
+        jobs[i].m_Result = 0;
+    }
+
+    dmJobThread::HGroup group = dmJobThread::PushGroup(ctx, jobs, DM_ARRAY_SIZE(jobs));
+    dmJobThread::WaitGroup(ctx, group);
+
+    for (int i = 0; i < DM_ARRAY_SIZE(jobs); ++i)
+    {
+        ASSERT_EQ(1 + i, jobs[i].m_Result);
+    }
+    ASSERT_EQ(DM_ARRAY_SIZE(jobs), dmAtomicGet32(&test_ctx.m_Running));
+    if (dmThread::PlatformHasThreadSupport())
+    {
+        ASSERT_LT(0, dmAtomicGet32(&test_ctx.m_WorkerJobs));
+    }
+
+    dmJobThread::Destroy(ctx);
+}
+
+// Blocks the worker thread until the test releases it
+static int ProcessBlockingJob(void* context, void* data)
+{
+    GroupTestContext* ctx = (GroupTestContext*) context;
+    uint64_t stop_time = dmTime::GetTime() + 2*1e6;
+    while (dmAtomicGet32(&ctx->m_Release) == 0 && dmTime::GetTime() < stop_time)
+        dmTime::Sleep(1000);
+    return 1;
+}
+
+static int ProcessGroupJob(void* context, void* data)
+{
+    GroupTestContext* ctx = (GroupTestContext*) context;
+    if (dmThread::GetCurrentThread() != ctx->m_MainThread)
+        dmAtomicIncrement32(&ctx->m_WorkerJobs);
+    return 1;
+}
+
+TEST(dmJobThread, GroupDoesNotWaitForOtherJobs)
+{
+    dmJobThread::JobThreadCreationParams job_thread_create_param;
+    job_thread_create_param.m_ThreadNames[0] = "DefoldTestJobThread1";
+    job_thread_create_param.m_ThreadCount    = 1;
+
+    dmJobThread::HContext ctx = dmJobThread::Create(job_thread_create_param);
+
+    GroupTestContext test_ctx;
+    test_ctx.m_Running = 0;
+    test_ctx.m_Release = 0;
+    test_ctx.m_MainThread = dmThread::GetCurrentThread();
+    test_ctx.m_WorkerJobs = 0;
+
+    uint8_t blocking_result = 0;
+    dmJobThread::PushJob(ctx, ProcessBlockingJob, callback, &test_ctx, &blocking_result);
+
+    dmJobThread::Job jobs[8];
+    for (int i = 0; i < DM_ARRAY_SIZE(jobs); ++i)
+    {
+        jobs[i].m_Process = ProcessGroupJob;
+        jobs[i].m_Context = &test_ctx;
+        jobs[i].m_Data = 0;
+        jobs[i].m_Result = 0;
+    }
+
+    // The only worker is busy, so the calling thread runs all the jobs
+    uint64_t start_time = dmTime::GetTime();
+    dmJobThread::HGroup group = dmJobThread::PushGroup(ctx, jobs, DM_ARRAY_SIZE(jobs));
+    dmJobThread::WaitGroup(ctx, group);
+    uint64_t wait_time = dmTime::GetTime() - start_time;
+
+    dmAtomicStore32(&test_ctx.m_Release, 1);
+
+    for (int i = 0; i < DM_ARRAY_SIZE(jobs); ++i)
+    {
+        ASSERT_EQ(1, jobs[i].m_Result);
+    }
+    ASSERT_EQ(0, dmAtomicGet32(&test_ctx.m_WorkerJobs));
+    ASSERT_GT(1000000U, wait_time);
+
+    // The group leaves nothing for Update(), only the blocking job is done
+    uint64_t stop_time = dmTime::GetTime() + 1*1e6; // 1 second
+    while (dmTime::GetTime() < stop_time && blocking_result == 0)
+    {
+        dmJobThread::Update(ctx);
+        dmTime::Sleep(1000);
+    }
+    ASSERT_EQ(1, blocking_result);
+
+    dmJobThread::Destroy(ctx);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
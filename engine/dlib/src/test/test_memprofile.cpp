@@ -275,6 +275,125 @@ TEST(dmMemProfile, TestNewDelete2)
     }
 }
 
+TEST(dmMemProfile, TestTagScope)
+{
+    dmMemProfile::TagStats stats1, stats2, stats3;
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_LUA, &stats1);
+
+    void* p = 0;
+    {
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_LUA);
+        if (g_MemprofileActive)
+        {
+            ASSERT_EQ(dmMemProfile::TAG_LUA, dmMemProfile::GetTag());
+        }
+        p = malloc(1024);
+        g_dont_optimize = p;
+    }
+    ASSERT_EQ(dmMemProfile::TAG_NONE, dmMemProfile::GetTag());
+
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_LUA, &stats2);
+
+    if (g_MemprofileActive)
+    {
+        ASSERT_EQ(1, stats2.m_AllocationCount - stats1.m_AllocationCount);
+        ASSERT_GE(stats2.m_Active - stats1.m_Active, 1024);
+        ASSERT_LE(stats2.m_Active - stats1.m_Active, 1024 + sizeof(size_t));
+        ASSERT_GE(stats2.m_Peak, stats2.m_Active);
+        ASSERT_GE(stats2.m_TotalAllocated - stats1.m_TotalAllocated, 1024);
+    }
+
+    // The tag follows the allocation, not the scope it is freed in
+    free(p);
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_LUA, &stats3);
+
+    if (g_MemprofileActive)
+    {
+        ASSERT_EQ(1, stats3.m_AllocationCount - stats1.m_AllocationCount);
+        ASSERT_EQ(0, stats3.m_Active - stats1.m_Active);
+        ASSERT_GE(stats3.m_Peak, stats2.m_Active);
+        ASSERT_EQ(stats2.m_TotalAllocated, stats3.m_TotalAllocated);
+    }
+}
+
+TEST(dmMemProfile, TestTagNested)
+{
+    dmMemProfile::TagStats render1, render2, sound1, sound2;
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_RENDER, &render1);
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_SOUND, &sound1);
+
+    void* p1 = 0;
+    void* p2 = 0;
+    void* p3 = 0;
+    {
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RENDER);
+        p1 = malloc(256);
+        g_dont_optimize = p1;
+        {
+            DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_SOUND);
+            p2 = malloc(512);
+            g_dont_optimize = p2;
+        }
+        p3 = malloc(256);
+        g_dont_optimize = p3;
+    }
+
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_RENDER, &render2);
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_SOUND, &sound2);
+
+    if (g_MemprofileActive)
+    {
+        ASSERT_EQ(2, render2.m_AllocationCount - render1.m_AllocationCount);
+        ASSERT_EQ(1, sound2.m_AllocationCount - sound1.m_AllocationCount);
+        ASSERT_GE(render2.m_Active - render1.m_Active, 512);
+        ASSERT_GE(sound2.m_Active - sound1.m_Active, 512);
+    }
+
+    free(p1);
+    free(p2);
+    free(p3);
+
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_RENDER, &render2);
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_SOUND, &sound2);
+    ASSERT_EQ(0, render2.m_Active - render1.m_Active);
+    ASSERT_EQ(0, sound2.m_Active - sound1.m_Active);
+}
+
+TEST(dmMemProfile, TestTagRealloc)
+{
+    dmMemProfile::TagStats stats1, stats2, stats3;
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_PHYSICS, &stats1);
+
+    void* p = 0;
+    {
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_PHYSICS);
+        p = malloc(1024);
+        g_dont_optimize = p;
+    }
+    // Reallocated memory keeps its tag
+    p = realloc(p, 4096);
+    g_dont_optimize = p;
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_PHYSICS, &stats2);
+
+    if (g_MemprofileActive)
+    {
+        ASSERT_EQ(2, stats2.m_AllocationCount - stats1.m_AllocationCount);
+        ASSERT_GE(stats2.m_Active - stats1.m_Active, 4096);
+        ASSERT_LE(stats2.m_Active - stats1.m_Active, 4096 + sizeof(size_t));
+    }
+
+    free(p);
+    dmMemProfile::GetTagStats(dmMemProfile::TAG_PHYSICS, &stats3);
+    ASSERT_EQ(0, stats3.m_Active - stats1.m_Active);
+}
+
+TEST(dmMemProfile, TestTagName)
+{
+    ASSERT_STREQ("none", dmMemProfile::GetTagName(dmMemProfile::TAG_NONE));
+    ASSERT_STREQ("lua", dmMemProfile::GetTagName(dmMemProfile::TAG_LUA));
+    ASSERT_STREQ("physics", dmMemProfile::GetTagName(dmMemProfile::TAG_PHYSICS));
+}
+
 #ifndef _MSC_VER
 
 #include <vector>
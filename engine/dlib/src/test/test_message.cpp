@@ -472,6 +472,104 @@ TEST(dmMessage, MessagePostDispatch)
     ASSERT_EQ(8111, g_PostDistpatchCalled);
 }
 
+uint32_t g_ExternalDataReleased = 0;
+
+void ExternalDataDestroyCallback(dmMessage::Message* message)
+{
+    free((void*)dmMessage::GetData(message));
+    g_ExternalDataReleased++;
+}
+
+void HandleExternalDataMessage(dmMessage::Message* message, void* user_ptr)
+{
+    ASSERT_TRUE(dmMessage::IsExternal(message));
+    const uint8_t* data = (const uint8_t*)dmMessage::GetData(message);
+    ASSERT_EQ(user_ptr, (void*)data);
+    for (uint32_t i = 0; i < message->m_DataSize; ++i)
+    {
+        ASSERT_EQ((uint8_t)i, data[i]);
+    }
+}
+
+void HandleInlineDataMessage(dmMessage::Message* message, void* user_ptr)
+{
+    ASSERT_FALSE(dmMessage::IsExternal(message));
+    ASSERT_EQ((const void*)message->m_Data, dmMessage::GetData(message));
+    ASSERT_EQ(0, memcmp(user_ptr, message->m_Data, message->m_DataSize));
+}
+
+TEST(dmMessage, PostExternal)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket));
+
+    // Larger than what fits in a message page
+    const uint32_t data_size = dmMessage::DM_MESSAGE_PAGE_SIZE * 4;
+    uint8_t* data = (uint8_t*)malloc(data_size);
+    for (uint32_t i = 0; i < data_size; ++i)
+    {
+        data[i] = (uint8_t)i;
+    }
+
+    // Post always copies the data into the message
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, m_HashMessage1, 0, 0, 0, data, 256, 0));
+    ASSERT_EQ(1u, dmMessage::Dispatch(receiver.m_Socket, HandleInlineDataMessage, (void*)data));
+
+    g_ExternalDataReleased = 0;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::PostExternal(0x0, &receiver, m_HashMessage1, 0, 0, 0, data, data_size, ExternalDataDestroyCallback));
+    ASSERT_EQ(1u, dmMessage::Dispatch(receiver.m_Socket, HandleExternalDataMessage, (void*)data));
+    ASSERT_EQ(1u, g_ExternalDataReleased);
+
+    // Pending external data is released when the socket is deleted
+    data = (uint8_t*)malloc(data_size);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::PostExternal(0x0, &receiver, m_HashMessage1, 0, 0, 0, data, data_size, ExternalDataDestroyCallback));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+    ASSERT_EQ(2u, g_ExternalDataReleased);
+}
+
+struct DispatchEndContext
+{
+    uint32_t m_MessageCount;
+    uint32_t m_MessageCountAtEnd;
+    uint32_t m_EndCount;
+};
+
+void CountMessage(dmMessage::Message* message, void* user_ptr)
+{
+    ((DispatchEndContext*)user_ptr)->m_MessageCount++;
+}
+
+void DispatchEnd(void* user_ptr)
+{
+    DispatchEndContext* ctx = (DispatchEndContext*)user_ptr;
+    ctx->m_MessageCountAtEnd = ctx->m_MessageCount;
+    ctx->m_EndCount++;
+}
+
+TEST(dmMessage, DispatchEnd)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(&receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket));
+
+    DispatchEndContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+
+    // Not called without messages
+    ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, CountMessage, DispatchEnd, &ctx));
+    ASSERT_EQ(0u, ctx.m_EndCount);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, m_HashMessage1, 0, 0, 0x0, 0, 0, 0));
+    }
+    ASSERT_EQ(3u, dmMessage::Dispatch(receiver.m_Socket, CountMessage, DispatchEnd, &ctx));
+    ASSERT_EQ(1u, ctx.m_EndCount);
+    ASSERT_EQ(3u, ctx.m_MessageCountAtEnd);
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
 
 int main(int argc, char **argv)
 {
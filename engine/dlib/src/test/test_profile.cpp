@@ -20,6 +20,8 @@
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
 #include "dlib/dstrings.h"
+#include "dlib/sys.h"
+#include "dlib/testutil.h"
 #include "dlib/hash.h"
 #include "dlib/time.h"
 #include "dlib/mutex.h"
@@ -348,6 +350,103 @@ TEST(dmProfile, PropertyIterator)
     dmMutex::Delete(ctx.m_Mutex);
 }
 
+static std::string ReadFile(const char* path)
+{
+    std::string content;
+    FILE* f = fopen(path, "rb");
+    if (f)
+    {
+        char buf[1024];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            content.append(buf, n);
+        fclose(f);
+    }
+    return content;
+}
+
+// Properties are registered with the profiler the first time they're set, so this one is only used by this test
+DM_PROPERTY_U32(prop_TraceCounter, 0, FrameReset, "");
+
+TEST(dmProfile, TraceCapture)
+{
+    char path[1024];
+    dmTestUtil::MakeHostPath(path, sizeof(path), "tmp");
+    dmSys::Mkdir(path, 0755);
+    dmTestUtil::MakeHostPath(path, sizeof(path), "tmp/trace.json");
+    dmSys::Unlink(path);
+
+    // Not used by the capture, and may be left over from the other tests
+    dmProfile::SetSampleTreeCallback(0, 0);
+    dmProfile::SetPropertyTreeCallback(0, 0);
+
+    dmProfile::Options options;
+    options.m_TraceFile = path;
+    options.m_TraceFrames = 2;
+    dmProfile::Initialize(&options);
+
+    if (dmProfile::IsInitialized()) // false for profile null (i.e. on unsupported platforms)
+    {
+        ASSERT_TRUE(dmProfile::IsTraceCaptureStarted());
+        for (int i = 0; i < 3; ++i)
+        {
+            dmProfile::HProfile profile = dmProfile::BeginFrame();
+            {
+                DM_PROFILE("TraceFrame");
+                {
+                    DM_PROFILE("Trace\"Quoted\"");
+                    dmTime::BusyWait(1000);
+                }
+            }
+            DM_PROPERTY_SET_U32(prop_TraceCounter, 17);
+            dmProfile::EndFrame(profile);
+        }
+
+        // The samples are processed on the profiler thread
+        for (int i = 0; i < 200 && !dmProfile::IsTraceCaptureFinished(); ++i)
+        {
+            dmTime::Sleep(10000);
+        }
+        ASSERT_TRUE(dmProfile::IsTraceCaptureFinished());
+        dmProfile::Finalize();
+
+        std::string trace = ReadFile(path);
+        ASSERT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+        ASSERT_EQ(trace.size() - 4, trace.rfind("\n]}\n"));
+        ASSERT_NE(std::string::npos, trace.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main\"}}"));
+        ASSERT_NE(std::string::npos, trace.find("{\"name\":\"Trace\\\"Quoted\\\"\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"));
+        ASSERT_NE(std::string::npos, trace.find("{\"name\":\"prop_TraceCounter\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":"));
+
+        // Only the first two frames are captured
+        uint32_t frame_count = 0;
+        for (size_t pos = trace.find("\"TraceFrame\""); pos != std::string::npos; pos = trace.find("\"TraceFrame\"", pos + 1))
+        {
+            ++frame_count;
+        }
+        ASSERT_EQ(2u, frame_count);
+    }
+    else
+    {
+        ASSERT_FALSE(dmProfile::IsTraceCaptureStarted());
+        dmProfile::Finalize();
+    }
+}
+
+TEST(dmProfile, TraceCaptureFileError)
+{
+    char path[1024];
+    dmTestUtil::MakeHostPath(path, sizeof(path), "tmp/no_such_dir/trace.json");
+
+    dmProfile::Options options;
+    options.m_TraceFile = path;
+    options.m_TraceFrames = 2;
+    dmProfile::Initialize(&options);
+
+    ASSERT_FALSE(dmProfile::IsTraceCaptureStarted());
+    ASSERT_FALSE(dmProfile::IsTraceCaptureFinished());
+    dmProfile::Finalize();
+}
+
 /*
 
 TEST(dmProfile, DynamicScope)
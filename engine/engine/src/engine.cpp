@@ -102,6 +102,26 @@ DM_PROPERTY_EXTERN(rmtp_Script);
 DM_PROPERTY_U32(rmtp_LuaMem, 0, FrameReset, "kb", &rmtp_Script); // kilo bytes
 DM_PROPERTY_U32(rmtp_LuaRefs, 0, FrameReset, "# Lua references", &rmtp_Script);
 
+DM_PROPERTY_GROUP(rmtp_FrameArena, "Frame arena");
+DM_PROPERTY_U32(rmtp_FrameArenaUsed, 0, FrameReset, "kb used this frame", &rmtp_FrameArena);
+DM_PROPERTY_U32(rmtp_FrameArenaHighWater, 0, FrameReset, "kb used by the largest frame", &rmtp_FrameArena);
+DM_PROPERTY_U32(rmtp_FrameArenaBlocks, 0, FrameReset, "# blocks allocated this frame", &rmtp_FrameArena);
+
+// Only available when running with the memprofile library, see dmMemProfile::SetTag()
+DM_PROPERTY_GROUP(rmtp_MemoryTags, "Memory per subsystem");
+DM_PROPERTY_U32(rmtp_MemResource, 0, FrameReset, "kb active, allocated during resource loading", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemResourceRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemComponent, 0, FrameReset, "kb active, allocated during component create and update", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemComponentRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemLua, 0, FrameReset, "kb active, allocated during script execution", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemLuaRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemRender, 0, FrameReset, "kb active, allocated during rendering", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemRenderRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemSound, 0, FrameReset, "kb active, allocated during sound mixing", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemSoundRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemPhysics, 0, FrameReset, "kb active, allocated during physics simulation", &rmtp_MemoryTags);
+DM_PROPERTY_U32(rmtp_MemPhysicsRate, 0, FrameReset, "kb allocated this frame", &rmtp_MemoryTags);
+
 namespace dmEngine
 {
 #if !(defined(DM_PLATFORM_VENDOR))
@@ -228,6 +248,7 @@ namespace dmEngine
     , m_MouseSensitivity(1.0f)
     , m_GraphicsContext(0)
     , m_RenderContext(0)
+    , m_FrameArena(0)
     , m_SharedScriptContext(0x0)
     , m_GOScriptContext(0x0)
     , m_RenderScriptContext(0x0)
@@ -258,6 +279,8 @@ namespace dmEngine
         m_PhysicsContext.m_Context3D = 0x0; // it'a union
         m_PhysicsContext.m_Debug = false;
         m_PhysicsContext.m_3D = false;
+        m_PhysicsContext.m_AsyncStep = false;
+        m_PhysicsContext.m_JobThread = 0x0;
         m_GuiContext = 0x0;
         m_SpriteContext.m_RenderContext = 0x0;
         m_SpriteContext.m_MaxSpriteCount = 0;
@@ -265,6 +288,13 @@ namespace dmEngine
         m_ModelContext.m_MaxModelCount = 0;
         m_AccumFrameTime = 0;
         m_PreviousFrameTime = dmTime::GetTime();
+
+        for (uint32_t i = 0; i < dmMemProfile::MAX_TAG_COUNT; ++i)
+        {
+            dmMemProfile::TagStats stats;
+            dmMemProfile::GetTagStats((dmMemProfile::Tag) i, &stats);
+            m_MemoryTagAllocated[i] = stats.m_TotalAllocated;
+        }
     }
 
     HEngine New(dmEngineService::HEngineService engine_service)
@@ -317,6 +347,9 @@ namespace dmEngine
 
         dmRender::DeleteRenderContext(engine->m_RenderContext, engine->m_RenderScriptContext);
 
+        if (engine->m_FrameArena)
+            dmFrameArena::Delete(engine->m_FrameArena);
+
         if (engine->m_HidContext)
         {
             dmHID::Final(engine->m_HidContext);
@@ -779,6 +812,19 @@ namespace dmEngine
             return false;
         }
 
+        // The profiler extension exits when the trace capture is finished. Fail instead of running forever.
+        if (dmConfigFile::GetInt(engine->m_Config, "profiler.trace_exit", 0)) {
+            if (dmConfigFile::GetInt(engine->m_Config, "profiler.trace_frames", 0) <= 0) {
+                dmLogFatal("profiler.trace_exit requires profiler.trace_frames to be set");
+                return false;
+            }
+            if (!dmProfile::IsTraceCaptureStarted()) {
+                dmLogFatal("Failed to start the profile trace capture to '%s'. The profiler is only available in debug builds.",
+                            dmConfigFile::GetString(engine->m_Config, "profiler.trace_file", ""));
+                return false;
+            }
+        }
+
         int write_log = dmConfigFile::GetInt(engine->m_Config, "project.write_log", 0);
         if (write_log) {
             uint32_t count = 0;
@@ -977,6 +1023,16 @@ namespace dmEngine
             dmScript::Initialize(engine->m_RenderScriptContext);
             engine->m_GuiScriptContext = dmScript::NewContext(engine->m_Config, engine->m_Factory, true);
             dmScript::Initialize(engine->m_GuiScriptContext);
+
+            // script.gc_budget is the budget for the whole frame, so it's split between the contexts
+            uint32_t gc_budget = dmScript::GetGCBudget(engine->m_GOScriptContext);
+            if (gc_budget > 0)
+            {
+                uint32_t context_gc_budget = dmMath::Max(1U, gc_budget / 3);
+                dmScript::SetGCBudget(engine->m_GOScriptContext, context_gc_budget);
+                dmScript::SetGCBudget(engine->m_RenderScriptContext, context_gc_budget);
+                dmScript::SetGCBudget(engine->m_GuiScriptContext, context_gc_budget);
+            }
             module_script_contexts.SetCapacity(3);
             module_script_contexts.Push(engine->m_GOScriptContext);
             module_script_contexts.Push(engine->m_RenderScriptContext);
@@ -1004,6 +1060,7 @@ namespace dmEngine
             return false;
         }
         dmGameObject::SetInputStackDefaultCapacity(engine->m_Register, dmConfigFile::GetInt(engine->m_Config, dmGameObject::COLLECTION_MAX_INPUT_STACK_ENTRIES_KEY, dmGameObject::DEFAULT_MAX_INPUT_STACK_CAPACITY));
+        dmGameObject::SetComponentUpdateThreadCount(engine->m_Register, dmConfigFile::GetInt(engine->m_Config, dmGameObject::COLLECTION_UPDATE_THREADS_KEY, 0));
 
         dmRender::RenderContextParams render_params;
         render_params.m_MaxRenderTypes = 16;
@@ -1012,6 +1069,9 @@ namespace dmEngine
         render_params.m_MaxCharacters = (uint32_t) dmConfigFile::GetInt(engine->m_Config, "graphics.max_characters", 2048 * 4);
         render_params.m_CommandBufferSize = 1024;
         render_params.m_ScriptContext = engine->m_RenderScriptContext;
+        // The arena grows to fit the largest frame
+        engine->m_FrameArena = dmFrameArena::New(64 * 1024);
+        render_params.m_FrameArena = engine->m_FrameArena;
 #if !defined(DM_RELEASE)
         render_params.m_VertexShaderDesc = ::DEBUG_VPC;
         render_params.m_VertexShaderDescSize = ::DEBUG_VPC_SIZE;
@@ -1093,6 +1153,7 @@ namespace dmEngine
         physics_params.m_Scale = dmConfigFile::GetFloat(engine->m_Config, "physics.scale", 1.0f);
         physics_params.m_RayCastLimit2D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_2d", 64);
         physics_params.m_RayCastLimit3D = dmConfigFile::GetInt(engine->m_Config, "physics.ray_cast_limit_3d", 128);
+        physics_params.m_QueryThreadCount = dmConfigFile::GetInt(engine->m_Config, "physics.query_thread_count", 0);
         physics_params.m_TriggerOverlapCapacity = dmConfigFile::GetInt(engine->m_Config, "physics.trigger_overlap_capacity", 16);
         physics_params.m_VelocityThreshold = dmConfigFile::GetFloat(engine->m_Config, "physics.velocity_threshold", 1.0f);
         if (physics_params.m_Scale < dmPhysics::MIN_SCALE || physics_params.m_Scale > dmPhysics::MAX_SCALE)
@@ -1126,6 +1187,8 @@ namespace dmEngine
         engine->m_PhysicsContext.m_MaxContactPointCount = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_MAX_CONTACTS_KEY, 128);
         engine->m_PhysicsContext.m_UseFixedTimestep = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_USE_FIXED_TIMESTEP, 1) ? 1 : 0;
         engine->m_PhysicsContext.m_MaxFixedTimesteps = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_MAX_FIXED_TIMESTEPS, 2);
+        engine->m_PhysicsContext.m_AsyncStep = dmConfigFile::GetInt(engine->m_Config, dmGameSystem::PHYSICS_ASYNC_STEP, 0) ? 1 : 0;
+        engine->m_PhysicsContext.m_JobThread = engine->m_JobThreadContext;
         // TODO: Should move inside the ifdef release? Is this usable without the debug callbacks?
         engine->m_PhysicsContext.m_Debug = (bool) dmConfigFile::GetInt(engine->m_Config, "physics.debug", 0);
 
@@ -1494,6 +1557,83 @@ bail:
         return memcount;
     }
 
+    static void UpdateMemoryTagProperties(HEngine engine)
+    {
+        if (!dmMemProfile::IsEnabled())
+            return;
+
+        uint32_t active[dmMemProfile::MAX_TAG_COUNT];
+        uint32_t allocated[dmMemProfile::MAX_TAG_COUNT];
+        for (uint32_t i = 0; i < dmMemProfile::MAX_TAG_COUNT; ++i)
+        {
+            dmMemProfile::TagStats stats;
+            dmMemProfile::GetTagStats((dmMemProfile::Tag) i, &stats);
+            active[i] = (uint32_t) stats.m_Active / 1024;
+            allocated[i] = ((uint32_t) stats.m_TotalAllocated - (uint32_t) engine->m_MemoryTagAllocated[i]) / 1024;
+            engine->m_MemoryTagAllocated[i] = stats.m_TotalAllocated;
+        }
+
+        DM_PROPERTY_SET_U32(rmtp_MemResource, active[dmMemProfile::TAG_RESOURCE]);
+        DM_PROPERTY_SET_U32(rmtp_MemResourceRate, allocated[dmMemProfile::TAG_RESOURCE]);
+        DM_PROPERTY_SET_U32(rmtp_MemComponent, active[dmMemProfile::TAG_COMPONENT]);
+        DM_PROPERTY_SET_U32(rmtp_MemComponentRate, allocated[dmMemProfile::TAG_COMPONENT]);
+        DM_PROPERTY_SET_U32(rmtp_MemLua, active[dmMemProfile::TAG_LUA]);
+        DM_PROPERTY_SET_U32(rmtp_MemLuaRate, allocated[dmMemProfile::TAG_LUA]);
+        DM_PROPERTY_SET_U32(rmtp_MemRender, active[dmMemProfile::TAG_RENDER]);
+        DM_PROPERTY_SET_U32(rmtp_MemRenderRate, allocated[dmMemProfile::TAG_RENDER]);
+        DM_PROPERTY_SET_U32(rmtp_MemSound, active[dmMemProfile::TAG_SOUND]);
+        DM_PROPERTY_SET_U32(rmtp_MemSoundRate, allocated[dmMemProfile::TAG_SOUND]);
+        DM_PROPERTY_SET_U32(rmtp_MemPhysics, active[dmMemProfile::TAG_PHYSICS]);
+        DM_PROPERTY_SET_U32(rmtp_MemPhysicsRate, allocated[dmMemProfile::TAG_PHYSICS]);
+        (void) active;
+        (void) allocated;
+    }
+
+    static void ResetFrameArena(HEngine engine)
+    {
+        dmFrameArena::Stats stats;
+        dmFrameArena::GetStats(engine->m_FrameArena, &stats);
+        DM_PROPERTY_SET_U32(rmtp_FrameArenaUsed, stats.m_Used / 1024);
+        DM_PROPERTY_SET_U32(rmtp_FrameArenaHighWater, dmMath::Max(stats.m_HighWater, stats.m_Used) / 1024);
+        DM_PROPERTY_SET_U32(rmtp_FrameArenaBlocks, stats.m_BlockCount);
+        (void) stats;
+
+        dmFrameArena::Reset(engine->m_FrameArena);
+    }
+
+    static void StepLuaGC(dmScript::HContext context, dmEngineService::LuaGCStats* stats)
+    {
+        dmScript::StepGC(context);
+
+        dmScript::GCStats gc_stats;
+        dmScript::GetGCStats(context, &gc_stats);
+        stats->m_Time += gc_stats.m_Time;
+        stats->m_Steps += gc_stats.m_Steps;
+        stats->m_Allocated += gc_stats.m_Allocated;
+        stats->m_HeapSize += gc_stats.m_HeapSize;
+        stats->m_Cycles += gc_stats.m_Cycles;
+        stats->m_Budget += dmScript::GetGCBudget(context);
+    }
+
+    // Runs the budgeted Lua garbage collection in the time left when the frame is done
+    static void StepLuaGC(HEngine engine)
+    {
+        dmEngineService::LuaGCStats stats;
+        memset(&stats, 0, sizeof(stats));
+        if (engine->m_SharedScriptContext) {
+            StepLuaGC(engine->m_SharedScriptContext, &stats);
+        } else {
+            StepLuaGC(engine->m_GOScriptContext, &stats);
+            StepLuaGC(engine->m_RenderScriptContext, &stats);
+            StepLuaGC(engine->m_GuiScriptContext, &stats);
+        }
+
+        if (engine->m_EngineService)
+        {
+            dmEngineService::SetLuaGCStats(engine->m_EngineService, &stats);
+        }
+    }
+
     static void StepFrame(HEngine engine, float dt)
     {
         dmProfiler::SetUpdateFrequency((uint32_t)(1.0f / dt));
@@ -1696,6 +1836,7 @@ bail:
 
             DM_PROPERTY_SET_U32(rmtp_LuaRefs, dmScript::GetLuaRefCount());
             DM_PROPERTY_SET_U32(rmtp_LuaMem, GetLuaMemCount(engine));
+            UpdateMemoryTagProperties(engine);
 
             if (dLib::IsDebugMode())
             {
@@ -1732,6 +1873,9 @@ bail:
 
             dmGraphics::Flip(engine->m_GraphicsContext);
 
+            ResetFrameArena(engine);
+            StepLuaGC(engine);
+
             RecordData* record_data = &engine->m_RecordData;
             if (record_data->m_Recorder)
             {
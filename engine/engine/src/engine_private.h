@@ -18,7 +18,9 @@
 #include <stdint.h>
 
 #include <dlib/configfile.h>
+#include <dlib/frame_arena.h>
 #include <dlib/hashtable.h>
+#include <dlib/memprofile.h>
 #include <dlib/message.h>
 
 #include <resource/resource.h>
@@ -123,6 +125,7 @@ namespace dmEngine
         dmJobThread::HContext                       m_JobThreadContext;
         dmGraphics::HContext                        m_GraphicsContext;
         dmRender::HRenderContext                    m_RenderContext;
+        dmFrameArena::HArena                        m_FrameArena;               // Transient per frame data, reset after Flip
         dmGameSystem::PhysicsContext                m_PhysicsContext;
         dmGameSystem::ParticleFXContext             m_ParticleFXContext;
         /// If the shared context is set, the three environment specific contexts below will point to the same context
@@ -166,6 +169,7 @@ namespace dmEngine
         uint32_t                                    m_ClearColor;
         float                                       m_InvPhysicalWidth;
         float                                       m_InvPhysicalHeight;
+        int32_t                                     m_MemoryTagAllocated[dmMemProfile::MAX_TAG_COUNT]; // Used to calculate the allocation rate per tag
 
         RecordData                                  m_RecordData;
     };
@@ -19,6 +19,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/math.h>
 #include <dlib/log.h>
+#include <dlib/memprofile.h>
 #include <dlib/profile.h>
 #include <dlib/ssdp.h>
 #include <dlib/socket.h>
@@ -503,6 +504,8 @@ namespace dmEngineService
 
         char                 m_InfoJson[sizeof(INFO_TEMPLATE) + 512]; // 512 is rather arbitrary :-)
 
+        LuaGCStats           m_LuaGCStats;
+
         dmProfile::HProfile  m_Profile;
     };
 
@@ -648,9 +651,9 @@ namespace dmEngineService
 
     static void OutputGuiDynamicTextures(dmGameObject::SceneNode* node, dmWebServer::Request* request)
     {
-        static const dmhash_t s_GuiResource = dmHashString64("guic");
-        static const dmhash_t s_PropertyResource = dmHashString64("resource");
-        static const dmhash_t s_PropertyType = dmHashString64("type");
+        static const dmhash_t s_GuiResource = dmHashConstString64("guic");
+        static const dmhash_t s_PropertyResource = dmHashConstString64("resource");
+        static const dmhash_t s_PropertyType = dmHashConstString64("type");
 
         if (node->m_Type == dmGameObject::SCENE_NODE_TYPE_SUBCOMPONENT)
             return;
@@ -719,9 +722,9 @@ namespace dmEngineService
 
     static void OutputResourceSceneGraph(dmGameObject::SceneNode* node, uint32_t parent, uint32_t* counter, dmWebServer::Request* request)
     {
-        static const dmhash_t s_PropertyId = dmHashString64("id");
-        static const dmhash_t s_PropertyResource = dmHashString64("resource");
-        static const dmhash_t s_PropertyType = dmHashString64("type");
+        static const dmhash_t s_PropertyId = dmHashConstString64("id");
+        static const dmhash_t s_PropertyResource = dmHashConstString64("resource");
+        static const dmhash_t s_PropertyType = dmHashConstString64("type");
 
         if (node->m_Type == dmGameObject::SCENE_NODE_TYPE_SUBCOMPONENT)
             return;
@@ -879,6 +882,56 @@ namespace dmEngineService
 
 #undef CHECK_RESULT_BOOL
 
+    //
+    // Lua garbage collection
+    //
+
+    static void HttpLuaGCRequestCallback(void* context, dmWebServer::Request* request)
+    {
+        const LuaGCStats* stats = &((EngineService*)context)->m_LuaGCStats;
+
+        char buffer[256];
+        dmSnPrintf(buffer, sizeof(buffer), "{\"time\": %u, \"steps\": %u, \"allocated\": %u, \"heap_size\": %u, \"cycles\": %u, \"budget\": %u}",
+                    stats->m_Time, stats->m_Steps, stats->m_Allocated, stats->m_HeapSize, stats->m_Cycles, stats->m_Budget);
+
+        dmWebServer::SetStatusCode(request, 200);
+        dmWebServer::SendAttribute(request, "Content-Type", "application/json");
+        dmWebServer::SendAttribute(request, "Access-Control-Allow-Origin", "*");
+        dmWebServer::SendAttribute(request, "Cache-Control", "no-store");
+        SendText(request, buffer);
+    }
+
+    void SetLuaGCStats(HEngineService engine_service, const LuaGCStats* stats)
+    {
+        engine_service->m_LuaGCStats = *stats;
+    }
+
+    //
+    // Memory per subsystem
+    //
+
+    static void HttpMemoryTagsRequestCallback(void* context, dmWebServer::Request* request)
+    {
+        char buffer[1024];
+        uint32_t n = dmSnPrintf(buffer, sizeof(buffer), "{\"enabled\": %s, \"tags\": [", dmMemProfile::IsEnabled() ? "true" : "false");
+        for (uint32_t i = 0; i < dmMemProfile::MAX_TAG_COUNT; ++i)
+        {
+            dmMemProfile::Tag tag = (dmMemProfile::Tag) i;
+            dmMemProfile::TagStats stats;
+            dmMemProfile::GetTagStats(tag, &stats);
+            n += dmSnPrintf(buffer + n, sizeof(buffer) - n, "%s{\"name\": \"%s\", \"active\": %u, \"peak\": %u, \"allocated\": %u, \"count\": %u}",
+                            i > 0 ? ", " : "", dmMemProfile::GetTagName(tag),
+                            (uint32_t) stats.m_Active, (uint32_t) stats.m_Peak, (uint32_t) stats.m_TotalAllocated, (uint32_t) stats.m_AllocationCount);
+        }
+        dmSnPrintf(buffer + n, sizeof(buffer) - n, "]}");
+
+        dmWebServer::SetStatusCode(request, 200);
+        dmWebServer::SendAttribute(request, "Content-Type", "application/json");
+        dmWebServer::SendAttribute(request, "Access-Control-Allow-Origin", "*");
+        dmWebServer::SendAttribute(request, "Cache-Control", "no-store");
+        SendText(request, buffer);
+    }
+
     //
     // All profilers' setup
     //
@@ -911,6 +964,16 @@ namespace dmEngineService
         scenegraph_params.m_Userdata = regist;
         dmWebServer::AddHandler(engine_service->m_WebServer, "/scene_graph", &scenegraph_params);
 
+        dmWebServer::HandlerParams lua_gc_params;
+        lua_gc_params.m_Handler = HttpLuaGCRequestCallback;
+        lua_gc_params.m_Userdata = engine_service;
+        dmWebServer::AddHandler(engine_service->m_WebServer, "/lua_gc_data", &lua_gc_params);
+
+        dmWebServer::HandlerParams memory_tags_params;
+        memory_tags_params.m_Handler = HttpMemoryTagsRequestCallback;
+        memory_tags_params.m_Userdata = 0;
+        dmWebServer::AddHandler(engine_service->m_WebServer, "/memory_tags", &memory_tags_params);
+
         // The entry point to the engine service profiler
         dmWebServer::HandlerParams profile_params;
         profile_params.m_Handler = ProfileHandler;
@@ -53,6 +53,20 @@ namespace dmEngineService
 
     void InitProfiler(HEngineService engine_service, dmResource::HFactory factory, dmGameObject::HRegister regist);
 
+    // Lua garbage collection statistics for the last frame, summed over all script contexts
+    struct LuaGCStats
+    {
+        uint32_t m_Time;        // us
+        uint32_t m_Steps;
+        uint32_t m_Allocated;   // kb
+        uint32_t m_HeapSize;    // kb
+        uint32_t m_Cycles;      // Total number of completed cycles
+        uint32_t m_Budget;      // us, 0 if the automatic garbage collection is used
+    };
+
+    // Served as json at /lua_gc_data
+    void SetLuaGCStats(HEngineService engine_service, const LuaGCStats* stats);
+
     struct ResourceHandlerParams
     {
         dmResource::HFactory      m_Factory;
@@ -37,6 +37,32 @@ namespace dmGameObject
 
     struct ComponentType;
 
+    /*# component update access flags
+     * Shared state that a component type update function may read or write.
+     * Component types that declare their access with [ref:ComponentTypeSetUpdateAccess] may be updated
+     * concurrently with other component types they don't conflict with.
+     *
+     * @enum
+     * @name ComponentUpdateAccess
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_TRANSFORMS game object transforms
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_MESSAGES posting messages. Only one of the types updated together may post
+     * messages, so they are dispatched in the same order as when the types are updated one at a time.
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_PHYSICS the physics world
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_SCRIPT the Lua state. Since a script may do anything, the type is always updated alone.
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_RESOURCES the resource factory
+     * @member dmGameObject::COMPONENT_UPDATE_ACCESS_RENDER the render and graphics contexts. Updated on the main thread, in update order,
+     * while the other types run on worker threads.
+     */
+    enum ComponentUpdateAccess
+    {
+        COMPONENT_UPDATE_ACCESS_TRANSFORMS  = 1 << 0,
+        COMPONENT_UPDATE_ACCESS_MESSAGES    = 1 << 1,
+        COMPONENT_UPDATE_ACCESS_PHYSICS     = 1 << 2,
+        COMPONENT_UPDATE_ACCESS_SCRIPT      = 1 << 3,
+        COMPONENT_UPDATE_ACCESS_RESOURCES   = 1 << 4,
+        COMPONENT_UPDATE_ACCESS_RENDER      = 1 << 5,
+    };
+
     /*#
      * Parameters to ComponentNewWorld callback.
      */
@@ -330,6 +356,30 @@ namespace dmGameObject
      */
     typedef UpdateResult (*ComponentOnMessage)(const ComponentOnMessageParams& params);
 
+    /*#
+     * Parameters to ComponentOnMessages callback.
+     */
+    struct ComponentOnMessagesParams
+    {
+        /// World
+        void* m_World;
+        /// User context
+        void* m_Context;
+        /// Array of per-message parameters, in the order the messages were posted
+        const ComponentOnMessageParams* m_Messages;
+        /// Number of messages
+        uint32_t m_MessageCount;
+    };
+
+    /*#
+     * Component on-messages function. Called with a batch of consecutive messages sent to
+     * the same component. If set, it is used instead of the ComponentOnMessage callback for
+     * messages addressed to a specific component.
+     * @param params Input parameters
+     * @return UPDATE_RESULT_OK on success
+     */
+    typedef UpdateResult (*ComponentOnMessages)(const ComponentOnMessagesParams& params);
+
     /*#
      * Parameters to ComponentOnInput callback.
      */
@@ -566,6 +616,16 @@ namespace dmGameObject
      */
     void ComponentTypeSetOnMessageFn(ComponentType* type, ComponentOnMessage fn);
 
+    /*# set the component on-messages callback
+     * Set the component batched on-message callback. Consecutive messages addressed to the same
+     * component are collected and passed in a single call. Broadcast messages (without a fragment)
+     * and messages with a destroy callback are still delivered through the on-message callback.
+     * @name ComponentTypeSetOnMessagesFn
+     * @param type [type: ComponentType*] the type
+     * @param fn [type: ComponentOnMessages] callback
+     */
+    void ComponentTypeSetOnMessagesFn(ComponentType* type, ComponentOnMessages fn);
+
     /*# set the component on-input callback
      * Set the component on-input callback. Called once per frame, before the Update function.
      * @name ComponentTypeSetOnInputFn
@@ -631,6 +691,17 @@ namespace dmGameObject
      */
     void ComponentTypeSetReadsTransforms(ComponentType* type, bool reads_transforms);
 
+    /*# set the component type update access
+     * Declare what shared state the update function of the component type reads and writes, as
+     * a combination of [type:ComponentUpdateAccess] flags. The update function may otherwise only touch its own world.
+     * Component types without a declaration are always updated alone, on the main thread.
+     * @name ComponentTypeSetUpdateAccess
+     * @param type [type: ComponentType*] the type
+     * @param reads [type: uint32_t] the state read by the update function
+     * @param writes [type: uint32_t] the state written by the update function
+     */
+    void ComponentTypeSetUpdateAccess(ComponentType* type, uint32_t reads, uint32_t writes);
+
     /*# set the component type prio order
      * Set the component type prio order. Defines the update order of the component types.
      * @name ComponentTypeSetPrio
@@ -516,6 +516,16 @@ namespace dmGameObject
      */
     uint32_t AcquireInstanceIndex(HCollection collection);
 
+    /*#
+     * Retrieve a number of instance indices from the index pool for the collection.
+     * @name AcquireInstanceIndices
+     * @param collection [type: dmGameObject::HColleciton] Collection from which to retrieve the instance indices.
+     * @param count [type: uint32_t] The number of indices to retrieve.
+     * @param out_indices [type: uint32_t*] Array of at least count elements that receives the indices.
+     * @return acquired [type: uint32_t] number of indices retrieved, less than count if the pool is exhausted.
+     */
+    uint32_t AcquireInstanceIndices(HCollection collection, uint32_t count, uint32_t* out_indices);
+
     /*#
      * Assign an index to the instance, only if the instance is not null.
      * @name AssignInstanceIndex
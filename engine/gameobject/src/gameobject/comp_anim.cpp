@@ -15,6 +15,7 @@
 
 #include "comp_anim.h"
 
+#include <dlib/flat_hashtable.h>
 #include <dlib/index_pool.h>
 #include <dlib/profile.h>
 
@@ -72,8 +73,8 @@ namespace dmGameObject
         dmArray<Animation>                  m_Animations;
         dmArray<uint16_t>                   m_AnimMap;
         dmIndexPool<uint16_t>               m_AnimMapIndexPool;
-        dmHashTable<uintptr_t, uint16_t>    m_InstanceToIndex;
-        dmHashTable<uintptr_t, uint16_t>    m_ListenerInstanceToIndex;
+        dmFlatHashTable<uintptr_t, uint16_t> m_InstanceToIndex;
+        dmFlatHashTable<uintptr_t, uint16_t> m_ListenerInstanceToIndex;
         uint32_t                            m_InUpdate : 1;
     };
 
@@ -90,9 +91,8 @@ namespace dmGameObject
             world->m_AnimMapIndexPool.SetCapacity(MAX_CAPACITY);
             // This is fetched from res_collection.cpp (ResCollectionCreate)
             const int32_t instance_count = params.m_MaxInstances;
-            const uint32_t table_count = dmMath::Max(1, instance_count/3);
-            world->m_InstanceToIndex.SetCapacity(table_count, instance_count);
-            world->m_ListenerInstanceToIndex.SetCapacity(table_count, instance_count);
+            world->m_InstanceToIndex.SetCapacity(instance_count);
+            world->m_ListenerInstanceToIndex.SetCapacity(instance_count);
             world->m_InUpdate = 0;
             return CREATE_RESULT_OK;
         }
@@ -422,12 +422,7 @@ namespace dmGameObject
         uint16_t* index_ptr = world->m_InstanceToIndex.Get((uintptr_t)instance);
         if (index_ptr == 0x0)
         {
-            if (world->m_InstanceToIndex.Full())
-            {
-                dmLogError("Animation could not be stored since the instance buffer is full (%d).", world->m_InstanceToIndex.Size());
-                world->m_AnimMapIndexPool.Push(index);
-                return false;
-            }
+            // The instance tables grow as needed, their size is bounded by the animation count
             world->m_InstanceToIndex.Put((uintptr_t)instance, index);
         }
         else
@@ -486,15 +481,7 @@ namespace dmGameObject
         if (0x0 != animation_stopped)
         {
             index_ptr = world->m_ListenerInstanceToIndex.Get((uintptr_t)userdata1);
-            if (0x0 == index_ptr)
-            {
-                if (world->m_ListenerInstanceToIndex.Full())
-                {
-                    dmLogError("Animation listener could not be stored since the buffer is full (%d).", world->m_ListenerInstanceToIndex.Size());
-                    return false;
-                }
-            }
-            else
+            if (0x0 != index_ptr)
             {
                 Animation* last_anim = &world->m_Animations[world->m_AnimMap[*index_ptr]];
                 animation.m_NextListener = last_anim->m_Index;
@@ -321,7 +321,7 @@ namespace dmGameObject
                 message_name = (const char*)dmHashReverse64(message->m_Id, 0);
             }
             if (message->m_DataSize > 0)
-                dmScript::PushTable(L, (const char*)message->m_Data, message->m_DataSize);
+                dmScript::PushTable(L, (const char*)dmMessage::GetData(message), message->m_DataSize);
             else
                 lua_newtable(L);
         }
@@ -347,9 +347,8 @@ namespace dmGameObject
         return result;
     }
 
-    UpdateResult CompScriptOnMessage(const ComponentOnMessageParams& params)
+    static UpdateResult OnMessage(const ComponentOnMessageParams& params)
     {
-        DM_PROFILE("RunScript");
         UpdateResult result = UPDATE_RESULT_OK;
 
         ScriptInstance* script_instance = (ScriptInstance*)*params.m_UserData;
@@ -391,6 +390,7 @@ namespace dmGameObject
                 message->m_Receiver     = params.m_Message->m_Receiver;
                 message->m_Id           = descriptor->m_NameHash;
                 message->m_DataSize     = payload_message_size;
+                message->m_External     = 0;
                 message->m_Descriptor   = (uintptr_t)descriptor;
                 message->m_UserData1    = 0; // should we copy the current m_UserData1?
                 message->m_UserData2    = 0; // deprecated (the Lua function reference)
@@ -443,6 +443,26 @@ namespace dmGameObject
         return result;
     }
 
+    UpdateResult CompScriptOnMessage(const ComponentOnMessageParams& params)
+    {
+        DM_PROFILE("RunScript");
+        return OnMessage(params);
+    }
+
+    UpdateResult CompScriptOnMessages(const ComponentOnMessagesParams& params)
+    {
+        DM_PROFILE("RunScript");
+        UpdateResult result = UPDATE_RESULT_OK;
+        for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+        {
+            if (OnMessage(params.m_Messages[i]) != UPDATE_RESULT_OK)
+            {
+                result = UPDATE_RESULT_UNKNOWN_ERROR;
+            }
+        }
+        return result;
+    }
+
     InputResult CompScriptOnInput(const ComponentOnInputParams& params)
     {
         DM_PROFILE("RunScript");
@@ -38,6 +38,8 @@ namespace dmGameObject
 
     UpdateResult CompScriptOnMessage(const ComponentOnMessageParams& params);
 
+    UpdateResult CompScriptOnMessages(const ComponentOnMessagesParams& params);
+
     InputResult CompScriptOnInput(const ComponentOnInputParams& params);
 
     void CompScriptOnReload(const ComponentOnReloadParams& params);
@@ -116,6 +116,7 @@ void ComponentTypeSetUpdateFn(ComponentType* type, ComponentsUpdate fn)
 void ComponentTypeSetFixedUpdateFn(ComponentType* type, ComponentsFixedUpdate fn)           { type->m_FixedUpdateFunction = fn; }
 void ComponentTypeSetPostUpdateFn(ComponentType* type, ComponentsPostUpdate fn)             { type->m_PostUpdateFunction = fn; }
 void ComponentTypeSetOnMessageFn(ComponentType* type, ComponentOnMessage fn)                { type->m_OnMessageFunction = fn; }
+void ComponentTypeSetOnMessagesFn(ComponentType* type, ComponentOnMessages fn)              { type->m_OnMessagesFunction = fn; }
 void ComponentTypeSetOnInputFn(ComponentType* type, ComponentOnInput fn)                    { type->m_OnInputFunction = fn; }
 void ComponentTypeSetOnReloadFn(ComponentType* type, ComponentOnReload fn)                  { type->m_OnReloadFunction = fn; }
 void ComponentTypeSetSetPropertiesFn(ComponentType* type, ComponentSetProperties fn)        { type->m_SetPropertiesFunction = fn; }
@@ -124,6 +125,7 @@ void ComponentTypeSetSetPropertyFn(ComponentType* type, ComponentSetProperty fn)
 void ComponentTypeSetContext(ComponentType* type, void* context)                            { type->m_Context = context; }
 void ComponentTypeSetReadsTransforms(ComponentType* type, bool reads_transforms)            { type->m_ReadsTransforms = reads_transforms?1:0; }
 void ComponentTypeSetPrio(ComponentType* type, uint16_t prio)                               { type->m_UpdateOrderPrio = prio; }
+void ComponentTypeSetUpdateAccess(ComponentType* type, uint32_t reads, uint32_t writes)     { type->m_UpdateReads = reads; type->m_UpdateWrites = writes; type->m_UpdateAccessDeclared = 1; }
 void ComponentTypeSetHasUserData(ComponentType* type, bool has_user_data)                   { type->m_InstanceHasUserData = has_user_data; }
 void ComponentTypeSetChildIteratorFn(ComponentType* type, FIteratorChildren fn)             { type->m_IterChildren = fn; }
 void ComponentTypeSetPropertyIteratorFn(ComponentType* type, FIteratorProperties fn)        { type->m_IterProperties = fn; }
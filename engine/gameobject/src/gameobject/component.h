@@ -46,6 +46,7 @@ namespace dmGameObject
         ComponentsRender        m_RenderFunction;
         ComponentsPostUpdate    m_PostUpdateFunction;
         ComponentOnMessage      m_OnMessageFunction;
+        ComponentOnMessages     m_OnMessagesFunction;
         ComponentOnInput        m_OnInputFunction;
         ComponentOnReload       m_OnReloadFunction;
         ComponentSetProperties  m_SetPropertiesFunction;
@@ -56,8 +57,11 @@ namespace dmGameObject
         uint32_t                m_TypeIndex : 16;
         uint32_t                m_InstanceHasUserData : 1;
         uint32_t                m_ReadsTransforms : 1;
-        uint32_t                m_Reserved : 14;
+        uint32_t                m_UpdateAccessDeclared : 1;
+        uint32_t                m_Reserved : 13;
         uint16_t                m_UpdateOrderPrio;
+        uint8_t                 m_UpdateReads;  // ComponentUpdateAccess flags
+        uint8_t                 m_UpdateWrites; // ComponentUpdateAccess flags
     };
 
     /*#
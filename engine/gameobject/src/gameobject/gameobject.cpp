@@ -24,8 +24,11 @@
 #include <dlib/index_pool.h>
 #include <dlib/profile.h>
 #include <dlib/math.h>
+#include <dlib/memprofile.h>
 #include <dlib/vmath.h>
 #include <dlib/mutex.h>
+#include <dlib/thread.h>
+#include <dmsdk/dlib/align.h>
 #include <dmsdk/dlib/vmath.h>
 #include <ddf/ddf.h>
 #include "gameobject.h"
@@ -45,7 +48,8 @@ namespace dmGameObject
 {
     const char* COLLECTION_MAX_INSTANCES_KEY = "collection.max_instances";
     const char* COLLECTION_MAX_INPUT_STACK_ENTRIES_KEY = "collection.max_input_stack_entries";
-    const dmhash_t UNNAMED_IDENTIFIER = dmHashBuffer64("__unnamed__", strlen("__unnamed__"));
+    const char* COLLECTION_UPDATE_THREADS_KEY = "collection.update_threads";
+    const dmhash_t UNNAMED_IDENTIFIER = dmHashConstString64("__unnamed__");
     const char* ID_SEPARATOR = "/";
     const uint32_t MAX_DISPATCH_ITERATION_COUNT = 10;
 
@@ -54,20 +58,20 @@ namespace dmGameObject
     static void Unlink(Collection* collection, Instance* instance);
 
 #define PROP_FLOAT(var_name, prop_name)\
-    const dmhash_t PROP_##var_name = dmHashString64(#prop_name);\
+    const dmhash_t PROP_##var_name = dmHashConstString64(#prop_name);\
 
 #define PROP_VECTOR3(var_name, prop_name)\
-    const dmhash_t PROP_##var_name = dmHashString64(#prop_name);\
-    const dmhash_t PROP_##var_name##_X = dmHashString64(#prop_name ".x");\
-    const dmhash_t PROP_##var_name##_Y = dmHashString64(#prop_name ".y");\
-    const dmhash_t PROP_##var_name##_Z = dmHashString64(#prop_name ".z");
+    const dmhash_t PROP_##var_name = dmHashConstString64(#prop_name);\
+    const dmhash_t PROP_##var_name##_X = dmHashConstString64(#prop_name ".x");\
+    const dmhash_t PROP_##var_name##_Y = dmHashConstString64(#prop_name ".y");\
+    const dmhash_t PROP_##var_name##_Z = dmHashConstString64(#prop_name ".z");
 
 #define PROP_QUAT(var_name, prop_name)\
-    const dmhash_t PROP_##var_name = dmHashString64(#prop_name);\
-    const dmhash_t PROP_##var_name##_X = dmHashString64(#prop_name ".x");\
-    const dmhash_t PROP_##var_name##_Y = dmHashString64(#prop_name ".y");\
-    const dmhash_t PROP_##var_name##_Z = dmHashString64(#prop_name ".z");\
-    const dmhash_t PROP_##var_name##_W = dmHashString64(#prop_name ".w");
+    const dmhash_t PROP_##var_name = dmHashConstString64(#prop_name);\
+    const dmhash_t PROP_##var_name##_X = dmHashConstString64(#prop_name ".x");\
+    const dmhash_t PROP_##var_name##_Y = dmHashConstString64(#prop_name ".y");\
+    const dmhash_t PROP_##var_name##_Z = dmHashConstString64(#prop_name ".z");\
+    const dmhash_t PROP_##var_name##_W = dmHashConstString64(#prop_name ".w");
 
     PROP_VECTOR3(POSITION, position);
     PROP_QUAT(ROTATION, rotation);
@@ -173,11 +177,16 @@ namespace dmGameObject
         m_ComponentTypeCount = 0;
         m_DefaultCollectionCapacity = DEFAULT_MAX_COLLECTION_CAPACITY;
         m_DefaultInputStackCapacity = DEFAULT_MAX_INPUT_STACK_CAPACITY;
+        m_UpdateScheduler = 0;
         m_Mutex = dmMutex::New();
     }
 
     Register::~Register()
     {
+        if (m_UpdateScheduler)
+        {
+            DeleteUpdateScheduler(m_UpdateScheduler);
+        }
         dmMutex::Delete(m_Mutex);
     }
 
@@ -206,7 +215,7 @@ namespace dmGameObject
         m_InstanceIndices.SetCapacity(max_instances);
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
-        m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
+        m_IDToInstance.SetCapacity(max_instances);
         m_InputFocusStack.SetCapacity(max_input_stack_entries);
         m_NameHash = 0;
         m_ComponentSocket = 0;
@@ -234,6 +243,7 @@ namespace dmGameObject
         memset(&m_Instances[0], 0, sizeof(Instance*) * max_instances);
         memset(&m_WorldTransforms[0], 0xcc, sizeof(dmTransform::Transform) * max_instances);
         memset(&m_LevelIndices[0], 0, sizeof(m_LevelIndices));
+        memset(m_FreeInstances, 0, sizeof(m_FreeInstances));
     }
 
     Result SetCollectionDefaultCapacity(HRegister regist, uint32_t capacity)
@@ -245,12 +255,31 @@ namespace dmGameObject
         return RESULT_OK;
     }
 
+    uint32_t GetInstanceIndexBits()
+    {
+        return DM_GAMEOBJECT_INSTANCE_INDEX_BITS;
+    }
+
     uint32_t GetCollectionDefaultCapacity(HRegister regist)
     {
         assert(regist != 0x0);
         return regist->m_DefaultCollectionCapacity;
     }
 
+    void SetComponentUpdateThreadCount(HRegister regist, uint32_t thread_count)
+    {
+        assert(regist != 0x0);
+        if (regist->m_UpdateScheduler)
+        {
+            DeleteUpdateScheduler(regist->m_UpdateScheduler);
+            regist->m_UpdateScheduler = 0;
+        }
+        if (thread_count > 0 && dmThread::PlatformHasThreadSupport())
+        {
+            regist->m_UpdateScheduler = NewUpdateScheduler(thread_count);
+        }
+    }
+
     void SetInputStackDefaultCapacity(HRegister regist, uint32_t capacity)
     {
         assert(regist != 0x0);
@@ -379,6 +408,12 @@ namespace dmGameObject
                 regist->m_ComponentTypes[i].m_DeleteWorldFunction(params);
         }
         dmMutex::Delete(collection->m_Mutex);
+
+        for (uint32_t i = 0; i < collection->m_InstanceSlabs.Size(); ++i)
+        {
+            operator delete (collection->m_InstanceSlabs[i]);
+        }
+
         delete collection;
     }
 
@@ -666,12 +701,12 @@ namespace dmGameObject
          * Remove instance from m_LevelIndices using an erase-swap operation
          */
 
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<InstanceIndex>& level = collection->m_LevelIndices[instance->m_Depth];
         assert(level.Size() > 0);
         assert(instance->m_LevelIndex < level.Size());
 
-        uint16_t level_index = instance->m_LevelIndex;
-        uint16_t swap_in_index = level.EraseSwap(level_index);
+        InstanceIndex level_index = instance->m_LevelIndex;
+        InstanceIndex swap_in_index = level.EraseSwap(level_index);
         HInstance swap_in_instance = collection->m_Instances[swap_in_index];
         assert(swap_in_instance->m_Index == swap_in_index);
         swap_in_instance->m_LevelIndex = level_index;
@@ -683,7 +718,7 @@ namespace dmGameObject
      * ** 10 elements as min
      * ** Up to max_instances as max
      */
-    static void ExpandLevel(dmArray<uint16_t>& level, uint32_t max_instances)
+    static void ExpandLevel(dmArray<InstanceIndex>& level, uint32_t max_instances)
     {
         const uint32_t min_offset = 10;
         const uint32_t max_offset = max_instances - level.Capacity();
@@ -696,18 +731,71 @@ namespace dmGameObject
         /*
          * Insert instance in m_LevelIndices at level set in instance->m_Depth
          */
-        dmArray<uint16_t>& level = collection->m_LevelIndices[instance->m_Depth];
+        dmArray<InstanceIndex>& level = collection->m_LevelIndices[instance->m_Depth];
         if (level.Full())
             ExpandLevel(level, collection->m_MaxInstances);
         assert(!level.Full());
 
-        uint16_t level_index = (uint16_t)level.Size();
+        InstanceIndex level_index = (InstanceIndex)level.Size();
         level.SetSize(level_index + 1);
         level[level_index] = instance->m_Index;
         instance->m_LevelIndex = level_index;
     }
 
-    static HInstance AllocInstance(Prototype* proto, const char* prototype_name) {
+    static inline uint32_t GetInstanceMemorySize(uint32_t component_instance_userdata_count)
+    {
+        uint32_t component_userdata_size = sizeof(((Instance*)0)->m_ComponentInstanceUserData[0]);
+        return DM_ALIGN(sizeof(Instance) + component_instance_userdata_count * component_userdata_size, 16);
+    }
+
+    // Instances with few component user data fields are allocated from slabs owned by the collection, one free list
+    // per user data count. Freed memory goes back to the free list of the collection, and the slabs themselves are
+    // only released when the collection is deleted. A collection therefore keeps the memory of its peak instance count.
+    void* AllocInstanceMemory(Collection* collection, uint32_t component_instance_userdata_count)
+    {
+        uint32_t memory_size = GetInstanceMemorySize(component_instance_userdata_count);
+        if (component_instance_userdata_count > MAX_SLAB_INSTANCE_USER_DATA_COUNT)
+        {
+            return ::operator new (memory_size);
+        }
+
+        void*& free_list = collection->m_FreeInstances[component_instance_userdata_count];
+        if (!free_list)
+        {
+            uint8_t* slab = (uint8_t*) ::operator new (memory_size * INSTANCE_SLAB_SIZE);
+            if (collection->m_InstanceSlabs.Full())
+            {
+                collection->m_InstanceSlabs.OffsetCapacity(16);
+            }
+            collection->m_InstanceSlabs.Push(slab);
+
+            for (uint32_t i = INSTANCE_SLAB_SIZE; i > 0; --i)
+            {
+                void* memory = slab + (i - 1) * memory_size;
+                *(void**) memory = free_list;
+                free_list = memory;
+            }
+        }
+
+        void* memory = free_list;
+        free_list = *(void**) memory;
+        return memory;
+    }
+
+    void FreeInstanceMemory(Collection* collection, void* memory, uint32_t component_instance_userdata_count)
+    {
+        if (component_instance_userdata_count > MAX_SLAB_INSTANCE_USER_DATA_COUNT)
+        {
+            operator delete (memory);
+            return;
+        }
+
+        void*& free_list = collection->m_FreeInstances[component_instance_userdata_count];
+        *(void**) memory = free_list;
+        free_list = memory;
+    }
+
+    static HInstance AllocInstance(Collection* collection, Prototype* proto, const char* prototype_name) {
         // Count number of component userdata fields required
         uint32_t component_instance_userdata_count = 0;
         for (uint32_t i = 0; i < proto->m_ComponentCount; ++i)
@@ -723,15 +811,15 @@ namespace dmGameObject
                 component_instance_userdata_count++;
         }
 
-        uint32_t component_userdata_size = sizeof(((Instance*)0)->m_ComponentInstanceUserData[0]);
         // NOTE: Allocate actual Instance with *all* component instance user-data accounted
-        void* instance_memory = ::operator new (sizeof(Instance) + component_instance_userdata_count * component_userdata_size);
+        void* instance_memory = AllocInstanceMemory(collection, component_instance_userdata_count);
         Instance* instance = new(instance_memory) Instance(proto);
         instance->m_ComponentInstanceUserDataCount = component_instance_userdata_count;
         return instance;
     }
 
-    static void DeallocInstance(HInstance instance) {
+    static void DeallocInstance(Collection* collection, HInstance instance) {
+        uint32_t component_instance_userdata_count = instance->m_ComponentInstanceUserDataCount;
         instance->~Instance();
         void* instance_memory = (void*) instance;
 
@@ -739,7 +827,7 @@ namespace dmGameObject
         // TODO: #ifdef on something...?
         // Clear all memory excluding ComponentInstanceUserData
         memset(instance_memory, 0xcc, sizeof(Instance));
-        operator delete (instance_memory);
+        FreeInstanceMemory(collection, instance_memory, component_instance_userdata_count);
     }
 
     HInstance NewInstance(Collection* collection, Prototype* proto, const char* prototype_name) {
@@ -748,10 +836,10 @@ namespace dmGameObject
             dmLogError("The game object instance could not be created since the buffer is full (%d). Increase the capacity with collection.max_instances", collection->m_InstanceIndices.Capacity());
             return 0;
         }
-        HInstance instance = AllocInstance(proto, prototype_name);
+        HInstance instance = AllocInstance(collection, proto, prototype_name);
         instance->m_Collection = collection;
         instance->m_ScaleAlongZ = collection->m_ScaleAlongZ;
-        uint16_t instance_index = collection->m_InstanceIndices.Pop();
+        InstanceIndex instance_index = collection->m_InstanceIndices.Pop();
         instance->m_Index = instance_index;
         assert(collection->m_Instances[instance_index] == 0);
         collection->m_Instances[instance_index] = instance;
@@ -776,8 +864,8 @@ namespace dmGameObject
             Unlink(collection, instance);
         }
 
-        uint16_t instance_index = instance->m_Index;
-        operator delete ((void*)instance);
+        InstanceIndex instance_index = instance->m_Index;
+        DeallocInstance(collection, instance);
         collection->m_Instances[instance_index] = 0x0;
         collection->m_InstanceIndices.Push(instance_index);
         assert(collection->m_IDToInstance.Size() <= collection->m_InstanceIndices.Size());
@@ -787,6 +875,33 @@ namespace dmGameObject
         UndoNewInstance(hcollection->m_Collection, instance);
     }
 
+    // Destroys the first 'components_created' components of an instance whose creation failed
+    static void DestroyCreatedComponents(Collection* collection, HInstance instance, uint32_t components_created)
+    {
+        Prototype* proto = instance->m_Prototype;
+        uint32_t next_component_instance_data = 0;
+        for (uint32_t i = 0; i < components_created; ++i)
+        {
+            Prototype::Component* component = &proto->m_Components[i];
+            ComponentType* component_type = component->m_Type;
+            assert(component_type);
+            uintptr_t* component_instance_data = 0;
+            if (component_type->m_InstanceHasUserData)
+            {
+                component_instance_data = &instance->m_ComponentInstanceUserData[next_component_instance_data++];
+            }
+            assert(next_component_instance_data <= instance->m_ComponentInstanceUserDataCount);
+
+            ComponentDestroyParams params;
+            params.m_Collection = collection->m_HCollection;
+            params.m_Instance = instance;
+            params.m_World = collection->m_ComponentWorlds[component->m_TypeIndex];
+            params.m_Context = component_type->m_Context;
+            params.m_UserData = component_instance_data;
+            component_type->m_DestroyFunction(params);
+        }
+    }
+
     bool CreateComponents(Collection* collection, HInstance instance) {
         DM_PROFILE("CreateComponents");
 
@@ -825,6 +940,7 @@ namespace dmGameObject
             params.m_Context = component_type->m_Context;
             params.m_UserData = component_instance_data;
             params.m_PropertySet = component->m_PropertySet;
+            DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_COMPONENT);
             CreateResult create_result =  component_type->m_CreateFunction(params);
             if (create_result == CREATE_RESULT_OK)
             {
@@ -839,34 +955,88 @@ namespace dmGameObject
 
         if (!ok)
         {
-            uint32_t next_component_instance_data = 0;
-            for (uint32_t i = 0; i < components_created; ++i)
+            DestroyCreatedComponents(collection, instance, components_created);
+        }
+
+        return ok;
+    }
+
+    bool CreateComponents(HCollection hcollection, HInstance instance) {
+        return CreateComponents(hcollection->m_Collection, instance);
+    }
+
+    // Creates the components of instances sharing the same prototype, one component type at a time.
+    // Instances that fail are removed and their entry in 'instances' is set to 0.
+    static void CreateComponentsBatch(Collection* collection, Prototype* proto, HInstance* instances, uint32_t count)
+    {
+        DM_PROFILE("CreateComponents");
+
+        if (proto->m_ComponentCount > 0xFFFF ) {
+            dmLogWarning("Too many components in game object: %u (max is 65536)", proto->m_ComponentCount);
+            for (uint32_t j = 0; j < count; ++j)
             {
-                Prototype::Component* component = &proto->m_Components[i];
-                ComponentType* component_type = component->m_Type;
-                assert(component_type);
+                if (instances[j])
+                {
+                    ReleaseIdentifier(collection, instances[j]);
+                    UndoNewInstance(collection, instances[j]);
+                    instances[j] = 0;
+                }
+            }
+            return;
+        }
+
+        uint32_t next_component_instance_data = 0;
+        for (uint32_t i = 0; i < proto->m_ComponentCount; ++i)
+        {
+            Prototype::Component* component = &proto->m_Components[i];
+            ComponentType* component_type = component->m_Type;
+            assert(component_type);
+
+            DM_PROFILE_DYN(component_type->m_Name, 0);
+
+            uint32_t component_instance_data_index = next_component_instance_data;
+            if (component_type->m_InstanceHasUserData)
+            {
+                next_component_instance_data++;
+            }
+
+            ComponentCreateParams params;
+            params.m_Position = component->m_Position;
+            params.m_Rotation = component->m_Rotation;
+            params.m_Scale = component->m_Scale;
+            params.m_ComponentIndex = i;
+            params.m_Resource = component->m_Resource;
+            params.m_World = collection->m_ComponentWorlds[component->m_TypeIndex];
+            params.m_Context = component_type->m_Context;
+            params.m_PropertySet = component->m_PropertySet;
+
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                HInstance instance = instances[j];
+                if (!instance)
+                    continue;
+
                 uintptr_t* component_instance_data = 0;
                 if (component_type->m_InstanceHasUserData)
                 {
-                    component_instance_data = &instance->m_ComponentInstanceUserData[next_component_instance_data++];
+                    assert(component_instance_data_index < instance->m_ComponentInstanceUserDataCount);
+                    component_instance_data = &instance->m_ComponentInstanceUserData[component_instance_data_index];
+                    *component_instance_data = 0;
                 }
-                assert(next_component_instance_data <= instance->m_ComponentInstanceUserDataCount);
 
-                ComponentDestroyParams params;
-                params.m_Collection = collection->m_HCollection;
                 params.m_Instance = instance;
-                params.m_World = collection->m_ComponentWorlds[component->m_TypeIndex];
-                params.m_Context = component_type->m_Context;
                 params.m_UserData = component_instance_data;
-                component_type->m_DestroyFunction(params);
+                DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_COMPONENT);
+                CreateResult create_result = component_type->m_CreateFunction(params);
+                if (create_result != CREATE_RESULT_OK)
+                {
+                    DestroyCreatedComponents(collection, instance, i);
+                    ReleaseIdentifier(collection, instance);
+                    UndoNewInstance(collection, instance);
+                    instances[j] = 0;
+                }
             }
         }
-
-        return ok;
-    }
-
-    bool CreateComponents(HCollection hcollection, HInstance instance) {
-        return CreateComponents(hcollection->m_Collection, instance);
     }
 
     static void DestroyComponents(Collection* collection, HInstance instance) {
@@ -955,6 +1125,24 @@ namespace dmGameObject
         return index;
     }
 
+    uint32_t AcquireInstanceIndices(HCollection hcollection, uint32_t count, uint32_t* out_indices)
+    {
+        Collection* collection = hcollection->m_Collection;
+        dmMutex::Lock(collection->m_Mutex);
+        uint32_t remaining = collection->m_InstanceIdPool.Remaining();
+        if (count > remaining)
+        {
+            count = remaining;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            out_indices[i] = collection->m_InstanceIdPool.Pop();
+        }
+        dmMutex::Unlock(collection->m_Mutex);
+
+        return count;
+    }
+
     void ReleaseInstanceIndex(uint32_t index, Collection* collection)
     {
         dmMutex::Lock(collection->m_Mutex);
@@ -1023,8 +1211,8 @@ namespace dmGameObject
             return;
         }
         instance->m_ToBeAdded = 1;
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToAddTail;
+        InstanceIndex index = instance->m_Index;
+        InstanceIndex tail = collection->m_InstancesToAddTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToAdd = index;
@@ -1084,7 +1272,7 @@ namespace dmGameObject
             dmLogError("Instances can not be added to update during the update.");
             return false;
         }
-        uint16_t index = collection->m_InstancesToAddHead;
+        InstanceIndex index = collection->m_InstancesToAddHead;
         bool result = true;
         while (index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[index];
@@ -1194,6 +1382,75 @@ namespace dmGameObject
         return instance;
     }
 
+    // Each spawned instance holds its own reference to 'proto'. The reference of the caller is not released.
+    static uint32_t SpawnBatchInternal(Collection* collection, Prototype *proto, const char *prototype_name, uint32_t count, const dmhash_t* ids, uint8_t* property_buffer, uint32_t property_buffer_size, const Point3* positions, const Quat* rotations, const Vector3& scale, HInstance* out_instances)
+    {
+        memset(out_instances, 0, sizeof(HInstance) * count);
+        if (collection->m_ToBeDeleted) {
+            dmLogWarning("Spawning is not allowed when the collection is being deleted.");
+            return 0;
+        }
+
+        if (collection->m_InstanceIndices.Remaining() < count)
+        {
+            dmLogError("The game object instances could not be created since the buffer is full (%d). Increase the capacity with collection.max_instances", collection->m_InstanceIndices.Capacity());
+            return 0;
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            HInstance instance = dmGameObject::NewInstance(collection, proto, prototype_name);
+            assert(instance != 0);
+
+            dmResource::IncRef(collection->m_Factory, proto);
+
+            SetPosition(instance, positions[i]);
+            SetRotation(instance, rotations[i]);
+            SetScale(instance, scale);
+            collection->m_WorldTransforms[instance->m_Index] = dmTransform::ToMatrix4(instance->m_Transform);
+
+            dmHashInit64(&instance->m_CollectionPathHashState, true);
+            dmHashUpdateBuffer64(&instance->m_CollectionPathHashState, ID_SEPARATOR, strlen(ID_SEPARATOR));
+
+            Result result = SetIdentifier(collection, instance, ids[i]);
+            if (result == RESULT_IDENTIFIER_IN_USE)
+            {
+                dmLogError("The identifier '%s' is already in use.", dmHashReverseSafe64(ids[i]));
+                UndoNewInstance(collection, instance);
+                continue;
+            }
+            out_instances[i] = instance;
+        }
+
+        CreateComponentsBatch(collection, proto, out_instances, count);
+
+        uint32_t spawned_count = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            HInstance instance = out_instances[i];
+            if (!instance)
+                continue;
+
+            bool success = SetScriptPropertiesFromBuffer(instance, prototype_name, property_buffer, property_buffer_size);
+
+            if (success && !InitInstance(collection, instance))
+            {
+                dmLogError("Could not initialize when spawning %s.", prototype_name);
+                success = false;
+            }
+
+            if (success) {
+                AddToUpdate(collection, instance);
+                spawned_count++;
+            } else {
+                Delete(collection, instance, false);
+                out_instances[i] = 0;
+            }
+        }
+
+        return spawned_count;
+    }
+
     static void Unlink(Collection* collection, Instance* instance)
     {
         // Unlink "me" from parent
@@ -1311,6 +1568,19 @@ namespace dmGameObject
         dmArray<HInstance> new_instances;
         new_instances.SetCapacity(collection_desc->m_Instances.m_Count);
 
+        // The instance ids are looked up in several passes below, hash them once up front
+        uint32_t instance_count = collection_desc->m_Instances.m_Count;
+        dmArray<const char*> instance_id_strings;
+        instance_id_strings.SetCapacity(instance_count);
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            instance_id_strings.Push(collection_desc->m_Instances[i].m_Id);
+        }
+        dmArray<dmhash_t> instance_ids;
+        instance_ids.SetCapacity(instance_count);
+        instance_ids.SetSize(instance_count);
+        dmHashStrings64(instance_id_strings.Begin(), instance_count, instance_ids.Begin());
+
         bool success = true;
 
         for (uint32_t i = 0; i < collection_desc->m_Instances.m_Count; ++i)
@@ -1361,8 +1631,7 @@ namespace dmGameObject
             dmHashClone64(&new_id_hs, &prefixHashState, true);
             dmHashUpdateBuffer64(&new_id_hs, instance_desc.m_Id, strlen(instance_desc.m_Id));
             dmhash_t new_id = dmHashFinal64(&new_id_hs);
-            dmhash_t id = dmHashBuffer64(instance_desc.m_Id, strlen(instance_desc.m_Id));
-            id_mapping->Put(id, new_id);
+            id_mapping->Put(instance_ids[i], new_id);
             new_instances.Push(instance);
 
             if (dmGameObject::SetIdentifier(collection, instance, new_id) != dmGameObject::RESULT_OK)
@@ -1380,7 +1649,7 @@ namespace dmGameObject
             {
                 const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
 
-                dmhash_t *parent_id = id_mapping->Get(dmHashString64(instance_desc.m_Id));
+                dmhash_t *parent_id = id_mapping->Get(instance_ids[i]);
                 assert(parent_id);
 
                 dmGameObject::HInstance parent = dmGameObject::GetInstanceFromIdentifier(collection, *parent_id);
@@ -1455,7 +1724,7 @@ namespace dmGameObject
         {
             const dmGameObjectDDF::InstanceDesc& instance_desc = collection_desc->m_Instances[i];
 
-            dmhash_t *instance_id = id_mapping->Get(dmHashString64(instance_desc.m_Id));
+            dmhash_t *instance_id = id_mapping->Get(instance_ids[i]);
             assert(instance_id);
 
             dmGameObject::HInstance instance = dmGameObject::GetInstanceFromIdentifier(collection, *instance_id);
@@ -1497,7 +1766,7 @@ namespace dmGameObject
                         }
 
                         HPropertyContainer lua_properties = 0x0;
-                        InstancePropertyBuffer *instance_properties = property_buffers->Get(dmHashString64(instance_desc.m_Id));
+                        InstancePropertyBuffer *instance_properties = property_buffers->Get(instance_ids[i]);
                         if (instance_properties != 0x0)
                         {
                             if (strcmp(type->m_Name, "scriptc") == 0)
@@ -1635,6 +1904,23 @@ namespace dmGameObject
         return instance;
     }
 
+    uint32_t SpawnBatch(HCollection hcollection, HPrototype proto, const char* prototype_name, uint32_t count, const dmhash_t* ids, uint8_t* property_buffer, uint32_t property_buffer_size, const Point3* positions, const Quat* rotations, const Vector3& scale, HInstance* out_instances)
+    {
+        if (proto == 0x0) {
+            dmLogError("No prototype to spawn from.");
+            memset(out_instances, 0, sizeof(HInstance) * count);
+            return 0;
+        }
+
+        uint32_t spawned_count = SpawnBatchInternal(hcollection->m_Collection, proto, prototype_name, count, ids, property_buffer, property_buffer_size, positions, rotations, scale, out_instances);
+
+        if (spawned_count != count) {
+            dmLogError("Could only spawn %u of %u instances of prototype %s.", spawned_count, count, prototype_name);
+        }
+
+        return spawned_count;
+    }
+
     static void MoveDown(Collection* collection, Instance* instance)
     {
         /*
@@ -1891,8 +2177,8 @@ namespace dmGameObject
         // Delete instance
         instance->m_ToBeDeleted = 1;
 
-        uint16_t index = instance->m_Index;
-        uint16_t tail = collection->m_InstancesToDeleteTail;
+        InstanceIndex index = instance->m_Index;
+        InstanceIndex tail = collection->m_InstancesToDeleteTail;
         if (tail != INVALID_INSTANCE_INDEX) {
             HInstance tail_instance = collection->m_Instances[tail];
             tail_instance->m_NextToDelete = index;
@@ -1909,10 +2195,10 @@ namespace dmGameObject
 
     static void RemoveFromAddToUpdate(Collection* collection, HInstance instance)
     {
-        uint16_t index = instance->m_Index;
+        InstanceIndex index = instance->m_Index;
         assert(collection->m_InstancesToAddTail == index || instance->m_NextToAdd != INVALID_INSTANCE_INDEX);
-        uint16_t* prev_index_ptr = &collection->m_InstancesToAddHead;
-        uint16_t prev_index = *prev_index_ptr;
+        InstanceIndex* prev_index_ptr = &collection->m_InstancesToAddHead;
+        InstanceIndex prev_index = *prev_index_ptr;
         while (prev_index != index) {
             prev_index_ptr = &collection->m_Instances[prev_index]->m_NextToAdd;
             if (collection->m_InstancesToAddTail == *prev_index_ptr) {
@@ -1989,7 +2275,7 @@ namespace dmGameObject
             collection->m_InputFocusStack.Pop();
         }
 
-        DeallocInstance(instance);
+        DeallocInstance(collection, instance);
 
         assert(collection->m_IDToInstance.Size() <= collection->m_InstanceIndices.Size());
     }
@@ -2100,11 +2386,11 @@ namespace dmGameObject
         return instance->m_Bone;
     }
 
-    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, uint16_t first_index, dmTransform::Transform* transforms, uint32_t transform_count)
+    static uint32_t DoSetBoneTransforms(HCollection hcollection, dmTransform::Transform* component_transform, InstanceIndex first_index, dmTransform::Transform* transforms, uint32_t transform_count)
     {
         if (transform_count == 0)
             return 0;
-        uint16_t current_index = first_index;
+        InstanceIndex current_index = first_index;
         uint32_t count = 0;
         Collection* collection = hcollection->m_Collection;
         while (current_index != INVALID_INSTANCE_INDEX)
@@ -2135,8 +2421,8 @@ namespace dmGameObject
         return DoSetBoneTransforms(instance->m_Collection->m_HCollection, &component_transform, instance->m_Index, transforms, transform_count);
     }
 
-    static void DeleteBones(Collection* collection, uint16_t first_index) {
-        uint16_t current_index = first_index;
+    static void DeleteBones(Collection* collection, InstanceIndex first_index) {
+        InstanceIndex current_index = first_index;
         while (current_index != INVALID_INSTANCE_INDEX) {
             HInstance instance = collection->m_Instances[current_index];
             if (instance->m_Bone && instance->m_ToBeDeleted == 0) {
@@ -2152,15 +2438,94 @@ namespace dmGameObject
         return DeleteBones(parent->m_Collection, parent->m_FirstChildIndex);
     }
 
+    static const uint32_t MAX_MESSAGE_BATCH_SIZE = 32;
+
     struct DispatchMessagesContext
     {
-        Collection* m_Collection;
-        bool m_Success;
+        Collection*              m_Collection;
+        // Pending consecutive messages to the same component
+        ComponentType*           m_BatchType;
+        ComponentOnMessageParams m_Batch[MAX_MESSAGE_BATCH_SIZE];
+        uint32_t                 m_BatchCount;
+        bool                     m_Success;
     };
 
-    void DispatchMessagesFunction(dmMessage::Message* message, void* user_ptr)
+    static void FlushMessageBatch(DispatchMessagesContext* context)
+    {
+        uint32_t count = context->m_BatchCount;
+        if (count == 0)
+        {
+            return;
+        }
+        ComponentType* component_type = context->m_BatchType;
+        context->m_BatchCount = 0;
+        context->m_BatchType = 0;
+
+        if (component_type->m_OnMessagesFunction)
+        {
+            DM_PROFILE("OnMessagesFunction");
+            ComponentOnMessagesParams params;
+            params.m_World = context->m_Batch[0].m_World;
+            params.m_Context = component_type->m_Context;
+            params.m_Messages = context->m_Batch;
+            params.m_MessageCount = count;
+            UpdateResult res = component_type->m_OnMessagesFunction(params);
+            if (res != UPDATE_RESULT_OK)
+                context->m_Success = false;
+            return;
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            DM_PROFILE("OnMessageFunction");
+            UpdateResult res = component_type->m_OnMessageFunction(context->m_Batch[i]);
+            if (res != UPDATE_RESULT_OK)
+                context->m_Success = false;
+        }
+    }
+
+    // Appends the message to the pending batch if it's sent to the same component as the previous
+    // message of the batch. No user code runs while the batch is pending, so the component resolved
+    // for the previous message is still valid. Batching skips the receiver lookup for every message
+    // but the first, also for component types without an on-messages callback.
+    static bool AppendToMessageBatch(DispatchMessagesContext* context, dmMessage::Message* message)
     {
-        DispatchMessagesContext* context = (DispatchMessagesContext*) user_ptr;
+        uint32_t count = context->m_BatchCount;
+        if (count == 0 || count == MAX_MESSAGE_BATCH_SIZE || message->m_DestroyCallback != 0)
+        {
+            return false;
+        }
+        const ComponentOnMessageParams& last = context->m_Batch[count - 1];
+        const dmMessage::URL& receiver = message->m_Receiver;
+        const dmMessage::URL& last_receiver = last.m_Message->m_Receiver;
+        if (receiver.m_Fragment == 0 || receiver.m_Fragment != last_receiver.m_Fragment || receiver.m_Path != last_receiver.m_Path)
+        {
+            return false;
+        }
+        // Handled by the game object itself
+        if (message->m_Descriptor == (uintptr_t)dmGameObjectDDF::AcquireInputFocus::m_DDFDescriptor ||
+            message->m_Descriptor == (uintptr_t)dmGameObjectDDF::ReleaseInputFocus::m_DDFDescriptor ||
+            message->m_Descriptor == (uintptr_t)dmGameObjectDDF::SetParent::m_DDFDescriptor)
+        {
+            return false;
+        }
+
+        ComponentOnMessageParams& params = context->m_Batch[context->m_BatchCount++];
+        params = last;
+        params.m_Message = message;
+        return true;
+    }
+
+    static void DispatchMessage(DispatchMessagesContext* context, dmMessage::Message* message)
+    {
+        if (AppendToMessageBatch(context, message))
+        {
+            return;
+        }
+        // The batch may run user code that deletes the receiver of this message, so it's delivered
+        // before the receiver is resolved
+        FlushMessageBatch(context);
+
         Collection* collection = context->m_Collection;
 
         Instance* instance = 0x0;
@@ -2286,7 +2651,9 @@ namespace dmGameObject
             ComponentType* component_type = component->m_Type;
             assert(component_type);
 
-            if (component_type->m_OnMessageFunction)
+            // Messages with a destroy callback have their payload released as soon as this function returns
+            bool batch = message->m_DestroyCallback == 0 && (component_type->m_OnMessagesFunction || component_type->m_OnMessageFunction);
+            if (component_type->m_OnMessageFunction || batch)
             {
                 // TODO: Not optimal way to find index of component instance data
                 uint32_t next_component_instance_data = 0;
@@ -2305,6 +2672,17 @@ namespace dmGameObject
                 {
                     component_instance_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
                 }
+                if (batch)
+                {
+                    ComponentOnMessageParams& params = context->m_Batch[context->m_BatchCount++];
+                    params.m_Instance = instance;
+                    params.m_World = collection->m_ComponentWorlds[component->m_TypeIndex];
+                    params.m_Context = component_type->m_Context;
+                    params.m_UserData = component_instance_data;
+                    params.m_Message = message;
+                    context->m_BatchType = component_type;
+                }
+                else
                 {
                     DM_PROFILE("OnMessageFunction");
                     ComponentOnMessageParams params;
@@ -2364,12 +2742,25 @@ namespace dmGameObject
         }
     }
 
+    void DispatchMessagesFunction(dmMessage::Message* message, void* user_ptr)
+    {
+        DispatchMessage((DispatchMessagesContext*) user_ptr, message);
+    }
+
+    // The message memory is reclaimed when the dispatch returns, so the pending batch is delivered here
+    static void DispatchMessagesEnd(void* user_ptr)
+    {
+        FlushMessageBatch((DispatchMessagesContext*) user_ptr);
+    }
+
     static bool DispatchMessages(Collection* collection, dmMessage::HSocket* sockets, uint32_t socket_count)
     {
         DM_PROFILE("DispatchMessages");
 
         DispatchMessagesContext ctx;
         ctx.m_Collection = collection;
+        ctx.m_BatchType = 0;
+        ctx.m_BatchCount = 0;
         ctx.m_Success = true;
         bool iterate = true;
         uint32_t iteration_count = 0;
@@ -2387,7 +2778,7 @@ namespace dmGameObject
                 {
                     UpdateTransforms(collection);
                 }
-                uint32_t message_count = dmMessage::Dispatch(sockets[i], &DispatchMessagesFunction, (void*) &ctx);
+                uint32_t message_count = dmMessage::Dispatch(sockets[i], &DispatchMessagesFunction, &DispatchMessagesEnd, (void*) &ctx);
                 if (message_count)
                 {
                     collection->m_DirtyTransforms = true;
@@ -2433,15 +2824,15 @@ namespace dmGameObject
 
         // Calculate world transforms
         // First root-level instances
-        dmArray<uint16_t>& root_level = collection->m_LevelIndices[0];
+        dmArray<InstanceIndex>& root_level = collection->m_LevelIndices[0];
         uint32_t root_count = root_level.Size();
         for (uint32_t i = 0; i < root_count; ++i)
         {
-            uint16_t index = root_level[i];
+            InstanceIndex index = root_level[i];
             Instance* instance = collection->m_Instances[index];
             CheckEuler(instance);
             collection->m_WorldTransforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
-            uint16_t parent_index = instance->m_Parent;
+            InstanceIndex parent_index = instance->m_Parent;
             assert(parent_index == INVALID_INSTANCE_INDEX);
         }
 
@@ -2449,16 +2840,16 @@ namespace dmGameObject
         if (collection->m_ScaleAlongZ) {
             for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
             {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+                dmArray<InstanceIndex>& level = collection->m_LevelIndices[level_i];
                 uint32_t instance_count = level.Size();
                 for (uint32_t i = 0; i < instance_count; ++i)
                 {
-                    uint16_t index = level[i];
+                    InstanceIndex index = level[i];
                     Instance* instance = collection->m_Instances[index];
                     CheckEuler(instance);
                     Matrix4* trans = &collection->m_WorldTransforms[index];
 
-                    uint16_t parent_index = instance->m_Parent;
+                    InstanceIndex parent_index = instance->m_Parent;
                     assert(parent_index != INVALID_INSTANCE_INDEX);
 
                     Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
@@ -2469,16 +2860,16 @@ namespace dmGameObject
         } else {
             for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
             {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+                dmArray<InstanceIndex>& level = collection->m_LevelIndices[level_i];
                 uint32_t instance_count = level.Size();
                 for (uint32_t i = 0; i < instance_count; ++i)
                 {
-                    uint16_t index = level[i];
+                    InstanceIndex index = level[i];
                     Instance* instance = collection->m_Instances[index];
                     CheckEuler(instance);
                     Matrix4* trans = &collection->m_WorldTransforms[index];
 
-                    uint16_t parent_index = instance->m_Parent;
+                    InstanceIndex parent_index = instance->m_Parent;
                     assert(parent_index != INVALID_INSTANCE_INDEX);
 
                     Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
@@ -2496,10 +2887,169 @@ namespace dmGameObject
         UpdateTransforms(hcollection->m_Collection);
     }
 
+    static inline ComponentsUpdate GetUpdateFunction(const ComponentType* component_type, bool fixed)
+    {
+        return fixed ? component_type->m_FixedUpdateFunction : component_type->m_UpdateFunction;
+    }
+
+    static inline uint32_t GetUpdateReads(const ComponentType* component_type)
+    {
+        return component_type->m_UpdateReads | (component_type->m_ReadsTransforms ? COMPONENT_UPDATE_ACCESS_TRANSFORMS : 0);
+    }
+
+    // Returns the end of the range of component types, starting at 'begin' in update order, that can be updated concurrently.
+    // Types that haven't declared their update access, or that run scripts, are always updated alone. At most one type in
+    // the range posts messages, and they are dispatched when all of the types are done.
+    static uint32_t FindConcurrentUpdateRange(Register* regist, uint32_t begin, bool fixed)
+    {
+        uint32_t reads = 0;
+        uint32_t writes = 0;
+        uint32_t end = begin;
+        while (end < regist->m_ComponentTypeCount)
+        {
+            const ComponentType* component_type = &regist->m_ComponentTypes[regist->m_ComponentTypesOrder[end]];
+            if (!GetUpdateFunction(component_type, fixed))
+            {
+                ++end;
+                continue;
+            }
+
+            uint32_t type_reads = GetUpdateReads(component_type);
+            uint32_t type_writes = component_type->m_UpdateWrites;
+            if (!component_type->m_UpdateAccessDeclared || ((type_reads | type_writes) & COMPONENT_UPDATE_ACCESS_SCRIPT))
+            {
+                return end == begin ? end + 1 : end;
+            }
+
+            // All render access runs on the main thread, in update order
+            type_reads &= ~COMPONENT_UPDATE_ACCESS_RENDER;
+            type_writes &= ~COMPONENT_UPDATE_ACCESS_RENDER;
+            // Two types posting messages conflict, so the messages of a range are posted in update order
+            if ((type_writes & (reads | writes)) || (writes & type_reads))
+            {
+                return end;
+            }
+            reads |= type_reads;
+            writes |= type_writes;
+            ++end;
+        }
+        return end;
+    }
+
+    static bool UpdateComponentTypesConcurrently(Collection* collection, const UpdateContext* update_context, uint32_t begin, uint32_t end, bool fixed)
+    {
+        Register* regist = collection->m_Register;
+        dmArray<UpdateTask>& tasks = collection->m_UpdateTasks;
+        tasks.SetSize(0);
+        if (tasks.Capacity() < end - begin)
+        {
+            tasks.SetCapacity(end - begin);
+        }
+
+        bool reads_transforms = false;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            uint16_t update_index = regist->m_ComponentTypesOrder[i];
+            ComponentType* component_type = &regist->m_ComponentTypes[update_index];
+            ComponentsUpdate update_function = GetUpdateFunction(component_type, fixed);
+            if (!update_function)
+                continue;
+
+            reads_transforms |= component_type->m_ReadsTransforms;
+
+            UpdateTask task;
+            task.m_Function = update_function;
+            task.m_Params.m_Collection = collection->m_HCollection;
+            task.m_Params.m_UpdateContext = update_context;
+            task.m_Params.m_World = collection->m_ComponentWorlds[update_index];
+            task.m_Params.m_Context = component_type->m_Context;
+            task.m_Result.m_TransformsUpdated = false;
+            task.m_UpdateResult = UPDATE_RESULT_OK;
+            task.m_Name = component_type->m_Name;
+            task.m_MainThread = ((component_type->m_UpdateReads | component_type->m_UpdateWrites) & COMPONENT_UPDATE_ACCESS_RENDER) != 0;
+            tasks.Push(task);
+        }
+
+        // None of the types in the range write transforms if any of them read them
+        if (reads_transforms && collection->m_DirtyTransforms) {
+            UpdateTransforms(collection);
+        }
+
+        RunUpdateTasks(regist->m_UpdateScheduler, tasks.Begin(), tasks.Size());
+
+        bool ret = true;
+        for (uint32_t i = 0; i < tasks.Size(); ++i)
+        {
+            if (tasks[i].m_UpdateResult != UPDATE_RESULT_OK)
+                ret = false;
+            collection->m_DirtyTransforms |= tasks[i].m_Result.m_TransformsUpdated;
+        }
+        return ret;
+    }
+
+    static bool UpdateComponentTypes(Collection* collection, const UpdateContext* update_context, bool fixed)
+    {
+        Register* regist = collection->m_Register;
+        bool ret = true;
+
+        uint32_t component_types = regist->m_ComponentTypeCount;
+        uint32_t i = 0;
+        while (i < component_types)
+        {
+            uint32_t end = regist->m_UpdateScheduler ? FindConcurrentUpdateRange(regist, i, fixed) : i + 1;
+            if (end - i > 1)
+            {
+                if (!UpdateComponentTypesConcurrently(collection, update_context, i, end, fixed))
+                {
+                    ret = false;
+                }
+            }
+            else
+            {
+                uint16_t update_index = regist->m_ComponentTypesOrder[i];
+                ComponentType* component_type = &regist->m_ComponentTypes[update_index];
+
+                // Avoid to call UpdateTransforms for each/all component types.
+                if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
+                    UpdateTransforms(collection);
+                }
+
+                ComponentsUpdate update_function = GetUpdateFunction(component_type, fixed);
+                if (update_function)
+                {
+                    DM_PROFILE_DYN(component_type->m_Name, 0);
+                    ComponentsUpdateParams params;
+                    params.m_Collection = collection->m_HCollection;
+                    params.m_UpdateContext = update_context;
+                    params.m_World = collection->m_ComponentWorlds[update_index];
+                    params.m_Context = component_type->m_Context;
+
+                    ComponentsUpdateResult update_result;
+                    update_result.m_TransformsUpdated = false;
+                    UpdateResult res = update_function(params, update_result);
+                    if (res != UPDATE_RESULT_OK)
+                        ret = false;
+
+                    // Mark the collections transforms as dirty if this component has updated
+                    // them in its update function.
+                    collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
+                }
+            }
+
+            if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
+            {
+                ret = false;
+            }
+            i = end;
+        }
+        return ret;
+    }
+
     static bool Update(Collection* collection, const UpdateContext* update_context)
     {
         DM_PROFILE("Update");
         DM_PROPERTY_ADD_U32(rmtp_GOInstances, collection->m_InstanceIndices.Size());
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_COMPONENT);
 
         assert(collection != 0x0);
 
@@ -2524,41 +3074,9 @@ namespace dmGameObject
             dynamic_update_context.m_AccumFrameTime = collection->m_FixedAccumTime;
         }
 
-        uint32_t component_types = collection->m_Register->m_ComponentTypeCount;
-        for (uint32_t i = 0; i < component_types; ++i)
+        if (!UpdateComponentTypes(collection, &dynamic_update_context, false))
         {
-            uint16_t update_index = collection->m_Register->m_ComponentTypesOrder[i];
-            ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
-
-            // Avoid to call UpdateTransforms for each/all component types.
-            if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
-                UpdateTransforms(collection);
-            }
-
-            if (component_type->m_UpdateFunction)
-            {
-                DM_PROFILE_DYN(component_type->m_Name, 0);
-                ComponentsUpdateParams params;
-                params.m_Collection = collection->m_HCollection;
-                params.m_UpdateContext = &dynamic_update_context;
-                params.m_World = collection->m_ComponentWorlds[update_index];
-                params.m_Context = component_type->m_Context;
-
-                ComponentsUpdateResult update_result;
-                update_result.m_TransformsUpdated = false;
-                UpdateResult res = component_type->m_UpdateFunction(params, update_result);
-                if (res != UPDATE_RESULT_OK)
-                    ret = false;
-
-                // Mark the collections transforms as dirty if this component has updated
-                // them in its update function.
-                collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
-            }
-
-            if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
-            {
-                ret = false;
-            }
+            ret = false;
         }
 
         if (update_context->m_FixedUpdateFrequency != 0 && update_context->m_TimeScale > 0.001f)
@@ -2585,43 +3103,11 @@ namespace dmGameObject
 
                 for (uint32_t step = 0; step < num_fixed_steps; ++step)
                 {
-                    for (uint32_t i = 0; i < component_types; ++i)
+                    if (!UpdateComponentTypes(collection, &fixed_update_context, true))
                     {
-                        uint16_t update_index = collection->m_Register->m_ComponentTypesOrder[i];
-                        ComponentType* component_type = &collection->m_Register->m_ComponentTypes[update_index];
-
-                        // Avoid to call UpdateTransforms for each/all component types.
-                        if (component_type->m_ReadsTransforms && collection->m_DirtyTransforms) {
-                            UpdateTransforms(collection);
-                        }
-
-                        if (component_type->m_FixedUpdateFunction)
-                        {
-                            DM_PROFILE_DYN(component_type->m_Name, 0);
-                            ComponentsUpdateParams params;
-                            params.m_Collection = collection->m_HCollection;
-                            params.m_UpdateContext = &fixed_update_context;
-                            params.m_World = collection->m_ComponentWorlds[update_index];
-                            params.m_Context = component_type->m_Context;
-
-                            ComponentsUpdateResult update_result;
-                            update_result.m_TransformsUpdated = false;
-                            UpdateResult res = component_type->m_FixedUpdateFunction(params, update_result);
-                            if (res != UPDATE_RESULT_OK)
-                                ret = false;
-
-                            // Mark the collections transforms as dirty if this component has updated
-                            // them in its update function.
-                            collection->m_DirtyTransforms |= update_result.m_TransformsUpdated;
-                        }
-
-                        if (!DispatchMessages(collection, &collection->m_ComponentSocket, 1))
-                        {
-                            ret = false;
-                        }
+                        ret = false;
                     }
                 }
-
             }
         }
 
@@ -2683,6 +3169,7 @@ namespace dmGameObject
     static bool PostUpdate(Collection* collection)
     {
         DM_PROFILE("PostUpdate");
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_COMPONENT);
         assert(collection != 0x0);
         HRegister reg = collection->m_Register;
         assert(reg);
@@ -2717,11 +3204,11 @@ namespace dmGameObject
             while (collection->m_InstancesToDeleteHead != INVALID_INSTANCE_INDEX && pass_count < max_pass_count) {
                 ++pass_count;
                 // Save the list and clear the head and tail
-                uint16_t head = collection->m_InstancesToDeleteHead;
+                InstanceIndex head = collection->m_InstancesToDeleteHead;
                 collection->m_InstancesToDeleteHead = INVALID_INSTANCE_INDEX;
                 collection->m_InstancesToDeleteTail = INVALID_INSTANCE_INDEX;
 
-                uint16_t index = head;
+                InstanceIndex index = head;
                 while (index != INVALID_INSTANCE_INDEX) {
                     Instance* instance = collection->m_Instances[index];
 
@@ -3611,12 +4098,12 @@ namespace dmGameObject
     //  - patch data structures for identification and input stack
     //  - copy the rest of the fields
     // The old instance is destroyed.
-    static void RecreateInstance(Collection* collection, uint16_t index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
+    static void RecreateInstance(Collection* collection, InstanceIndex index, Prototype* old_proto, Prototype* new_proto, const char* new_proto_name) {
         HInstance instance = collection->m_Instances[index];
         // We don't support recreating instances that are 'transitioning'
         assert(instance->m_ToBeAdded == 0);
         assert(instance->m_ToBeDeleted == 0);
-        HInstance new_instance = AllocInstance(new_proto, new_proto_name);
+        HInstance new_instance = AllocInstance(collection, new_proto, new_proto_name);
         if (!new_instance) {
             return;
         }
@@ -3643,7 +4130,7 @@ namespace dmGameObject
         bool res = CreateComponents(hcollection, new_instance);
         if (!res) {
             dmHashRelease64(&new_instance->m_CollectionPathHashState);
-            DeallocInstance(new_instance);
+            DeallocInstance(collection, new_instance);
             return;
         }
         if (instance->m_Initialized) {
@@ -3669,7 +4156,7 @@ namespace dmGameObject
                 break;
             }
         }
-        DeallocInstance(instance);
+        DeallocInstance(collection, instance);
         DoAddToUpdate(collection, new_instance);
     }
 
@@ -3678,11 +4165,11 @@ namespace dmGameObject
         Collection* collection = (Collection*) params.m_UserData;
         for (uint32_t level_i = 0; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
         {
-            dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+            dmArray<InstanceIndex>& level = collection->m_LevelIndices[level_i];
             uint32_t instance_count = level.Size();
             for (uint32_t i = 0; i < instance_count; ++i)
             {
-                uint16_t index = level[i];
+                InstanceIndex index = level[i];
                 Instance* instance = collection->m_Instances[index];
                 if (instance->m_Prototype == params.m_Resource->m_Resource) {
                     RecreateInstance(collection, index, (Prototype*)params.m_Resource->m_PrevResource, (Prototype*)params.m_Resource->m_Resource, params.m_Name);
@@ -3725,7 +4212,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToAddHead;
+        InstanceIndex index = collection->m_InstancesToAddHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToAdd;
             ++count;
@@ -3737,7 +4224,7 @@ namespace dmGameObject
     {
         Collection* collection = hcollection->m_Collection;
         uint32_t count = 0;
-        uint16_t index = collection->m_InstancesToDeleteHead;
+        InstanceIndex index = collection->m_InstancesToDeleteHead;
         while (index != INVALID_INSTANCE_INDEX) {
             index = collection->m_Instances[index]->m_NextToDelete;
             ++count;
@@ -46,6 +46,9 @@ namespace dmGameObject
     /// Config key to use for tweaking the maximum capacity of the input stack
     extern const char* COLLECTION_MAX_INPUT_STACK_ENTRIES_KEY;
 
+    /// Config key to use for setting the number of threads updating component types concurrently
+    extern const char* COLLECTION_UPDATE_THREADS_KEY;
+
     extern const dmhash_t UNNAMED_IDENTIFIER;
 
 
@@ -77,7 +80,7 @@ namespace dmGameObject
     /**
      * Set default capacity of collections in this register. This does not affect existing collections.
      * @param regist Register
-     * @param capacity Default capacity of collections in this register (0-32766).
+     * @param capacity Default capacity of collections in this register (0-32766, or larger when built with DM_GAMEOBJECT_INSTANCE_INDEX_BITS=32).
      * @return RESULT_OK on success or RESULT_INVALID_OPERATION if max_count is not within range
      */
     Result SetCollectionDefaultCapacity(HRegister regist, uint32_t capacity);
@@ -96,6 +99,17 @@ namespace dmGameObject
      */
     void SetInputStackDefaultCapacity(HRegister regist, uint32_t capacity);
 
+    /**
+     * Set the number of worker threads used to update component types concurrently. Component types
+     * that have declared their update access (see ComponentTypeSetUpdateAccess) and don't conflict are
+     * updated at the same time, and the messages they post are dispatched when all of them are done.
+     * With 0 threads, all component types are updated one by one on the calling thread.
+     * Must not be called during an update.
+     * @param regist Register
+     * @param thread_count Number of worker threads
+     */
+    void SetComponentUpdateThreadCount(HRegister regist, uint32_t thread_count);
+
     /**
      * Creates a new gameobject collection
      * @param name Collection name, which must be unique and follow the same naming as for sockets
@@ -160,6 +174,24 @@ namespace dmGameObject
      */
     HInstance Spawn(HCollection collection, HPrototype prototype, const char* prototype_name, dmhash_t id, uint8_t* property_buffer, uint32_t property_buffer_size, const Point3& position, const Quat& rotation, const Vector3& scale);
 
+    /**
+     * Spawns a batch of gameobject instances from the same prototype. The components are created one
+     * component type at a time, for all instances, and the same property buffer is applied to each instance.
+     * @param collection Gameobject collection
+     * @param prototype Prototype to spawn from
+     * @param prototype_name Prototype file name
+     * @param count Number of instances to spawn
+     * @param ids Array of count ids for the spawned instances
+     * @param property_buffer Buffer with serialized properties
+     * @param property_buffer_size Size of property buffer
+     * @param positions Array of count positions
+     * @param rotations Array of count rotations
+     * @param scale Scale of the spawned objects
+     * @param out_instances Array of count instances that is filled with the spawned instances, 0 where spawning failed
+     * return the number of spawned instances
+     */
+    uint32_t SpawnBatch(HCollection collection, HPrototype prototype, const char* prototype_name, uint32_t count, const dmhash_t* ids, uint8_t* property_buffer, uint32_t property_buffer_size, const Point3* positions, const Quat* rotations, const Vector3& scale, HInstance* out_instances);
+
     struct InstancePropertyBuffer
     {
         uint8_t *property_buffer;
@@ -17,6 +17,7 @@
 
 #include <dlib/hash.h>
 #include <dlib/hashtable.h>
+#include <dlib/flat_hashtable.h>
 #include <dlib/index_pool.h>
 #include <dlib/math.h>
 #include <dlib/mutex.h>
@@ -25,6 +26,7 @@
 #include "gameobject.h"
 #include "gameobject_props.h"
 #include "component.h"
+#include "gameobject_update_scheduler.h"
 
 extern "C"
 {
@@ -88,8 +90,33 @@ namespace dmGameObject
         dmArray<void*> m_PropertyResources;
     };
 
+    // Width of the instance indices used for the hierarchy and update lists. Configure with
+    // --gameobject-instance-index-bits=32 to allow more than 32766 instances per collection,
+    // at the cost of 16 more bytes per Instance (176 -> 192 bytes on 64-bit) and 2 more bytes per
+    // Collection::m_InstanceIndices and Collection::m_LevelIndices entry.
+#if !defined(DM_GAMEOBJECT_INSTANCE_INDEX_BITS)
+    #define DM_GAMEOBJECT_INSTANCE_INDEX_BITS 16
+#endif
+
+#if DM_GAMEOBJECT_INSTANCE_INDEX_BITS == 32
+    typedef uint32_t        InstanceIndex;
+    typedef dmIndexPool32   InstanceIndexPool;
+    // Invalid instance index. Implies that maximum number of instances is 2147483646 (ie 0x7fffffff - 1)
+    const uint32_t INVALID_INSTANCE_INDEX = 0x7fffffff;
+#elif DM_GAMEOBJECT_INSTANCE_INDEX_BITS == 16
+    typedef uint16_t        InstanceIndex;
+    typedef dmIndexPool16   InstanceIndexPool;
     // Invalid instance index. Implies that maximum number of instances is 32766 (ie 0x7fff - 1)
     const uint32_t INVALID_INSTANCE_INDEX = 0x7fff;
+#else
+    #error "DM_GAMEOBJECT_INSTANCE_INDEX_BITS must be 16 or 32"
+#endif
+    // Number of bits available for the indices that share their storage with a flag
+    const uint32_t INSTANCE_INDEX_BITS = DM_GAMEOBJECT_INSTANCE_INDEX_BITS - 1;
+
+    // Returns the DM_GAMEOBJECT_INSTANCE_INDEX_BITS the library was built with. Code including this header
+    // must be built with the same value, since the layout of Instance and Collection depends on it.
+    uint32_t GetInstanceIndexBits();
 
     // NOTE: Actual size of Instance is sizeof(Instance) + sizeof(uintptr_t) * m_UserDataCount
     struct Instance
@@ -156,32 +183,32 @@ namespace dmGameObject
         uint16_t        m_Pad : 4;
 
         // Index to parent
-        uint16_t        m_Parent : 16;
+        InstanceIndex   m_Parent;
 
         // Index to Collection::m_Instances
-        uint16_t        m_Index : 15;
+        InstanceIndex   m_Index : INSTANCE_INDEX_BITS;
         // Used for deferred deletion
-        uint16_t        m_ToBeDeleted : 1;
+        InstanceIndex   m_ToBeDeleted : 1;
 
         // Index to Collection::m_LevelIndex. Index is relative to current level (m_Depth), eg first object in level L always has level-index 0
         // Level-index is used to reorder Collection::m_LevelIndex entries in O(1). Given an instance we need to find where the
         // instance index is located in Collection::m_LevelIndex
-        uint16_t        m_LevelIndex : 15;
-        uint16_t        m_Pad2 : 1;
+        InstanceIndex   m_LevelIndex : INSTANCE_INDEX_BITS;
+        InstanceIndex   m_Pad2 : 1;
 
         // Index to next instance to delete or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToDelete : 16;
+        InstanceIndex   m_NextToDelete;
 
         // Index to next instance to add-to-update or INVALID_INSTANCE_INDEX
-        uint16_t        m_NextToAdd;
+        InstanceIndex   m_NextToAdd;
 
         // Next sibling index. Index to Collection::m_Instances
-        uint16_t        m_SiblingIndex : 15;
-        uint16_t        m_ToBeAdded : 1;
+        InstanceIndex   m_SiblingIndex : INSTANCE_INDEX_BITS;
+        InstanceIndex   m_ToBeAdded : 1;
 
         // First child index. Index to Collection::m_Instances
-        uint16_t        m_FirstChildIndex : 15;
-        uint16_t        m_Pad4 : 1;
+        InstanceIndex   m_FirstChildIndex : INSTANCE_INDEX_BITS;
+        InstanceIndex   m_Pad4 : 1;
 
         uint32_t        m_ComponentInstanceUserDataCount;
         uintptr_t       m_ComponentInstanceUserData[0];
@@ -204,6 +231,8 @@ namespace dmGameObject
         // Default capacity of collections
         uint32_t                    m_DefaultCollectionCapacity;
         uint32_t                    m_DefaultInputStackCapacity;
+        // Worker threads for updating component types concurrently. 0 if the types are updated one by one
+        HUpdateScheduler            m_UpdateScheduler;
 
         Register();
         ~Register();
@@ -213,6 +242,12 @@ namespace dmGameObject
     // depth is interpreted as up to <depth> levels of child nodes including root-nodes
     // Must be greater than zero
     const uint32_t MAX_HIERARCHICAL_DEPTH = 128;
+
+    // Instances with up to this many component user data fields are allocated from the collection slabs
+    const uint32_t MAX_SLAB_INSTANCE_USER_DATA_COUNT = 16;
+    // Number of instances allocated per slab
+    const uint32_t INSTANCE_SLAB_SIZE = 32;
+
     struct Collection
     {
         Collection(dmResource::HFactory factory, HRegister regist, uint32_t max_instances, uint32_t max_input_stack_entries);
@@ -238,7 +273,16 @@ namespace dmGameObject
         dmArray<Instance*>       m_Instances;
 
         // Index pool for mapping Instance::m_Index to m_Instances
-        dmIndexPool16            m_InstanceIndices;
+        InstanceIndexPool        m_InstanceIndices;
+
+        // Memory blocks for the instances, allocated INSTANCE_SLAB_SIZE instances at a time. Slabs are never
+        // trimmed, they are only freed when the collection is deleted.
+        dmArray<void*>           m_InstanceSlabs;
+        // Free lists of instance memory, one per component user data count. The next pointer is stored in the free memory.
+        void*                    m_FreeInstances[MAX_SLAB_INSTANCE_USER_DATA_COUNT + 1];
+
+        // Scratch buffer for the component types updated concurrently
+        dmArray<UpdateTask>      m_UpdateTasks;
 
         // Resources referenced through property overrides inside the collection
         dmArray<void*>           m_PropertyResources;
@@ -248,13 +292,13 @@ namespace dmGameObject
         // Two dimensional table of indices with stride "max_instances"
         // Level 0 contains root-nodes in [0..m_LevelIndices[0].Size()-1]
         // Level 1 contains level 1 indices in [0..m_LevelIndices[1].Size()-1]
-        dmArray<uint16_t>        m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
+        dmArray<InstanceIndex>   m_LevelIndices[MAX_HIERARCHICAL_DEPTH];
 
         // Array of world transforms. Calculated using m_LevelIndices above
         dmArray<Matrix4>         m_WorldTransforms;
 
         // Identifier to Instance mapping
-        dmHashTable64<Instance*> m_IDToInstance;
+        dmFlatHashTable64<Instance*> m_IDToInstance;
 
         // Stack keeping track of which instance has the input focus
         dmArray<Instance*>       m_InputFocusStack;
@@ -278,14 +322,14 @@ namespace dmGameObject
         dmIndexPool32            m_InstanceIdPool;
 
         // Head of linked list of instances scheduled for deferred deletion
-        uint16_t                 m_InstancesToDeleteHead;
+        InstanceIndex            m_InstancesToDeleteHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToDeleteTail;
+        InstanceIndex            m_InstancesToDeleteTail;
 
         // Head of linked list of instances scheduled to be added to update
-        uint16_t                 m_InstancesToAddHead;
+        InstanceIndex            m_InstancesToAddHead;
         // Tail of the same list, for O(1) appending
-        uint16_t                 m_InstancesToAddTail;
+        InstanceIndex            m_InstancesToAddTail;
 
         float                    m_FixedAccumTime;  // Accumulated time between fixed updates. Scaled time.
 
@@ -309,6 +353,10 @@ namespace dmGameObject
 
     // Used by res_collection.cpp
     HInstance NewInstance(Collection* collection, Prototype* proto, const char* prototype_name);
+    // Allocates uninitialized memory for an instance with the given number of component user data fields
+    void* AllocInstanceMemory(Collection* collection, uint32_t component_instance_userdata_count);
+    // The user data count must be the same as when the memory was allocated
+    void FreeInstanceMemory(Collection* collection, void* memory, uint32_t component_instance_userdata_count);
     HInstance GetInstanceFromIdentifier(Collection* collection, dmhash_t identifier);
     void ReleaseInstanceIndex(uint32_t index, HCollection collection);
     Result SetIdentifier(Collection* collection, HInstance instance, const char* identifier);
@@ -0,0 +1,101 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <assert.h>
+
+#include <dlib/array.h>
+#include <dlib/job_thread.h>
+#include <dlib/math.h>
+#include <dlib/memprofile.h>
+#include <dlib/profile.h>
+
+#include "gameobject_update_scheduler.h"
+
+namespace dmGameObject
+{
+    struct UpdateScheduler
+    {
+        dmJobThread::HContext       m_JobContext;
+        dmArray<dmJobThread::Job>   m_Jobs;
+    };
+
+    static void RunTask(UpdateTask* task)
+    {
+        DM_PROFILE_DYN(task->m_Name, 0);
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_COMPONENT);
+        task->m_Result.m_TransformsUpdated = false;
+        task->m_UpdateResult = task->m_Function(task->m_Params, task->m_Result);
+    }
+
+    static int ProcessTask(void* context, void* data)
+    {
+        RunTask((UpdateTask*) data);
+        return 0;
+    }
+
+    HUpdateScheduler NewUpdateScheduler(uint32_t thread_count)
+    {
+        assert(thread_count > 0);
+        UpdateScheduler* scheduler = new UpdateScheduler;
+
+        dmJobThread::JobThreadCreationParams job_thread_create_params;
+        job_thread_create_params.m_ThreadCount = (uint8_t) dmMath::Min(thread_count, (uint32_t) dmJobThread::DM_MAX_JOB_THREAD_COUNT);
+        for (uint32_t i = 0; i < job_thread_create_params.m_ThreadCount; ++i)
+        {
+            job_thread_create_params.m_ThreadNames[i] = "GOUpdate";
+        }
+        scheduler->m_JobContext = dmJobThread::Create(job_thread_create_params);
+        return scheduler;
+    }
+
+    void DeleteUpdateScheduler(HUpdateScheduler scheduler)
+    {
+        dmJobThread::Destroy(scheduler->m_JobContext);
+        delete scheduler;
+    }
+
+    void RunUpdateTasks(HUpdateScheduler scheduler, UpdateTask* tasks, uint32_t task_count)
+    {
+        dmArray<dmJobThread::Job>& jobs = scheduler->m_Jobs;
+        jobs.SetSize(0);
+        if (jobs.Capacity() < task_count)
+        {
+            jobs.SetCapacity(task_count);
+        }
+        for (uint32_t i = 0; i < task_count; ++i)
+        {
+            if (!tasks[i].m_MainThread)
+            {
+                dmJobThread::Job job;
+                job.m_Process = ProcessTask;
+                job.m_Context = scheduler;
+                job.m_Data = &tasks[i];
+                job.m_Result = 0;
+                jobs.Push(job);
+            }
+        }
+
+        dmJobThread::HGroup group = dmJobThread::PushGroup(scheduler->m_JobContext, jobs.Begin(), jobs.Size());
+
+        for (uint32_t i = 0; i < task_count; ++i)
+        {
+            if (tasks[i].m_MainThread)
+            {
+                RunTask(&tasks[i]);
+            }
+        }
+
+        dmJobThread::WaitGroup(scheduler->m_JobContext, group);
+    }
+}
@@ -0,0 +1,61 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef GAMEOBJECT_UPDATE_SCHEDULER_H
+#define GAMEOBJECT_UPDATE_SCHEDULER_H
+
+#include <stdint.h>
+
+#include <dmsdk/gameobject/component.h>
+
+namespace dmGameObject
+{
+    typedef struct UpdateScheduler* HUpdateScheduler;
+
+    // One component type update function call
+    struct UpdateTask
+    {
+        ComponentsUpdate        m_Function;
+        ComponentsUpdateParams  m_Params;
+        ComponentsUpdateResult  m_Result;
+        UpdateResult            m_UpdateResult;
+        const char*             m_Name;
+        // If the task must run on the thread calling RunUpdateTasks
+        uint8_t                 m_MainThread : 1;
+    };
+
+    /*#
+     * Create a scheduler with a job thread context of a number of worker threads
+     * @param thread_count Number of worker threads. Must be greater than zero
+     * @return the scheduler
+     */
+    HUpdateScheduler NewUpdateScheduler(uint32_t thread_count);
+
+    /*#
+     * Stop the worker threads and delete the scheduler
+     * @param scheduler the scheduler
+     */
+    void DeleteUpdateScheduler(HUpdateScheduler scheduler);
+
+    /*#
+     * Run the tasks and return when all of them are finished. The calling thread runs the
+     * main thread tasks while the workers start on the rest, and then helps with what is left.
+     * @param scheduler the scheduler
+     * @param tasks the tasks
+     * @param task_count number of tasks
+     */
+    void RunUpdateTasks(HUpdateScheduler scheduler, UpdateTask* tasks, uint32_t task_count);
+}
+
+#endif // GAMEOBJECT_UPDATE_SCHEDULER_H
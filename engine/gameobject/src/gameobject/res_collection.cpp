@@ -243,7 +243,7 @@ bail:
     static size_t CalcSize(Collection* collection)
     {
         size_t size = sizeof(Collection) + sizeof(CollectionHandle);
-        size += collection->m_InstanceIndices.Capacity()*sizeof(uint16_t);
+        size += collection->m_InstanceIndices.Capacity()*sizeof(InstanceIndex);
         size += collection->m_WorldTransforms.Capacity()*sizeof(Matrix4);
         size += collection->m_IDToInstance.Capacity()*(sizeof(Instance*)+sizeof(dmhash_t));
         size += collection->m_InputFocusStack.Capacity()*sizeof(Instance*);
@@ -535,3 +535,105 @@ TEST_F(CollectionTest, CreateCallback)
 
     dmGameObject::PostUpdate(m_Register);
 }
+
+static void AllocInstanceMemoryBlocks(dmGameObject::Collection* collection, uint32_t user_data_count, void** memory, uint32_t count)
+{
+    uint32_t size = sizeof(dmGameObject::Instance) + user_data_count * sizeof(uintptr_t);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        memory[i] = dmGameObject::AllocInstanceMemory(collection, user_data_count);
+        ASSERT_NE((void*) 0, memory[i]);
+        ASSERT_EQ(0U, ((uintptr_t) memory[i]) % 16);
+        memset(memory[i], i + 1, size);
+    }
+}
+
+static void FreeInstanceMemoryBlocks(dmGameObject::Collection* collection, uint32_t user_data_count, void** memory, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::FreeInstanceMemory(collection, memory[i], user_data_count);
+    }
+}
+
+TEST_F(CollectionTest, InstanceMemory)
+{
+    dmGameObject::Collection* collection = m_Collection->m_Collection;
+    ASSERT_EQ(0U, collection->m_InstanceSlabs.Size());
+
+    // Enough blocks to need a second slab
+    const uint32_t count = dmGameObject::INSTANCE_SLAB_SIZE + 1;
+    void* memory[count];
+    void* memory2[count];
+
+    const uint32_t user_data_counts[] = {0, 1, dmGameObject::MAX_SLAB_INSTANCE_USER_DATA_COUNT, dmGameObject::MAX_SLAB_INSTANCE_USER_DATA_COUNT + 1, 40};
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(user_data_counts); ++c)
+    {
+        uint32_t user_data_count = user_data_counts[c];
+        bool from_slab = user_data_count <= dmGameObject::MAX_SLAB_INSTANCE_USER_DATA_COUNT;
+        uint32_t slab_count = collection->m_InstanceSlabs.Size();
+
+        AllocInstanceMemoryBlocks(collection, user_data_count, memory, count);
+        ASSERT_EQ(slab_count + (from_slab ? 2 : 0), collection->m_InstanceSlabs.Size());
+        slab_count = collection->m_InstanceSlabs.Size();
+
+        // No block is handed out twice, and no block overlaps another one
+        uint32_t size = sizeof(dmGameObject::Instance) + user_data_count * sizeof(uintptr_t);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ((uint8_t) (i + 1), ((uint8_t*) memory[i])[0]);
+            ASSERT_EQ((uint8_t) (i + 1), ((uint8_t*) memory[i])[size - 1]);
+            for (uint32_t j = i + 1; j < count; ++j)
+            {
+                ASSERT_NE(memory[i], memory[j]);
+            }
+        }
+
+        FreeInstanceMemoryBlocks(collection, user_data_count, memory, count);
+
+        // Slab memory is reused, without allocating new slabs
+        AllocInstanceMemoryBlocks(collection, user_data_count, memory2, count);
+        ASSERT_EQ(slab_count, collection->m_InstanceSlabs.Size());
+        if (from_slab)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                ASSERT_EQ(memory[count - 1 - i], memory2[i]);
+            }
+        }
+        FreeInstanceMemoryBlocks(collection, user_data_count, memory2, count);
+    }
+
+    // Each user data count has its own free list
+    void* small = dmGameObject::AllocInstanceMemory(collection, 1);
+    dmGameObject::FreeInstanceMemory(collection, small, 1);
+    void* other = dmGameObject::AllocInstanceMemory(collection, 2);
+    ASSERT_NE(small, other);
+    ASSERT_EQ(small, dmGameObject::AllocInstanceMemory(collection, 1));
+    dmGameObject::FreeInstanceMemory(collection, small, 1);
+    dmGameObject::FreeInstanceMemory(collection, other, 2);
+}
+
+TEST_F(CollectionTest, InstanceMemoryDeleteCollection)
+{
+    dmGameObject::HCollection coll = dmGameObject::NewCollection("slabcollection", m_Factory, m_Register, 1024, 0x0);
+    ASSERT_NE((void*) 0, coll);
+    dmGameObject::Collection* collection = coll->m_Collection;
+
+    // The slab memory still in use is released with the collection
+    void* memory[dmGameObject::INSTANCE_SLAB_SIZE];
+    for (uint32_t user_data_count = 0; user_data_count <= dmGameObject::MAX_SLAB_INSTANCE_USER_DATA_COUNT; ++user_data_count)
+    {
+        AllocInstanceMemoryBlocks(collection, user_data_count, memory, DM_ARRAY_SIZE(memory));
+    }
+    ASSERT_EQ(dmGameObject::MAX_SLAB_INSTANCE_USER_DATA_COUNT + 1, collection->m_InstanceSlabs.Size());
+
+    // Instances created and deleted with the collection use the same memory
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        ASSERT_NE((void*) 0, dmGameObject::New(coll, 0x0));
+    }
+
+    dmGameObject::DeleteCollection(coll);
+    dmGameObject::PostUpdate(m_Register);
+}
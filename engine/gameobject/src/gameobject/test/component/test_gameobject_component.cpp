@@ -16,8 +16,11 @@
 
 #include <map>
 
+#include <dlib/atomic.h>
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
+#include <dlib/thread.h>
+#include <dlib/time.h>
 
 #include <resource/resource.h>
 
@@ -35,6 +38,7 @@ protected:
     virtual void SetUp()
     {
         m_UpdateCount = 0;
+        m_ConcurrentUpdateCount = 0;
         m_UpdateContext.m_DT = 1.0f / 60.0f;
 
         dmResource::NewFactoryParams params;
@@ -186,6 +190,10 @@ public:
 
     std::map<uint64_t, int>      m_ComponentUserDataAcc;
 
+    // Written by the update functions that may run on worker threads
+    int32_atomic_t               m_ConcurrentUpdateCount;
+    dmThread::Thread             m_ConcurrentUpdateThreads[3];
+
     dmScript::HContext m_ScriptContext;
     dmGameObject::UpdateContext m_UpdateContext;
     dmGameObject::HRegister m_Register;
@@ -279,6 +287,29 @@ static dmGameObject::UpdateResult GenericComponentsUpdate(const dmGameObject::Co
     return dmGameObject::UPDATE_RESULT_OK;
 }
 
+// Waits for (at most a second for) the other update functions, so that they all run at the same time
+template <int index>
+static dmGameObject::UpdateResult ConcurrentComponentsUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+{
+    ComponentTest* game_object_test = (ComponentTest*) params.m_Context;
+    game_object_test->m_ConcurrentUpdateThreads[index] = dmThread::GetCurrentThread();
+    dmAtomicIncrement32(&game_object_test->m_ConcurrentUpdateCount);
+
+    uint64_t stop_time = dmTime::GetTime() + 1000000;
+    while (dmAtomicGet32(&game_object_test->m_ConcurrentUpdateCount) < DM_ARRAY_SIZE(game_object_test->m_ConcurrentUpdateThreads) && dmTime::GetTime() < stop_time)
+    {
+        dmTime::Sleep(1000);
+    }
+    return dmGameObject::UPDATE_RESULT_OK;
+}
+
+template <int index>
+static dmGameObject::UpdateResult ThreadComponentsUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
+{
+    ComponentTest* game_object_test = (ComponentTest*) params.m_Context;
+    game_object_test->m_ConcurrentUpdateThreads[index] = dmThread::GetCurrentThread();
+    return dmGameObject::UPDATE_RESULT_OK;
+}
 
 template <typename T>
 static dmGameObject::CreateResult GenericComponentDestroy(const dmGameObject::ComponentDestroyParams& params)
@@ -431,6 +462,108 @@ TEST_F(ComponentTest, TestUpdateOrder)
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+TEST_F(ComponentTest, TestUpdateOrderConcurrent)
+{
+    // Only reading render state makes the types update in the same range, but on the main thread
+    const char* extensions[] = {"a", "b", "c"};
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(extensions); ++i)
+    {
+        dmResource::ResourceType resource_type;
+        ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, extensions[i], &resource_type));
+        uint32_t component_index;
+        dmGameObject::ComponentType* component_type = dmGameObject::FindComponentType(m_Register, resource_type, &component_index);
+        ASSERT_NE((void*) 0, (void*) component_type);
+        dmGameObject::ComponentTypeSetUpdateAccess(component_type, dmGameObject::COMPONENT_UPDATE_ACCESS_RENDER, 0);
+    }
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 2);
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go1.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    bool ret = dmGameObject::Update(m_Collection, &m_UpdateContext);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateCountMap[TestGameObjectDDF::AResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateCountMap[TestGameObjectDDF::BResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateCountMap[TestGameObjectDDF::CResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 2, m_ComponentUpdateOrderMap[TestGameObjectDDF::AResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 1, m_ComponentUpdateOrderMap[TestGameObjectDDF::BResource::m_DDFHash]);
+    ASSERT_EQ((uint32_t) 0, m_ComponentUpdateOrderMap[TestGameObjectDDF::CResource::m_DDFHash]);
+    dmGameObject::Delete(m_Collection, go, false);
+
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 0);
+}
+
+TEST_F(ComponentTest, TestUpdateConcurrentWorkers)
+{
+    // Types that don't access any shared state are all updated at the same time, on the worker threads and the main thread
+    const char* extensions[] = {"a", "b", "c"};
+    dmGameObject::ComponentsUpdate update_functions[] = {ConcurrentComponentsUpdate<0>, ConcurrentComponentsUpdate<1>, ConcurrentComponentsUpdate<2>};
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(extensions); ++i)
+    {
+        dmResource::ResourceType resource_type;
+        ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, extensions[i], &resource_type));
+        uint32_t component_index;
+        dmGameObject::ComponentType* component_type = dmGameObject::FindComponentType(m_Register, resource_type, &component_index);
+        ASSERT_NE((void*) 0, (void*) component_type);
+        dmGameObject::ComponentTypeSetUpdateFn(component_type, update_functions[i]);
+        dmGameObject::ComponentTypeSetUpdateAccess(component_type, 0, 0);
+        m_ConcurrentUpdateThreads[i] = dmThread::GetCurrentThread();
+    }
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 2);
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go1.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    bool ret = dmGameObject::Update(m_Collection, &m_UpdateContext);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ(3, dmAtomicGet32(&m_ConcurrentUpdateCount));
+
+    if (dmThread::PlatformHasThreadSupport())
+    {
+        uint32_t worker_updates = 0;
+        for (uint32_t i = 0; i < DM_ARRAY_SIZE(m_ConcurrentUpdateThreads); ++i)
+        {
+            if (m_ConcurrentUpdateThreads[i] != dmThread::GetCurrentThread())
+                ++worker_updates;
+        }
+        ASSERT_LT(0U, worker_updates);
+    }
+    dmGameObject::Delete(m_Collection, go, false);
+
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 0);
+}
+
+TEST_F(ComponentTest, TestUpdateMessagesInOrder)
+{
+    // Types that post messages are never updated together, so their messages are posted in update order
+    const char* extensions[] = {"a", "b", "c"};
+    dmGameObject::ComponentsUpdate update_functions[] = {ThreadComponentsUpdate<0>, ThreadComponentsUpdate<1>, ThreadComponentsUpdate<2>};
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(extensions); ++i)
+    {
+        dmResource::ResourceType resource_type;
+        ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, extensions[i], &resource_type));
+        uint32_t component_index;
+        dmGameObject::ComponentType* component_type = dmGameObject::FindComponentType(m_Register, resource_type, &component_index);
+        ASSERT_NE((void*) 0, (void*) component_type);
+        dmGameObject::ComponentTypeSetUpdateFn(component_type, update_functions[i]);
+        dmGameObject::ComponentTypeSetUpdateAccess(component_type, 0, dmGameObject::COMPONENT_UPDATE_ACCESS_MESSAGES);
+        m_ConcurrentUpdateThreads[i] = 0;
+    }
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 2);
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go1.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    bool ret = dmGameObject::Update(m_Collection, &m_UpdateContext);
+    ASSERT_TRUE(ret);
+
+    // A type that is updated alone is updated on the main thread
+    for (uint32_t i = 0; i < DM_ARRAY_SIZE(m_ConcurrentUpdateThreads); ++i)
+    {
+        ASSERT_EQ(dmThread::GetCurrentThread(), m_ConcurrentUpdateThreads[i]);
+    }
+    dmGameObject::Delete(m_Collection, go, false);
+
+    dmGameObject::SetComponentUpdateThreadCount(m_Register, 0);
+}
+
 TEST_F(ComponentTest, TestDuplicatedIds)
 {
     dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/go6.goc");
@@ -272,3 +272,46 @@ TEST_F(FactoryTest, FactoryCreateCallback)
     dmGameObject::HInstance instance = Spawn(m_Factory, m_Collection, "/test_create.goc", id, 0x0, 0, Point3(2.0f, 0.0f, 0.0f), Quat(), Vector3(2, 2, 2));
     ASSERT_NE((void*)0, instance);
 }
+
+TEST_F(FactoryTest, FactoryBatch)
+{
+    const uint32_t count = 10;
+    uint32_t indices[count];
+    dmhash_t ids[count];
+    Point3 positions[count];
+    Quat rotations[count];
+    dmGameObject::HInstance instances[count];
+
+    ASSERT_EQ(count, dmGameObject::AcquireInstanceIndices(m_Collection, count, indices));
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ids[i] = dmGameObject::ConstructInstanceId(indices[i]);
+        positions[i] = Point3((float)i, 0.0f, 0.0f);
+        rotations[i] = Quat::identity();
+    }
+
+    dmGameObject::HPrototype prototype = 0x0;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/test.goc", (void**)&prototype));
+    uint32_t spawned = dmGameObject::SpawnBatch(m_Collection, prototype, "/test.goc", count, ids, 0x0, 0, positions, rotations, Vector3(1, 1, 1), instances);
+    dmResource::Release(m_Factory, prototype);
+
+    ASSERT_EQ(count, spawned);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_NE((void*)0, instances[i]);
+        dmGameObject::AssignInstanceIndex(indices[i], instances[i]);
+        ASSERT_EQ(ids[i], dmGameObject::GetIdentifier(instances[i]));
+        ASSERT_EQ((float)i, dmGameObject::GetPosition(instances[i]).getX());
+    }
+
+    // The identifiers are now in use, so spawning with the same ids fails
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/test.goc", (void**)&prototype));
+    spawned = dmGameObject::SpawnBatch(m_Collection, prototype, "/test.goc", count, ids, 0x0, 0, positions, rotations, Vector3(1, 1, 1), instances);
+    dmResource::Release(m_Factory, prototype);
+
+    ASSERT_EQ(0u, spawned);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ((void*)0, instances[i]);
+    }
+}
@@ -63,6 +63,7 @@ protected:
         assert(dmMessage::NewSocket("@system", &m_Socket) == dmMessage::RESULT_OK);
 
         m_MessageTargetCounter = 0;
+        m_MessageTargetBatchCount = 0;
 
         dmResource::Result e = dmResource::RegisterType(m_Factory, "mt", this, 0, ResMessageTargetCreate, 0, ResMessageTargetDestroy, 0);
         ASSERT_EQ(dmResource::RESULT_OK, e);
@@ -107,6 +108,7 @@ protected:
     static dmGameObject::CreateResult CompMessageTargetCreate(const dmGameObject::ComponentCreateParams& params);
     static dmGameObject::CreateResult CompMessageTargetDestroy(const dmGameObject::ComponentDestroyParams& params);
     static dmGameObject::UpdateResult CompMessageTargetOnMessage(const dmGameObject::ComponentOnMessageParams& params);
+    static dmGameObject::UpdateResult CompMessageTargetOnMessages(const dmGameObject::ComponentOnMessagesParams& params);
 
 public:
     dmGameObject::UpdateContext m_UpdateContext;
@@ -119,6 +121,7 @@ public:
     std::map<uint32_t, uint32_t> m_MessageMap;
 
     uint32_t m_MessageTargetCounter;
+    uint32_t m_MessageTargetBatchCount;
     dmGameObject::ModuleContext m_ModuleContext;
     dmHashTable64<void*> m_Contexts;
 };
@@ -199,6 +202,23 @@ dmGameObject::UpdateResult MessageTest::CompMessageTargetOnMessage(const dmGameO
     return dmGameObject::UPDATE_RESULT_OK;
 }
 
+dmGameObject::UpdateResult MessageTest::CompMessageTargetOnMessages(const dmGameObject::ComponentOnMessagesParams& params)
+{
+    MessageTest* self = (MessageTest*) params.m_Context;
+    assert(params.m_Context == params.m_World);
+    assert(params.m_MessageCount > 0);
+
+    self->m_MessageTargetBatchCount++;
+    for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+    {
+        assert(params.m_Messages[i].m_World == params.m_World);
+        dmGameObject::UpdateResult result = CompMessageTargetOnMessage(params.m_Messages[i]);
+        if (result != dmGameObject::UPDATE_RESULT_OK)
+            return result;
+    }
+    return dmGameObject::UPDATE_RESULT_OK;
+}
+
 void DispatchCallback(dmMessage::Message *message, void* user_ptr)
 {
     MessageTest* test = (MessageTest*)user_ptr;
@@ -304,6 +324,106 @@ TEST_F(MessageTest, TestComponentMessageFail)
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+static void BatchMessageDestroyCallback(dmMessage::Message* message)
+{
+}
+
+TEST_F(MessageTest, TestComponentMessageBatch)
+{
+    dmResource::ResourceType resource_type;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, "mt", &resource_type));
+    dmGameObject::ComponentType* type = dmGameObject::FindComponentType(m_Register, resource_type, 0x0);
+    ASSERT_NE((void*) 0, (void*) type);
+    dmGameObject::ComponentTypeSetOnMessagesFn(type, CompMessageTargetOnMessages);
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_message.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+
+    dmMessage::URL sender;
+    sender.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    sender.m_Path = dmGameObject::GetIdentifier(go);
+    sender.m_Fragment = dmHashString64("script");
+    dmMessage::URL receiver;
+    receiver.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    receiver.m_Path = dmGameObject::GetIdentifier(go);
+    receiver.m_Fragment = dmHashString64("mt");
+
+    // Consecutive messages are delivered in batches of at most 32
+    dmhash_t message_id = dmHashString64("inc");
+    for (uint32_t i = 0; i < 40; ++i)
+    {
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    }
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(40U, m_MessageTargetCounter);
+    ASSERT_EQ(2U, m_MessageTargetBatchCount);
+
+    // Messages with a destroy callback split the batch and are delivered through the regular callback
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, dmHashString64("dec"), 0, 0, 0x0, 0, BatchMessageDestroyCallback));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(41U, m_MessageTargetCounter);
+    ASSERT_EQ(4U, m_MessageTargetBatchCount);
+
+    // A batch only holds messages to the same component, it's delivered before the next receiver is resolved
+    dmGameObject::HInstance go2 = dmGameObject::New(m_Collection, "/component_message.goc");
+    ASSERT_NE((void*) 0, (void*) go2);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go2, "test_instance2"));
+    dmMessage::URL receiver2 = receiver;
+    receiver2.m_Path = dmGameObject::GetIdentifier(go2);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, message_id, 0, 0, 0x0, 0, 0));
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver2, message_id, 0, 0, 0x0, 0, 0));
+    }
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(45U, m_MessageTargetCounter);
+    ASSERT_EQ(8U, m_MessageTargetBatchCount);
+
+    dmGameObject::ComponentTypeSetOnMessagesFn(type, 0);
+
+    // Without an on-messages callback, the messages of a batch are delivered one at a time
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(&sender, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    }
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(48U, m_MessageTargetCounter);
+    ASSERT_EQ(8U, m_MessageTargetBatchCount);
+
+    dmGameObject::Delete(m_Collection, go2, false);
+    dmGameObject::Delete(m_Collection, go, false);
+}
+
+TEST_F(MessageTest, TestScriptMessageBatch)
+{
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/script_message_batch.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmMessage::URL receiver;
+    receiver.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    receiver.m_Path = dmGameObject::GetIdentifier(go);
+    receiver.m_Fragment = dmHashString64("script");
+
+    // The script component receives the messages in batches, in the order they were posted
+    dmhash_t message_id = dmHashString64("inc");
+    for (uint32_t i = 0; i < 40; ++i)
+    {
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, 0, 0x0, 0, 0));
+    }
+    TestGameObjectDDF::TestMessage ddf;
+    ddf.m_TestUint32 = 40;
+    uintptr_t descriptor = (uintptr_t)TestGameObjectDDF::TestMessage::m_DDFDescriptor;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, TestGameObjectDDF::TestMessage::m_DDFDescriptor->m_NameHash, 0, descriptor, &ddf, sizeof(TestGameObjectDDF::TestMessage), 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    dmGameObject::Delete(m_Collection, go, false);
+}
+
 TEST_F(MessageTest, TestBroadcastDDFMessage)
 {
     dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_broadcast_message.goc");
@@ -14,6 +14,8 @@
 
 #include <testmain/testmain.h> // TestMainPlatformInit, TestMainIsDebuggerAttached
 #include <ddf/ddf.h>
+#include <dlib/log.h>
+#include "../gameobject_private.h"
 
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
@@ -22,6 +24,13 @@
 int main(int argc, char **argv)
 {
     TestMainPlatformInit();
+
+    // The tests access the private structs, which only match the library if it was built with the same index width
+    if (dmGameObject::GetInstanceIndexBits() != DM_GAMEOBJECT_INSTANCE_INDEX_BITS)
+    {
+        dmLogError("The gameobject library uses %u bit instance indices, but the tests were built with %u", dmGameObject::GetInstanceIndexBits(), (uint32_t) DM_GAMEOBJECT_INSTANCE_INDEX_BITS);
+        return 1;
+    }
     dmDDF::RegisterAllTypes();
     jc_test_init(&argc, argv);
     return jc_test_run_all();
@@ -63,13 +63,13 @@ namespace dmGameSystem
         dmArray<CameraComponent*> m_FocusStack;
     };
 
-    static const dmhash_t CAMERA_PROP_FOV = dmHashString64("fov");
-    static const dmhash_t CAMERA_PROP_NEAR_Z = dmHashString64("near_z");
-    static const dmhash_t CAMERA_PROP_FAR_Z = dmHashString64("far_z");
-    static const dmhash_t CAMERA_PROP_ORTHOGRAPHIC_ZOOM = dmHashString64("orthographic_zoom");
-    static const dmhash_t CAMERA_PROP_PROJECTION = dmHashString64("projection");
-    static const dmhash_t CAMERA_PROP_VIEW = dmHashString64("view");
-    static const dmhash_t CAMERA_PROP_ASPECT_RATIO = dmHashString64("aspect_ratio");
+    static const dmhash_t CAMERA_PROP_FOV = dmHashConstString64("fov");
+    static const dmhash_t CAMERA_PROP_NEAR_Z = dmHashConstString64("near_z");
+    static const dmhash_t CAMERA_PROP_FAR_Z = dmHashConstString64("far_z");
+    static const dmhash_t CAMERA_PROP_ORTHOGRAPHIC_ZOOM = dmHashConstString64("orthographic_zoom");
+    static const dmhash_t CAMERA_PROP_PROJECTION = dmHashConstString64("projection");
+    static const dmhash_t CAMERA_PROP_VIEW = dmHashConstString64("view");
+    static const dmhash_t CAMERA_PROP_ASPECT_RATIO = dmHashConstString64("aspect_ratio");
 
 
     void CompCameraUpdateViewProjection(CameraComponent* camera, dmRender::RenderContext* render_context)
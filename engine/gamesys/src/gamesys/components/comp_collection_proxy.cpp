@@ -55,10 +55,10 @@ namespace dmGameSystem
 
     const char* COLLECTION_PROXY_MAX_COUNT_KEY = "collection_proxy.max_count";
 
-    static const dmhash_t COLLECTION_PROXY_LOAD_HASH = dmHashString64("load");
-    static const dmhash_t COLLECTION_PROXY_ASYNC_LOAD_HASH = dmHashString64("async_load");
-    static const dmhash_t COLLECTION_PROXY_UNLOAD_HASH = dmHashString64("unload");
-    static const dmhash_t COLLECTION_PROXY_INIT_HASH = dmHashString64("init");
+    static const dmhash_t COLLECTION_PROXY_LOAD_HASH = dmHashConstString64("load");
+    static const dmhash_t COLLECTION_PROXY_ASYNC_LOAD_HASH = dmHashConstString64("async_load");
+    static const dmhash_t COLLECTION_PROXY_UNLOAD_HASH = dmHashConstString64("unload");
+    static const dmhash_t COLLECTION_PROXY_INIT_HASH = dmHashConstString64("init");
 
     struct CollectionProxyComponent
     {
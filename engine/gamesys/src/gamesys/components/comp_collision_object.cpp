@@ -17,9 +17,12 @@
 #include <dlib/dlib.h>
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
+#include <dlib/job_thread.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/memprofile.h>
 #include <dlib/static_assert.h>
+#include <dlib/thread.h>
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/dlib/profile.h>
 #include <dmsdk/gameobject/script.h>
@@ -56,15 +59,18 @@ namespace dmGameSystem
     const char* PHYSICS_USE_FIXED_TIMESTEP          = "physics.use_fixed_timestep";
     /// Config key for using max updates during a single step
     const char* PHYSICS_MAX_FIXED_TIMESTEPS         = "physics.max_fixed_timesteps";
+    /// Config key for stepping the 2D physics worlds on a separate thread
+    const char* PHYSICS_ASYNC_STEP                  = "physics.async_step";
 
-    static const dmhash_t PROP_LINEAR_DAMPING = dmHashString64("linear_damping");
-    static const dmhash_t PROP_ANGULAR_DAMPING = dmHashString64("angular_damping");
-    static const dmhash_t PROP_LINEAR_VELOCITY = dmHashString64("linear_velocity");
-    static const dmhash_t PROP_ANGULAR_VELOCITY = dmHashString64("angular_velocity");
-    static const dmhash_t PROP_MASS = dmHashString64("mass");
-    static const dmhash_t PROP_BULLET = dmHashString64("bullet");
+    static const dmhash_t PROP_LINEAR_DAMPING = dmHashConstString64("linear_damping");
+    static const dmhash_t PROP_ANGULAR_DAMPING = dmHashConstString64("angular_damping");
+    static const dmhash_t PROP_LINEAR_VELOCITY = dmHashConstString64("linear_velocity");
+    static const dmhash_t PROP_ANGULAR_VELOCITY = dmHashConstString64("angular_velocity");
+    static const dmhash_t PROP_MASS = dmHashConstString64("mass");
+    static const dmhash_t PROP_BULLET = dmHashConstString64("bullet");
 
     struct CollisionComponent;
+    struct CollisionWorld;
     struct JointEndPoint;
 
     /// Joint entry that will keep track of joint connections from collision components.
@@ -127,6 +133,13 @@ namespace dmGameSystem
         uint8_t m_FlippedY : 1;
     };
 
+    struct CollisionUserData
+    {
+        CollisionWorld* m_World;
+        PhysicsContext* m_Context;
+        uint32_t m_Count;
+    };
+
     struct CollisionWorld
     {
         uint64_t m_Groups[16];
@@ -143,7 +156,18 @@ namespace dmGameSystem
         uint8_t     m_ComponentTypeIndex;
         uint8_t     m_3D : 1;
         uint8_t     m_FirstUpdate : 1;
+        uint8_t     m_AsyncStep : 1;
         dmArray<CollisionComponent*> m_Components;
+
+        // The step simulated on the job thread, see StartAsyncStep()
+        dmPhysics::StepWorldContext m_StepContext;
+        CollisionUserData           m_CollisionUserData;
+        CollisionUserData           m_ContactUserData;
+        dmJobThread::Job            m_StepJob;
+        // Set while the simulation may still be running, cleared by WaitForStep()
+        dmJobThread::HGroup         m_StepGroup;
+        // Set when a step is started, cleared when it's committed
+        bool                        m_StepStarted;
     };
 
     // Forward declarations
@@ -184,6 +208,28 @@ namespace dmGameSystem
         ++g_NumPhysicsTransformsUpdated;
     }
 
+    static int SimulateStepJob(void* context, void* data)
+    {
+        CollisionWorld* world = (CollisionWorld*)data;
+        DM_PROFILE("SimulateWorld2D");
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_PHYSICS);
+        dmPhysics::SimulateWorld2D(world->m_World2D, world->m_StepContext);
+        return 0;
+    }
+
+    // Waits until the world is no longer simulated on the job thread, or simulates it on this thread if
+    // the job hasn't started yet. Must be called before the world is accessed outside of the component
+    // update, where the results of the step are committed.
+    static void WaitForStep(CollisionWorld* world)
+    {
+        if (!world->m_StepGroup)
+            return;
+
+        DM_PROFILE("WaitForStep");
+        dmJobThread::WaitGroup(world->m_CollisionUserData.m_Context->m_JobThread, world->m_StepGroup);
+        world->m_StepGroup = 0x0;
+    }
+
     dmGameObject::CreateResult CompCollisionObjectNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
         DM_STATIC_ASSERT(sizeof(ShapeInfo::m_BoxDimensions) <= sizeof(dmVMath::Vector3), Invalid_Struct_Size);
@@ -235,6 +281,10 @@ namespace dmGameSystem
         world->m_3D = physics_context->m_3D;
         world->m_FirstUpdate = 1;
         world->m_Components.SetCapacity(comp_count);
+        if (physics_context->m_AsyncStep && !physics_context->m_3D && physics_context->m_JobThread && dmThread::PlatformHasThreadSupport())
+        {
+            world->m_AsyncStep = 1;
+        }
         *params.m_World = world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -247,6 +297,8 @@ namespace dmGameSystem
         {
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        // The results of an uncommitted step are discarded along with the world
+        WaitForStep(world);
         if (physics_context->m_3D)
             dmPhysics::DeleteWorld3D(physics_context->m_Context3D, world->m_World3D);
         else
@@ -467,6 +519,7 @@ namespace dmGameSystem
         component->m_ShapeBuffer = 0;
 
         CollisionWorld* world = (CollisionWorld*)params.m_World;
+        WaitForStep(world);
         if (!CreateCollisionObject(physics_context, world, params.m_Instance, component, false))
         {
             delete component;
@@ -489,6 +542,7 @@ namespace dmGameSystem
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         CollisionComponent* component = (CollisionComponent*)*params.m_UserData;
         CollisionWorld* world = (CollisionWorld*)params.m_World;
+        WaitForStep(world);
 
         delete[] component->m_ShapeBuffer;
 
@@ -553,13 +607,6 @@ namespace dmGameSystem
         return dmGameObject::CREATE_RESULT_OK;
     }
 
-    struct CollisionUserData
-    {
-        CollisionWorld* m_World;
-        PhysicsContext* m_Context;
-        uint32_t m_Count;
-    };
-
     template <class DDFMessage>
     static void BroadCast(DDFMessage* ddf, dmGameObject::HInstance instance, dmhash_t instance_id, uint16_t component_index)
     {
@@ -923,6 +970,7 @@ namespace dmGameSystem
                     // NOTE! The collision world for the target collection is looked up using this worlds component index
                     //       which is assumed to be the same as in the target collection.
                     CollisionWorld* world = (CollisionWorld*) dmGameObject::GetWorld(collection, context->m_World->m_ComponentTypeIndex);
+                    WaitForStep(world);
 
                     // Give that the assumption above holds, this assert will hold too.
                     assert(world->m_ComponentTypeIndex == context->m_World->m_ComponentTypeIndex);
@@ -958,6 +1006,7 @@ namespace dmGameSystem
         {
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
+        WaitForStep(world);
         if (world->m_Components.Full())
         {
             ShowFullBufferError("Collision object", PHYSICS_MAX_COLLISION_OBJECTS_KEY, world->m_Components.Capacity());
@@ -1002,31 +1051,8 @@ namespace dmGameSystem
         return dispatch_context.m_Success;
     }
 
-    static void Step(CollisionWorld* world, PhysicsContext* physics_context, dmGameObject::HCollection collection, const dmPhysics::StepWorldContext* step_ctx)
+    static void CheckMessageOverflow(PhysicsContext* physics_context, const CollisionUserData* collision_user_data, const CollisionUserData* contact_user_data)
     {
-        CollisionUserData* collision_user_data = (CollisionUserData*)step_ctx->m_CollisionUserData;
-        CollisionUserData* contact_user_data = (CollisionUserData*)step_ctx->m_ContactPointUserData;
-
-        g_NumPhysicsTransformsUpdated = 0;
-
-        world->m_CurrentDT = step_ctx->m_DT;
-
-        if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, collection))
-        {
-            dmLogWarning("Failed to dispatch physics messages");
-        }
-
-        if (physics_context->m_3D)
-        {
-            DM_PROFILE("StepWorld3D");
-            dmPhysics::StepWorld3D(world->m_World3D, *step_ctx);
-        }
-        else
-        {
-            DM_PROFILE("StepWorld2D");
-            dmPhysics::StepWorld2D(world->m_World2D, *step_ctx);
-        }
-
         if (collision_user_data->m_Count >= physics_context->m_MaxCollisionCount)
         {
             if (!g_CollisionOverflowWarning)
@@ -1051,7 +1077,10 @@ namespace dmGameSystem
         {
             g_ContactOverflowWarning = false;
         }
+    }
 
+    static void DispatchStepMessages(dmGameObject::HCollection collection)
+    {
         dmMessage::HSocket socket = dmGameObject::GetMessageSocket(collection);
         dmGameObject::DispatchMessages(collection, &socket, 1);
 
@@ -1061,6 +1090,91 @@ namespace dmGameSystem
         }
     }
 
+    static void Step(CollisionWorld* world, PhysicsContext* physics_context, dmGameObject::HCollection collection, const dmPhysics::StepWorldContext* step_ctx)
+    {
+        CollisionUserData* collision_user_data = (CollisionUserData*)step_ctx->m_CollisionUserData;
+        CollisionUserData* contact_user_data = (CollisionUserData*)step_ctx->m_ContactPointUserData;
+
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_PHYSICS);
+
+        g_NumPhysicsTransformsUpdated = 0;
+
+        world->m_CurrentDT = step_ctx->m_DT;
+
+        if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, collection))
+        {
+            dmLogWarning("Failed to dispatch physics messages");
+        }
+
+        if (physics_context->m_3D)
+        {
+            DM_PROFILE("StepWorld3D");
+            dmPhysics::StepWorld3D(world->m_World3D, *step_ctx);
+        }
+        else
+        {
+            DM_PROFILE("StepWorld2D");
+            dmPhysics::StepWorld2D(world->m_World2D, *step_ctx);
+        }
+
+        CheckMessageOverflow(physics_context, collision_user_data, contact_user_data);
+        DispatchStepMessages(collection);
+    }
+
+    // Reports the results of the step started in the previous update: contacts, triggers, ray casts and the new transforms
+    static void CommitAsyncStep(CollisionWorld* world, PhysicsContext* physics_context, dmGameObject::HCollection collection)
+    {
+        if (!world->m_StepStarted)
+            return;
+
+        WaitForStep(world);
+
+        g_NumPhysicsTransformsUpdated = 0;
+        {
+            DM_PROFILE("EndStepWorld2D");
+            dmPhysics::EndStepWorld2D(world->m_World2D, world->m_StepContext);
+        }
+        world->m_StepStarted = false;
+
+        CheckMessageOverflow(physics_context, &world->m_CollisionUserData, &world->m_ContactUserData);
+        DispatchStepMessages(collection);
+    }
+
+    // Starts a step that is simulated on the job thread while the rest of the frame is updated
+    static void StartAsyncStep(CollisionWorld* world, PhysicsContext* physics_context, float dt)
+    {
+        world->m_CollisionUserData.m_World = world;
+        world->m_CollisionUserData.m_Context = physics_context;
+        world->m_CollisionUserData.m_Count = 0;
+        world->m_ContactUserData = world->m_CollisionUserData;
+
+        dmPhysics::StepWorldContext& step_world_context = world->m_StepContext;
+        step_world_context.m_CollisionCallback = CollisionCallback;
+        step_world_context.m_CollisionUserData = &world->m_CollisionUserData;
+        step_world_context.m_ContactPointCallback = ContactPointCallback;
+        step_world_context.m_ContactPointUserData = &world->m_ContactUserData;
+        step_world_context.m_TriggerEnteredCallback = TriggerEnteredCallback;
+        step_world_context.m_TriggerEnteredUserData = world;
+        step_world_context.m_TriggerExitedCallback = TriggerExitedCallback;
+        step_world_context.m_TriggerExitedUserData = world;
+        step_world_context.m_RayCastCallback = RayCastCallback;
+        step_world_context.m_RayCastUserData = world;
+        step_world_context.m_FixedTimeStep = physics_context->m_UseFixedTimestep;
+        step_world_context.m_MaxFixedTimeSteps = physics_context->m_MaxFixedTimesteps;
+        step_world_context.m_DT = dt;
+
+        world->m_CurrentDT = dt;
+
+        dmPhysics::BeginStepWorld2D(world->m_World2D, step_world_context);
+
+        world->m_StepJob.m_Process = SimulateStepJob;
+        world->m_StepJob.m_Context = 0x0;
+        world->m_StepJob.m_Data = world;
+        world->m_StepJob.m_Result = 0;
+        world->m_StepStarted = true;
+        world->m_StepGroup = dmJobThread::PushGroup(physics_context->m_JobThread, &world->m_StepJob, 1);
+    }
+
     static dmGameObject::UpdateResult CompCollisionObjectUpdateInternal(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
     {
         if (params.m_World == 0x0)
@@ -1069,6 +1183,11 @@ namespace dmGameSystem
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         CollisionWorld* world = (CollisionWorld*)params.m_World;
 
+        if (world->m_AsyncStep)
+        {
+            CommitAsyncStep(world, physics_context, params.m_Collection);
+        }
+
         // Hot-reload is not available in release, so lets not iterate collision components in that case.
         if (dLib::IsDebugMode())
         {
@@ -1096,6 +1215,19 @@ namespace dmGameSystem
             }
         }
 
+        if (world->m_AsyncStep)
+        {
+            if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, params.m_Collection))
+            {
+                dmLogWarning("Failed to dispatch physics messages");
+            }
+            dmPhysics::SetDrawDebug2D(world->m_World2D, physics_context->m_Debug);
+            StartAsyncStep(world, physics_context, params.m_UpdateContext->m_DT);
+
+            DM_PROPERTY_ADD_U32(rmtp_CollisionObject, world->m_Components.Size());
+            return dmGameObject::UPDATE_RESULT_OK;
+        }
+
         CollisionUserData collision_user_data;
         collision_user_data.m_World = world;
         collision_user_data.m_Context = physics_context;
@@ -1160,6 +1292,11 @@ namespace dmGameSystem
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         CollisionWorld* world = (CollisionWorld*)params.m_World;
 
+        // The step keeps running into the next frame. The ray casts requested since the update are
+        // performed by the next step anyway, so they are dispatched in the update instead.
+        if (world->m_AsyncStep)
+            return dmGameObject::UPDATE_RESULT_OK;
+
         // Dispatch also in post-messages since messages might have been posting from script components, or init
         // functions in factories, and they should not linger around to next frame (which might not come around)
         if (!CompCollisionObjectDispatchPhysicsMessages(physics_context, world, params.m_Collection))
@@ -1173,6 +1310,9 @@ namespace dmGameSystem
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         CollisionComponent* component = (CollisionComponent*) *params.m_UserData;
 
+        // Messages are dispatched while an async step may still be running, and most of them modify the bodies
+        WaitForStep((CollisionWorld*)params.m_World);
+
         if (params.m_Message->m_Id == dmGameObjectDDF::Enable::m_DDFDescriptor->m_NameHash
                 || params.m_Message->m_Id == dmGameObjectDDF::Disable::m_DDFDescriptor->m_NameHash)
         {
@@ -1305,6 +1445,7 @@ namespace dmGameSystem
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         CollisionWorld* world = (CollisionWorld*)params.m_World;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)*params.m_UserData;
         component->m_Resource = (CollisionObjectResource*)params.m_Resource;
         component->m_AddedToUpdate = false;
@@ -1318,6 +1459,7 @@ namespace dmGameSystem
     dmGameObject::PropertyResult CompCollisionObjectGetProperty(const dmGameObject::ComponentGetPropertyParams& params, dmGameObject::PropertyDesc& out_value) {
         CollisionComponent* component = (CollisionComponent*)*params.m_UserData;
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
+        WaitForStep((CollisionWorld*)params.m_World);
         if (params.m_PropertyId == PROP_LINEAR_VELOCITY) {
             if (physics_context->m_3D) {
                 out_value.m_Variant = dmGameObject::PropertyVar(dmPhysics::GetLinearVelocity3D(physics_context->m_Context3D, component->m_Object3D));
@@ -1369,6 +1511,7 @@ namespace dmGameSystem
     dmGameObject::PropertyResult CompCollisionObjectSetProperty(const dmGameObject::ComponentSetPropertyParams& params) {
         CollisionComponent* component = (CollisionComponent*)*params.m_UserData;
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
+        WaitForStep((CollisionWorld*)params.m_World);
 
         if (params.m_PropertyId == PROP_LINEAR_VELOCITY)
         {
@@ -1468,6 +1611,7 @@ namespace dmGameSystem
     void RayCast(void* _world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (world->m_3D)
         {
             dmPhysics::RayCast3D(world->m_World3D, request, results);
@@ -1478,6 +1622,20 @@ namespace dmGameSystem
         }
     }
 
+    void RayCastBatch(void* _world, const dmPhysics::RayCastRequest* requests, dmPhysics::RayCastResponse* responses, uint32_t count)
+    {
+        CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
+        if (world->m_3D)
+        {
+            dmPhysics::RayCastBatch3D(world->m_World3D, requests, responses, count);
+        }
+        else
+        {
+            dmPhysics::RayCastBatch2D(world->m_World2D, requests, responses, count);
+        }
+    }
+
     // Find a JointEntry in the linked list of a collision component based on the joint id.
     static JointEntry* FindJointEntry(CollisionWorld* world, CollisionComponent* component, dmhash_t id)
     {
@@ -1508,6 +1666,7 @@ namespace dmGameSystem
     dmPhysics::JointResult CreateJoint(void* _world, void* _component_a, dmhash_t id, const dmVMath::Point3& apos, void* _component_b, const dmVMath::Point3& bpos, dmPhysics::JointType type, const dmPhysics::ConnectJointParams& joint_params)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1552,6 +1711,7 @@ namespace dmGameSystem
     dmPhysics::JointResult DestroyJoint(void* _world, void* _component, dmhash_t id)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1590,6 +1750,7 @@ namespace dmGameSystem
     dmPhysics::JointResult GetJointParams(void* _world, void* _component, dmhash_t id, dmPhysics::JointType& joint_type, dmPhysics::ConnectJointParams& joint_params)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1613,6 +1774,7 @@ namespace dmGameSystem
     dmPhysics::JointResult GetJointType(void* _world, void* _component, dmhash_t id, dmPhysics::JointType& joint_type)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1636,6 +1798,7 @@ namespace dmGameSystem
     dmPhysics::JointResult SetJointParams(void* _world, void* _component, dmhash_t id, const dmPhysics::ConnectJointParams& joint_params)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1703,6 +1866,7 @@ namespace dmGameSystem
     dmPhysics::JointResult GetJointReactionForce(void* _world, void* _component, dmhash_t id, dmVMath::Vector3& force)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1725,6 +1889,7 @@ namespace dmGameSystem
     dmPhysics::JointResult GetJointReactionTorque(void* _world, void* _component, dmhash_t id, float& torque)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (!IsJointsSupported(world)) {
             return dmPhysics::RESULT_NOT_SUPPORTED;
         }
@@ -1747,6 +1912,7 @@ namespace dmGameSystem
     void SetGravity(void* _world, const dmVMath::Vector3& gravity)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (world->m_3D)
         {
             dmPhysics::SetGravity3D(world->m_World3D, gravity);
@@ -1760,6 +1926,7 @@ namespace dmGameSystem
     dmVMath::Vector3 GetGravity(void* _world)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         if (world->m_3D)
         {
             return dmPhysics::GetGravity3D(world->m_World3D);
@@ -1796,6 +1963,7 @@ namespace dmGameSystem
     {
         CollisionWorld* world         = (CollisionWorld*)_world;
         CollisionComponent* component = (CollisionComponent*) _component;
+        WaitForStep(world);
         uint32_t shape_count          = component->m_Resource->m_ShapeCount;
 
         if (shape_ix >= shape_count)
@@ -1889,6 +2057,7 @@ namespace dmGameSystem
     {
         CollisionWorld* world         = (CollisionWorld*)_world;
         CollisionComponent* component = (CollisionComponent*) _component;
+        WaitForStep(world);
         uint32_t shape_count          = component->m_Resource->m_ShapeCount;
 
         if (shape_ix >= shape_count)
@@ -1960,16 +2129,18 @@ namespace dmGameSystem
         return !world->m_3D;
     }
 
-    void SetCollisionFlipH(void* _component, bool flip)
+    void SetCollisionFlipH(void* _world, void* _component, bool flip)
     {
+        WaitForStep((CollisionWorld*)_world);
         CollisionComponent* component = (CollisionComponent*)_component;
         if (component->m_FlippedX != flip)
             dmPhysics::FlipH2D(component->m_Object2D);
         component->m_FlippedX = flip;
     }
 
-    void SetCollisionFlipV(void* _component, bool flip)
+    void SetCollisionFlipV(void* _world, void* _component, bool flip)
     {
+        WaitForStep((CollisionWorld*)_world);
         CollisionComponent* component = (CollisionComponent*)_component;
         if (component->m_FlippedY != flip)
             dmPhysics::FlipV2D(component->m_Object2D);
@@ -1979,6 +2150,7 @@ namespace dmGameSystem
     void WakeupCollision(void* _world, void* _component)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         if (world->m_3D)
@@ -2005,6 +2177,7 @@ namespace dmGameSystem
     dmhash_t GetCollisionGroup(void* _world, void* _component)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         uint16_t groupbit;
@@ -2022,6 +2195,7 @@ namespace dmGameSystem
     bool SetCollisionGroup(void* _world, void* _component, dmhash_t group_hash)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         uint16_t groupbit = GetGroupBitIndex(world, group_hash, true);
@@ -2044,6 +2218,7 @@ namespace dmGameSystem
     bool GetCollisionMaskBit(void* _world, void* _component, dmhash_t group_hash, bool* maskbit)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         uint16_t groupbit = GetGroupBitIndex(world, group_hash, true);
@@ -2065,6 +2240,7 @@ namespace dmGameSystem
     bool SetCollisionMaskBit(void* _world, void* _component, dmhash_t group_hash, bool boolvalue)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         uint16_t groupbit = GetGroupBitIndex(world, group_hash, true);
@@ -2086,6 +2262,7 @@ namespace dmGameSystem
     void UpdateMass(void* _world, void* _component, float mass)
     {
         CollisionWorld* world = (CollisionWorld*)_world;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)_component;
 
         if (world->m_3D)
@@ -2104,6 +2281,7 @@ namespace dmGameSystem
     static bool CompCollisionIterPropertiesGetNext(dmGameObject::SceneNodePropertyIterator* pit)
     {
         CollisionWorld* world = (CollisionWorld*)pit->m_Node->m_ComponentWorld;
+        WaitForStep(world);
         CollisionComponent* component = (CollisionComponent*)pit->m_Node->m_Component;
 
         uint64_t index = pit->m_Next++;
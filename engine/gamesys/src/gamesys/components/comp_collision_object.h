@@ -60,6 +60,7 @@ namespace dmGameSystem
 
     // For script_physics.cpp
     void RayCast(void* world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
+    void RayCastBatch(void* world, const dmPhysics::RayCastRequest* requests, dmPhysics::RayCastResponse* responses, uint32_t count);
     uint64_t GetLSBGroupHash(void* world, uint16_t mask);
     dmhash_t CompCollisionObjectGetIdentifier(void* component);
 
@@ -75,8 +76,8 @@ namespace dmGameSystem
     dmVMath::Vector3 GetGravity(void* _world);
 
     bool IsCollision2D(void* _world);
-    void SetCollisionFlipH(void* _component, bool flip);
-    void SetCollisionFlipV(void* _component, bool flip);
+    void SetCollisionFlipH(void* _world, void* _component, bool flip);
+    void SetCollisionFlipV(void* _world, void* _component, bool flip);
     void WakeupCollision(void* _world, void* _component);
     dmhash_t GetCollisionGroup(void* _world, void* _component);
     bool SetCollisionGroup(void* _world, void* _component, dmhash_t group_hash);
@@ -193,7 +193,11 @@ namespace dmGameSystem
 
         // Grows automatically
         gui_world->m_ClientVertexBuffer.SetCapacity(512);
-        gui_world->m_VertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            gui_world->m_VertexBuffers[i] = dmGraphics::NewVertexBuffer(graphics_context, 0, 0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        }
+        gui_world->m_VertexBuffer = gui_world->m_VertexBuffers[0];
 
         uint8_t white_texture[] = { 0xff, 0xff, 0xff, 0xff,
                                     0xff, 0xff, 0xff, 0xff,
@@ -277,7 +281,10 @@ namespace dmGameSystem
         }
 
         dmGraphics::DeleteVertexDeclaration(gui_world->m_VertexDeclaration);
-        dmGraphics::DeleteVertexBuffer(gui_world->m_VertexBuffer);
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            dmGraphics::DeleteVertexBuffer(gui_world->m_VertexBuffers[i]);
+        }
         dmGraphics::DeleteTexture(gui_world->m_WhiteTexture);
 
         dmScript::DeleteScriptWorld(gui_world->m_ScriptWorld);
@@ -856,6 +863,7 @@ namespace dmGameSystem
         dmRender::HRenderContext    m_RenderContext;
         dmRender::HMaterial         m_Material;
         GuiWorld*                   m_GuiWorld;
+        GuiComponent*               m_Component;
 
         // This order value is increased during rendering for each
         // render object generated, then used to make sure the final
@@ -1076,6 +1084,72 @@ namespace dmGameSystem
         dmRender::FlushTexts(gui_context->m_RenderContext, dmRender::RENDER_ORDER_AFTER_WORLD, MakeFinalRenderOrder(dmGui::GetRenderOrder(scene), gui_context->m_NextSortOrder++), false);
     }
 
+    // Adds the range [start, end) to a sorted list of ranges. Overlapping or adjacent ranges are merged.
+    // When the list is full, the two ranges with the smallest gap between them are merged.
+    static void AddVertexRange(VertexRange* ranges, uint32_t* count, uint32_t start, uint32_t end)
+    {
+        uint32_t n = *count;
+
+        // Vertices are mostly written in order, so the new range usually goes last
+        uint32_t i = n;
+        while (i > 0 && ranges[i-1].m_Start > start)
+            --i;
+
+        if (i > 0 && ranges[i-1].m_End >= start)
+        {
+            // Extend the previous range
+            --i;
+            ranges[i].m_End = dmMath::Max(ranges[i].m_End, end);
+        }
+        else
+        {
+            memmove(&ranges[i+1], &ranges[i], (n - i) * sizeof(VertexRange));
+            ranges[i].m_Start = start;
+            ranges[i].m_End = end;
+            ++n;
+        }
+
+        // Merge the following ranges that now overlap
+        uint32_t j = i + 1;
+        while (j < n && ranges[j].m_Start <= ranges[i].m_End)
+        {
+            ranges[i].m_End = dmMath::Max(ranges[i].m_End, ranges[j].m_End);
+            ++j;
+        }
+        if (j > i + 1)
+        {
+            memmove(&ranges[i+1], &ranges[j], (n - j) * sizeof(VertexRange));
+            n -= j - (i + 1);
+        }
+
+        if (n > GUI_MAX_DIRTY_VERTEX_RANGES)
+        {
+            uint32_t best = 0;
+            for (uint32_t k = 1; k < n - 1; ++k)
+            {
+                if (ranges[k+1].m_Start - ranges[k].m_End < ranges[best+1].m_Start - ranges[best].m_End)
+                    best = k;
+            }
+            ranges[best].m_End = ranges[best+1].m_End;
+            memmove(&ranges[best+1], &ranges[best+2], (n - best - 2) * sizeof(VertexRange));
+            --n;
+        }
+
+        *count = n;
+    }
+
+    // Marks the vertices [start, end) of the client vertex buffer as changed, so they are uploaded at the end of the frame.
+    // The range is added to every vertex buffer, since each one needs all changes made since it was last uploaded.
+    static inline void MarkVertexRangeDirty(GuiWorld* gui_world, uint32_t start, uint32_t end)
+    {
+        if (start >= end)
+            return;
+        for (uint32_t i = 0; i < GUI_VERTEX_BUFFER_COUNT; ++i)
+        {
+            AddVertexRange(gui_world->m_DirtyVertexRanges[i], &gui_world->m_DirtyVertexRangeCount[i], start, end);
+        }
+    }
+
     static void RenderParticlefxNodes(dmGui::HScene scene,
                           const dmGui::RenderEntry* entries,
                           const Matrix4* node_transforms,
@@ -1198,6 +1272,7 @@ namespace dmGameSystem
 
         ApplyStencilClipping(gui_context, stencil_scopes[0], ro);
         gui_world->m_ClientVertexBuffer.SetSize(vb_end - gui_world->m_ClientVertexBuffer.Begin());
+        MarkVertexRangeDirty(gui_world, ro.m_VertexStart, gui_world->m_ClientVertexBuffer.Size());
     }
 
     static GuiRenderObject* GetRenderObject(RenderGuiContext* gui_context)
@@ -1286,6 +1361,8 @@ namespace dmGameSystem
             memcpy(gui_world->m_ClientVertexBuffer.Begin() + node_vertex_start, node_vertices.Begin(), node_vertex_count * sizeof(BoxVertex));
         }
 
+        MarkVertexRangeDirty(gui_world, vertex_start, gui_world->m_ClientVertexBuffer.Size());
+
         ro.Init();
         ro.m_VertexDeclaration = gui_world->m_VertexDeclaration;
         ro.m_VertexBuffer      = gui_world->m_VertexBuffer;
@@ -1309,6 +1386,271 @@ namespace dmGameSystem
         }
     }
 
+    // Pushes the vertices of a box node to the vertex buffer and returns the number of vertices added
+    static uint32_t PushBoxNodeVertices(dmArray<BoxVertex>& vertex_buffer, const BoxNodeVertexKey& key)
+    {
+        const Matrix4& transform = key.m_Transform;
+        const Vector4& pm_color = key.m_Color;
+        const Vector4& slice9 = key.m_Slice9;
+        const float* tc = key.m_TexCoords;
+        bool use_slice_nine = sum(slice9) != 0;
+
+        // render simple quad ignoring 9-slicing
+        if ((!use_slice_nine && key.m_ManualTexture) || !key.m_Texture)
+        {
+            BoxVertex v00;
+            v00.SetColor(pm_color);
+            v00.SetPosition(transform * Point3(0, 0, 0));
+            v00.SetUV(0, 0);
+            v00.SetPageIndex(0);
+
+            BoxVertex v10;
+            v10.SetColor(pm_color);
+            v10.SetPosition(transform * Point3(1, 0, 0));
+            v10.SetUV(1, 0);
+            v10.SetPageIndex(0);
+
+            BoxVertex v01;
+            v01.SetColor(pm_color);
+            v01.SetPosition(transform * Point3(0, 1, 0));
+            v01.SetUV(0, 1);
+            v01.SetPageIndex(0);
+
+            BoxVertex v11;
+            v11.SetColor(pm_color);
+            v11.SetPosition(transform * Point3(1, 1, 0));
+            v11.SetUV(1, 1);
+            v11.SetPageIndex(0);
+
+            vertex_buffer.Push(v00);
+            vertex_buffer.Push(v10);
+            vertex_buffer.Push(v11);
+            vertex_buffer.Push(v00);
+            vertex_buffer.Push(v11);
+            vertex_buffer.Push(v01);
+            return 6;
+        }
+
+        uint32_t frame_index                               = key.m_FrameIndex;
+        uint32_t page_index                                = key.m_PageIndex;
+        const dmGameSystemDDF::TextureSet* texture_set_ddf = (const dmGameSystemDDF::TextureSet*) key.m_TextureSet;
+        bool use_geometries                                = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
+        bool flip_u                                        = key.m_FlipU;
+        bool flip_v                                        = key.m_FlipV;
+
+        // render using geometries without 9-slicing
+        if (!use_slice_nine && use_geometries)
+        {
+            const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+
+            // NOTE: The original rendering code is from the comp_sprite.cpp.
+            // Compare with that one if you do any changes to either.
+            uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+
+            const float* points = geometry->m_Vertices.m_Data;
+            const float* uvs = geometry->m_Uvs.m_Data;
+
+            // Depending on the sprite is flipped or not, we loop the vertices forward or backward
+            // to respect face winding (and backface culling)
+            int reverse = (int)flip_u ^ (int)flip_v;
+
+            float scaleX = flip_u ? -1 : 1;
+            float scaleY = flip_v ? -1 : 1;
+
+            // Since we don't use an index buffer, we duplicate the vertices manually
+            uint32_t index_count = geometry->m_Indices.m_Count;
+            for (uint32_t index = 0; index < index_count; ++index)
+            {
+                uint32_t i = geometry->m_Indices.m_Data[index];
+                i = reverse ? (num_points - i - 1) : i;
+
+                const float* point = &points[i * 2];
+                const float* uv = &uvs[i * 2];
+                // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
+                float x = point[0] * scaleX + 0.5f;
+                float y = point[1] * scaleY + 0.5f;
+
+                Vector4 p = transform * Point3(x, y, 0.0f);
+                BoxVertex v(p, uv[0], uv[1], pm_color, page_index);
+                vertex_buffer.Push(v);
+            }
+
+            return index_count;
+        }
+
+        // render 9-sliced node
+
+        //   0 1     2 3
+        // 0 *-*-----*-*
+        //   | |  y  | |
+        // 1 *-*-----*-*
+        //   | |     | |
+        //   |x|     |z|
+        //   | |     | |
+        // 2 *-*-----*-*
+        //   | |  w  | |
+        // 3 *-*-----*-*
+        float us[4], vs[4], xs[4], ys[4];
+
+        // v are '1-v'
+        xs[0] = ys[0] = 0;
+        xs[3] = ys[3] = 1;
+
+        // disable slice9 computation below a certain dimension
+        // (avoid div by zero)
+        const float s9_min_dim = 0.001f;
+
+        const float su = 1.0f / key.m_OriginalWidth;
+        const float sv = 1.0f / key.m_OriginalHeight;
+
+        const Point3& size = key.m_Size;
+        const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
+        const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+
+        static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
+        bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+        if(uv_rotated)
+        {
+            const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getW());
+            us[uI[2]] = tc[2] - (su * slice9.getY());
+            us[uI[3]] = tc[2];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] - (sv * slice9.getX());
+            vs[vI[2]] = tc[5] + (sv * slice9.getZ());
+            vs[vI[3]] = tc[5];
+        }
+        else
+        {
+            const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getX());
+            us[uI[2]] = tc[4] - (su * slice9.getZ());
+            us[uI[3]] = tc[4];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] + (sv * slice9.getW());
+            vs[vI[2]] = tc[3] - (sv * slice9.getY());
+            vs[vI[3]] = tc[3];
+        }
+
+        xs[1] = sx * slice9.getX();
+        xs[2] = 1 - sx * slice9.getZ();
+        ys[1] = sy * slice9.getW();
+        ys[2] = 1 - sy * slice9.getY();
+
+        Vector4 pts[4][4];
+        for (int y=0;y<4;y++)
+        {
+            for (int x=0;x<4;x++)
+            {
+                pts[y][x] = (transform * Point3(xs[x], ys[y], 0));
+            }
+        }
+
+        BoxVertex v00, v10, v01, v11;
+        v00.SetColor(pm_color);
+        v10.SetColor(pm_color);
+        v01.SetColor(pm_color);
+        v11.SetColor(pm_color);
+
+        v00.SetPageIndex(page_index);
+        v10.SetPageIndex(page_index);
+        v01.SetPageIndex(page_index);
+        v11.SetPageIndex(page_index);
+
+        for (int y=0;y<3;y++)
+        {
+            for (int x=0;x<3;x++)
+            {
+                const int x0 = x;
+                const int x1 = x+1;
+                const int y0 = y;
+                const int y1 = y+1;
+                v00.SetPosition(pts[y0][x0]);
+                v10.SetPosition(pts[y0][x1]);
+                v01.SetPosition(pts[y1][x0]);
+                v11.SetPosition(pts[y1][x1]);
+                if(uv_rotated)
+                {
+                    v00.SetUV(us[y0], vs[x0]);
+                    v10.SetUV(us[y0], vs[x1]);
+                    v01.SetUV(us[y1], vs[x0]);
+                    v11.SetUV(us[y1], vs[x1]);
+                }
+                else
+                {
+                    v00.SetUV(us[x0], vs[y0]);
+                    v10.SetUV(us[x1], vs[y0]);
+                    v01.SetUV(us[x0], vs[y1]);
+                    v11.SetUV(us[x1], vs[y1]);
+                }
+                vertex_buffer.Push(v00);
+                vertex_buffer.Push(v10);
+                vertex_buffer.Push(v11);
+                vertex_buffer.Push(v00);
+                vertex_buffer.Push(v11);
+                vertex_buffer.Push(v01);
+            }
+        }
+        return 6*9;
+    }
+
+    template <typename T>
+    static T* GetNodeVertexCache(dmArray<T>& vertex_cache, dmGui::HNode node)
+    {
+        // The lower 16 bits of a node handle is the index of the node in the scene
+        uint32_t index = node & 0xffff;
+        if (index >= vertex_cache.Size())
+        {
+            uint32_t old_size = vertex_cache.Size();
+            if (index >= vertex_cache.Capacity())
+            {
+                vertex_cache.SetCapacity(dmMath::Max(index + 1, old_size * 2));
+            }
+            vertex_cache.SetSize(index + 1);
+            memset(vertex_cache.Begin() + old_size, 0, (index + 1 - old_size) * sizeof(T));
+        }
+        return &vertex_cache[index];
+    }
+
+    // Pushes the vertices of a node, and returns the number of vertices. The vertices written by the node last frame
+    // are reused if its key is unchanged and nothing has overwritten them so far this frame, i.e. they are located at
+    // or after the current write position.
+    template <typename Cache, typename Key>
+    static uint32_t PushCachedNodeVertices(GuiWorld* gui_world, Cache* cache, const Key& key, bool can_reuse_vertices,
+                                           uint32_t (*push_vertices)(dmArray<BoxVertex>&, const Key&))
+    {
+        dmArray<BoxVertex>& vertex_buffer = gui_world->m_ClientVertexBuffer;
+        uint32_t vertex_start = vertex_buffer.Size();
+
+        if (can_reuse_vertices &&
+            cache->m_VertexCount > 0 &&
+            cache->m_Generation + 1 == gui_world->m_RenderGeneration &&
+            cache->m_VertexStart >= vertex_start &&
+            memcmp(&cache->m_Key, &key, sizeof(key)) == 0)
+        {
+            if (cache->m_VertexStart != vertex_start)
+            {
+                memmove(vertex_buffer.Begin() + vertex_start, vertex_buffer.Begin() + cache->m_VertexStart, cache->m_VertexCount * sizeof(BoxVertex));
+                MarkVertexRangeDirty(gui_world, vertex_start, vertex_start + cache->m_VertexCount);
+            }
+            vertex_buffer.SetSize(vertex_start + cache->m_VertexCount);
+        }
+        else
+        {
+            cache->m_Key = key;
+            cache->m_VertexCount = push_vertices(vertex_buffer, key);
+            MarkVertexRangeDirty(gui_world, vertex_start, vertex_start + cache->m_VertexCount);
+        }
+
+        cache->m_VertexStart = vertex_start;
+        cache->m_Generation = gui_world->m_RenderGeneration;
+        return cache->m_VertexCount;
+    }
+
     static void RenderBoxNodes(dmGui::HScene scene,
                         const dmGui::RenderEntry* entries,
                         const Matrix4* node_transforms,
@@ -1365,14 +1707,27 @@ namespace dmGameSystem
         float org_height = (float)dmGraphics::GetOriginalTextureHeight(ro.m_Textures[0]);
         assert(org_width > 0 && org_height > 0);
 
+        GuiComponent* component = gui_context->m_Component;
+        dmArray<BoxVertex>& vertex_buffer = gui_world->m_ClientVertexBuffer;
+
+        // Vertices from the previous frame are only still around if the buffer wasn't reallocated
+        bool can_reuse_vertices = vertex_buffer.Begin() == gui_world->m_ClientVertexBufferBase;
+
         int rendered_vert_count = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
             const dmGui::HNode node = entries[i].m_Node;
 
+            BoxNodeVertexKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform      = node_transforms[i];
+            key.m_Texture        = texture;
+            key.m_OriginalWidth  = org_width;
+            key.m_OriginalHeight = org_height;
+
             // pre-multiplied alpha
             const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
+            key.m_Color = Vector4(color.getXYZ(), node_opacities[i]);
 
             // default not uv_rotated texture coords
             const float default_tc[6] = {0, 0, 0, 1, 1, 1};
@@ -1383,250 +1738,189 @@ namespace dmGameSystem
             if (manually_set_texture) {
                 tc = default_tc;
             }
+            memcpy(key.m_TexCoords, tc, sizeof(key.m_TexCoords));
+            key.m_ManualTexture = manually_set_texture;
 
-            Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
-            bool use_slice_nine = sum(slice9) != 0;
-
-            // render simple quad ignoring 9-slicing
-            if ((!use_slice_nine && manually_set_texture) || !texture)
-            {
-                BoxVertex v00;
-                v00.SetColor(pm_color);
-                v00.SetPosition(node_transforms[i] * Point3(0, 0, 0));
-                v00.SetUV(0, 0);
-                v00.SetPageIndex(0);
-
-                BoxVertex v10;
-                v10.SetColor(pm_color);
-                v10.SetPosition(node_transforms[i] * Point3(1, 0, 0));
-                v10.SetUV(1, 0);
-                v10.SetPageIndex(0);
-
-                BoxVertex v01;
-                v01.SetColor(pm_color);
-                v01.SetPosition(node_transforms[i] * Point3(0, 1, 0));
-                v01.SetUV(0, 1);
-                v01.SetPageIndex(0);
-
-                BoxVertex v11;
-                v11.SetColor(pm_color);
-                v11.SetPosition(node_transforms[i] * Point3(1, 1, 0));
-                v11.SetUV(1, 1);
-                v11.SetPageIndex(0);
-
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v10);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v01);
-
-                rendered_vert_count += 6;
-                continue;
-            }
+            key.m_Slice9 = dmGui::GetNodeSlice9(scene, node);
+            key.m_Size   = dmGui::GetNodeSize(scene, node);
 
-            uint32_t frame_index                         = 0;
-            uint32_t page_index                          = 0;
-            dmGui::TextureSetAnimDesc* anim_desc         = dmGui::GetNodeTextureSet(scene, node);
-            dmGameSystemDDF::TextureSet* texture_set_ddf = 0;
+            dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
             if (anim_desc)
             {
-                texture_set_ddf        = (dmGameSystemDDF::TextureSet*) anim_desc->m_TextureSet;
-                frame_index            = dmGui::GetNodeAnimationFrame(scene, node);
-                frame_index            = texture_set_ddf->m_FrameIndices[frame_index];
-                uint32_t* page_indices = texture_set_ddf->m_PageIndices.m_Data;
-                page_index             = page_indices[frame_index];
+                dmGameSystemDDF::TextureSet* texture_set_ddf = (dmGameSystemDDF::TextureSet*) anim_desc->m_TextureSet;
+                uint32_t frame_index                         = dmGui::GetNodeAnimationFrame(scene, node);
+                frame_index                                  = texture_set_ddf->m_FrameIndices[frame_index];
+                key.m_TextureSet                             = texture_set_ddf;
+                key.m_FrameIndex                             = frame_index;
+                key.m_PageIndex                              = texture_set_ddf->m_PageIndices.m_Data[frame_index];
             }
 
-            bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
-            bool flip_u = false;
-            bool flip_v = false;
             if (!manually_set_texture)
             {
+                bool flip_u = false;
+                bool flip_v = false;
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
+                key.m_FlipU = flip_u;
+                key.m_FlipV = flip_v;
             }
 
-            // render using geometries without 9-slicing
-            if (!use_slice_nine && use_geometries)
-            {
-                const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+            BoxNodeVertexCache* cache = GetNodeVertexCache(component->m_BoxVertexCache, node);
+            rendered_vert_count += PushCachedNodeVertices(gui_world, cache, key, can_reuse_vertices, PushBoxNodeVertices);
+        }
 
-                const Matrix4& w = node_transforms[i];
+        ro.m_VertexCount = rendered_vert_count;
+    }
 
-                // NOTE: The original rendering code is from the comp_sprite.cpp.
-                // Compare with that one if you do any changes to either.
-                uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+    // Computes max vertices required in the vertex buffer to draw a pie node with a
+    // given number of perimeter vertices in its configuration.
+    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
+    {
+        // 1.  Minimum is capped to 4
+        // 2a. There will always be one extra needed to complete a full fill.
+        //     I.e. an 8-gon will need 9 vertices around, where the first and last
+        //     overlap. (+1)
+        // 2b. If the shape has rectangular bounds and pass through all four corners,
+        //     there will be 4 vertices inserted around the loop. (+4)
+        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
+        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
+        //     doubled vertices to tie it together (+2)
+        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+    }
 
-                const float* points = geometry->m_Vertices.m_Data;
-                const float* uvs = geometry->m_Uvs.m_Data;
+    static uint32_t PushPieNodeVertices(dmArray<BoxVertex>& vertex_buffer, const PieNodeVertexKey& key)
+    {
+        const Matrix4& transform = key.m_Transform;
+        const Vector4& pm_color = key.m_Color;
+        const uint32_t page_index = key.m_PageIndex;
+        const uint32_t perimeterVertices = key.m_PerimeterVertices;
+        const float innerMultiplier = key.m_InnerMultiplier;
+        const dmGui::PieBounds outerBounds = (dmGui::PieBounds) key.m_OuterBounds;
 
-                // Depending on the sprite is flipped or not, we loop the vertices forward or backward
-                // to respect face winding (and backface culling)
-                int reverse = (int)flip_u ^ (int)flip_v;
+        const float PI = 3.1415926535f;
+        const float ad = PI * 2.0f / (float)perimeterVertices;
 
-                float scaleX = flip_u ? -1 : 1;
-                float scaleY = flip_v ? -1 : 1;
+        float stopAngle = key.m_FillAngle;
+        bool backwards = false;
+        if (stopAngle < 0)
+        {
+            stopAngle = -stopAngle;
+            backwards = true;
+        }
 
-                // Since we don't use an index buffer, we duplicate the vertices manually
-                uint32_t index_count = geometry->m_Indices.m_Count;
-                for (uint32_t index = 0; index < index_count; ++index)
-                {
-                    uint32_t i = geometry->m_Indices.m_Data[index];
-                    i = reverse ? (num_points - i - 1) : i;
-
-                    const float* point = &points[i * 2];
-                    const float* uv = &uvs[i * 2];
-                    // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
-                    float x = point[0] * scaleX + 0.5f;
-                    float y = point[1] * scaleY + 0.5f;
-
-                    Vector4 p = w * Point3(x, y, 0.0f);
-                    BoxVertex v(p, uv[0], uv[1], pm_color, page_index);
-                    gui_world->m_ClientVertexBuffer.Push(v);
-                }
+        stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
 
-                rendered_vert_count += index_count;
-                continue;
-            }
+        // 1. Division computes number of cirlce segments needed, and we need 1 more
+        // vertex than that (1 lone segment = 2 perimeter vertices).
+        // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
+        // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
+        // floating point imprecision)
+        const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
 
-            // render 9-sliced node
-
-            //   0 1     2 3
-            // 0 *-*-----*-*
-            //   | |  y  | |
-            // 1 *-*-----*-*
-            //   | |     | |
-            //   |x|     |z|
-            //   | |     | |
-            // 2 *-*-----*-*
-            //   | |  w  | |
-            // 3 *-*-----*-*
-            float us[4], vs[4], xs[4], ys[4];
-
-            // v are '1-v'
-            xs[0] = ys[0] = 0;
-            xs[3] = ys[3] = 1;
-
-            // disable slice9 computation below a certain dimension
-            // (avoid div by zero)
-            const float s9_min_dim = 0.001f;
-
-            const float su = 1.0f / org_width;
-            const float sv = 1.0f / org_height;
-
-            Point3 size = dmGui::GetNodeSize(scene, node);
-            const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
-            const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
-
-            static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
-            bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-            if(uv_rotated)
-            {
-                const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getW());
-                us[uI[2]] = tc[2] - (su * slice9.getY());
-                us[uI[3]] = tc[2];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] - (sv * slice9.getX());
-                vs[vI[2]] = tc[5] + (sv * slice9.getZ());
-                vs[vI[3]] = tc[5];
+        float lastAngle = 0;
+        float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
+        bool first = true;
+
+        float u0,su,v0,sv;
+        bool uv_rotated;
+
+        if(key.m_HasTexCoords)
+        {
+            const float* tc = key.m_TexCoords;
+            bool flip_u = key.m_FlipU;
+            bool flip_v = key.m_FlipV;
+            uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+            if(uv_rotated ? flip_v : flip_u)
+            {
+                su = -(tc[4] - tc[0]);
+                u0 = tc[0] - su;
             }
             else
             {
-                const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getX());
-                us[uI[2]] = tc[4] - (su * slice9.getZ());
-                us[uI[3]] = tc[4];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] + (sv * slice9.getW());
-                vs[vI[2]] = tc[3] - (sv * slice9.getY());
-                vs[vI[3]] = tc[3];
+                u0 = tc[0];
+                su = tc[4] - u0;
             }
+            uint32_t v0i = uv_rotated ? 1 : 3;
+            uint32_t v1i = uv_rotated ? 5 : 1;
+            if(uv_rotated ? flip_u : flip_v)
+            {
+                sv = -(tc[v1i] - tc[v0i]);
+                v0 = tc[v0i] - sv;
+            }
+            else
+            {
+                v0 = tc[v0i];
+                sv = tc[v1i] - v0;
+            }
+        }
+        else
+        {
+            uv_rotated = false;
+            u0 = 0.0f;
+            su = 1.0f;
+            v0 = 1.0f;
+            sv = -1.0f;
+        }
 
-            xs[1] = sx * slice9.getX();
-            xs[2] = 1 - sx * slice9.getZ();
-            ys[1] = sy * slice9.getW();
-            ys[2] = 1 - sy * slice9.getY();
+        uint32_t sizeBefore = vertex_buffer.Size();
+        for (uint32_t j = 0; j != generate; j++)
+        {
+            float a;
+            if (j == (generate-1))
+                a = stopAngle;
+            else
+                a = ad * j;
 
-            const Matrix4* transform = &node_transforms[i];
-            Vector4 pts[4][4];
-            for (int y=0;y<4;y++)
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
             {
-                for (int x=0;x<4;x++)
+                // insert extra vertex (and ignore == case)
+                if (lastAngle < nextCorner && a >= nextCorner)
                 {
-                    pts[y][x] = (*transform * Point3(xs[x], ys[y], 0));
+                    a = nextCorner;
+                    nextCorner += 0.50f * PI;
+                    --j;
                 }
+
+                lastAngle = a;
             }
 
-            BoxVertex v00, v10, v01, v11;
-            v00.SetColor(pm_color);
-            v10.SetColor(pm_color);
-            v01.SetColor(pm_color);
-            v11.SetColor(pm_color);
+            const float s = dmTrigLookup::Sin(backwards ? -a : a);
+            const float c = dmTrigLookup::Cos(backwards ? -a : a);
 
-            v00.SetPageIndex(page_index);
-            v10.SetPageIndex(page_index);
-            v01.SetPageIndex(page_index);
-            v11.SetPageIndex(page_index);
+            // make inner vertex
+            float u = 0.5f + innerMultiplier * c;
+            float v = 0.5f + innerMultiplier * s;
+            BoxVertex vInner(transform * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color, page_index);
+
+            // make outer vertex
+            float d;
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
+                d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
+            else
+                d = 0.5f;
 
-            for (int y=0;y<3;y++)
+            u = 0.5f + d * c;
+            v = 0.5f + d * s;
+            BoxVertex vOuter(transform * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color, page_index);
+
+            // both inner & outer are doubled at first / last entry to generate degenerate triangles
+            // for the triangle strip, allowing more than one pie to be chained together in the same
+            // drawcall.
+            if (first)
             {
-                for (int x=0;x<3;x++)
-                {
-                    const int x0 = x;
-                    const int x1 = x+1;
-                    const int y0 = y;
-                    const int y1 = y+1;
-                    v00.SetPosition(pts[y0][x0]);
-                    v10.SetPosition(pts[y0][x1]);
-                    v01.SetPosition(pts[y1][x0]);
-                    v11.SetPosition(pts[y1][x1]);
-                    if(uv_rotated)
-                    {
-                        v00.SetUV(us[y0], vs[x0]);
-                        v10.SetUV(us[y0], vs[x1]);
-                        v01.SetUV(us[y1], vs[x0]);
-                        v11.SetUV(us[y1], vs[x1]);
-                    }
-                    else
-                    {
-                        v00.SetUV(us[x0], vs[y0]);
-                        v10.SetUV(us[x1], vs[y0]);
-                        v01.SetUV(us[x0], vs[y1]);
-                        v11.SetUV(us[x1], vs[y1]);
-                    }
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v10);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v01);
-                }
+                vertex_buffer.Push(vInner);
+                first = false;
             }
-            rendered_vert_count += verts_per_node;
-        }
 
-        ro.m_VertexCount = rendered_vert_count;
-    }
+            vertex_buffer.Push(vInner);
+            vertex_buffer.Push(vOuter);
 
-    // Computes max vertices required in the vertex buffer to draw a pie node with a
-    // given number of perimeter vertices in its configuration.
-    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
-    {
-        // 1.  Minimum is capped to 4
-        // 2a. There will always be one extra needed to complete a full fill.
-        //     I.e. an 8-gon will need 9 vertices around, where the first and last
-        //     overlap. (+1)
-        // 2b. If the shape has rectangular bounds and pass through all four corners,
-        //     there will be 4 vertices inserted around the loop. (+4)
-        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
-        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
-        //     doubled vertices to tie it together (+2)
-        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+            if (j == generate-1)
+                vertex_buffer.Push(vOuter);
+        }
+
+        uint32_t vertex_count = vertex_buffer.Size() - sizeBefore;
+        assert(vertex_count <= ComputeRequiredVertices(perimeterVertices));
+        return vertex_count;
     }
 
     static void RenderPieNodes(dmGui::HScene scene,
@@ -1683,6 +1977,12 @@ namespace dmGameSystem
             gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, max_total_vertices));
         }
 
+        GuiComponent* component = gui_context->m_Component;
+
+        // Vertices from the previous frame are only still around if the buffer wasn't reallocated
+        bool can_reuse_vertices = gui_world->m_ClientVertexBuffer.Begin() == gui_world->m_ClientVertexBufferBase;
+
+        uint32_t rendered_vert_count = 0;
         for (uint32_t i = 0; i < node_count; ++i)
         {
             const dmGui::HNode node = entries[i].m_Node;
@@ -1691,7 +1991,10 @@ namespace dmGameSystem
             if (dmMath::Abs(size.getX()) < 0.001f)
                 continue;
 
-            uint32_t page_index                  = 0;
+            PieNodeVertexKey key;
+            memset(&key, 0, sizeof(key));
+            key.m_Transform = node_transforms[i];
+
             dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
             if (anim_desc)
             {
@@ -1699,144 +2002,34 @@ namespace dmGameSystem
                 uint32_t frame_index                         = dmGui::GetNodeAnimationFrame(scene, node);
                 frame_index                                  = texture_set_ddf->m_FrameIndices[frame_index];
                 uint32_t* page_indices                       = texture_set_ddf->m_PageIndices.m_Data;
-                page_index                                   = page_indices[frame_index];
+                key.m_PageIndex                              = page_indices[frame_index];
             }
 
-            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
-
             // Pre-multiplied alpha
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
-
-            const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
-            const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
-            const dmGui::PieBounds outerBounds = dmGui::GetNodeOuterBounds(scene, node);
-
-            const float PI = 3.1415926535f;
-            const float ad = PI * 2.0f / (float)perimeterVertices;
-
-            float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
-            bool backwards = false;
-            if (stopAngle < 0)
-            {
-                stopAngle = -stopAngle;
-                backwards = true;
-            }
-
-            stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
-
-            // 1. Division computes number of cirlce segments needed, and we need 1 more
-            // vertex than that (1 lone segment = 2 perimeter vertices).
-            // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
-            // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
-            // floating point imprecision)
-            const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
+            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
+            key.m_Color = Vector4(color.getXYZ(), node_opacities[i]);
 
-            float lastAngle = 0;
-            float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
-            bool first = true;
+            key.m_PerimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
+            key.m_InnerMultiplier   = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
+            key.m_OuterBounds       = dmGui::GetNodeOuterBounds(scene, node);
+            key.m_FillAngle         = dmGui::GetNodePieFillAngle(scene, node);
 
-            float u0,su,v0,sv;
-            bool uv_rotated;
             const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-
-            if(tc)
+            if (tc)
             {
                 bool flip_u, flip_v;
                 GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
-                uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-                if(uv_rotated ? flip_v : flip_u)
-                {
-                    su = -(tc[4] - tc[0]);
-                    u0 = tc[0] - su;
-                }
-                else
-                {
-                    u0 = tc[0];
-                    su = tc[4] - u0;
-                }
-                uint32_t v0i = uv_rotated ? 1 : 3;
-                uint32_t v1i = uv_rotated ? 5 : 1;
-                if(uv_rotated ? flip_u : flip_v)
-                {
-                    sv = -(tc[v1i] - tc[v0i]);
-                    v0 = tc[v0i] - sv;
-                }
-                else
-                {
-                    v0 = tc[v0i];
-                    sv = tc[v1i] - v0;
-                }
-            }
-            else
-            {
-                uv_rotated = false;
-                u0 = 0.0f;
-                su = 1.0f;
-                v0 = 1.0f;
-                sv = -1.0f;
+                memcpy(key.m_TexCoords, tc, sizeof(key.m_TexCoords));
+                key.m_HasTexCoords = 1;
+                key.m_FlipU = flip_u;
+                key.m_FlipV = flip_v;
             }
 
-            uint32_t sizeBefore = gui_world->m_ClientVertexBuffer.Size();
-            for (uint32_t j = 0; j != generate; j++)
-            {
-                float a;
-                if (j == (generate-1))
-                    a = stopAngle;
-                else
-                    a = ad * j;
-
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                {
-                    // insert extra vertex (and ignore == case)
-                    if (lastAngle < nextCorner && a >= nextCorner)
-                    {
-                        a = nextCorner;
-                        nextCorner += 0.50f * PI;
-                        --j;
-                    }
-
-                    lastAngle = a;
-                }
-
-                const float s = dmTrigLookup::Sin(backwards ? -a : a);
-                const float c = dmTrigLookup::Cos(backwards ? -a : a);
-
-                // make inner vertex
-                float u = 0.5f + innerMultiplier * c;
-                float v = 0.5f + innerMultiplier * s;
-                BoxVertex vInner(node_transforms[i] * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color, page_index);
-
-                // make outer vertex
-                float d;
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                    d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
-                else
-                    d = 0.5f;
-
-                u = 0.5f + d * c;
-                v = 0.5f + d * s;
-                BoxVertex vOuter(node_transforms[i] * Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color, page_index);
-
-                // both inner & outer are doubled at first / last entry to generate degenerate triangles
-                // for the triangle strip, allowing more than one pie to be chained together in the same
-                // drawcall.
-                if (first)
-                {
-                    gui_world->m_ClientVertexBuffer.Push(vInner);
-                    first = false;
-                }
-
-                gui_world->m_ClientVertexBuffer.Push(vInner);
-                gui_world->m_ClientVertexBuffer.Push(vOuter);
-
-                if (j == generate-1)
-                    gui_world->m_ClientVertexBuffer.Push(vOuter);
-            }
-
-            assert((gui_world->m_ClientVertexBuffer.Size() - sizeBefore) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node)));
+            PieNodeVertexCache* cache = GetNodeVertexCache(component->m_PieVertexCache, node);
+            rendered_vert_count += PushCachedNodeVertices(gui_world, cache, key, can_reuse_vertices, PushPieNodeVertices);
         }
 
-        ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+        ro.m_VertexCount = rendered_vert_count;
     }
 
     static uint64_t GetCombinedNodeType(uint32_t node_type, uint32_t custom_type)
@@ -2010,13 +2203,46 @@ namespace dmGameSystem
                     break;
             }
         }
+    }
+
+    // Uploads the vertices that changed since the current vertex buffer was last used.
+    // The graphics buffer is only reallocated when it needs to grow.
+    static void UploadVertexBuffer(GuiWorld* gui_world)
+    {
+        DM_PROFILE("UploadVertexBuffer");
+
+        const dmArray<BoxVertex>& vertex_buffer = gui_world->m_ClientVertexBuffer;
+        uint32_t vertex_count = vertex_buffer.Size();
+        uint32_t current = gui_world->m_CurrentVertexBuffer;
+        VertexRange* ranges = gui_world->m_DirtyVertexRanges[current];
+        uint32_t range_count = gui_world->m_DirtyVertexRangeCount[current];
+
+        if (vertex_count > gui_world->m_VertexBufferVertexCount[current])
+        {
+            dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
+                                            vertex_count * sizeof(BoxVertex),
+                                            vertex_buffer.Begin(),
+                                            dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+            gui_world->m_VertexBufferVertexCount[current] = vertex_count;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < range_count; ++i)
+            {
+                uint32_t start = ranges[i].m_Start;
+                uint32_t end = dmMath::Min(ranges[i].m_End, vertex_count);
+                if (start >= end)
+                    break;
+                dmGraphics::SetVertexBufferSubData(gui_world->m_VertexBuffer,
+                                                   start * sizeof(BoxVertex),
+                                                   (end - start) * sizeof(BoxVertex),
+                                                   vertex_buffer.Begin() + start);
+            }
+        }
 
-        dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
-                                        gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
-                                        gui_world->m_ClientVertexBuffer.Begin(),
-                                        dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        gui_world->m_DirtyVertexRangeCount[current] = 0;
 
-        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, gui_world->m_ClientVertexBuffer.Size());
+        DM_PROPERTY_ADD_U32(rmtp_GuiVertexCount, vertex_count);
     }
 
     static dmGraphics::TextureFormat ToGraphicsFormat(dmImage::Type type) {
@@ -2276,6 +2502,10 @@ namespace dmGameSystem
 
         gui_world->m_GuiRenderObjects.SetSize(0);
         gui_world->m_ClientVertexBuffer.SetSize(0);
+        gui_world->m_ClientVertexBufferBase = gui_world->m_ClientVertexBuffer.Begin();
+        gui_world->m_RenderGeneration++;
+        gui_world->m_CurrentVertexBuffer = gui_world->m_RenderGeneration % GUI_VERTEX_BUFFER_COUNT;
+        gui_world->m_VertexBuffer = gui_world->m_VertexBuffers[gui_world->m_CurrentVertexBuffer];
 
         uint32_t lastEnd = 0;
 
@@ -2287,6 +2517,7 @@ namespace dmGameSystem
 
             // Render scene and see how many render objects it added, then we add those individually.
             render_gui_context.m_Material = GetMaterial(c, c->m_Resource);
+            render_gui_context.m_Component = c;
             dmGui::RenderScene(c->m_Scene, rp, &render_gui_context);
             const uint32_t count = gui_world->m_GuiRenderObjects.Size() - lastEnd;
 
@@ -2312,6 +2543,8 @@ namespace dmGameSystem
             dmRender::RenderListSubmit(gui_context->m_RenderContext, render_list, write_ptr);
         }
 
+        UploadVertexBuffer(gui_world);
+
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
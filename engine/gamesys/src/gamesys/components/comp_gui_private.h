@@ -31,6 +31,60 @@ namespace dmGameSystem
     struct GuiSceneResource;
     struct MaterialResource;
 
+    // The inputs the vertices of a box node are generated from. If the key of a node
+    // is unchanged since the previous frame, its vertices can be reused as is.
+    struct BoxNodeVertexKey
+    {
+        dmVMath::Matrix4        m_Transform;
+        dmVMath::Vector4        m_Color;
+        dmVMath::Vector4        m_Slice9;
+        dmVMath::Point3         m_Size;
+        float                   m_TexCoords[6];
+        float                   m_OriginalWidth;
+        float                   m_OriginalHeight;
+        dmGraphics::HTexture    m_Texture;
+        const void*             m_TextureSet;
+        uint32_t                m_FrameIndex;
+        uint32_t                m_PageIndex;
+        uint32_t                m_ManualTexture : 1;
+        uint32_t                m_FlipU         : 1;
+        uint32_t                m_FlipV         : 1;
+        uint32_t                m_Padding       : 29;
+    };
+
+    struct BoxNodeVertexCache
+    {
+        BoxNodeVertexKey        m_Key;
+        uint32_t                m_VertexStart;
+        uint32_t                m_VertexCount;
+        uint32_t                m_Generation;
+    };
+
+    // The inputs the vertices of a pie node are generated from, see BoxNodeVertexKey
+    struct PieNodeVertexKey
+    {
+        dmVMath::Matrix4        m_Transform;
+        dmVMath::Vector4        m_Color;
+        float                   m_TexCoords[6];
+        float                   m_InnerMultiplier;
+        float                   m_FillAngle;
+        uint32_t                m_PerimeterVertices;
+        uint32_t                m_PageIndex;
+        uint32_t                m_OuterBounds;
+        uint32_t                m_HasTexCoords  : 1;
+        uint32_t                m_FlipU         : 1;
+        uint32_t                m_FlipV         : 1;
+        uint32_t                m_Padding       : 29;
+    };
+
+    struct PieNodeVertexCache
+    {
+        PieNodeVertexKey        m_Key;
+        uint32_t                m_VertexStart;
+        uint32_t                m_VertexCount;
+        uint32_t                m_Generation;
+    };
+
     struct GuiComponent
     {
         struct GuiWorld*        m_World;
@@ -44,6 +98,8 @@ namespace dmGameSystem
         uint8_t                 m_Initialized   : 1;
         uint8_t                 m_Padding       : 5;
         dmArray<void*>          m_ResourcePropertyPointers;
+        dmArray<BoxNodeVertexCache> m_BoxVertexCache; // indexed by node index
+        dmArray<PieNodeVertexCache> m_PieVertexCache; // indexed by node index
     };
 
     struct BoxVertex
@@ -128,17 +184,42 @@ namespace dmGameSystem
         CompGuiNodeSetNodeDescFn    m_SetNodeDesc;
     };
 
+    static const uint32_t GUI_VERTEX_BUFFER_COUNT = 2;
+    static const uint32_t GUI_MAX_DIRTY_VERTEX_RANGES = 8;
+
+    // Range of vertices [start, end)
+    struct VertexRange
+    {
+        uint32_t m_Start;
+        uint32_t m_End;
+    };
+
     struct GuiWorld
     {
         dmArray<GuiRenderObject>                 m_GuiRenderObjects;
         dmArray<HComponentRenderConstants>       m_RenderConstants;
         dmArray<GuiComponent*>                   m_Components;
         dmGraphics::HVertexDeclaration           m_VertexDeclaration;
+        // The vertex buffer used this frame, one of m_VertexBuffers
         dmGraphics::HVertexBuffer                m_VertexBuffer;
+        // The vertex buffers are used every other frame, so that a partial upload never writes to
+        // a buffer the previous frame might still be drawing from (e.g. with Vulkan, where the
+        // upload writes directly to the buffer memory)
+        dmGraphics::HVertexBuffer                m_VertexBuffers[GUI_VERTEX_BUFFER_COUNT];
         dmBuffer::StreamDeclaration*             m_BoxVertexStreamDeclaration;
         uint32_t                                 m_BoxVertexStreamDeclarationCount;
         uint32_t                                 m_BoxVertexStructSize;
         dmArray<BoxVertex>                       m_ClientVertexBuffer;
+        // Start of the client vertex buffer when the frame began. Used to detect if the buffer was reallocated.
+        const BoxVertex*                         m_ClientVertexBufferBase;
+        // Ranges of vertices written since each vertex buffer was last uploaded, sorted by start.
+        // The extra slot holds a new range until it has been merged with the others.
+        VertexRange                              m_DirtyVertexRanges[GUI_VERTEX_BUFFER_COUNT][GUI_MAX_DIRTY_VERTEX_RANGES + 1];
+        uint32_t                                 m_DirtyVertexRangeCount[GUI_VERTEX_BUFFER_COUNT];
+        // Number of vertices allocated in each graphics vertex buffer
+        uint32_t                                 m_VertexBufferVertexCount[GUI_VERTEX_BUFFER_COUNT];
+        uint32_t                                 m_CurrentVertexBuffer;
+        uint32_t                                 m_RenderGeneration;
         dmGraphics::HTexture                     m_WhiteTexture;
         dmParticle::HParticleContext             m_ParticleContext;
         dmParticle::ParticleVertexAttributeInfos m_ParticleAttributeInfos;
@@ -98,9 +98,9 @@ namespace dmGameSystem
     DM_GAMESYS_PROP_VECTOR4(LABEL_PROP_COLOR, color, false);
     DM_GAMESYS_PROP_VECTOR4(LABEL_PROP_OUTLINE, outline, false);
     DM_GAMESYS_PROP_VECTOR4(LABEL_PROP_SHADOW, shadow, false);
-    static const dmhash_t LABEL_PROP_LEADING = dmHashString64("leading");
-    static const dmhash_t LABEL_PROP_TRACKING = dmHashString64("tracking");
-    static const dmhash_t LABEL_PROP_LINE_BREAK = dmHashString64("line_break");
+    static const dmhash_t LABEL_PROP_LEADING = dmHashConstString64("leading");
+    static const dmhash_t LABEL_PROP_TRACKING = dmHashConstString64("tracking");
+    static const dmhash_t LABEL_PROP_LINE_BREAK = dmHashConstString64("line_break");
 
     dmGameObject::CreateResult CompLabelNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
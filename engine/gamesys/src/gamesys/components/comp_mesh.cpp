@@ -212,9 +212,9 @@ namespace dmGameSystem
 
     static const uint32_t MAX_TEXTURE_COUNT = dmRender::RenderObject::MAX_TEXTURE_COUNT;
 
-    static const dmhash_t PROP_VERTICES = dmHashString64("vertices");
+    static const dmhash_t PROP_VERTICES = dmHashConstString64("vertices");
 
-    static const uint64_t AABB_HASH = dmHashString64("AABB");
+    static const uint64_t AABB_HASH = dmHashConstString64("AABB");
 
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams& params);
 
@@ -16,6 +16,7 @@
 
 #include <string.h>
 #include <float.h>
+#include <algorithm>
 
 #include <dlib/array.h>
 #include <dlib/hash.h>
@@ -59,11 +60,17 @@ namespace dmGameSystem
     using namespace dmGameSystemDDF;
 
     static const uint16_t ATTRIBUTE_RENDER_DATA_INDEX_UNUSED = 0xffff;
+    static const uint16_t ATTRIBUTE_OFFSET_UNUSED            = 0xffff;
 
     struct MeshAttributeRenderData
     {
+        dmVMath::Matrix4               m_World;             // The world transform written to the vertex buffer
         dmGraphics::HVertexBuffer      m_VertexBuffer;
         dmGraphics::HVertexDeclaration m_VertexDeclaration;
+        uint8_t*                       m_Vertex;            // The custom attributes are the same for all vertices
+        uint16_t                       m_VertexSize;
+        uint16_t                       m_WorldMatrixOffset; // Offset of the "mtx_world" attribute in the vertex, if any
+        uint16_t                       m_NormalMatrixOffset;
     };
 
     struct MeshRenderItem
@@ -93,6 +100,7 @@ namespace dmGameSystem
         dmMessage::URL              m_Listener;
         int                         m_FunctionRef;
         HComponentRenderConstants   m_RenderConstants;
+        dmRender::HNamedConstantBuffer m_SkinningConstants; // Pose matrices and render constants when skinned on the GPU
         TextureResource*            m_Textures[dmRender::RenderObject::MAX_TEXTURE_COUNT];
         MaterialResource*           m_Material; // Override material
 
@@ -108,11 +116,20 @@ namespace dmGameSystem
         uint8_t                     : 4;
     };
 
+    struct InstancedRenderItem
+    {
+        const MeshRenderItem* m_RenderItem;
+        dmRender::HMaterial   m_Material;
+    };
+
     struct ModelWorld
     {
         dmObjectPool<ModelComponent*>    m_Components;
         dmArray<dmRender::RenderObject>  m_RenderObjects;
         dmGraphics::HVertexDeclaration   m_VertexDeclaration;
+        dmGraphics::HVertexDeclaration   m_SkinVertexDeclaration;
+        // Temporary scratch array for the pose matrices of a rig instance, only used during rendering
+        dmArray<dmVMath::Matrix4>        m_ScratchPoseMatrices;
         dmRender::HBufferedRenderBuffer* m_VertexBuffers;
         dmArray<uint8_t>*                m_VertexBufferData;
         uint32_t*                        m_VertexBufferVertexCounts;
@@ -120,16 +137,23 @@ namespace dmGameSystem
         // Temporary scratch array for instances, only used during the creation phase of components
         dmArray<dmGameObject::HInstance> m_ScratchInstances;
         dmRig::HRigContext               m_RigContext;
+        // Per instance data for the instanced draw calls of the current frame
+        InstanceBufferPool               m_InstanceBuffers;
+        // Temporary scratch array for render items that are drawn instanced, only used during rendering
+        dmArray<InstancedRenderItem>     m_ScratchInstancedItems;
+        // Temporary scratch array for custom vertex attributes, only used during rendering
+        dmArray<uint8_t>                 m_ScratchAttributeData;
         uint32_t                         m_MaxElementsVertices;
         uint32_t                         m_MaxBatchIndex;
+        uint8_t                          m_InstancingSupported : 1;
     };
 
     static const uint32_t VERTEX_BUFFER_MAX_BATCHES = 16;     // Max dmRender::RenderListEntry.m_MinorOrder (4 bits)
 
-    static const dmhash_t PROP_SKIN = dmHashString64("skin");
-    static const dmhash_t PROP_ANIMATION = dmHashString64("animation");
-    static const dmhash_t PROP_CURSOR = dmHashString64("cursor");
-    static const dmhash_t PROP_PLAYBACK_RATE = dmHashString64("playback_rate");
+    static const dmhash_t PROP_SKIN = dmHashConstString64("skin");
+    static const dmhash_t PROP_ANIMATION = dmHashConstString64("animation");
+    static const dmhash_t PROP_CURSOR = dmHashConstString64("cursor");
+    static const dmhash_t PROP_PLAYBACK_RATE = dmHashConstString64("playback_rate");
 
     static const uint32_t MAX_TEXTURE_COUNT = dmRender::RenderObject::MAX_TEXTURE_COUNT;
 
@@ -168,6 +192,8 @@ namespace dmGameSystem
         world->m_MaxBatchIndex = 0;
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
         world->m_MaxElementsVertices = dmGraphics::GetMaxElementsVertices(graphics_context);
+        world->m_InstancingSupported = dmGraphics::IsContextFeatureSupported(graphics_context, dmGraphics::CONTEXT_FEATURE_INSTANCING);
+        world->m_InstanceBuffers.m_UsedCount = 0;
         world->m_VertexBuffers = new dmRender::HBufferedRenderBuffer[VERTEX_BUFFER_MAX_BATCHES];
         world->m_VertexBufferData = new dmArray<uint8_t>[VERTEX_BUFFER_MAX_BATCHES];
         world->m_VertexBufferVertexCounts = new uint32_t[VERTEX_BUFFER_MAX_BATCHES];
@@ -181,6 +207,13 @@ namespace dmGameSystem
 
         dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 
+        DM_STATIC_ASSERT( sizeof(ModelSkinVertex) == ((4+4)*4), Invalid_Struct_Size);
+        stream_declaration = dmGraphics::NewVertexStreamDeclaration(graphics_context);
+        dmGraphics::AddVertexStream(stream_declaration, "bone_weights", 4, dmGraphics::TYPE_FLOAT, false);
+        dmGraphics::AddVertexStream(stream_declaration, "bone_indices", 4, dmGraphics::TYPE_FLOAT, false);
+        world->m_SkinVertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
+        dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+
         *params.m_World = world;
 
         dmResource::RegisterResourceReloadedCallback(context->m_Factory, ResourceReloadedCallback, world);
@@ -193,6 +226,7 @@ namespace dmGameSystem
         ModelContext* context = (ModelContext*)params.m_Context;
         ModelWorld* world = (ModelWorld*)params.m_World;
         dmGraphics::DeleteVertexDeclaration(world->m_VertexDeclaration);
+        dmGraphics::DeleteVertexDeclaration(world->m_SkinVertexDeclaration);
         for(uint32_t i = 0; i < VERTEX_BUFFER_MAX_BATCHES; ++i)
         {
             dmRender::DeleteBufferedRenderBuffer(context->m_RenderContext, world->m_VertexBuffers[i]);
@@ -202,6 +236,8 @@ namespace dmGameSystem
 
         dmRig::DeleteContext(world->m_RigContext);
 
+        DestroyInstanceBufferPool(world->m_InstanceBuffers);
+
         delete [] world->m_VertexBufferData;
         delete [] world->m_VertexBufferVertexCounts;
         delete [] world->m_VertexBufferDispatchCounts;
@@ -490,7 +526,7 @@ namespace dmGameSystem
         return true;
     }
 
-    static bool HasCustomVertexAttributes(dmRender::HMaterial material)
+    static bool HasCustomVertexAttributes(dmRender::HMaterial material, bool include_instance_attributes)
     {
         const dmGraphics::VertexAttribute* attributes = 0;
         uint32_t attribute_count = 0;
@@ -498,6 +534,10 @@ namespace dmGameSystem
         for (int i = 0; i < attribute_count; ++i)
         {
             const dmGraphics::VertexAttribute& attr = attributes[i];
+            if (!include_instance_attributes && attr.m_StepFunction == dmGraphics::VertexAttribute::STEP_FUNCTION_INSTANCE)
+            {
+                continue;
+            }
             if (!IsDefaultStream(attr.m_NameHash, attr.m_SemanticType))
             {
                 return true;
@@ -506,6 +546,13 @@ namespace dmGameSystem
         return false;
     }
 
+    static inline bool IsTransformMatrixAttribute(const dmGraphics::VertexAttribute* attr, uint32_t byte_size)
+    {
+        return (attr->m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX ||
+                attr->m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL_MATRIX) &&
+               byte_size == sizeof(dmVMath::Matrix4);
+    }
+
     static void FillAttributeInfos(dmRig::AttributeInfo* material_infos, uint32_t material_infos_count, const dmGraphics::VertexAttribute* attributes, uint32_t attribute_count, dmRig::AttributeInfo* attribute_infos)
     {
         for (int i = 0; i < material_infos_count; ++i)
@@ -557,6 +604,9 @@ namespace dmGameSystem
         uint8_t* scratch_attribute_vertex = (uint8_t*) malloc(dmGraphics::GetVertexDeclarationStride(material_vx_decl));
         uint32_t custom_vertex_size       = 0;
 
+        rd->m_WorldMatrixOffset  = ATTRIBUTE_OFFSET_UNUSED;
+        rd->m_NormalMatrixOffset = ATTRIBUTE_OFFSET_UNUSED;
+
         for (int i = 0; i < material_attributes_count; ++i)
         {
             const dmGraphics::VertexAttribute* attr = attributes[i].m_Attribute;
@@ -571,34 +621,89 @@ namespace dmGameSystem
                     dmGraphics::GetGraphicsType(attr->m_DataType),
                     attr->m_Normalize);
 
+                // Per instance attributes share the buffer with the other custom attributes, since there is
+                // no vertex buffer slot left for them. The transform matrices are written per render item.
+                if (IsTransformMatrixAttribute(attr_material, attributes[i].m_ValueByteSize))
+                {
+                    if (attr_material->m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX)
+                        rd->m_WorldMatrixOffset = custom_vertex_size;
+                    else
+                        rd->m_NormalMatrixOffset = custom_vertex_size;
+                }
+
                 uint8_t* data_write_ptr = scratch_attribute_vertex + custom_vertex_size;
                 memcpy(data_write_ptr, attributes[i].m_ValuePtr, attributes[i].m_ValueByteSize);
                 custom_vertex_size += attributes[i].m_ValueByteSize;
             }
         }
 
+        rd->m_Vertex            = scratch_attribute_vertex;
+        rd->m_VertexSize        = custom_vertex_size;
+        rd->m_VertexBuffer      = dmGraphics::NewVertexBuffer(graphics_context, 0, 0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        rd->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
+
+        dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+    }
+
+    // Fills the custom attribute buffer of a render item, and refills it when the world transform
+    // of the item changes if the material reads the transform from the vertex data.
+    static void UpdateMeshAttributeRenderData(ModelWorld* world, const MeshRenderItem* render_item, MeshAttributeRenderData* rd, bool initial)
+    {
+        bool has_transform = rd->m_WorldMatrixOffset != ATTRIBUTE_OFFSET_UNUSED || rd->m_NormalMatrixOffset != ATTRIBUTE_OFFSET_UNUSED;
+        if (!initial && (!has_transform || memcmp(&rd->m_World, &render_item->m_World, sizeof(Matrix4)) == 0))
+        {
+            return;
+        }
+
+        rd->m_World = render_item->m_World;
+        if (rd->m_WorldMatrixOffset != ATTRIBUTE_OFFSET_UNUSED)
+        {
+            memcpy(rd->m_Vertex + rd->m_WorldMatrixOffset, &rd->m_World, sizeof(Matrix4));
+        }
+        if (rd->m_NormalMatrixOffset != ATTRIBUTE_OFFSET_UNUSED)
+        {
+            Matrix4 normal_matrix = dmVMath::Transpose(dmVMath::Inverse(rd->m_World));
+            memcpy(rd->m_Vertex + rd->m_NormalMatrixOffset, &normal_matrix, sizeof(Matrix4));
+        }
+
         uint32_t vertex_count     = render_item->m_Buffers->m_VertexCount;
-        uint32_t vertex_data_size = custom_vertex_size * vertex_count;
-        void* attribute_data      = malloc(vertex_data_size);
-        uint8_t* vertex_write_ptr = (uint8_t*) attribute_data;
+        uint32_t vertex_data_size = rd->m_VertexSize * vertex_count;
 
-        for (int i = 0; i < vertex_count; ++i)
+        dmArray<uint8_t>& attribute_data = world->m_ScratchAttributeData;
+        if (attribute_data.Capacity() < vertex_data_size)
         {
-            memcpy(vertex_write_ptr, scratch_attribute_vertex, custom_vertex_size);
-            vertex_write_ptr += custom_vertex_size;
+            attribute_data.SetCapacity(vertex_data_size);
         }
+        attribute_data.SetSize(vertex_data_size);
 
-        rd->m_VertexBuffer      = dmGraphics::NewVertexBuffer(graphics_context, vertex_data_size, attribute_data, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
-        rd->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
+        uint8_t* vertex_write_ptr = attribute_data.Begin();
+        for (int i = 0; i < vertex_count; ++i)
+        {
+            memcpy(vertex_write_ptr, rd->m_Vertex, rd->m_VertexSize);
+            vertex_write_ptr += rd->m_VertexSize;
+        }
 
-        dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+        dmGraphics::SetVertexBufferData(rd->m_VertexBuffer, vertex_data_size, attribute_data.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+    }
 
-        free(attribute_data);
-        free(scratch_attribute_vertex);
+    static void DestroyMeshAttributeRenderDatas(ModelComponent* component)
+    {
+        for (uint32_t i = 0; i < component->m_MeshAttributeRenderDatas.Size(); ++i)
+        {
+            MeshAttributeRenderData& rd = component->m_MeshAttributeRenderDatas[i];
+            if (rd.m_VertexBuffer)
+                dmGraphics::DeleteVertexBuffer(rd.m_VertexBuffer);
+            if (rd.m_VertexDeclaration)
+                dmGraphics::DeleteVertexDeclaration(rd.m_VertexDeclaration);
+            free(rd.m_Vertex);
+        }
+        component->m_MeshAttributeRenderDatas.SetSize(0);
     }
 
     static void SetupRenderItems(ModelComponent* component, ModelResource* resource)
     {
+        DestroyMeshAttributeRenderDatas(component);
+
         component->m_RenderItems.SetCapacity(resource->m_Meshes.Size());
         component->m_RenderItems.SetSize(0);
 
@@ -632,7 +737,8 @@ namespace dmGameSystem
                 }
             }
 
-            if (HasCustomVertexAttributes(GetMaterial(component, component->m_Resource, item.m_MaterialIndex)))
+            // Per instance attributes (e.g "mtx_world") are bound from a separate instance buffer when drawing
+            if (HasCustomVertexAttributes(GetMaterial(component, component->m_Resource, item.m_MaterialIndex), false))
             {
                 item.m_AttributeRenderDataIndex = num_custom_attributes;
                 num_custom_attributes++;
@@ -757,6 +863,12 @@ namespace dmGameSystem
             dmGameSystem::DestroyRenderConstants(component->m_RenderConstants);
         }
 
+        if (component->m_SkinningConstants) {
+            dmRender::DeleteNamedConstantBuffer(component->m_SkinningConstants);
+        }
+
+        DestroyMeshAttributeRenderDatas(component);
+
         delete component;
         world->m_Components.Free(index, true);
     }
@@ -779,23 +891,228 @@ namespace dmGameSystem
         return dmGameObject::CREATE_RESULT_OK;
     }
 
+    // Skinned meshes are skinned in the vertex shader if the material declares the pose matrices,
+    // otherwise the CPU generates the vertices (world space materials) or the bind pose is used.
+    static bool IsSkinnedOnGPU(const MeshRenderItem* render_item, dmRender::HMaterial material)
+    {
+        const ModelComponent* component = render_item->m_Component;
+        bool skinned = component->m_RigInstance &&
+                       GetSkinVertexBuffer(render_item->m_Buffers) &&
+                       render_item->m_BoneIndex == dmRig::INVALID_BONE_INDEX &&
+                       render_item->m_AttributeRenderDataIndex == ATTRIBUTE_RENDER_DATA_INDEX_UNUSED &&
+                       dmRig::GetBoneCount(component->m_RigInstance) > 0;
+        if (!skinned)
+        {
+            return false;
+        }
+
+        dmRender::HConstant pose_matrices;
+        if (!dmRender::GetMaterialProgramConstant(material, UNIFORM_POSE_MATRICES, pose_matrices))
+        {
+            return false;
+        }
+
+        // The skin data and the per instance attributes would both need the second vertex buffer
+        if (dmRender::GetInstanceVertexDeclaration(material))
+        {
+            dmLogOnceWarning("Models can't be skinned in the vertex shader with a material that has per instance attributes (e.g. 'mtx_world'). The bind pose is used instead.");
+            return false;
+        }
+
+        // A matrix takes four values in the constant
+        uint32_t num_values;
+        dmRender::GetConstantValues(pose_matrices, &num_values);
+        uint32_t max_bone_count = num_values / 4;
+        uint32_t bone_count     = dmRig::GetBoneCount(component->m_RigInstance);
+        if (bone_count > max_bone_count)
+        {
+            dmLogOnceWarning("The model skeleton has %u bones, but the material only has room for %u '%s' matrices. The bind pose is used instead.",
+                bone_count, max_bone_count, dmHashReverseSafe64(UNIFORM_POSE_MATRICES));
+            return false;
+        }
+        return true;
+    }
+
+    // The pose matrices are set in a constant buffer of their own, together with a copy of the
+    // render constants of the component, so that the render constants are left untouched.
+    static void SetSkinningConstants(ModelWorld* world, ModelComponent* component, dmRender::RenderObject* ro)
+    {
+        if (!component->m_SkinningConstants)
+        {
+            component->m_SkinningConstants = dmRender::NewNamedConstantBuffer();
+        }
+
+        dmRender::HNamedConstantBuffer constant_buffer = component->m_SkinningConstants;
+        dmRender::ClearNamedConstantBuffer(constant_buffer);
+
+        if (component->m_RenderConstants)
+        {
+            uint32_t constant_count = GetRenderConstantCount(component->m_RenderConstants);
+            for (uint32_t i = 0; i < constant_count; ++i)
+            {
+                dmRender::HConstant constant = GetRenderConstant(component->m_RenderConstants, i);
+                dmRender::SetNamedConstants(constant_buffer, &constant, 1);
+            }
+        }
+
+        uint32_t bone_count = dmRig::GeneratePoseMatrices(component->m_RigInstance, world->m_ScratchPoseMatrices);
+        dmRender::SetNamedConstant(constant_buffer, UNIFORM_POSE_MATRICES, (dmVMath::Vector4*) world->m_ScratchPoseMatrices.Begin(), bone_count * 4, dmRenderDDF::MaterialDesc::CONSTANT_TYPE_USER_MATRIX4);
+
+        ro->m_ConstantBuffer = constant_buffer;
+    }
+
+    // Binds the per instance attributes for an item that is drawn on its own. Without instancing support
+    // the attributes are read per vertex, so the instance data is repeated for each vertex of the mesh.
+    static void SetSingleInstanceAttributes(ModelWorld* world, dmGraphics::HContext graphics_context, dmRender::HMaterial material, const MeshRenderItem* render_item, dmRender::RenderObject* ro)
+    {
+        dmGraphics::HVertexDeclaration instance_declaration = dmRender::GetInstanceVertexDeclaration(material);
+        uint32_t instance_stride = dmGraphics::GetVertexDeclarationStride(instance_declaration);
+        uint32_t repeat_count    = world->m_InstancingSupported ? 1 : render_item->m_Buffers->m_VertexCount;
+
+        dmArray<uint8_t>& instance_data = world->m_InstanceBuffers.m_Data;
+        if (instance_data.Capacity() < instance_stride * repeat_count)
+        {
+            instance_data.SetCapacity(instance_stride * repeat_count);
+        }
+        instance_data.SetSize(instance_stride * repeat_count);
+
+        uint8_t* instance = instance_data.Begin();
+        WriteInstanceAttributes(material, render_item->m_World, instance);
+        for (uint32_t i = 1; i < repeat_count; ++i)
+        {
+            memcpy(instance + i * instance_stride, instance, instance_stride);
+        }
+
+        ro->m_VertexDeclarations[1] = instance_declaration;
+        ro->m_VertexBuffers[1]      = AddInstanceBuffer(graphics_context, world->m_InstanceBuffers);
+    }
+
+    static bool InstancedRenderItemLess(const InstancedRenderItem& a, const InstancedRenderItem& b)
+    {
+        if (a.m_RenderItem->m_Buffers != b.m_RenderItem->m_Buffers)
+            return a.m_RenderItem->m_Buffers < b.m_RenderItem->m_Buffers;
+        return a.m_Material < b.m_Material;
+    }
+
+    // Renders all items sharing the same mesh and material with one instanced draw call per group.
+    // The items are part of the same batch, so they also share textures and render constants.
+    // The items are reordered, so this is only used when blending is disabled.
+    static void RenderBatchInstanced(ModelWorld* world, dmRender::HRenderContext render_context, InstancedRenderItem* items, uint32_t item_count)
+    {
+        DM_PROFILE("RenderBatchInstanced");
+
+        std::sort(items, items + item_count, InstancedRenderItemLess);
+
+        dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
+
+        uint32_t group_start = 0;
+        while (group_start < item_count)
+        {
+            const MeshRenderItem* first_item    = items[group_start].m_RenderItem;
+            dmRender::HMaterial material        = items[group_start].m_Material;
+            const ModelResourceBuffers* buffers = first_item->m_Buffers;
+
+            uint32_t group_end = group_start + 1;
+            while (group_end < item_count && items[group_end].m_RenderItem->m_Buffers == buffers && items[group_end].m_Material == material)
+            {
+                ++group_end;
+            }
+            uint32_t instance_count = group_end - group_start;
+
+            dmGraphics::HVertexDeclaration instance_declaration = dmRender::GetInstanceVertexDeclaration(material);
+            uint32_t instance_stride = dmGraphics::GetVertexDeclarationStride(instance_declaration);
+
+            dmArray<uint8_t>& instance_data = world->m_InstanceBuffers.m_Data;
+            if (instance_data.Capacity() < instance_stride * instance_count)
+            {
+                instance_data.SetCapacity(instance_stride * instance_count);
+            }
+            instance_data.SetSize(instance_stride * instance_count);
+
+            uint8_t* write_ptr = instance_data.Begin();
+            for (uint32_t i = group_start; i < group_end; ++i)
+            {
+                write_ptr = WriteInstanceAttributes(material, items[i].m_RenderItem->m_World, write_ptr);
+            }
+
+            world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
+            dmRender::RenderObject& ro = world->m_RenderObjects.Back();
+
+            ro.Init();
+            ro.m_Material              = material;
+            ro.m_PrimitiveType         = dmGraphics::PRIMITIVE_TRIANGLES;
+            ro.m_VertexDeclarations[0] = world->m_VertexDeclaration;
+            ro.m_VertexBuffers[0]      = buffers->m_VertexBuffer;
+            ro.m_VertexDeclarations[1] = instance_declaration;
+            ro.m_VertexBuffers[1]      = AddInstanceBuffer(graphics_context, world->m_InstanceBuffers);
+            ro.m_VertexStart           = 0;
+            ro.m_VertexCount           = buffers->m_IndexCount;
+            ro.m_InstanceCount         = instance_count;
+            ro.m_WorldTransform        = first_item->m_World;
+            ro.m_IndexBuffer           = buffers->m_IndexBuffer;
+            ro.m_IndexType             = buffers->m_IndexBufferElementType;
+
+            DM_PROPERTY_ADD_U32(rmtp_ModelIndexCount, buffers->m_IndexCount * instance_count);
+            DM_PROPERTY_ADD_U32(rmtp_ModelVertexCount, buffers->m_VertexCount * instance_count);
+            DM_PROPERTY_ADD_U32(rmtp_ModelVertexSize, buffers->m_VertexCount * sizeof(dmRig::RigModelVertex));
+
+            ModelComponent* component = first_item->m_Component;
+            FillTextures(&ro, component, first_item->m_MaterialIndex);
+
+            if (component->m_RenderConstants)
+            {
+                dmGameSystem::EnableRenderObjectConstants(&ro, component->m_RenderConstants);
+            }
+
+            dmRender::AddToRender(render_context, &ro);
+
+            group_start = group_end;
+        }
+    }
+
     static inline void RenderBatchLocalVS(ModelWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE("RenderBatchLocal");
 
+        dmArray<InstancedRenderItem>& instanced_items = world->m_ScratchInstancedItems;
+        instanced_items.SetSize(0);
+
+        // Grouping the items changes the draw order, which only is safe if the result doesn't depend on it
+        dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
+        bool group_instances = world->m_InstancingSupported && !dmGraphics::GetPipelineState(graphics_context).m_BlendEnabled;
+
         for (uint32_t *i=begin;i!=end;i++)
         {
             const MeshRenderItem* render_item = (MeshRenderItem*) buf[*i].m_UserData;
             const ModelResourceBuffers* buffers = render_item->m_Buffers;
             ModelComponent* component = render_item->m_Component;
             uint32_t material_index = render_item->m_MaterialIndex;
+            dmRender::HMaterial material = GetMaterial(component, component->m_Resource, material_index);
+            bool skinned_on_gpu = IsSkinnedOnGPU(render_item, material);
+            bool has_instance_attributes = dmRender::GetInstanceVertexDeclaration(material) != 0;
+
+            // Materials with per instance attributes (e.g "mtx_world") are drawn instanced,
+            // unless the item already uses the second vertex buffer for its custom attributes
+            if (group_instances && has_instance_attributes &&
+                render_item->m_AttributeRenderDataIndex == ATTRIBUTE_RENDER_DATA_INDEX_UNUSED)
+            {
+                if (instanced_items.Full())
+                {
+                    instanced_items.OffsetCapacity(dmMath::Max(16U, (uint32_t) (end - begin)));
+                }
+                InstancedRenderItem item;
+                item.m_RenderItem = render_item;
+                item.m_Material   = material;
+                instanced_items.Push(item);
+                continue;
+            }
 
-            // We currently have no support for instancing, so we generate a separate draw call for each render item
+            // Generate a separate draw call for each remaining render item
             world->m_RenderObjects.SetSize(world->m_RenderObjects.Size()+1);
             dmRender::RenderObject& ro = world->m_RenderObjects.Back();
 
             ro.Init();
-            ro.m_Material              = GetMaterial(component, component->m_Resource, material_index);
+            ro.m_Material              = material;
             ro.m_PrimitiveType         = dmGraphics::PRIMITIVE_TRIANGLES;
             ro.m_VertexDeclarations[0] = world->m_VertexDeclaration;
             ro.m_VertexBuffers[0]      = buffers->m_VertexBuffer;
@@ -804,7 +1121,8 @@ namespace dmGameSystem
             {
                 MeshAttributeRenderData* attribute_rd = &component->m_MeshAttributeRenderDatas[render_item->m_AttributeRenderDataIndex];
 
-                if (!attribute_rd->m_VertexDeclaration)
+                bool initial = !attribute_rd->m_VertexDeclaration;
+                if (initial)
                 {
                     SetupMeshAttributeRenderData(render_context,
                         ro.m_Material,
@@ -813,10 +1131,20 @@ namespace dmGameSystem
                         component->m_Resource->m_Materials[material_index].m_AttributeCount,
                         attribute_rd);
                 }
+                UpdateMeshAttributeRenderData(world, render_item, attribute_rd, initial);
 
                 ro.m_VertexDeclarations[1] = attribute_rd->m_VertexDeclaration;
                 ro.m_VertexBuffers[1]      = attribute_rd->m_VertexBuffer;
             }
+            else if (skinned_on_gpu)
+            {
+                ro.m_VertexDeclarations[1] = world->m_SkinVertexDeclaration;
+                ro.m_VertexBuffers[1]      = GetSkinVertexBuffer(buffers);
+            }
+            else if (has_instance_attributes)
+            {
+                SetSingleInstanceAttributes(world, graphics_context, material, render_item, &ro);
+            }
 
             // These should be named "element" or "index" (as opposed to vertex)
             ro.m_VertexStart = 0;
@@ -833,13 +1161,22 @@ namespace dmGameSystem
 
             FillTextures(&ro, component, material_index);
 
-            if (component->m_RenderConstants)
+            if (skinned_on_gpu)
+            {
+                SetSkinningConstants(world, component, &ro);
+            }
+            else if (component->m_RenderConstants)
             {
                 dmGameSystem::EnableRenderObjectConstants(&ro, component->m_RenderConstants);
             }
 
             dmRender::AddToRender(render_context, &ro);
         }
+
+        if (!instanced_items.Empty())
+        {
+            RenderBatchInstanced(world, render_context, instanced_items.Begin(), instanced_items.Size());
+        }
     }
 
     #if 0
@@ -904,11 +1241,14 @@ namespace dmGameSystem
 
         uint32_t vertex_stride = dmGraphics::GetVertexDeclarationStride(vx_decl);
 
-        if (!HasCustomVertexAttributes(material))
+        // The vertices are in world space, so any per instance attributes (e.g "mtx_world") are written per vertex
+        bool custom_attributes = HasCustomVertexAttributes(material, true);
+        if (!custom_attributes)
         {
             vertex_stride = sizeof(dmRig::RigModelVertex);
             vx_decl       = world->m_VertexDeclaration;
         }
+        const Matrix4 identity = Matrix4::identity();
 
         uint32_t required_vertex_memory_count = required_vertex_count * vertex_stride;
 
@@ -963,7 +1303,7 @@ namespace dmGameSystem
 
                 // Either generate the vertices by using the attributes or the 'old' way.
                 // This should mean that we won't take a performance hit if we don't use attributes.
-                if (render_item->m_AttributeRenderDataIndex != ATTRIBUTE_RENDER_DATA_INDEX_UNUSED)
+                if (custom_attributes)
                 {
                     dmRig::AttributeInfo attributes[dmGraphics::MAX_VERTEX_STREAM_COUNT];
                     FillAttributeInfos(material_attributes, material_attributes_count,
@@ -971,6 +1311,15 @@ namespace dmGameSystem
                         c->m_Resource->m_Model->m_Materials[material_index].m_Attributes.m_Count,
                         attributes);
 
+                    // The positions and normals are already transformed
+                    for (uint32_t a = 0; a < material_attributes_count; ++a)
+                    {
+                        if (IsTransformMatrixAttribute(attributes[a].m_Attribute, attributes[a].m_ValueByteSize))
+                        {
+                            attributes[a].m_ValuePtr = (const uint8_t*) &identity;
+                        }
+                    }
+
                     vb_end = dmRig::GenerateVertexDataFromAttributes(world->m_RigContext, c->m_RigInstance, render_item->m_Mesh, world_matrix, attributes, material_attributes_count, vertex_stride, vb_end);
                 }
                 else
@@ -1139,6 +1488,7 @@ namespace dmGameSystem
             world->m_VertexBufferDispatchCounts[i] = 0;
         }
 
+        RewindInstanceBufferPool(world->m_InstanceBuffers);
         world->m_MaxBatchIndex = 0;
 
         update_result.m_TransformsUpdated = rig_res == dmRig::RESULT_UPDATED_POSE;
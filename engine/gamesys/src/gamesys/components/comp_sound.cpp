@@ -68,10 +68,10 @@ namespace dmGameSystem
         dmIndexPool32                   m_EntryIndices;
     };
 
-    static const dmhash_t SOUND_PROP_GAIN   = dmHashString64("gain");
-    static const dmhash_t SOUND_PROP_PAN    = dmHashString64("pan");
-    static const dmhash_t SOUND_PROP_SPEED  = dmHashString64("speed");
-    static const dmhash_t SOUND_PROP_SOUND  = dmHashString64("sound");
+    static const dmhash_t SOUND_PROP_GAIN   = dmHashConstString64("gain");
+    static const dmhash_t SOUND_PROP_PAN    = dmHashConstString64("pan");
+    static const dmhash_t SOUND_PROP_SPEED  = dmHashConstString64("speed");
+    static const dmhash_t SOUND_PROP_SOUND  = dmHashConstString64("sound");
 
     dmGameObject::CreateResult CompSoundNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
@@ -173,8 +173,8 @@ namespace dmGameSystem
     {
         // For reverse hashing to work for easier debugging we hash these ids here
         // The hash container is enabled in engine init so it's too early in compilation unit scope
-        static const dmhash_t SOUND_EVENT_DONE    = dmHashString64("sound_done");
-        static const dmhash_t SOUND_EVENT_STOPPED = dmHashString64("sound_stopped");
+        static const dmhash_t SOUND_EVENT_DONE    = dmHashConstString64("sound_done");
+        static const dmhash_t SOUND_EVENT_STOPPED = dmHashConstString64("sound_stopped");
 
         dmSound::Result r = dmSound::DeleteSoundInstance(entry.m_SoundInstance);
         entry.m_SoundInstance = 0;
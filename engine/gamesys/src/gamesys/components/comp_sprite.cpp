@@ -19,6 +19,7 @@
 #include <algorithm>
 
 #include <dlib/array.h>
+#include <dlib/frame_arena.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/message.h>
@@ -164,10 +165,10 @@ namespace dmGameSystem
     DM_GAMESYS_PROP_VECTOR3(SPRITE_PROP_SCALE, scale, false);
     DM_GAMESYS_PROP_VECTOR3(SPRITE_PROP_SIZE, size, false);
 
-    static const dmhash_t SPRITE_PROP_CURSOR        = dmHashString64("cursor");
-    static const dmhash_t SPRITE_PROP_PLAYBACK_RATE = dmHashString64("playback_rate");
-    static const dmhash_t SPRITE_PROP_ANIMATION     = dmHashString64("animation");
-    static const dmhash_t SPRITE_PROP_FRAME_COUNT   = dmHashString64("frame_count");
+    static const dmhash_t SPRITE_PROP_CURSOR        = dmHashConstString64("cursor");
+    static const dmhash_t SPRITE_PROP_PLAYBACK_RATE = dmHashConstString64("playback_rate");
+    static const dmhash_t SPRITE_PROP_ANIMATION     = dmHashConstString64("animation");
+    static const dmhash_t SPRITE_PROP_FRAME_COUNT   = dmHashConstString64("frame_count");
 
     // The 9 slice function produces 16 vertices (4 rows 4 columns)
     // and since there's 2 triangles per quad and 9 quads in total,
@@ -765,6 +766,14 @@ namespace dmGameSystem
         array.SetSize(size);
     }
 
+    // Scratch arrays taken from the frame arena can't grow by themselves, so they must be reserved before EnsureSize()
+    static void ReserveScratch(dmFrameArena::HArena arena, dmArray<float>& array, uint32_t size)
+    {
+        if (arena && array.Capacity() < size) {
+            dmFrameArena::SetCapacity(arena, array, size);
+        }
+    }
+
     static void FillSlice9Uvs(const float us[4], const float vs[4], bool rotated, float uvs[SPRITE_VERTEX_COUNT_SLICE9*2]) {
         int index = 0;
         for (int y=0; y<4; ++y)
@@ -1166,7 +1175,7 @@ namespace dmGameSystem
         }
     }
 
-    static void CreateVertexData(SpriteWorld* sprite_world, SpriteAttributeInfo* material_attribute_info, uint32_t vertex_stride, uint8_t** vb_where, uint8_t** ib_where, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    static void CreateVertexData(SpriteWorld* sprite_world, dmFrameArena::HArena arena, SpriteAttributeInfo* material_attribute_info, uint32_t vertex_stride, uint8_t** vb_where, uint8_t** ib_where, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE("CreateVertexData");
 
@@ -1194,6 +1203,12 @@ namespace dmGameSystem
             textures.m_TextureSets[i] = textures.m_Resources[i]->m_TextureSet;
         }
 
+        // Enough for quads and slice9 sprites. Sprites with geometry reserve more below.
+        for (uint32_t i = 0; i < dmMath::Max(textures.m_NumTextures, 1U); ++i)
+        {
+            ReserveScratch(arena, scratch_uvs[i], SPRITE_VERTEX_COUNT_SLICE9*2);
+        }
+
         SpriteAttributeInfo sprite_attribute_info = {};
 
         for (uint32_t* i = begin; i != end; ++i)
@@ -1239,6 +1254,12 @@ namespace dmGameSystem
                 // to respect face winding (and backface culling)
                 int reverse = flipx ^ flipy;
 
+                uint32_t geometry_size = textures.m_Geometries[0]->m_Vertices.m_Count;
+                ReserveScratch(arena, scratch_pos, geometry_size);
+                for (uint32_t t = 0; t < textures.m_NumTextures; ++t)
+                {
+                    ReserveScratch(arena, scratch_uvs[t], geometry_size);
+                }
                 ResolvePositionAndUVDataFromGeometry(&textures, &scratch_pos, scratch_uvs, scaleX, scaleY, reverse);
 
                 const Matrix4& w = component->m_World;
@@ -1419,7 +1440,7 @@ namespace dmGameSystem
         uint8_t* ib_begin = (uint8_t*)sprite_world->m_IndexBufferWritePtr;
         uint8_t* vb_iter  = vb_begin;
         uint8_t* ib_iter  = ib_begin;
-        CreateVertexData(sprite_world, &material_attribute_info, vertex_stride, &vb_iter, &ib_iter, buf, begin, end);
+        CreateVertexData(sprite_world, dmRender::GetFrameArena(render_context), &material_attribute_info, vertex_stride, &vb_iter, &ib_iter, buf, begin, end);
 
         sprite_world->m_VertexBufferWritePtr = vb_iter;
         sprite_world->m_IndexBufferWritePtr = ib_iter;
@@ -1786,15 +1807,6 @@ namespace dmGameSystem
 
         PostMessages(world);
 
-        SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
-        dmRender::TrimBuffer(sprite_context->m_RenderContext, world->m_VertexBuffer);
-        dmRender::RewindBuffer(sprite_context->m_RenderContext, world->m_VertexBuffer);
-
-        dmRender::TrimBuffer(sprite_context->m_RenderContext, world->m_IndexBuffer);
-        dmRender::RewindBuffer(sprite_context->m_RenderContext, world->m_IndexBuffer);
-
-        world->m_DispatchCount = 0;
-
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -1861,14 +1873,23 @@ namespace dmGameSystem
         SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
         SpriteWorld* sprite_world = (SpriteWorld*)params.m_World;
 
+        dmRender::HRenderContext render_context = sprite_context->m_RenderContext;
+
+        // The update doesn't touch the render buffers, so that it may run on a worker thread
+        dmRender::TrimBuffer(render_context, sprite_world->m_VertexBuffer);
+        dmRender::RewindBuffer(render_context, sprite_world->m_VertexBuffer);
+
+        dmRender::TrimBuffer(render_context, sprite_world->m_IndexBuffer);
+        dmRender::RewindBuffer(render_context, sprite_world->m_IndexBuffer);
+
+        sprite_world->m_DispatchCount = 0;
+
         sprite_world->m_VerticesWritten = 0;
 
         UpdateTransforms(sprite_world, sprite_context->m_Subpixels); // TODO: Why is this not in the update function?
 
         UpdateVertexAndIndexCount(sprite_world);
 
-        dmRender::HRenderContext render_context = sprite_context->m_RenderContext;
-
         dmArray<SpriteComponent>& components = sprite_world->m_Components.GetRawObjects();
         uint32_t sprite_count = components.Size();
 
@@ -512,11 +512,6 @@ namespace dmGameSystem
         }
         DM_PROPERTY_ADD_U32(rmtp_Tilemap, world->m_Components.Size());
 
-        TilemapContext* context = (TilemapContext*)params.m_Context;
-        dmRender::TrimBuffer(context->m_RenderContext, world->m_VertexBuffer);
-        dmRender::RewindBuffer(context->m_RenderContext, world->m_VertexBuffer);
-        world->m_DispatchCount = 0;
-
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -761,6 +756,11 @@ namespace dmGameSystem
         TilemapContext* context = (TilemapContext*)params.m_Context;
         TileGridWorld* world = (TileGridWorld*)params.m_World;
 
+        // The update doesn't touch the render buffer, so that it may run on a worker thread
+        dmRender::TrimBuffer(context->m_RenderContext, world->m_VertexBuffer);
+        dmRender::RewindBuffer(context->m_RenderContext, world->m_VertexBuffer);
+        world->m_DispatchCount = 0;
+
         dmArray<TileGridComponent*>& components = world->m_Components;
         uint32_t n = components.Size();
         if( n == 0 )
@@ -157,12 +157,20 @@ namespace dmGameSystem
         dmResource::Result factory_result;
         dmGameObject::Result go_result;
 
+        // Types that don't declare what their update function touches are always updated on their own
+        static const uint32_t UPDATE_ACCESS_UNDECLARED = 0xFFFFFFFF;
+        static const uint32_t UPDATE_TRANSFORMS = dmGameObject::COMPONENT_UPDATE_ACCESS_TRANSFORMS;
+        static const uint32_t UPDATE_MESSAGES = dmGameObject::COMPONENT_UPDATE_ACCESS_MESSAGES;
+        static const uint32_t UPDATE_SCRIPT = dmGameObject::COMPONENT_UPDATE_ACCESS_SCRIPT;
+        static const uint32_t UPDATE_RESOURCES = dmGameObject::COMPONENT_UPDATE_ACCESS_RESOURCES;
+        static const uint32_t UPDATE_RENDER = dmGameObject::COMPONENT_UPDATE_ACCESS_RENDER;
+
 #define REGISTER_COMPONENT_TYPE(extension, prio, context, new_world_func, delete_world_func, \
                                 create_func, destroy_func, init_func, final_func, add_to_update_func, get_func, \
                                 update_func, fixed_update_func, render_func, post_update_func, on_message_func, on_input_func, \
                                 on_reload_func, get_property_func, set_property_func, \
                                 iter_child_func, iter_property_func, \
-                                set_reads_transforms)\
+                                set_reads_transforms, update_reads, update_writes)\
     factory_result = dmResource::GetTypeFromExtension(factory, extension, &type);\
     if (factory_result != dmResource::RESULT_OK)\
     {\
@@ -195,6 +203,8 @@ namespace dmGameSystem
     component_type.m_ReadsTransforms = set_reads_transforms;\
     component_type.m_InstanceHasUserData = (uint32_t)true;\
     component_type.m_UpdateOrderPrio = prio;\
+    if (update_reads != UPDATE_ACCESS_UNDECLARED)\
+        dmGameObject::ComponentTypeSetUpdateAccess(&component_type, update_reads, update_writes);\
     go_result = dmGameObject::RegisterComponentType(regist, component_type);\
     if (go_result != dmGameObject::RESULT_OK)\
         return go_result;
@@ -210,7 +220,7 @@ namespace dmGameSystem
                 &CompCollectionProxyUpdate, 0, &CompCollectionProxyRender, &CompCollectionProxyPostUpdate, &CompCollectionProxyOnMessage, &CompCollectionProxyOnInput,
                 0, 0, 0,
                 &CompCollectionProxyIterChildren, 0,
-                0);
+                0, UPDATE_ACCESS_UNDECLARED, 0);
 
         // See gameobject_comp.cpp for these two component types:
         // Priority 200 is reserved for scriptc (read+write transforms)
@@ -224,7 +234,7 @@ namespace dmGameSystem
                 &CompCollisionObjectUpdate, CompCollisionObjectFixedUpdate, 0, &CompCollisionObjectPostUpdate, &CompCollisionObjectOnMessage, 0,
                 &CompCollisionObjectOnReload, CompCollisionObjectGetProperty, CompCollisionObjectSetProperty,
                 0, CompCollisionIterProperties,
-                1);
+                1, UPDATE_ACCESS_UNDECLARED, 0);
 
         REGISTER_COMPONENT_TYPE("camerac", 500, render_context,
                 &CompCameraNewWorld, &CompCameraDeleteWorld,
@@ -232,7 +242,7 @@ namespace dmGameSystem
                 &CompCameraUpdate, 0, 0, 0, &CompCameraOnMessage, 0,
                 &CompCameraOnReload, CompCameraGetProperty, CompCameraSetProperty,
                 0, 0,
-                1);
+                1, 0, UPDATE_MESSAGES | UPDATE_RENDER);
 
         REGISTER_COMPONENT_TYPE("soundc", 600, sound_context,
                 CompSoundNewWorld, CompSoundDeleteWorld,
@@ -240,7 +250,7 @@ namespace dmGameSystem
                 CompSoundUpdate, 0, 0, 0, CompSoundOnMessage, 0,
                 0, CompSoundGetProperty, CompSoundSetProperty,
                 0, 0,
-                0);
+                0, 0, UPDATE_MESSAGES);
 
         REGISTER_COMPONENT_TYPE("modelc", 700, model_context,
                 CompModelNewWorld, CompModelDeleteWorld,
@@ -248,17 +258,18 @@ namespace dmGameSystem
                 CompModelUpdate, 0, CompModelRender, 0, CompModelOnMessage, 0,
                 0, CompModelGetProperty, CompModelSetProperty,
                 0, CompModelIterProperties,
-                0);
+                0, 0, UPDATE_TRANSFORMS | UPDATE_MESSAGES | UPDATE_RENDER);
 
         // prio: 725  comp_mesh.cpp
 
+        // The emitter state changed callbacks call into Lua from the update
         REGISTER_COMPONENT_TYPE("particlefxc", 800, particlefx_context,
                 &CompParticleFXNewWorld, &CompParticleFXDeleteWorld,
                 &CompParticleFXCreate, &CompParticleFXDestroy, 0, 0, &CompParticleFXAddToUpdate, 0,
                 &CompParticleFXUpdate, 0, &CompParticleFXRender, 0, &CompParticleFXOnMessage, 0,
                 &CompParticleFXOnReload, 0, 0,
                 0, 0,
-                1);
+                1, 0, UPDATE_MESSAGES | UPDATE_SCRIPT | UPDATE_RESOURCES | UPDATE_RENDER);
 
         REGISTER_COMPONENT_TYPE("factoryc", 900, factory_context,
                 CompFactoryNewWorld, CompFactoryDeleteWorld,
@@ -266,7 +277,7 @@ namespace dmGameSystem
                 CompFactoryUpdate, 0, 0, 0, CompFactoryOnMessage, 0,
                 0, CompFactoryGetProperty, 0,
                 0, 0,
-                0);
+                0, 0, UPDATE_MESSAGES | UPDATE_SCRIPT | UPDATE_RESOURCES | UPDATE_RENDER);
 
         REGISTER_COMPONENT_TYPE("collectionfactoryc", 950, collectionfactory_context,
                 CompCollectionFactoryNewWorld, CompCollectionFactoryDeleteWorld,
@@ -274,7 +285,7 @@ namespace dmGameSystem
                 CompCollectionFactoryUpdate, 0, 0, 0, 0, 0,
                 0, CompCollectionFactoryGetProperty, 0,
                 0, 0,
-                0);
+                0, 0, UPDATE_MESSAGES | UPDATE_SCRIPT | UPDATE_RESOURCES | UPDATE_RENDER);
 
         REGISTER_COMPONENT_TYPE("lightc", 1000, render_context,
                 CompLightNewWorld, CompLightDeleteWorld,
@@ -282,7 +293,7 @@ namespace dmGameSystem
                 CompLightUpdate, 0, 0, 0, CompLightOnMessage, 0,
                 0, 0, 0,
                 0, 0,
-                1);
+                1, 0, UPDATE_MESSAGES);
 
         REGISTER_COMPONENT_TYPE("spritec", 1100, sprite_context,
                 CompSpriteNewWorld, CompSpriteDeleteWorld,
@@ -290,7 +301,7 @@ namespace dmGameSystem
                 CompSpriteUpdate, 0, CompSpriteRender, 0, CompSpriteOnMessage, 0,
                 CompSpriteOnReload, CompSpriteGetProperty, CompSpriteSetProperty,
                 0, CompSpriteIterProperties,
-                1);
+                1, 0, UPDATE_MESSAGES);
 
         REGISTER_COMPONENT_TYPE(TILE_MAP_EXT, 1200, tilemap_context,
                 CompTileGridNewWorld, CompTileGridDeleteWorld,
@@ -298,7 +309,7 @@ namespace dmGameSystem
                 CompTileGridUpdate, 0, CompTileGridRender, 0, CompTileGridOnMessage, 0,
                 CompTileGridOnReload, CompTileGridGetProperty, CompTileGridSetProperty,
                 0, CompTileGridIterProperties,
-                1);
+                1, 0, 0);
 
         REGISTER_COMPONENT_TYPE("labelc", 1400, label_context,
                 CompLabelNewWorld, CompLabelDeleteWorld,
@@ -306,7 +317,7 @@ namespace dmGameSystem
                 CompLabelUpdate, 0, CompLabelRender, 0, CompLabelOnMessage, 0,
                 CompLabelOnReload, CompLabelGetProperty, CompLabelSetProperty,
                 0, CompLabelIterProperties,
-                1);
+                1, 0, 0);
 
         #undef REGISTER_COMPONENT_TYPE
 
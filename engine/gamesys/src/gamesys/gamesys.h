@@ -46,6 +46,8 @@ namespace dmGameSystem
     extern const char* PHYSICS_USE_FIXED_TIMESTEP;
     /// Config key for using max updates during a single step
     extern const char* PHYSICS_MAX_FIXED_TIMESTEPS;
+    /// Config key for stepping the 2D physics worlds on a separate thread
+    extern const char* PHYSICS_ASYNC_STEP;
     /// Config key to use for tweaking maximum number of collection proxies
     extern const char* COLLECTION_PROXY_MAX_COUNT_KEY;
     /// Config key to use for tweaking maximum number of factories
@@ -89,6 +91,9 @@ namespace dmGameSystem
         bool        m_3D;
         bool        m_UseFixedTimestep;
         uint32_t    m_MaxFixedTimesteps;
+        // Simulate the 2D worlds on m_JobThread while the rest of the frame is updated
+        bool        m_AsyncStep;
+        dmJobThread::HContext m_JobThread;
     };
 
     struct ParticleFXContext
@@ -259,6 +259,80 @@ namespace dmGameSystem
         return -1;
     }
 
+    uint8_t* WriteInstanceAttributes(dmRender::HMaterial material, const Matrix4& world, uint8_t* write_ptr)
+    {
+        const dmGraphics::VertexAttribute* attributes;
+        uint32_t attribute_count;
+        dmRender::GetMaterialProgramAttributes(material, &attributes, &attribute_count);
+
+        for (int i = 0; i < attribute_count; ++i)
+        {
+            const dmGraphics::VertexAttribute& attribute = attributes[i];
+            if (attribute.m_StepFunction != dmGraphics::VertexAttribute::STEP_FUNCTION_INSTANCE)
+            {
+                continue;
+            }
+
+            uint32_t byte_size = dmGraphics::GetTypeSize(dmGraphics::GetGraphicsType(attribute.m_DataType)) * attribute.m_ElementCount;
+            bool is_mat4       = attribute.m_DataType == dmGraphics::VertexAttribute::TYPE_FLOAT && attribute.m_ElementCount == 16;
+
+            if (is_mat4 && attribute.m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX)
+            {
+                memcpy(write_ptr, &world, sizeof(Matrix4));
+            }
+            else if (is_mat4 && attribute.m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL_MATRIX)
+            {
+                Matrix4 normal_matrix = dmVMath::Transpose(dmVMath::Inverse(world));
+                memcpy(write_ptr, &normal_matrix, sizeof(Matrix4));
+            }
+            else
+            {
+                const uint8_t* value_ptr;
+                uint32_t value_size;
+                dmRender::GetMaterialProgramAttributeValues(material, i, &value_ptr, &value_size);
+                value_size = dmMath::Min(value_size, byte_size);
+                memcpy(write_ptr, value_ptr, value_size);
+                memset(write_ptr + value_size, 0, byte_size - value_size);
+            }
+            write_ptr += byte_size;
+        }
+        return write_ptr;
+    }
+
+    dmGraphics::HVertexBuffer AddInstanceBuffer(dmGraphics::HContext graphics_context, InstanceBufferPool& pool)
+    {
+        if (pool.m_UsedCount == pool.m_Buffers.Size())
+        {
+            if (pool.m_Buffers.Full())
+            {
+                pool.m_Buffers.OffsetCapacity(4);
+            }
+            pool.m_Buffers.Push(dmGraphics::NewVertexBuffer(graphics_context, 0, 0, dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW));
+        }
+
+        dmGraphics::HVertexBuffer buffer = pool.m_Buffers[pool.m_UsedCount++];
+        dmGraphics::SetVertexBufferData(buffer, pool.m_Data.Size(), pool.m_Data.Begin(), dmGraphics::BUFFER_USAGE_DYNAMIC_DRAW);
+        return buffer;
+    }
+
+    void RewindInstanceBufferPool(InstanceBufferPool& pool)
+    {
+        for (uint32_t i = pool.m_UsedCount; i < pool.m_Buffers.Size(); ++i)
+        {
+            dmGraphics::DeleteVertexBuffer(pool.m_Buffers[i]);
+        }
+        pool.m_Buffers.SetSize(pool.m_UsedCount);
+        pool.m_UsedCount = 0;
+    }
+
+    void DestroyInstanceBufferPool(InstanceBufferPool& pool)
+    {
+        pool.m_UsedCount = 0;
+        RewindInstanceBufferPool(pool);
+        pool.m_Buffers.SetCapacity(0);
+        pool.m_Data.SetCapacity(0);
+    }
+
     int32_t FindMaterialAttributeIndex(const DynamicAttributeInfo& info, dmhash_t name_hash)
     {
         for (int i = 0; i < info.m_NumInfos; ++i)
@@ -47,11 +47,11 @@ namespace dmGameSystem
 
 #undef EXT_CONSTANTS
 
-    static const dmhash_t PROP_FONT = dmHashString64("font");
-    static const dmhash_t PROP_FONTS = dmHashString64("fonts");
-    static const dmhash_t PROP_IMAGE = dmHashString64("image");
-    static const dmhash_t PROP_MATERIAL = dmHashString64("material");
-    static const dmhash_t PROP_MATERIALS = dmHashString64("materials");
+    static const dmhash_t PROP_FONT = dmHashConstString64("font");
+    static const dmhash_t PROP_FONTS = dmHashConstString64("fonts");
+    static const dmhash_t PROP_IMAGE = dmHashConstString64("image");
+    static const dmhash_t PROP_MATERIAL = dmHashConstString64("material");
+    static const dmhash_t PROP_MATERIALS = dmHashConstString64("materials");
     static const dmhash_t PROP_TEXTURE[dmRender::RenderObject::MAX_TEXTURE_COUNT] = {
         dmHashString64("texture0"),
         dmHashString64("texture1"),
@@ -62,8 +62,8 @@ namespace dmGameSystem
         dmHashString64("texture6"),
         dmHashString64("texture7")
     };
-    static const dmhash_t PROP_TEXTURES = dmHashString64("textures");
-    static const dmhash_t PROP_TILE_SOURCE = dmHashString64("tile_source");
+    static const dmhash_t PROP_TEXTURES = dmHashConstString64("textures");
+    static const dmhash_t PROP_TILE_SOURCE = dmHashConstString64("tile_source");
 
     struct EmitterStateChangedScriptData
     {
@@ -100,6 +100,24 @@ namespace dmGameSystem
     // Vertex attributes
     int32_t FindAttributeIndex(const dmGraphics::VertexAttribute* attributes, uint32_t attributes_count, dmhash_t name_hash);
 
+    // Instanced rendering
+    // A pool of vertex buffers holding per-instance attribute data. Each instanced draw call
+    // within a frame gets its own buffer, since the data must stay intact until the frame is drawn.
+    struct InstanceBufferPool
+    {
+        dmArray<dmGraphics::HVertexBuffer> m_Buffers;
+        dmArray<uint8_t>                   m_Data;      // Instance data for the next draw call
+        uint32_t                           m_UsedCount; // Number of buffers used since the last rewind
+    };
+
+    // Writes the per-instance attributes of the material for one instance, returns the new write position
+    uint8_t*                     WriteInstanceAttributes(dmRender::HMaterial material, const dmVMath::Matrix4& world, uint8_t* write_ptr);
+    // Uploads the pool data to the next free buffer in the pool
+    dmGraphics::HVertexBuffer    AddInstanceBuffer(dmGraphics::HContext graphics_context, InstanceBufferPool& pool);
+    // Releases buffers unused since the last rewind, and makes all buffers available again. Call once per frame.
+    void                         RewindInstanceBufferPool(InstanceBufferPool& pool);
+    void                         DestroyInstanceBufferPool(InstanceBufferPool& pool);
+
     // Dynamic Vertex Attribute
     static const uint16_t INVALID_DYNAMIC_ATTRIBUTE_INDEX  = 0xFFFF;
     static const uint8_t  DYNAMIC_ATTRIBUTE_INCREASE_COUNT = 1;
@@ -135,10 +135,31 @@ namespace dmGameSystem
         return out_write_ptr;
     }
 
-    static ModelResourceBuffers* CreateBuffers(dmGraphics::HContext context, const dmRigDDF::Mesh* ddf_mesh, dmArray<dmRig::RigModelVertex>& scratch_buffer)
+    // The bone indices are stored as floats, since integer vertex attributes aren't available on all graphics adapters
+    static ModelSkinVertex* CreateSkinVertexData(const dmRigDDF::Mesh* mesh, ModelSkinVertex* out_write_ptr)
     {
-        ModelResourceBuffers* buffers = new ModelResourceBuffers;
-        memset(buffers, 0, sizeof(ModelResourceBuffers));
+        uint32_t vertex_count = mesh->m_Positions.m_Count / 3;
+
+        const uint32_t* indices = mesh->m_BoneIndices.m_Data;
+        const float* weights = mesh->m_Weights.m_Data;
+
+        for (uint32_t i = 0; i < vertex_count; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                out_write_ptr->weights[c] = *weights++;
+                out_write_ptr->indices[c] = (float) *indices++;
+            }
+            out_write_ptr++;
+        }
+
+        return out_write_ptr;
+    }
+
+    static ModelResourceBuffers* CreateBuffers(dmGraphics::HContext context, const dmRigDDF::Mesh* ddf_mesh, dmArray<dmRig::RigModelVertex>& scratch_buffer, dmArray<ModelSkinVertex>& skin_scratch_buffer)
+    {
+        ModelMeshBuffers* buffers = new ModelMeshBuffers;
+        memset(buffers, 0, sizeof(ModelMeshBuffers));
 
         uint32_t num_vertices = ddf_mesh->m_Positions.m_Count / 3;
 
@@ -169,6 +190,18 @@ namespace dmGameSystem
         buffers->m_VertexBuffer = dmGraphics::NewVertexBuffer(context, num_vertices * sizeof(dmRig::RigModelVertex), scratch_buffer.Begin(), dmGraphics::BUFFER_USAGE_STATIC_DRAW);
         buffers->m_VertexCount = num_vertices;
 
+        // Skinned meshes also get the bone weights and indices, so they can be skinned in the vertex shader
+        if (ddf_mesh->m_BoneIndices.m_Count == num_vertices * 4 && ddf_mesh->m_Weights.m_Count == num_vertices * 4)
+        {
+            if (skin_scratch_buffer.Capacity() < num_vertices)
+                skin_scratch_buffer.SetCapacity(num_vertices);
+            skin_scratch_buffer.SetSize(num_vertices);
+
+            CreateSkinVertexData(ddf_mesh, skin_scratch_buffer.Begin());
+
+            buffers->m_SkinVertexBuffer = dmGraphics::NewVertexBuffer(context, num_vertices * sizeof(ModelSkinVertex), skin_scratch_buffer.Begin(), dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+        }
+
         buffers->m_IndexBuffer = 0;
         buffers->m_IndexCount = 0;
         if (index_buffer != 0)
@@ -185,22 +218,25 @@ namespace dmGameSystem
     static void CreateBuffers(dmGraphics::HContext context, ModelResource* resource)
     {
         dmArray<dmRig::RigModelVertex> scratch_buffer;
+        dmArray<ModelSkinVertex> skin_scratch_buffer;
         for (uint32_t i = 0; i < resource->m_Meshes.Size(); ++i)
         {
             MeshInfo& info = resource->m_Meshes[i];
-            info.m_Buffers = CreateBuffers(context, info.m_Mesh, scratch_buffer);
+            info.m_Buffers = CreateBuffers(context, info.m_Mesh, scratch_buffer, skin_scratch_buffer);
         }
     }
 
-    static bool AreAllMaterialsWorldSpace(const ModelResource* resource)
+    // World space materials are skinned on the CPU, and local space materials need to skin in the vertex shader
+    static bool AreAllMaterialsSkinnable(const ModelResource* resource)
     {
         for (uint32_t i = 0; i < resource->m_Materials.Size(); ++i)
         {
             dmRender::HMaterial material = resource->m_Materials[i].m_Material->m_Material;
-            if (dmRender::GetMaterialVertexSpace(material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_LOCAL)
+            if (dmRender::GetMaterialVertexSpace(material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_LOCAL &&
+                dmRender::GetMaterialConstantLocation(material, UNIFORM_POSE_MATRICES) == dmGraphics::INVALID_UNIFORM_LOCATION)
                 return false;
         }
-        return true; // All materials are currently world space
+        return true;
     }
 
     // We could sort them in the pipeline, but then we'd have to read the material data
@@ -318,9 +354,9 @@ namespace dmGameSystem
 
         if(resource->m_RigScene->m_AnimationSetRes || resource->m_RigScene->m_SkeletonRes)
         {
-            if (!AreAllMaterialsWorldSpace(resource))
+            if (!AreAllMaterialsSkinnable(resource))
             {
-                dmLogError("Failed to create Model component. Material vertex space option VERTEX_SPACE_LOCAL does not support skinning.");
+                dmLogError("Failed to create Model component. Material vertex space option VERTEX_SPACE_LOCAL only supports skinning if the vertex program declares the 'pose_matrices' uniform.");
                 return dmResource::RESULT_NOT_SUPPORTED;
             }
         }
@@ -332,7 +368,12 @@ namespace dmGameSystem
     {
         dmGraphics::DeleteVertexBuffer(buffers->m_VertexBuffer);
         dmGraphics::DeleteIndexBuffer(buffers->m_IndexBuffer);
-        delete buffers;
+        ModelMeshBuffers* mesh_buffers = (ModelMeshBuffers*) buffers;
+        if (mesh_buffers->m_SkinVertexBuffer)
+        {
+            dmGraphics::DeleteVertexBuffer(mesh_buffers->m_SkinVertexBuffer);
+        }
+        delete mesh_buffers;
     }
 
     static void ReleaseResources(dmResource::HFactory factory, ModelResource* resource)
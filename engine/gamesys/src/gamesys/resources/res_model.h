@@ -20,6 +20,28 @@
 
 namespace dmGameSystem
 {
+    // Local space materials declaring this uniform (mat4 array) skin the vertices in the vertex shader
+    static const dmhash_t UNIFORM_POSE_MATRICES = dmHashConstString64("pose_matrices");
+
+    // Per vertex data of the ModelMeshBuffers::m_SkinVertexBuffer
+    struct ModelSkinVertex
+    {
+        float weights[4];
+        float indices[4];
+    };
+
+    // The buffers of a mesh are allocated as this type, and handed out as ModelResourceBuffers
+    // in the sdk, which keeps the layout of the public struct unchanged.
+    struct ModelMeshBuffers : ModelResourceBuffers
+    {
+        dmGraphics::HVertexBuffer m_SkinVertexBuffer; // Bone weights and indices per vertex (or 0 if the mesh isn't skinned)
+    };
+
+    static inline dmGraphics::HVertexBuffer GetSkinVertexBuffer(const ModelResourceBuffers* buffers)
+    {
+        return ((const ModelMeshBuffers*) buffers)->m_SkinVertexBuffer;
+    }
+
     dmResource::Result ResModelPreload(const dmResource::ResourcePreloadParams& params);
 
     dmResource::Result ResModelCreate(const dmResource::ResourceCreateParams& params);
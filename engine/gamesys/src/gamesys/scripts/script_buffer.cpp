@@ -684,6 +684,415 @@ namespace dmGameSystem
     }
 
 
+    // Converts a value index, as used when indexing a stream from Lua (minus one), into an offset from the stream data
+    static inline uint32_t GetValueOffset(const BufferStream* stream, uint32_t index)
+    {
+        return (index / stream->m_TypeCount) * stream->m_Stride + index % stream->m_TypeCount;
+    }
+
+    static bool IsValidValueRange(const BufferStream* stream, int offset, int stride, int count)
+    {
+        if (offset < 0 || stride < 1 || count < 0)
+        {
+            return false;
+        }
+        if (count == 0)
+        {
+            return (uint32_t)offset <= stream->m_Count * stream->m_TypeCount;
+        }
+        uint64_t last = (uint64_t)offset + (uint64_t)(count - 1) * stride;
+        return last < (uint64_t)stream->m_Count * stream->m_TypeCount;
+    }
+
+    // Copies values between streams of any type, converting the values if the types differ
+    static void CopyValuesInternal(BufferStream* dststream, uint32_t dstoffset, uint32_t dststride,
+                                    const BufferStream* srcstream, uint32_t srcoffset, uint32_t srcstride,
+                                    uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            lua_Number v = srcstream->m_Get(srcstream->m_Data, GetValueOffset(srcstream, srcoffset + i * srcstride));
+            dststream->m_Set(dststream->m_Data, GetValueOffset(dststream, dstoffset + i * dststride), v);
+        }
+    }
+
+    /*# sets values in a stream
+     *
+     * Set a range of values in a stream from a Lua table, or from all the values in another stream.
+     * This is much faster than setting the values one by one.
+     * The values are converted to the value type of the stream.
+     *
+     * @name buffer.set_values
+     * @param stream [type:bufferstream] the destination stream
+     * @param offset [type:number] the offset to start writing values to (measured in value type)
+     * @param values [type:table|bufferstream] an array of numbers, or a stream to copy all values from
+     *
+     * @examples
+     * How to set the positions of a triangle:
+     *
+     * ```lua
+     * local positions = buffer.get_stream(buf, hash("position"))
+     * buffer.set_values(positions, 0, {
+     *     0, 0, 0,
+     *     1, 0, 0,
+     *     0, 1, 0
+     * })
+     * ```
+    */
+    static int SetValues(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+
+        if (IsStream(L, 3))
+        {
+            BufferStream* srcstream = CheckStream(L, 3);
+            int count = (int)(srcstream->m_Count * srcstream->m_TypeCount);
+            if (!IsValidValueRange(stream, offset, 1, count))
+            {
+                return DM_LUA_ERROR("Trying to write too many values: Stream length: %d, Offset: %d, Values to write: %d", (int)(stream->m_Count * stream->m_TypeCount), offset, count);
+            }
+
+            if (stream->m_Type == srcstream->m_Type && stream->m_TypeCount == srcstream->m_TypeCount)
+            {
+                CopyStreamInternal(stream, offset, srcstream, 0, count);
+            }
+            else
+            {
+                CopyValuesInternal(stream, offset, 1, srcstream, 0, 1, count);
+            }
+        }
+        else
+        {
+            luaL_checktype(L, 3, LUA_TTABLE);
+            int count = (int)lua_objlen(L, 3);
+            if (!IsValidValueRange(stream, offset, 1, count))
+            {
+                return DM_LUA_ERROR("Trying to write too many values: Stream length: %d, Offset: %d, Values to write: %d", (int)(stream->m_Count * stream->m_TypeCount), offset, count);
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                lua_rawgeti(L, 3, i + 1);
+                stream->m_Set(stream->m_Data, GetValueOffset(stream, offset + i), luaL_checknumber(L, -1));
+                lua_pop(L, 1);
+            }
+        }
+
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+    /*# gets values from a stream
+     *
+     * Get a range of values from a stream as a Lua table.
+     * This is much faster than reading the values one by one.
+     *
+     * @name buffer.get_values
+     * @param stream [type:bufferstream] the source stream
+     * @param offset [type:number] the offset to start reading values from (measured in value type)
+     * @param count [type:number] the number of values to read
+     * @param [table] [type:table] a table to store the values in, to avoid creating a new table. Entries after the last value are left unchanged.
+     * @return values [type:table] an array with the values
+     *
+     * @examples
+     * How to read the positions of the first triangle:
+     *
+     * ```lua
+     * local positions = buffer.get_stream(buf, hash("position"))
+     * local values = buffer.get_values(positions, 0, 9)
+     * ```
+    */
+    static int GetValues(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+        int count = luaL_checkint(L, 3);
+        if (!IsValidValueRange(stream, offset, 1, count))
+        {
+            return DM_LUA_ERROR("Trying to read too many values: Stream length: %d, Offset: %d, Values to read: %d", (int)(stream->m_Count * stream->m_TypeCount), offset, count);
+        }
+
+        if (lua_istable(L, 4))
+        {
+            lua_pushvalue(L, 4);
+        }
+        else
+        {
+            lua_createtable(L, count, 0);
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            lua_pushnumber(L, stream->m_Get(stream->m_Data, GetValueOffset(stream, offset + i)));
+            lua_rawseti(L, -2, i + 1);
+        }
+        return 1;
+    }
+
+    /*# fills a range of a stream
+     *
+     * Set a range of values in a stream to a single value, or to a repeating pattern of values.
+     *
+     * @name buffer.fill_values
+     * @param stream [type:bufferstream] the destination stream
+     * @param offset [type:number] the offset to start writing values to (measured in value type)
+     * @param count [type:number] the number of values to write
+     * @param value [type:number|table] the value, or an array of values to repeat
+     *
+     * @examples
+     * How to clear a stream, and set the color of all vertices to opaque white:
+     *
+     * ```lua
+     * local positions = buffer.get_stream(buf, hash("position"))
+     * buffer.fill_values(positions, 0, #positions, 0)
+     * local colors = buffer.get_stream(buf, hash("color"))
+     * buffer.fill_values(colors, 0, #colors, {1, 1, 1, 1})
+     * ```
+    */
+    static int FillValues(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        int offset = luaL_checkint(L, 2);
+        int count = luaL_checkint(L, 3);
+        if (!IsValidValueRange(stream, offset, 1, count))
+        {
+            return DM_LUA_ERROR("Trying to write too many values: Stream length: %d, Offset: %d, Values to write: %d", (int)(stream->m_Count * stream->m_TypeCount), offset, count);
+        }
+
+        if (lua_istable(L, 4))
+        {
+            int pattern_count = (int)lua_objlen(L, 4);
+            if (pattern_count == 0)
+            {
+                return DM_LUA_ERROR("The fill pattern is empty");
+            }
+
+            // Write the pattern once, and then repeat the converted values already in the stream
+            int i = 0;
+            for (; i < count && i < pattern_count; ++i)
+            {
+                lua_rawgeti(L, 4, i + 1);
+                stream->m_Set(stream->m_Data, GetValueOffset(stream, offset + i), luaL_checknumber(L, -1));
+                lua_pop(L, 1);
+            }
+            for (; i < count; ++i)
+            {
+                lua_Number v = stream->m_Get(stream->m_Data, GetValueOffset(stream, offset + i - pattern_count));
+                stream->m_Set(stream->m_Data, GetValueOffset(stream, offset + i), v);
+            }
+        }
+        else
+        {
+            lua_Number v = luaL_checknumber(L, 4);
+            for (int i = 0; i < count; ++i)
+            {
+                stream->m_Set(stream->m_Data, GetValueOffset(stream, offset + i), v);
+            }
+        }
+
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+    /*# copies values between streams with a stride
+     *
+     * Copy values from one stream to another, stepping a number of values between each read and each write.
+     * This can be used to copy a single component of each element, or to spread or gather values.
+     * The values are converted to the value type of the destination stream.
+     * The source and destination streams can be the same, as long as the ranges don't overlap.
+     *
+     * @name buffer.copy_values
+     * @param dst [type:bufferstream] the destination stream
+     * @param dstoffset [type:number] the offset to start copying data to (measured in value type)
+     * @param dststride [type:number] the number of values to step after each write
+     * @param src [type:bufferstream] the source data stream
+     * @param srcoffset [type:number] the offset to start copying data from (measured in value type)
+     * @param srcstride [type:number] the number of values to step after each read
+     * @param count [type:number] the number of values to copy
+     *
+     * @examples
+     * How to copy the height (y) of each position to a separate stream:
+     *
+     * ```lua
+     * local positions = buffer.get_stream(buf, hash("position"))
+     * local heights = buffer.get_stream(buf, hash("height"))
+     * buffer.copy_values(heights, 0, 1, positions, 1, 3, #heights)
+     * ```
+    */
+    static int CopyValues(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* dststream = CheckStream(L, 1);
+        int dstoffset = luaL_checkint(L, 2);
+        int dststride = luaL_checkint(L, 3);
+        BufferStream* srcstream = CheckStream(L, 4);
+        int srcoffset = luaL_checkint(L, 5);
+        int srcstride = luaL_checkint(L, 6);
+        int count = luaL_checkint(L, 7);
+
+        if (!IsValidValueRange(dststream, dstoffset, dststride, count))
+        {
+            return DM_LUA_ERROR("Trying to write outside the stream: Stream length: %d, Offset: %d, Stride: %d, Values to copy: %d", (int)(dststream->m_Count * dststream->m_TypeCount), dstoffset, dststride, count);
+        }
+        if (!IsValidValueRange(srcstream, srcoffset, srcstride, count))
+        {
+            return DM_LUA_ERROR("Trying to read outside the stream: Stream length: %d, Offset: %d, Stride: %d, Values to copy: %d", (int)(srcstream->m_Count * srcstream->m_TypeCount), srcoffset, srcstride, count);
+        }
+
+        CopyValuesInternal(dststream, dstoffset, dststride, srcstream, srcoffset, srcstride, count);
+        dmBuffer::UpdateContentVersion(dststream->m_Buffer);
+        return 0;
+    }
+
+    /*# transforms the elements of a stream
+     *
+     * Multiply the elements of a stream with a matrix, in place. This is done in native
+     * code, using SIMD instructions where available.
+     *
+     * The stream must be of type `buffer.VALUE_TYPE_FLOAT32`, with 3 or 4 components.
+     * Elements with 3 components are transformed as points (w = 1). To transform
+     * directions, use a matrix without translation.
+     *
+     * @name buffer.transform_stream
+     * @param stream [type:bufferstream] the stream to transform
+     * @param matrix [type:matrix4] the transform
+     * @param [start] [type:number] the first element to transform. Defaults to 0.
+     * @param [count] [type:number] the number of elements to transform. Defaults to the remaining elements.
+     *
+     * @examples
+     * How to rotate and move all vertices of a mesh:
+     *
+     * ```lua
+     * local positions = buffer.get_stream(buf, hash("position"))
+     * local m = vmath.matrix4_rotation_z(math.pi * 0.5)
+     * m.c3 = vmath.vector4(10, 0, 0, 1)
+     * buffer.transform_stream(positions, m)
+     * ```
+    */
+    static int TransformStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+        dmVMath::Matrix4* transform = dmScript::CheckMatrix4(L, 2);
+        int start = luaL_optint(L, 3, 0);
+        int count = luaL_optint(L, 4, (int)stream->m_Count - start);
+
+        dmBuffer::Result r = dmBuffer::TransformStream(stream->m_Buffer, stream->m_Name, (uint32_t)start, (uint32_t)count, *transform);
+        if (r == dmBuffer::RESULT_STREAM_TYPE_MISMATCH)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: The stream must be of type buffer.VALUE_TYPE_FLOAT32 with 3 or 4 components, got %d 'buffer.%s'",
+                                    (int)stream->m_TypeCount, dmBuffer::GetValueTypeString(stream->m_Type));
+        }
+        else if (r == dmBuffer::RESULT_BUFFER_SIZE_ERROR)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: Trying to transform outside the stream: Stream count: %d, Start: %d, Count: %d", (int)stream->m_Count, start, count);
+        }
+        else if (r != dmBuffer::RESULT_OK)
+        {
+            return DM_LUA_ERROR("buffer.transform_stream: %s", dmBuffer::GetResultString(r));
+        }
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+    // Gets one value per stream component from a number, vector3 or vector4
+    static bool GetComponentValues(lua_State* L, int index, uint32_t components, float* out)
+    {
+        if (lua_type(L, index) == LUA_TNUMBER)
+        {
+            float v = (float)lua_tonumber(L, index);
+            for (uint32_t c = 0; c < components; ++c)
+            {
+                out[c] = v;
+            }
+            return true;
+        }
+
+        dmVMath::Vector4* v4 = dmScript::ToVector4(L, index);
+        if (v4 && components <= 4)
+        {
+            for (uint32_t c = 0; c < components; ++c)
+            {
+                out[c] = v4->getElem(c);
+            }
+            return true;
+        }
+
+        dmVMath::Vector3* v3 = dmScript::ToVector3(L, index);
+        if (v3 && components <= 3)
+        {
+            for (uint32_t c = 0; c < components; ++c)
+            {
+                out[c] = v3->getElem(c);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /*# scales and offsets the elements of a stream
+     *
+     * Set each component of the elements of a stream to `value * scale + bias`, in place.
+     * This is done in native code, using SIMD instructions where available.
+     *
+     * The stream must be of type `buffer.VALUE_TYPE_FLOAT32`. The scale and bias can be numbers,
+     * which are applied to all components, or vectors with one value per component.
+     *
+     * @name buffer.scale_bias_stream
+     * @param stream [type:bufferstream] the stream to modify
+     * @param scale [type:number|vector3|vector4] the scale
+     * @param bias [type:number|vector3|vector4] the bias
+     * @param [start] [type:number] the first element to modify. Defaults to 0.
+     * @param [count] [type:number] the number of elements to modify. Defaults to the remaining elements.
+     *
+     * @examples
+     * How to convert texture coordinates from the range [-1, 1] to [0, 1]:
+     *
+     * ```lua
+     * local texcoords = buffer.get_stream(buf, hash("texcoord0"))
+     * buffer.scale_bias_stream(texcoords, 0.5, 0.5)
+     * ```
+    */
+    static int ScaleBiasStream(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 0);
+        BufferStream* stream = CheckStream(L, 1);
+
+        float* scale = (float*)alloca(stream->m_TypeCount * sizeof(float));
+        float* bias = (float*)alloca(stream->m_TypeCount * sizeof(float));
+        if (!GetComponentValues(L, 2, stream->m_TypeCount, scale))
+        {
+            return DM_LUA_ERROR("buffer.scale_bias_stream: The scale must be a number, or a vector with at least %d components", (int)stream->m_TypeCount);
+        }
+        if (!GetComponentValues(L, 3, stream->m_TypeCount, bias))
+        {
+            return DM_LUA_ERROR("buffer.scale_bias_stream: The bias must be a number, or a vector with at least %d components", (int)stream->m_TypeCount);
+        }
+        int start = luaL_optint(L, 4, 0);
+        int count = luaL_optint(L, 5, (int)stream->m_Count - start);
+
+        dmBuffer::Result r = dmBuffer::ScaleBiasStream(stream->m_Buffer, stream->m_Name, (uint32_t)start, (uint32_t)count, scale, bias);
+        if (r == dmBuffer::RESULT_STREAM_TYPE_MISMATCH)
+        {
+            return DM_LUA_ERROR("buffer.scale_bias_stream: The stream must be of type buffer.VALUE_TYPE_FLOAT32, got 'buffer.%s'", dmBuffer::GetValueTypeString(stream->m_Type));
+        }
+        else if (r == dmBuffer::RESULT_BUFFER_SIZE_ERROR)
+        {
+            return DM_LUA_ERROR("buffer.scale_bias_stream: Trying to modify outside the stream: Stream count: %d, Start: %d, Count: %d", (int)stream->m_Count, start, count);
+        }
+        else if (r != dmBuffer::RESULT_OK)
+        {
+            return DM_LUA_ERROR("buffer.scale_bias_stream: %s", dmBuffer::GetResultString(r));
+        }
+        dmBuffer::UpdateContentVersion(stream->m_Buffer);
+        return 0;
+    }
+
+
     /*# gets data from a stream
      *
      * Get a copy of all the bytes from a specified stream as a Lua string.
@@ -1148,6 +1557,12 @@ namespace dmGameSystem
         {"get_bytes", GetBytes},
         {"copy_stream", CopyStream},
         {"copy_buffer", CopyBuffer},
+        {"set_values", SetValues},
+        {"get_values", GetValues},
+        {"fill_values", FillValues},
+        {"copy_values", CopyValues},
+        {"transform_stream", TransformStream},
+        {"scale_bias_stream", ScaleBiasStream},
         {"set_metadata",SetMetadata},
         {"get_metadata",GetMetadata},
         {0, 0}
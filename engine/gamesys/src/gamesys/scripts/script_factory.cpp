@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <assert.h>
 
+#include <dlib/array.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
@@ -363,6 +364,215 @@ namespace dmGameSystem
         return 1;
     }
 
+    /*# make a factory create a number of new game objects
+     *
+     * The URL identifies which factory should create the game objects.
+     * All game objects are created from the same prototype in one batch, which is considerably faster than calling
+     * [ref:factory.create] in a loop when spawning many objects (e.g. projectiles or tiles).
+     *
+     * The same properties are applied to all created game objects.
+     *
+     * [icon:attention] Calling [ref:factory.create_many] on a factory that is marked as dynamic without having loaded resources
+     * using [ref:factory.load] will synchronously load and create resources which may affect application performance.
+     *
+     * @name factory.create_many
+     * @param url [type:string|hash|url] the factory that should create the game objects.
+     * @param count [type:number] the number of game objects to create.
+     * @param [positions] [type:table] array of `count` positions ([type:vector3]) for the new game objects. The position of the game object calling `factory.create_many()` is used by default, or if the value is `nil`.
+     * @param [rotations] [type:table] array of `count` rotations ([type:quaternion]) for the new game objects. The rotation of the game object calling `factory.create_many()` is used by default, or if the value is `nil`.
+     * @param [properties] [type:table] the properties defined in a script attached to the new game objects.
+     * @param [scale] [type:number|vector3] the scale of the new game objects (must be greater than 0), the scale of the game object containing the factory is used by default, or if the value is `nil`
+     * @return ids [type:table] array with the global ids of the spawned game objects
+     * @examples
+     *
+     * How to create a row of game objects:
+     *
+     * ```lua
+     * function init(self)
+     *     local positions = {}
+     *     for i = 1, 100 do
+     *         positions[i] = vmath.vector3(i * 16, 0, 0)
+     *     end
+     *     self.tiles = factory.create_many("#factory", 100, positions)
+     * end
+     * ```
+     */
+    static int FactoryComp_CreateMany(lua_State* L)
+    {
+        int top = lua_gettop(L);
+
+        dmGameObject::HInstance sender_instance = dmScript::CheckGOInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+
+        FactoryComponent* component;
+        dmScript::GetComponentFromLua(L, 1, FACTORY_EXT, 0, (void**)&component, 0);
+
+        if (dmGameObject::GetInstanceFromLua(L) == 0x0)
+        {
+            return luaL_error(L, "factory.create_many can not be called from this script type");
+        }
+
+        int count = luaL_checkinteger(L, 2);
+        if (count <= 0)
+        {
+            return luaL_error(L, "the count supplied to factory.create_many must be greater than 0.");
+        }
+
+        bool has_positions = top >= 3 && !lua_isnil(L, 3);
+        if (has_positions)
+        {
+            luaL_checktype(L, 3, LUA_TTABLE);
+        }
+        bool has_rotations = top >= 4 && !lua_isnil(L, 4);
+        if (has_rotations)
+        {
+            luaL_checktype(L, 4, LUA_TTABLE);
+        }
+
+        // Check all arguments before allocating anything, since a Lua error does not unwind the C++ stack
+        for (int i = 0; i < count; ++i)
+        {
+            if (has_positions)
+            {
+                lua_rawgeti(L, 3, i + 1);
+                if (!lua_isnil(L, -1))
+                {
+                    dmScript::CheckVector3(L, -1);
+                }
+                lua_pop(L, 1);
+            }
+            if (has_rotations)
+            {
+                lua_rawgeti(L, 4, i + 1);
+                if (!lua_isnil(L, -1))
+                {
+                    dmScript::CheckQuat(L, -1);
+                }
+                lua_pop(L, 1);
+            }
+        }
+
+        const uint32_t buffer_size = 512;
+        uint8_t DM_ALIGNED(16) buffer[buffer_size];
+        uint32_t actual_prop_buffer_size = 0;
+        if (top >= 5 && !lua_isnil(L, 5))
+        {
+            actual_prop_buffer_size = dmScript::CheckTable(L, (char*)buffer, buffer_size, 5);
+            if (actual_prop_buffer_size > buffer_size)
+                return luaL_error(L, "the properties supplied to factory.create_many are too many.");
+        }
+
+        dmVMath::Vector3 scale;
+        if (top >= 6 && !lua_isnil(L, 6))
+        {
+            // We check for zero in the ToTransform/ResetScale in transform.h
+            dmVMath::Vector3* v = dmScript::ToVector3(L, 6);
+            if (v != 0)
+            {
+                scale = *v;
+            }
+            else
+            {
+                float val = luaL_checknumber(L, 6);
+                scale = dmVMath::Vector3(val, val, val);
+            }
+        }
+        else
+        {
+            scale = dmGameObject::GetWorldScale(sender_instance);
+        }
+
+        // The positions and rotations are valid at this point
+        dmArray<dmVMath::Point3> positions;
+        positions.SetCapacity(count);
+        positions.SetSize(count);
+        dmArray<dmVMath::Quat> rotations;
+        rotations.SetCapacity(count);
+        rotations.SetSize(count);
+        dmVMath::Point3 default_position = dmGameObject::GetWorldPosition(sender_instance);
+        dmVMath::Quat default_rotation = dmGameObject::GetWorldRotation(sender_instance);
+        for (int i = 0; i < count; ++i)
+        {
+            positions[i] = default_position;
+            if (has_positions)
+            {
+                lua_rawgeti(L, 3, i + 1);
+                if (!lua_isnil(L, -1))
+                {
+                    positions[i] = dmVMath::Point3(*dmScript::ToVector3(L, -1));
+                }
+                lua_pop(L, 1);
+            }
+            rotations[i] = default_rotation;
+            if (has_rotations)
+            {
+                lua_rawgeti(L, 4, i + 1);
+                if (!lua_isnil(L, -1))
+                {
+                    rotations[i] = *dmScript::ToQuat(L, -1);
+                }
+                lua_pop(L, 1);
+            }
+        }
+
+        dmArray<uint32_t> indices;
+        indices.SetCapacity(count);
+        indices.SetSize(dmGameObject::AcquireInstanceIndices(collection, count, indices.Begin()));
+        if (indices.Size() != (uint32_t)count)
+        {
+            for (uint32_t i = 0; i < indices.Size(); ++i)
+            {
+                dmGameObject::ReleaseInstanceIndex(indices[i], collection);
+            }
+            dmLogError("factory.create_many can not create %d gameobjects since the buffer is full.", count);
+            lua_newtable(L);
+            assert(top + 1 == lua_gettop(L));
+            return 1;
+        }
+
+        dmArray<dmhash_t> ids;
+        ids.SetCapacity(count);
+        ids.SetSize(count);
+        for (int i = 0; i < count; ++i)
+        {
+            ids[i] = dmGameObject::ConstructInstanceId(indices[i]);
+        }
+
+        dmArray<dmGameObject::HInstance> instances;
+        instances.SetCapacity(count);
+        instances.SetSize(count);
+
+        dmScript::GetInstance(L);
+        int ref = dmScript::Ref(L, LUA_REGISTRYINDEX);
+        dmGameObject::HPrototype prototype = CompFactoryGetPrototype(collection, component);
+        const char* path = CompFactoryGetPrototypePath(component);
+        dmGameObject::SpawnBatch(collection, prototype, path, count, ids.Begin(), buffer, actual_prop_buffer_size,
+                                 positions.Begin(), rotations.Begin(), scale, instances.Begin());
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        dmScript::SetInstance(L);
+        dmScript::Unref(L, LUA_REGISTRYINDEX, ref);
+
+        lua_createtable(L, count, 0);
+        int table_index = 1;
+        for (int i = 0; i < count; ++i)
+        {
+            if (instances[i] != 0x0)
+            {
+                dmGameObject::AssignInstanceIndex(indices[i], instances[i]);
+                dmScript::PushHash(L, ids[i]);
+                lua_rawseti(L, -2, table_index++);
+            }
+            else
+            {
+                dmGameObject::ReleaseInstanceIndex(indices[i], collection);
+            }
+        }
+
+        assert(top + 1 == lua_gettop(L));
+        return 1;
+    }
+
     /*# changes the prototype for the factory
      *
      * Changes the prototype for the factory.
@@ -464,6 +674,7 @@ namespace dmGameSystem
     static const luaL_reg FACTORY_COMP_FUNCTIONS[] =
     {
         {"create",            FactoryComp_Create},
+        {"create_many",       FactoryComp_CreateMany},
         {"load",              FactoryComp_Load},
         {"unload",            FactoryComp_Unload},
         {"get_status",        FactoryComp_GetStatus},
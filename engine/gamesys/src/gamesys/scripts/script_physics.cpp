@@ -145,6 +145,9 @@ namespace dmGameSystem
     {
         dmMessage::HSocket m_Socket;
         uint32_t m_ComponentIndex;
+        // Reused by physics.raycast_batch
+        dmArray<dmPhysics::RayCastRequest> m_BatchRequests;
+        dmArray<dmPhysics::RayCastResponse> m_BatchResponses;
     };
 
     /*# [type:number] collision object mass
@@ -509,6 +512,191 @@ namespace dmGameSystem
         return 1;
     }
 
+    static void SetVector3Field(lua_State* L, const char* name, const dmVMath::Vector3& value)
+    {
+        lua_getfield(L, -1, name);
+        dmVMath::Vector3* v = dmScript::ToVector3(L, -1);
+        lua_pop(L, 1);
+        if (v != 0x0)
+        {
+            *v = value;
+        }
+        else
+        {
+            dmScript::PushVector3(L, value);
+            lua_setfield(L, -2, name);
+        }
+    }
+
+    static dmVMath::Point3 GetRayCastBatchPoint(lua_State* L, int index, bool list, uint32_t i)
+    {
+        if (!list)
+        {
+            return dmVMath::Point3(*dmScript::CheckVector3(L, index));
+        }
+        lua_rawgeti(L, index, i + 1);
+        dmVMath::Point3 p(*dmScript::CheckVector3(L, -1));
+        lua_pop(L, 1);
+        return p;
+    }
+
+    /*# performs a batch of ray casts
+     *
+     * Casts a number of rays in one call and reports the closest hit of each ray. The rays are cast
+     * in parallel if `physics.query_thread_count` is set in the game.project file.
+     * Collision objects of types kinematic, dynamic and static are tested against. Trigger objects
+     * do not intersect with ray casts.
+     * Which collision objects to hit is filtered by their collision groups and can be configured
+     * through `groups`.
+     *
+     * Either `from` or `to` must be a list of positions. The other one can be a single position that
+     * is shared by all rays, e.g. for line-of-sight tests from many agents to one target.
+     *
+     * @name physics.raycast_batch
+     * @param from [type:vector3|table] the world position of the start of the rays, or a list of positions
+     * @param to [type:vector3|table] the world position of the end of the rays, or a list of positions
+     * @param groups [type:table] a lua table containing the hashed groups for which to test collisions against
+     * @param [results] [type:table] the table returned by a previous call, to be reused. The hit tables, and
+     * their `position` and `normal` vectors, are updated in place.
+     * @return results [type:table] a list with one entry per ray. The entry is `false` if the ray missed,
+     * otherwise a table with the same fields as [ref:ray_cast_response], except `request_id`.
+     * @examples
+     *
+     * How to test line-of-sight from a number of agents to the player:
+     *
+     * ```lua
+     * function update(self, dt)
+     *     local player = go.get_position("player")
+     *     self.sight = physics.raycast_batch(self.agent_positions, player, self.groups, self.sight)
+     *     for i,hit in ipairs(self.sight) do
+     *         -- the agent can see the player if nothing is in between
+     *         set_can_see(i, not hit or hit.id == hash("/player"))
+     *     end
+     * end
+     * ```
+     */
+    int Physics_RayCastBatch(lua_State* L)
+    {
+        DM_LUA_STACK_CHECK(L, 1);
+
+        dmMessage::URL sender;
+        if (!dmScript::GetURL(L, &sender)) {
+            return luaL_error(L, "could not find a requesting instance for physics.raycast_batch");
+        }
+
+        dmScript::GetGlobal(L, PHYSICS_CONTEXT_HASH);
+        PhysicsScriptContext* context = (PhysicsScriptContext*)lua_touserdata(L, -1);
+        lua_pop(L, 1);
+
+        dmGameObject::HInstance sender_instance = CheckGoInstance(L);
+        dmGameObject::HCollection collection = dmGameObject::GetCollection(sender_instance);
+        void* world = dmGameObject::GetWorld(collection, context->m_ComponentIndex);
+        if (world == 0x0)
+        {
+            return DM_LUA_ERROR("Physics world doesn't exist. Make sure you have at least one physics component in collection.");
+        }
+
+        bool from_list = lua_istable(L, 1);
+        bool to_list = lua_istable(L, 2);
+        if (!from_list && !to_list)
+        {
+            return DM_LUA_ERROR("either from or to must be a list of positions");
+        }
+        uint32_t count = from_list ? lua_objlen(L, 1) : lua_objlen(L, 2);
+        if (from_list && to_list && lua_objlen(L, 2) != count)
+        {
+            return DM_LUA_ERROR("from and to must be lists of the same length (%d != %d)", count, (uint32_t)lua_objlen(L, 2));
+        }
+
+        uint32_t mask = 0;
+        luaL_checktype(L, 3, LUA_TTABLE);
+        lua_pushnil(L);
+        while (lua_next(L, 3) != 0)
+        {
+            mask |= CompCollisionGetGroupBitIndex(world, dmScript::CheckHash(L, -1));
+            lua_pop(L, 1);
+        }
+
+        dmArray<dmPhysics::RayCastRequest>& requests = context->m_BatchRequests;
+        dmArray<dmPhysics::RayCastResponse>& responses = context->m_BatchResponses;
+        if (requests.Capacity() < count)
+        {
+            requests.SetCapacity(count);
+            responses.SetCapacity(count);
+        }
+        requests.SetSize(count);
+        responses.SetSize(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::RayCastRequest& request = requests[i];
+            request = dmPhysics::RayCastRequest();
+            request.m_From = GetRayCastBatchPoint(L, 1, from_list, i);
+            request.m_To = GetRayCastBatchPoint(L, 2, to_list, i);
+            request.m_Mask = mask;
+        }
+
+        dmGameSystem::RayCastBatch(world, requests.Begin(), responses.Begin(), count);
+
+        if (lua_istable(L, 4))
+        {
+            lua_pushvalue(L, 4);
+        }
+        else
+        {
+            lua_createtable(L, count, 0);
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmPhysics::RayCastResponse& response = responses[i];
+            if (!response.m_Hit)
+            {
+                lua_pushboolean(L, 0);
+                lua_rawseti(L, -2, i + 1);
+                continue;
+            }
+
+            lua_rawgeti(L, -1, i + 1);
+            if (!lua_istable(L, -1))
+            {
+                lua_pop(L, 1);
+                lua_newtable(L);
+                lua_pushvalue(L, -1);
+                lua_rawseti(L, -3, i + 1);
+            }
+
+            lua_pushnumber(L, response.m_Fraction);
+            lua_setfield(L, -2, "fraction");
+            SetVector3Field(L, "position", dmVMath::Vector3(response.m_Position));
+            SetVector3Field(L, "normal", response.m_Normal);
+
+            dmhash_t group = dmGameSystem::GetLSBGroupHash(world, response.m_CollisionObjectGroup);
+            dmScript::PushHash(L, group);
+            lua_setfield(L, -2, "group");
+
+            dmhash_t id = dmGameSystem::CompCollisionObjectGetIdentifier(response.m_CollisionObjectUserData);
+            dmScript::PushHash(L, id);
+            lua_setfield(L, -2, "id");
+
+            lua_pop(L, 1);
+        }
+
+        // Truncate a reused table that held more rays
+        for (uint32_t i = count + 1; ; ++i)
+        {
+            lua_rawgeti(L, -1, i);
+            bool is_nil = lua_isnil(L, -1);
+            lua_pop(L, 1);
+            if (is_nil)
+                break;
+            lua_pushnil(L);
+            lua_rawseti(L, -2, i);
+        }
+
+        return 1;
+    }
+
     // Matches JointResult in physics.h
     static const char* PhysicsResultString[] = {
         "result ok",
@@ -1096,9 +1284,9 @@ namespace dmGameSystem
         bool flip = lua_toboolean(L, 2);
 
         if (horizontal)
-            SetCollisionFlipH(comp, flip);
+            SetCollisionFlipH(comp_world, comp, flip);
         else
-            SetCollisionFlipV(comp, flip);
+            SetCollisionFlipV(comp_world, comp, flip);
 
         return 0;
     }
@@ -1720,6 +1908,7 @@ namespace dmGameSystem
         {"ray_cast",        Physics_RayCastAsync}, // Deprecated
         {"raycast_async",   Physics_RayCastAsync},
         {"raycast",         Physics_RayCast},
+        {"raycast_batch",   Physics_RayCastBatch},
 
         {"create_joint",    Physics_CreateJoint},
         {"destroy_joint",   Physics_DestroyJoint},
@@ -0,0 +1,8 @@
+components {
+  id: "script"
+  component: "/factory/create_many.script"
+}
+components {
+  id: "factory"
+  component: "/factory/create_many.factory"
+}
@@ -0,0 +1,4 @@
+components {
+  id: "script"
+  component: "/factory/create_many_resource.script"
+}
@@ -0,0 +1,8 @@
+components {
+  id: "model"
+  component: "/model/skinned.model"
+}
+components {
+  id: "model_small_palette"
+  component: "/model/skinned_small_palette.model"
+}
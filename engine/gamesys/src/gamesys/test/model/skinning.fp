@@ -0,0 +1,6 @@
+uniform lowp vec4 tint;
+
+void main()
+{
+    gl_FragColor = tint;
+}
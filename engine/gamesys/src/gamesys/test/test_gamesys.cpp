@@ -1543,6 +1543,31 @@ TEST_P(FactoryTest, Test)
     dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
 }
 
+/* Factory script functions */
+
+TEST_F(FactoryScriptTest, CreateMany)
+{
+    dmGameSystem::ScriptLibContext scriptlibcontext;
+    scriptlibcontext.m_Factory         = m_Factory;
+    scriptlibcontext.m_Register        = m_Register;
+    scriptlibcontext.m_LuaState        = dmScript::GetLuaState(m_ScriptContext);
+    scriptlibcontext.m_GraphicsContext = m_GraphicsContext;
+
+    dmGameSystem::InitializeScriptLibs(scriptlibcontext);
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/factory/create_many.goc", dmHashString64("/go"), 0, 0, Point3(10, 20, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    bool tests_done = false;
+    WaitForTestsDone(100, false, &tests_done);
+    ASSERT_TRUE(tests_done);
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+    dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
+}
+
 /* Collection factory dynamic and static loading */
 
 TEST_P(CollectionFactoryTest, Test)
@@ -1891,6 +1916,98 @@ TEST_P(DrawCountTest, DrawCount)
     ASSERT_TRUE(dmGameObject::Final(m_Collection));
 }
 
+/* Model */
+
+static dmRender::RenderObject* FindRenderObject(dmRender::HRenderContext render_context, dmRender::HMaterial material)
+{
+    dmRender::RenderContext* context = (dmRender::RenderContext*) render_context;
+    for (uint32_t i = 0; i < context->m_RenderObjects.Size(); ++i)
+    {
+        if (context->m_RenderObjects[i]->m_Material == material)
+            return context->m_RenderObjects[i];
+    }
+    return 0;
+}
+
+// The skinned quad has two bones ("root" and "tip"). The "model" component uses a material with
+// room for four pose matrices, and "model_small_palette" a material with room for a single one.
+TEST_F(ModelTest, SkinningConstants)
+{
+    dmGameSystem::MaterialResource* material_res;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/model/skinning.materialc", (void**) &material_res));
+    dmGameSystem::MaterialResource* small_palette_material_res;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(m_Factory, "/model/skinning_small_palette.materialc", (void**) &small_palette_material_res));
+
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/model/skinned.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    // A render constant set by the user
+    dmGameObject::PropertyOptions opt;
+    opt.m_Index = 0;
+    opt.m_HasKey = 0;
+    dmGameObject::PropertyVar tint(Vector4(0.25f, 0.5f, 0.75f, 1.0f));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go, dmHashString64("model"), dmHashString64("tint"), opt, tint));
+    ASSERT_EQ(dmGameObject::PROPERTY_RESULT_OK, dmGameObject::SetProperty(go, dmHashString64("model_small_palette"), dmHashString64("tint"), opt, tint));
+
+    for (uint32_t frame = 0; frame < 2; ++frame)
+    {
+        ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+        dmRender::RenderListBegin(m_RenderContext);
+        dmGameObject::Render(m_Collection);
+        dmRender::RenderListEnd(m_RenderContext);
+        dmRender::DrawRenderList(m_RenderContext, 0x0, 0x0, 0x0);
+
+        // Skinned in the vertex shader: the bone weights and indices are bound, and the pose matrices
+        // are set in a constant buffer together with the render constants of the component
+        dmRender::RenderObject* ro = FindRenderObject(m_RenderContext, material_res->m_Material);
+        ASSERT_NE((void*)0, ro);
+        ASSERT_NE((dmGraphics::HVertexBuffer) 0, ro->m_VertexBuffers[1]);
+        ASSERT_NE((void*)0, ro->m_ConstantBuffer);
+        ASSERT_EQ(2U, dmRender::GetNamedConstantCount(ro->m_ConstantBuffer));
+
+        dmVMath::Vector4* values;
+        uint32_t num_values;
+        ASSERT_TRUE(dmRender::GetNamedConstant(ro->m_ConstantBuffer, dmHashString64("pose_matrices"), &values, &num_values));
+        ASSERT_EQ(2U * 4U, num_values);
+
+        // Both bones are in their bind pose
+        Matrix4* pose_matrices = (Matrix4*) values;
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                for (uint32_t r = 0; r < 4; ++r)
+                {
+                    ASSERT_NEAR(c == r ? 1.0f : 0.0f, pose_matrices[i].getElem(c, r), 0.0001f);
+                }
+            }
+        }
+
+        ASSERT_TRUE(dmRender::GetNamedConstant(ro->m_ConstantBuffer, dmHashString64("tint"), &values, &num_values));
+        ASSERT_EQ(1U, num_values);
+        ASSERT_NEAR(0.5f, values[0].getY(), 0.0001f);
+
+        // The skeleton doesn't fit in the material, so the model isn't skinned
+        ro = FindRenderObject(m_RenderContext, small_palette_material_res->m_Material);
+        ASSERT_NE((void*)0, ro);
+        ASSERT_EQ((dmGraphics::HVertexBuffer) 0, ro->m_VertexBuffers[1]);
+        ASSERT_NE((void*)0, ro->m_ConstantBuffer);
+        ASSERT_FALSE(dmRender::GetNamedConstant(ro->m_ConstantBuffer, dmHashString64("pose_matrices"), &values, &num_values));
+        ASSERT_TRUE(dmRender::GetNamedConstant(ro->m_ConstantBuffer, dmHashString64("tint"), &values, &num_values));
+
+        ASSERT_TRUE(dmGameObject::PostUpdate(m_Collection));
+        dmGraphics::Flip(m_GraphicsContext);
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+
+    dmResource::Release(m_Factory, material_res);
+    dmResource::Release(m_Factory, small_palette_material_res);
+}
+
 /* GUI Box Render */
 
 void AssertVertexEqual(const dmGameSystem::BoxVertex& lhs, const dmGameSystem::BoxVertex& rhs)
@@ -1955,6 +2072,97 @@ TEST_P(BoxRenderTest, BoxRender)
     dmGameSystem::FinalizeScriptLibs(scriptlibcontext);
 }
 
+static void RenderGuiFrame(dmRender::HRenderContext render_context, dmGraphics::HContext graphics_context, dmGameObject::HCollection collection, dmGameObject::UpdateContext* update_context)
+{
+    ASSERT_TRUE(dmGameObject::Update(collection, update_context));
+    dmRender::RenderListBegin(render_context);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0, 0x0);
+    ASSERT_TRUE(dmGameObject::PostUpdate(collection));
+    dmGraphics::Flip(graphics_context);
+}
+
+// Only the vertices of changed nodes are uploaded, to the vertex buffer that wasn't used the previous frame
+TEST_F(GuiTest, PartialVertexUpload)
+{
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, "/gui/vertex_upload_test.goc", dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+
+    uint32_t component_type_index = dmGameObject::GetComponentTypeIndex(m_Collection, dmHashString64("guic"));
+    dmGameSystem::GuiWorld* world = (dmGameSystem::GuiWorld*)dmGameObject::GetWorld(m_Collection, component_type_index);
+    dmGui::HScene scene = world->m_Components[0]->m_Scene;
+
+    // Box and pie nodes both keep the vertices of unchanged nodes
+    const dmGui::NodeType node_types[] = {dmGui::NODE_TYPE_BOX, dmGui::NODE_TYPE_PIE};
+    for (uint32_t t = 0; t < DM_ARRAY_SIZE(node_types); ++t)
+    {
+        const uint32_t node_count = 16;
+        dmGui::HNode nodes[node_count];
+        for (uint32_t i = 0; i < node_count; ++i)
+        {
+            nodes[i] = dmGui::NewNode(scene, Point3(i * 20.0f, 10.0f, 0.0f), Vector3(10.0f, 10.0f, 0.0f), node_types[t], 0);
+            ASSERT_NE((dmGui::HNode)0, nodes[i]);
+        }
+
+        // The first frames allocate both vertex buffers
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            RenderGuiFrame(m_RenderContext, m_GraphicsContext, m_Collection, &m_UpdateContext);
+
+            dmGraphics::VertexBuffer* vb = (dmGraphics::VertexBuffer*) world->m_VertexBuffer;
+            uint32_t size = world->m_ClientVertexBuffer.Size() * sizeof(dmGameSystem::BoxVertex);
+            ASSERT_LE(size, vb->m_Size);
+            ASSERT_EQ(0, memcmp(vb->m_Buffer, world->m_ClientVertexBuffer.Begin(), size));
+        }
+        ASSERT_NE(world->m_VertexBuffers[0], world->m_VertexBuffers[1]);
+
+        uint32_t vertex_count = world->m_ClientVertexBuffer.Size();
+        ASSERT_EQ(0U, vertex_count % node_count);
+        uint32_t node_vertex_count = vertex_count / node_count;
+        ASSERT_LT(0U, node_vertex_count);
+
+        // Overwrite the vertices of the unchanged nodes in the buffer that was used this frame
+        dmGraphics::VertexBuffer* vb = (dmGraphics::VertexBuffer*) world->m_VertexBuffer;
+        uint32_t node_size = node_vertex_count * sizeof(dmGameSystem::BoxVertex);
+        memset(vb->m_Buffer + node_size, 0xff, (node_count - 2) * node_size);
+
+        // Move the first and the last node during the two frames until the buffer is used again
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            dmGui::SetNodePosition(scene, nodes[0], Point3(0.0f, 20.0f + i, 0.0f));
+            dmGui::SetNodePosition(scene, nodes[node_count - 1], Point3((node_count - 1) * 20.0f, 20.0f + i, 0.0f));
+            RenderGuiFrame(m_RenderContext, m_GraphicsContext, m_Collection, &m_UpdateContext);
+        }
+        ASSERT_EQ(vb, (dmGraphics::VertexBuffer*) world->m_VertexBuffer);
+        ASSERT_EQ(vertex_count, world->m_ClientVertexBuffer.Size());
+
+        // The changed nodes were uploaded as two separate ranges, leaving the nodes in between untouched
+        const uint8_t* client = (const uint8_t*) world->m_ClientVertexBuffer.Begin();
+        ASSERT_EQ(0, memcmp(vb->m_Buffer, client, node_size));
+        ASSERT_EQ(0, memcmp(vb->m_Buffer + (node_count - 1) * node_size, client + (node_count - 1) * node_size, node_size));
+        for (uint32_t i = node_size; i < (node_count - 1) * node_size; ++i)
+        {
+            ASSERT_EQ(0xff, (uint8_t) vb->m_Buffer[i]);
+        }
+
+        // The other buffer is up to date after its next use
+        RenderGuiFrame(m_RenderContext, m_GraphicsContext, m_Collection, &m_UpdateContext);
+        ASSERT_NE(vb, (dmGraphics::VertexBuffer*) world->m_VertexBuffer);
+        vb = (dmGraphics::VertexBuffer*) world->m_VertexBuffer;
+        ASSERT_EQ(0, memcmp(vb->m_Buffer, world->m_ClientVertexBuffer.Begin(), vertex_count * sizeof(dmGameSystem::BoxVertex)));
+
+        for (uint32_t i = 0; i < node_count; ++i)
+        {
+            dmGui::DeleteNode(scene, nodes[i], false);
+        }
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
 /* Gamepad connected */
 
 TEST_F(GamepadConnectedTest, TestGamepadConnectedInputEvent)
@@ -4022,6 +4230,114 @@ TEST_F(ScriptBufferTest, CopyStream)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+TEST_F(ScriptBufferTest, BulkValues)
+{
+    int top = lua_gettop(L);
+
+    dmScript::LuaHBuffer luabuf(m_Buffer, dmScript::OWNER_C);
+    dmScript::PushBuffer(L, luabuf);
+    lua_setglobal(L, "test_buffer");
+
+    // set_values/get_values from a table, with the interleaved "rgb" stream
+    ASSERT_TRUE(RunString(L, "local rgb = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                              buffer.fill_values(rgb, 0, #rgb, 0) \
+                              buffer.set_values(rgb, 2, {1, 2, 3, 4, 5}) \
+                              for i=1,5 do assert(rgb[2 + i] == i) end \
+                              local values = buffer.get_values(rgb, 1, 7) \
+                              assert(#values == 7) \
+                              assert(values[1] == 0 and values[2] == 1 and values[6] == 5 and values[7] == 0) \
+                              local t = {} \
+                              assert(buffer.get_values(rgb, 3, 2, t) == t) \
+                              assert(#t == 2 and t[1] == 2 and t[2] == 3) \
+                             "));
+
+    // set_values from a stream of another type, converting the values
+    ASSERT_TRUE(RunString(L, "local src = buffer.create(4, { {name=hash(\"temp\"), type=buffer.VALUE_TYPE_FLOAT32, count=1 } }) \
+                              local srcstream = buffer.get_stream(src, \"temp\") \
+                              for i=1,#srcstream do srcstream[i] = i + 0.25 end \
+                              local a = buffer.get_stream(test_buffer, hash(\"a\")) \
+                              local rgb = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                              buffer.set_values(a, 10, srcstream) \
+                              buffer.set_values(rgb, 10, srcstream) \
+                              for i=1,4 do \
+                                assert(a[10 + i] == i + 0.25) \
+                                assert(rgb[10 + i] == i) \
+                              end \
+                             "));
+
+    // fill_values with a value and with a pattern
+    ASSERT_TRUE(RunString(L, "local rgb = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                              buffer.fill_values(rgb, 0, #rgb, 7) \
+                              for i=1,#rgb do assert(rgb[i] == 7) end \
+                              buffer.fill_values(rgb, 3, 9, {1, 2, 3}) \
+                              for i=1,3 do assert(rgb[i] == 7) end \
+                              for i=4,12 do assert(rgb[i] == (i - 4) % 3 + 1) end \
+                              assert(rgb[13] == 7) \
+                             "));
+
+    // copy_values, gathering the green component of each element into the "a" stream
+    ASSERT_TRUE(RunString(L, "local rgb = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                              local a = buffer.get_stream(test_buffer, hash(\"a\")) \
+                              for i=1,#rgb do rgb[i] = i end \
+                              buffer.copy_values(a, 0, 1, rgb, 1, 3, #a) \
+                              for i=1,#a do assert(a[i] == (i - 1) * 3 + 2) end \
+                             "));
+
+    // Errors
+    ASSERT_TRUE(RunString(L, "local rgb = buffer.get_stream(test_buffer, hash(\"rgb\")) \
+                              local a = buffer.get_stream(test_buffer, hash(\"a\")) \
+                              assert(not pcall(buffer.set_values, rgb, #rgb - 1, {1, 2})) \
+                              assert(not pcall(buffer.get_values, rgb, -1, 2)) \
+                              assert(not pcall(buffer.fill_values, rgb, 0, #rgb + 1, 0)) \
+                              assert(not pcall(buffer.fill_values, rgb, 0, 1, {})) \
+                              assert(not pcall(buffer.copy_values, a, 0, 1, rgb, 1, 3, #a + 1)) \
+                              assert(not pcall(buffer.copy_values, a, 0, 0, rgb, 0, 1, 1)) \
+                             "));
+
+    ASSERT_EQ(dmBuffer::RESULT_OK, dmBuffer::ValidateBuffer(m_Buffer));
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
+TEST_F(ScriptBufferTest, TransformStream)
+{
+    int top = lua_gettop(L);
+
+    ASSERT_TRUE(RunString(L, "local buf = buffer.create(10, { {name=hash(\"position\"), type=buffer.VALUE_TYPE_FLOAT32, count=3 }, \
+                                                              {name=hash(\"color\"), type=buffer.VALUE_TYPE_FLOAT32, count=4 }, \
+                                                              {name=hash(\"index\"), type=buffer.VALUE_TYPE_UINT16, count=1 } }) \
+                              local positions = buffer.get_stream(buf, hash(\"position\")) \
+                              for i=1,#positions do positions[i] = i end \
+                              local m = vmath.matrix4_rotation_z(math.pi * 0.5) \
+                              m.c3 = vmath.vector4(10, 20, 30, 1) \
+                              buffer.transform_stream(positions, m, 1, 8) \
+                              local function near(a, b) return math.abs(a - b) < 0.001 end \
+                              for i=0,9 do \
+                                local x, y, z = i*3 + 1, i*3 + 2, i*3 + 3 \
+                                if i >= 1 and i < 9 then \
+                                    local p = m * vmath.vector4(x, y, z, 1) \
+                                    x, y, z = p.x, p.y, p.z \
+                                end \
+                                assert(near(positions[i*3 + 1], x) and near(positions[i*3 + 2], y) and near(positions[i*3 + 3], z)) \
+                              end \
+                              local colors = buffer.get_stream(buf, hash(\"color\")) \
+                              buffer.fill_values(colors, 0, #colors, {0.5, 1, 0, 1}) \
+                              buffer.scale_bias_stream(colors, vmath.vector4(2, 0.5, 1, 1), vmath.vector4(0, 0, 0.25, -1)) \
+                              for i=0,9 do \
+                                assert(colors[i*4 + 1] == 1 and colors[i*4 + 2] == 0.5 and colors[i*4 + 3] == 0.25 and colors[i*4 + 4] == 0) \
+                              end \
+                              buffer.scale_bias_stream(positions, 0, 1, 9) \
+                              assert(positions[28] == 1 and positions[29] == 1 and positions[30] == 1) \
+                              assert(positions[27] ~= 1) \
+                              local index = buffer.get_stream(buf, hash(\"index\")) \
+                              assert(not pcall(buffer.transform_stream, index, m)) \
+                              assert(not pcall(buffer.transform_stream, positions, m, 5, 6)) \
+                              assert(not pcall(buffer.scale_bias_stream, index, 1, 0)) \
+                              assert(not pcall(buffer.scale_bias_stream, colors, vmath.vector3(1), 0)) \
+                             "));
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
 
 TEST_P(ScriptBufferCopyTest, CopyBuffer)
 {
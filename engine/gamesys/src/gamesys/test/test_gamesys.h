@@ -237,6 +237,12 @@ public:
     virtual ~FactoryTest() {}
 };
 
+class FactoryScriptTest : public GamesysTest<const char*>
+{
+public:
+    virtual ~FactoryScriptTest() {}
+};
+
 struct CollectionFactoryTestParams
 {
     const char* m_GOPath;
@@ -380,6 +386,12 @@ public:
     virtual ~MaterialTest() {}
 };
 
+class ModelTest : public GamesysTest<const char*>
+{
+public:
+    virtual ~ModelTest() {}
+};
+
 class ShaderTest : public GamesysTest<const char*>
 {
 public:
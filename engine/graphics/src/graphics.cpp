@@ -1146,13 +1146,17 @@ namespace dmGraphics
     {
         g_functions.m_DisableVertexBuffer(context, vertex_buffer);
     }
-    void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
+    void SetVertexDeclarationStepFunction(HContext context, HVertexDeclaration vertex_declaration, VertexStepFunction step_function)
     {
-        g_functions.m_DrawElements(context, prim_type, first, count, type, index_buffer);
+        vertex_declaration->m_StepFunction = step_function;
     }
-    void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
+    void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
     {
-        g_functions.m_Draw(context, prim_type, first, count);
+        g_functions.m_DrawElements(context, prim_type, first, count, type, index_buffer, instance_count);
+    }
+    void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
+    {
+        g_functions.m_Draw(context, prim_type, first, count, instance_count);
     }
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf)
     {
@@ -141,6 +141,17 @@ namespace dmGraphics
         params.m_DataSize = 0;
     }
 
+    // Matrix attributes (mat3/mat4) are bound as one vertex attribute per column,
+    // at consecutive locations starting from the attribute location.
+    static inline uint32_t GetVertexStreamColumnCount(uint32_t stream_size)
+    {
+        if (stream_size == 9)
+            return 3;
+        if (stream_size == 16)
+            return 4;
+        return 1;
+    }
+
     template <typename T>
     static inline HAssetHandle StoreAssetInContainer(dmOpaqueHandleContainer<uintptr_t>& container, T* asset, AssetType type)
     {
@@ -159,6 +159,7 @@ namespace dmGraphics
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_MULTI_TARGET_RENDERING;
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_TEXTURE_ARRAY;
         context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_COMPUTE_SHADER;
+        context->m_ContextFeatures |= 1 << CONTEXT_FEATURE_INSTANCING;
 
         if (context->m_AsyncProcessingSupport)
         {
@@ -529,6 +530,10 @@ namespace dmGraphics
         assert(_context);
         assert(vertex_declaration);
 
+        // The null device only emulates per-vertex fetching of the vertex streams
+        if (vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE)
+            return;
+
         NullContext* context = (NullContext*) _context;
 
         VertexBuffer* vb = (VertexBuffer*) context->m_VertexBuffer;
@@ -563,6 +568,8 @@ namespace dmGraphics
     {
         assert(context);
         assert(vertex_declaration);
+        if (vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE)
+            return;
         for (uint32_t i = 0; i < vertex_declaration->m_StreamCount; ++i)
             if (vertex_declaration->m_Streams[i].m_Size > 0)
                 DisableVertexStream(context, i);
@@ -585,7 +592,7 @@ namespace dmGraphics
         return ~0;
     }
 
-    static void NullDrawElements(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
+    static void NullDrawElements(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
     {
         assert(_context);
         assert(index_buffer);
@@ -617,7 +624,7 @@ namespace dmGraphics
         g_DrawCount++;
     }
 
-    static void NullDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
+    static void NullDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
     {
         assert(context);
 
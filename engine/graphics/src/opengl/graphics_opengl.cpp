@@ -369,6 +369,15 @@ static void LogFrameBufferError(GLenum status)
     typedef void (* DM_PFNGLDRAWBUFFERSPROC) (GLsizei n, const GLenum *bufs);
     DM_PFNGLDRAWBUFFERSPROC PFN_glDrawBuffers = NULL;
 
+    typedef void (* DM_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+    DM_PFNGLVERTEXATTRIBDIVISORPROC PFN_glVertexAttribDivisor = NULL;
+
+    typedef void (* DM_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount);
+    DM_PFNGLDRAWELEMENTSINSTANCEDPROC PFN_glDrawElementsInstanced = NULL;
+
+    typedef void (* DM_PFNGLDRAWARRAYSINSTANCEDPROC) (GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+    DM_PFNGLDRAWARRAYSINSTANCEDPROC PFN_glDrawArraysInstanced = NULL;
+
     // Note: This is necessary for webgl and android to work since we don't load core functions with emsc,
     //       however we might want to do this the other way around perhaps? i.e special case for webgl
     //       and load functions like this for all other platforms.
@@ -602,6 +611,7 @@ static void LogFrameBufferError(GLenum status)
             case CONTEXT_FEATURE_MULTI_TARGET_RENDERING: return context->m_MultiTargetRenderingSupport;
             case CONTEXT_FEATURE_TEXTURE_ARRAY:          return context->m_TextureArraySupport;
             case CONTEXT_FEATURE_COMPUTE_SHADER:         return context->m_ComputeSupport;
+            case CONTEXT_FEATURE_INSTANCING:             return context->m_InstancingSupport;
         }
         return false;
     }
@@ -738,6 +748,7 @@ static void LogFrameBufferError(GLenum status)
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_MULTI_TARGET_RENDERING);
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_TEXTURE_ARRAY);
         PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_COMPUTE_SHADER);
+        PRINT_FEATURE_IF_SUPPORTED(CONTEXT_FEATURE_INSTANCING);
     #undef PRINT_FEATURE_IF_SUPPORTED
     }
 
@@ -955,6 +966,12 @@ static void LogFrameBufferError(GLenum status)
 
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glInvalidateFramebuffer,   "glDiscardFramebuffer", "discard_framebuffer", "glInvalidateFramebuffer", DM_PFNGLINVALIDATEFRAMEBUFFERPROC, context);
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawBuffers,             "glDrawBuffers",        "draw_buffers",        "glDrawBuffers",           DM_PFNGLDRAWBUFFERSPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glVertexAttribDivisor,     "glVertexAttribDivisor",   "instanced_arrays", "glVertexAttribDivisor",   DM_PFNGLVERTEXATTRIBDIVISORPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced,   "glDrawElementsInstanced", "draw_instanced",   "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawArraysInstanced,     "glDrawArraysInstanced",   "draw_instanced",   "glDrawArraysInstanced",   DM_PFNGLDRAWARRAYSINSTANCEDPROC, context);
+        // GL_EXT_instanced_arrays (GLES2) exposes the draw functions as part of the same extension
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced,   "glDrawElementsInstanced", "instanced_arrays", 0,                         DM_PFNGLDRAWELEMENTSINSTANCEDPROC, context);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawArraysInstanced,     "glDrawArraysInstanced",   "instanced_arrays", 0,                         DM_PFNGLDRAWARRAYSINSTANCEDPROC, context);
     #ifdef ANDROID
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glTexSubImage3D,           "glTexSubImage3D",           "texture_array", "glTexSubImage3D",           DM_PFNGLTEXSUBIMAGE3DPROC, context);
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glTexImage3D,              "glTexImage3D",              "texture_array", "glTexImage3D",              DM_PFNGLTEXIMAGE3DPROC, context);
@@ -1190,6 +1207,8 @@ static void LogFrameBufferError(GLenum status)
         CLEAR_GL_ERROR;
 #endif
 
+        context->m_InstancingSupport = PFN_glVertexAttribDivisor != 0 && PFN_glDrawElementsInstanced != 0 && PFN_glDrawArraysInstanced != 0;
+
     #ifdef DM_HAVE_PLATFORM_COMPUTE_SUPPORT
         int32_t version_major = 0, version_minor = 0;
         glGetIntegerv(GL_MAJOR_VERSION, &version_major);
@@ -1580,38 +1599,65 @@ static void LogFrameBufferError(GLenum status)
 
         #define BUFFER_OFFSET(i) ((char*)0x0 + (i))
 
+        uint32_t divisor = vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE ? 1 : 0;
+
         for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
         {
-            if (vertex_declaration->m_Streams[i].m_Location != -1)
+            VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
+            if (stream.m_Location != -1)
             {
-                glEnableVertexAttribArray(vertex_declaration->m_Streams[i].m_Location);
-                CHECK_GL_ERROR;
-                glVertexAttribPointer(
-                        vertex_declaration->m_Streams[i].m_Location,
-                        vertex_declaration->m_Streams[i].m_Size,
-                        GetOpenGLType(vertex_declaration->m_Streams[i].m_Type),
-                        vertex_declaration->m_Streams[i].m_Normalize,
-                        vertex_declaration->m_Stride,
-                BUFFER_OFFSET(vertex_declaration->m_Streams[i].m_Offset) );   //The starting point of the VBO, for the vertices
+                uint32_t column_count = GetVertexStreamColumnCount(stream.m_Size);
+                uint32_t column_size  = stream.m_Size / column_count;
 
-                CHECK_GL_ERROR;
+                for (uint32_t c = 0; c < column_count; ++c)
+                {
+                    glEnableVertexAttribArray(stream.m_Location + c);
+                    CHECK_GL_ERROR;
+                    glVertexAttribPointer(
+                            stream.m_Location + c,
+                            column_size,
+                            GetOpenGLType(stream.m_Type),
+                            stream.m_Normalize,
+                            vertex_declaration->m_Stride,
+                    BUFFER_OFFSET(stream.m_Offset + c * column_size * GetTypeSize(stream.m_Type)) );   //The starting point of the VBO, for the vertices
+                    CHECK_GL_ERROR;
+
+                    if (context->m_InstancingSupport)
+                    {
+                        PFN_glVertexAttribDivisor(stream.m_Location + c, divisor);
+                        CHECK_GL_ERROR;
+                    }
+                }
             }
         }
 
         #undef BUFFER_OFFSET
     }
 
-    static void OpenGLDisableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
+    static void OpenGLDisableVertexDeclaration(HContext _context, HVertexDeclaration vertex_declaration)
     {
-        assert(context);
+        assert(_context);
         assert(vertex_declaration);
 
+        OpenGLContext* context = (OpenGLContext*) _context;
+
         for (uint32_t i=0; i<vertex_declaration->m_StreamCount; i++)
         {
-            if (vertex_declaration->m_Streams[i].m_Location != -1)
+            VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
+            if (stream.m_Location != -1)
             {
-                glDisableVertexAttribArray(vertex_declaration->m_Streams[i].m_Location);
-                CHECK_GL_ERROR;
+                uint32_t column_count = GetVertexStreamColumnCount(stream.m_Size);
+                for (uint32_t c = 0; c < column_count; ++c)
+                {
+                    // Reset the divisor so the location can be reused as a per-vertex attribute
+                    if (context->m_InstancingSupport && vertex_declaration->m_StepFunction == VERTEX_STEP_FUNCTION_INSTANCE)
+                    {
+                        PFN_glVertexAttribDivisor(stream.m_Location + c, 0);
+                        CHECK_GL_ERROR;
+                    }
+                    glDisableVertexAttribArray(stream.m_Location + c);
+                    CHECK_GL_ERROR;
+                }
             }
         }
 
@@ -1622,25 +1668,42 @@ static void LogFrameBufferError(GLenum status)
         CHECK_GL_ERROR;
     }
 
-    static void OpenGLDrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer)
+    static void OpenGLDrawElements(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
     {
         DM_PROFILE(__FUNCTION__);
         DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
-        assert(context);
+        assert(_context);
         assert(index_buffer);
+        OpenGLContext* context = (OpenGLContext*) _context;
         glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
         CHECK_GL_ERROR;
 
-        glDrawElements(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first);
+        if (instance_count > 1 && context->m_InstancingSupport)
+        {
+            PFN_glDrawElementsInstanced(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first, instance_count);
+        }
+        else
+        {
+            glDrawElements(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first);
+        }
         CHECK_GL_ERROR
     }
 
-    static void OpenGLDraw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count)
+    static void OpenGLDraw(HContext _context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
     {
         DM_PROFILE(__FUNCTION__);
         DM_PROPERTY_ADD_U32(rmtp_DrawCalls, 1);
-        assert(context);
-        glDrawArrays(GetOpenGLPrimitiveType(prim_type), first, count);
+        assert(_context);
+        OpenGLContext* context = (OpenGLContext*) _context;
+
+        if (instance_count > 1 && context->m_InstancingSupport)
+        {
+            PFN_glDrawArraysInstanced(GetOpenGLPrimitiveType(prim_type), first, count, instance_count);
+        }
+        else
+        {
+            glDrawArrays(GetOpenGLPrimitiveType(prim_type), first, count);
+        }
         CHECK_GL_ERROR
     }
 
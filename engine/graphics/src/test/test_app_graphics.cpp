@@ -339,7 +339,7 @@ struct SubPassTest : ITest
         dmGraphics::EnableTexture(engine->m_GraphicsContext, 0, 0, sub_pass_0_color);
 
         dmGraphics::EnableVertexDeclaration(engine->m_GraphicsContext, m_VertexDeclaration, m_VertexBuffer);
-        dmGraphics::Draw(engine->m_GraphicsContext, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6);
+        dmGraphics::Draw(engine->m_GraphicsContext, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6, 1);
 
         dmGraphics::SetRenderTarget(engine->m_GraphicsContext, 0, 0);
     }
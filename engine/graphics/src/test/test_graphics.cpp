@@ -350,15 +350,15 @@ TEST_F(dmGraphicsTest, Drawing)
     dmGraphics::EnableVertexBuffer(m_Context, vb, 0);
 
     dmGraphics::EnableVertexDeclaration(m_Context, vd, 0);
-    dmGraphics::DrawElements(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6, dmGraphics::TYPE_UNSIGNED_INT, ib);
+    dmGraphics::DrawElements(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6, dmGraphics::TYPE_UNSIGNED_INT, ib, 1);
     dmGraphics::DisableVertexDeclaration(m_Context, vd);
 
     dmGraphics::EnableVertexDeclaration(m_Context, vd, 0);
-    dmGraphics::DrawElements(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 3, 6, dmGraphics::TYPE_UNSIGNED_INT, ib);
+    dmGraphics::DrawElements(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 3, 6, dmGraphics::TYPE_UNSIGNED_INT, ib, 1);
     dmGraphics::DisableVertexDeclaration(m_Context, vd);
 
     dmGraphics::EnableVertexDeclaration(m_Context, vd, 0);
-    dmGraphics::Draw(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6);
+    dmGraphics::Draw(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6, 1);
     dmGraphics::DisableVertexDeclaration(m_Context, vd);
 
     dmGraphics::DisableVertexBuffer(m_Context, vb);
@@ -369,6 +369,56 @@ TEST_F(dmGraphicsTest, Drawing)
     dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
 }
 
+TEST_F(dmGraphicsTest, DrawingInstanced)
+{
+    ASSERT_TRUE(dmGraphics::IsContextFeatureSupported(m_Context, dmGraphics::CONTEXT_FEATURE_INSTANCING));
+
+    float v[] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+    float instance_data[16 * 4] = {};
+    uint32_t i[] = { 0, 1, 2 };
+
+    dmGraphics::HVertexStreamDeclaration stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_Context);
+    dmGraphics::AddVertexStream(stream_declaration, "position", 3, dmGraphics::TYPE_FLOAT, false);
+
+    dmGraphics::HVertexStreamDeclaration instance_stream_declaration = dmGraphics::NewVertexStreamDeclaration(m_Context);
+    dmGraphics::AddVertexStream(instance_stream_declaration, "mtx_world", 16, dmGraphics::TYPE_FLOAT, false);
+
+    dmGraphics::HVertexDeclaration vd = dmGraphics::NewVertexDeclaration(m_Context, stream_declaration);
+    dmGraphics::HVertexDeclaration instance_vd = dmGraphics::NewVertexDeclaration(m_Context, instance_stream_declaration);
+    dmGraphics::SetVertexDeclarationStepFunction(m_Context, instance_vd, dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE);
+    ASSERT_EQ(16 * sizeof(float), dmGraphics::GetVertexDeclarationStride(instance_vd));
+
+    dmGraphics::HVertexBuffer vb = dmGraphics::NewVertexBuffer(m_Context, sizeof(v), v, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HVertexBuffer instance_vb = dmGraphics::NewVertexBuffer(m_Context, sizeof(instance_data), instance_data, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HIndexBuffer ib = dmGraphics::NewIndexBuffer(m_Context, sizeof(i), i, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+
+    dmGraphics::ResetDrawCount();
+
+    dmGraphics::EnableVertexBuffer(m_Context, vb, 0);
+    dmGraphics::EnableVertexDeclaration(m_Context, vd, 0);
+    dmGraphics::EnableVertexBuffer(m_Context, instance_vb, 1);
+    dmGraphics::EnableVertexDeclaration(m_Context, instance_vd, 1);
+
+    dmGraphics::DrawElements(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 3, dmGraphics::TYPE_UNSIGNED_INT, ib, 4);
+    dmGraphics::Draw(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 3, 4);
+
+    dmGraphics::DisableVertexDeclaration(m_Context, instance_vd);
+    dmGraphics::DisableVertexDeclaration(m_Context, vd);
+    dmGraphics::DisableVertexBuffer(m_Context, instance_vb);
+    dmGraphics::DisableVertexBuffer(m_Context, vb);
+
+    // One draw call per instanced draw, regardless of instance count
+    ASSERT_EQ(2u, dmGraphics::GetDrawCount());
+
+    dmGraphics::DeleteIndexBuffer(ib);
+    dmGraphics::DeleteVertexBuffer(instance_vb);
+    dmGraphics::DeleteVertexBuffer(vb);
+    dmGraphics::DeleteVertexDeclaration(instance_vd);
+    dmGraphics::DeleteVertexDeclaration(vd);
+    dmGraphics::DeleteVertexStreamDeclaration(instance_stream_declaration);
+    dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+}
+
 static inline dmGraphics::ShaderDesc::Shader MakeDDFShader(dmGraphics::ShaderDesc::Language language, const char* data, uint32_t count)
 {
     dmGraphics::ShaderDesc::Shader ddf;
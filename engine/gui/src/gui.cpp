@@ -58,9 +58,9 @@ namespace dmGui
     /**
      * Default layer id
      */
-    const dmhash_t DEFAULT_LAYER = dmHashString64("");
+    const dmhash_t DEFAULT_LAYER = dmHashConstString64("");
 
-    const dmhash_t DEFAULT_LAYOUT = dmHashString64("");
+    const dmhash_t DEFAULT_LAYOUT = dmHashConstString64("");
 
     const uint16_t INVALID_INDEX = 0xffff;
 
@@ -358,6 +358,7 @@ namespace dmGui
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NextVersionNumber = 0;
         scene->m_RenderOrder = 0;
+        scene->m_RenderOrderChanged = 1;
         scene->m_Width = context->m_DefaultProjectWidth;
         scene->m_Height = context->m_DefaultProjectHeight;
         scene->m_FetchTextureSetAnimCallback = params->m_FetchTextureSetAnimCallback;
@@ -665,12 +666,6 @@ namespace dmGui
 
     static void AddResourcePath(HScene scene, void* resource, dmhash_t path_hash)
     {
-        if (scene->m_ResourceToPath.Full())
-        {
-            int newcapacity = scene->m_ResourceToPath.Capacity() + 8;
-            int tablesize = (newcapacity*2)/3;
-            scene->m_ResourceToPath.SetCapacity(tablesize, newcapacity);
-        }
         scene->m_ResourceToPath.Put((uintptr_t)resource, path_hash);
     }
 
@@ -843,6 +838,7 @@ namespace dmGui
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        scene->m_RenderOrderChanged = 1;
         return RESULT_OK;
     }
 
@@ -1437,16 +1433,47 @@ namespace dmGui
         }
         #undef PUSH_RENDER_ENTRY
 
-        DM_PROPERTY_ADD_U32(rmtp_GuiActiveNodes, active_nodes);
+        scene->m_ActiveNodeCount += active_nodes;
         return order;
     }
 
     static void CollectNodes(HScene scene, dmArray<InternalClippingNode>& clippers, dmArray<RenderEntry>& render_entries)
     {
+        scene->m_ActiveNodeCount = 0;
         CollectClippers(scene, scene->m_RenderHead, 0, 0, clippers, INVALID_INDEX);
         CollectRenderEntries(scene, scene->m_RenderHead, 0, clippers, render_entries);
     }
 
+    // Rebuilds the sorted render entries and the clipping scopes of the scene, but only when the
+    // hierarchy, the render order or the clipping setup changed since the previous frame.
+    // Particlefx emitters produce new render data every frame, so scenes with live effects are always rebuilt.
+    static void UpdateRenderEntries(HScene scene)
+    {
+        if (!scene->m_RenderOrderChanged && scene->m_AliveParticlefxs.Empty())
+        {
+            return;
+        }
+
+        DM_PROFILE("CollectNodes");
+        dmArray<RenderEntry>& render_entries = scene->m_RenderEntries;
+        dmArray<InternalClippingNode>& clippers = scene->m_ClippingNodes;
+        render_entries.SetSize(0);
+        clippers.SetSize(0);
+        uint32_t capacity = scene->m_NodePool.Size() * 2;
+        if (capacity > render_entries.Capacity())
+        {
+            render_entries.SetCapacity(capacity);
+        }
+        if (scene->m_NodePool.Size() > clippers.Capacity())
+        {
+            clippers.SetCapacity(scene->m_NodePool.Size());
+        }
+
+        CollectNodes(scene, clippers, render_entries);
+        std::sort(render_entries.Begin(), render_entries.End(), RenderEntrySortPred());
+        scene->m_RenderOrderChanged = 0;
+    }
+
     static inline bool IsVisible(InternalNode* n, float opacity)
     {
         bool use_clipping = n->m_ClipperIndex != INVALID_INDEX;
@@ -1461,13 +1488,15 @@ namespace dmGui
         UpdateDynamicTextures(scene, params, context);
         DeferredDeleteDynamicTextures(scene, params, context);
 
+        UpdateRenderEntries(scene);
+        DM_PROPERTY_ADD_U32(rmtp_GuiActiveNodes, scene->m_ActiveNodeCount);
+
         c->m_RenderNodes.SetSize(0);
         c->m_RenderTransforms.SetSize(0);
         c->m_RenderOpacities.SetSize(0);
-        c->m_StencilClippingNodes.SetSize(0);
         c->m_StencilScopes.SetSize(0);
         c->m_StencilScopeIndices.SetSize(0);
-        uint32_t capacity = scene->m_NodePool.Size() * 2;
+        uint32_t capacity = dmMath::Max((uint32_t) scene->m_NodePool.Size() * 2, scene->m_RenderEntries.Size());
         if (capacity > c->m_RenderNodes.Capacity())
         {
             c->m_RenderNodes.SetCapacity(capacity);
@@ -1475,7 +1504,6 @@ namespace dmGui
             c->m_RenderOpacities.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetSize(capacity);
-            c->m_StencilClippingNodes.SetCapacity(capacity);
             c->m_StencilScopes.SetCapacity(capacity);
             c->m_StencilScopeIndices.SetCapacity(capacity);
         }
@@ -1486,22 +1514,15 @@ namespace dmGui
             c->m_SceneTraversalCache.m_Version = 0;
         }
 
-        CollectNodes(scene, c->m_StencilClippingNodes, c->m_RenderNodes);
-        uint32_t node_count = c->m_RenderNodes.Size();
-        std::sort(c->m_RenderNodes.Begin(), c->m_RenderNodes.End(), RenderEntrySortPred());
-        Matrix4 transform;
-
-        if (c->m_RenderNodes.Capacity() > c->m_RenderTransforms.Capacity())
+        // The pruning below modifies the entries, so work on a copy of the cached (sorted) list
+        uint32_t node_count = scene->m_RenderEntries.Size();
+        c->m_RenderNodes.SetSize(node_count);
+        if (node_count)
         {
-            uint32_t new_capacity = c->m_RenderNodes.Capacity();
-            c->m_RenderTransforms.SetCapacity(new_capacity);
-            c->m_RenderOpacities.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetSize(new_capacity);
-            c->m_StencilClippingNodes.SetCapacity(new_capacity);
-            c->m_StencilScopes.SetCapacity(new_capacity);
-            c->m_StencilScopeIndices.SetCapacity(new_capacity);
+            memcpy(c->m_RenderNodes.Begin(), scene->m_RenderEntries.Begin(), sizeof(RenderEntry) * node_count);
         }
+        dmArray<InternalClippingNode>& clippers = scene->m_ClippingNodes;
+        Matrix4 transform;
 
         uint32_t num_pruned = 0;
         for (uint32_t i = 0; i < node_count; ++i)
@@ -1531,12 +1552,12 @@ namespace dmGui
             c->m_RenderTransforms.Push(transform);
             c->m_RenderOpacities.Push(opacity);
             if (n->m_ClipperIndex != INVALID_INDEX) {
-                InternalClippingNode* clipper = &c->m_StencilClippingNodes[n->m_ClipperIndex];
+                InternalClippingNode* clipper = &clippers[n->m_ClipperIndex];
                 if (clipper->m_NodeIndex == index) {
                     if (clipper->m_VisibleRenderKey == entry.m_RenderKey) {
                         StencilScope* scope = 0x0;
                         if (clipper->m_ParentIndex != INVALID_INDEX) {
-                            scope = &c->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
+                            scope = &clippers[clipper->m_ParentIndex].m_ChildScope;
                         }
                         c->m_StencilScopes.Push(scope);
                     } else {
@@ -1833,7 +1854,7 @@ namespace dmGui
                         }
                         if (message->m_DataSize > 0)
                         {
-                            dmScript::PushTable(L, (const char*) message->m_Data, message->m_DataSize);
+                            dmScript::PushTable(L, (const char*)dmMessage::GetData(message), message->m_DataSize);
                         }
                         else
                         {
@@ -2152,6 +2173,7 @@ namespace dmGui
                 n = scene->m_Nodes.Size();
             }
         }
+        scene->m_HasDeferredDeletes = 0;
 
         // Destroy all living particlefx instances
         uint32_t count = scene->m_AliveParticlefxs.Size();
@@ -2161,6 +2183,7 @@ namespace dmGui
             dmParticle::DestroyInstance(scene->m_ParticlefxContext, c->m_Instance);
         }
         scene->m_AliveParticlefxs.SetSize(0);
+        scene->m_RenderOrderChanged = 1;
 
         DeleteDynamicTextures(scene, delete_texture);
         ClearLayouts(scene);
@@ -2188,29 +2211,35 @@ namespace dmGui
 
         UpdateAnimations(scene, dt);
 
-        uint32_t total_nodes = 0;
-        node_count = scene->m_Nodes.Size();
-        nodes      = scene->m_Nodes.Begin();
-        for (uint32_t i = 0; i < node_count; ++i)
+        // Only visit the nodes when there is something to do, most frames of a static scene have neither
+        uint32_t total_nodes = scene->m_NodePool.Size();
+        if (scene->m_HasDeferredDeletes || scene->m_HasCustomNodes)
         {
-            InternalNode* node = &nodes[i];
-
-            // Deferred deletion of nodes
-            if (node->m_Deleted)
-            {
-                DeleteNode(scene, GetNodeHandle(node), false);
-                node->m_Deleted = 0; // Make sure to clear deferred delete flag
-                node_count = scene->m_Nodes.Size();
-            }
-            else if (node->m_Index != INVALID_INDEX)
+            total_nodes = 0;
+            node_count = scene->m_Nodes.Size();
+            nodes      = scene->m_Nodes.Begin();
+            for (uint32_t i = 0; i < node_count; ++i)
             {
-                ++total_nodes;
-                if (node->m_Node.m_CustomType != 0)
+                InternalNode* node = &nodes[i];
+
+                // Deferred deletion of nodes
+                if (node->m_Deleted)
                 {
-                    scene->m_UpdateCustomNodeCallback(scene->m_CreateCustomNodeCallbackContext, scene, GetNodeHandle(node),
-                                                        node->m_Node.m_CustomType, node->m_Node.m_CustomData, dt);
+                    DeleteNode(scene, GetNodeHandle(node), false);
+                    node->m_Deleted = 0; // Make sure to clear deferred delete flag
+                    node_count = scene->m_Nodes.Size();
+                }
+                else if (node->m_Index != INVALID_INDEX)
+                {
+                    ++total_nodes;
+                    if (node->m_Node.m_CustomType != 0)
+                    {
+                        scene->m_UpdateCustomNodeCallback(scene->m_CreateCustomNodeCallbackContext, scene, GetNodeHandle(node),
+                                                            node->m_Node.m_CustomType, node->m_Node.m_CustomData, dt);
+                    }
                 }
             }
+            scene->m_HasDeferredDeletes = 0;
         }
 
         // Prune sleeping pfx instances
@@ -2250,6 +2279,7 @@ namespace dmGui
 
                 dmParticle::DestroyInstance(scene->m_ParticlefxContext, c->m_Instance);
                 scene->m_AliveParticlefxs.EraseSwap(i);
+                scene->m_RenderOrderChanged = 1;
                 --count;
             }
             else
@@ -2455,6 +2485,7 @@ namespace dmGui
         {
             void* custom_node_data = scene->m_CreateCustomNodeCallback(scene->m_CreateCustomNodeCallbackContext, scene, hnode, custom_type);
             node->m_Node.m_CustomData = custom_node_data;
+            scene->m_HasCustomNodes = 1;
         }
 
         MoveNodeAbove(scene, hnode, INVALID_HANDLE);
@@ -2545,6 +2576,7 @@ namespace dmGui
             tail = &parent_n->m_ChildTail;
         }
         n->m_ParentIndex = parent_index;
+        scene->m_RenderOrderChanged = 1;
         if (prev_n != 0x0)
         {
             if (*tail == prev_n->m_Index)
@@ -2580,6 +2612,8 @@ namespace dmGui
 
     static void RemoveFromNodeList(HScene scene, InternalNode* n)
     {
+        scene->m_RenderOrderChanged = 1;
+
         // Remove from list
         if (n->m_PrevIndex != INVALID_INDEX)
             scene->m_Nodes[n->m_PrevIndex].m_NextIndex = n->m_NextIndex;
@@ -2698,6 +2732,7 @@ namespace dmGui
         scene->m_Nodes.SetSize(0);
         scene->m_RenderHead = INVALID_INDEX;
         scene->m_RenderTail = INVALID_INDEX;
+        scene->m_RenderOrderChanged = 1;
         scene->m_NodePool.Clear();
         scene->m_Animations.SetSize(0);
     }
@@ -3199,6 +3234,7 @@ namespace dmGui
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            scene->m_RenderOrderChanged = 1;
             return RESULT_OK;
         }
         else
@@ -3334,6 +3370,7 @@ namespace dmGui
 
         uint32_t count = scene->m_AliveParticlefxs.Size();
         scene->m_AliveParticlefxs.SetSize(count + 1);
+        scene->m_RenderOrderChanged = 1;
         ParticlefxComponent* component = &scene->m_AliveParticlefxs[count];
         component->m_Prototype = particlefx_prototype;
         component->m_Instance = inst;
@@ -3371,6 +3408,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingMode = mode;
+        scene->m_RenderOrderChanged = 1;
     }
 
     ClippingMode GetNodeClippingMode(HScene scene, HNode node)
@@ -3383,6 +3421,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingVisible = (uint32_t) visible;
+        scene->m_RenderOrderChanged = 1;
     }
 
     bool GetNodeClippingVisible(HScene scene, HNode node)
@@ -3395,6 +3434,7 @@ namespace dmGui
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingInverted = (uint32_t) inverted;
+        scene->m_RenderOrderChanged = 1;
     }
 
     bool GetNodeClippingInverted(HScene scene, HNode node)
@@ -4000,6 +4040,10 @@ namespace dmGui
     void SetNodeEnabled(HScene scene, HNode node, bool enabled)
     {
         InternalNode* n = GetNode(scene, node);
+        if (n->m_Node.m_Enabled != (uint32_t) enabled)
+        {
+            scene->m_RenderOrderChanged = 1;
+        }
         n->m_Node.m_Enabled = enabled;
         if(enabled)
         {
@@ -4260,6 +4304,7 @@ namespace dmGui
             void* src_custom_data = n->m_Node.m_CustomData;
             out_n->m_Node.m_CustomData = scene->m_CloneCustomNodeCallback(scene->m_CreateCustomNodeCallbackContext, scene, *out_node, n->m_Node.m_CustomType, src_custom_data);
             out_n->m_Node.m_CustomType = n->m_Node.m_CustomType;
+            scene->m_HasCustomNodes = 1;
         }
 
         if (n->m_Node.m_FlipbookAnimHash != 0)
@@ -17,6 +17,7 @@
 
 #include <dlib/index_pool.h>
 #include <dlib/array.h>
+#include <dlib/flat_hashtable.h>
 #include <dlib/hashtable.h>
 #include <dlib/easing.h>
 #include <dlib/image.h>
@@ -94,7 +95,6 @@ namespace dmGui
         dmArray<RenderEntry>            m_RenderNodes;
         dmArray<dmVMath::Matrix4>       m_RenderTransforms;
         dmArray<float>                	m_RenderOpacities;
-        dmArray<InternalClippingNode>   m_StencilClippingNodes;
         dmArray<StencilScope*>          m_StencilScopes;
         dmArray<uint16_t>               m_StencilScopeIndices;
         dmArray<HNode>                  m_ScratchBoneNodes;
@@ -276,7 +276,7 @@ namespace dmGui
         dmIndexPool16           m_NodePool;
         dmArray<InternalNode>   m_Nodes;
         dmArray<Animation>      m_Animations;
-        dmHashTable<uintptr_t, dmhash_t>      m_ResourceToPath;
+        dmFlatHashTable<uintptr_t, dmhash_t>  m_ResourceToPath;
         dmHashTable64<void*>                  m_Fonts;
         dmHashTable64<TextureInfo>            m_Textures;
         dmHashTable64<DynamicTexture>         m_DynamicTextures;
@@ -284,6 +284,10 @@ namespace dmGui
         dmParticle::HParticleContext          m_ParticlefxContext;
         dmHashTable64<dmParticle::HPrototype> m_Particlefxs;
         dmArray<ParticlefxComponent>          m_AliveParticlefxs;
+        // Sorted render entries and clippers, kept across frames until the hierarchy or the render order changes
+        dmArray<RenderEntry>                  m_RenderEntries;
+        dmArray<InternalClippingNode>         m_ClippingNodes;
+        uint32_t                              m_ActiveNodeCount;
         dmHashTable64<uint16_t> m_Layers;
         dmArray<dmhash_t>       m_Layouts;
         dmArray<void*>          m_LayoutsNodeDescs;
@@ -298,6 +302,9 @@ namespace dmGui
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
+        uint16_t                m_RenderOrderChanged : 1;   // Render entries must be recollected
+        uint16_t                m_HasDeferredDeletes : 1;   // Nodes are marked for deletion during the next update
+        uint16_t                m_HasCustomNodes : 1;       // Custom nodes need to be visited during the update
         uint32_t                m_Width;
         uint32_t                m_Height;
         dmScript::ScriptWorld*  m_ScriptWorld;
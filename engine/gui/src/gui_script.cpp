@@ -679,6 +679,8 @@ namespace dmGui
 
         // Set deferred delete flag
         n->m_Deleted = 1;
+        Scene* scene = GuiScriptInstance_Check(L);
+        scene->m_HasDeferredDeletes = 1;
 
         return 0;
     }
@@ -2228,8 +2230,10 @@ namespace dmGui
     {
         HNode hnode;
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
+        (void) n;
         int clipping_mode = (int) luaL_checknumber(L, 2);
-        n->m_Node.m_ClippingMode = (ClippingMode) clipping_mode;
+        Scene* scene = GuiScriptInstance_Check(L);
+        dmGui::SetNodeClippingMode(scene, hnode, (ClippingMode) clipping_mode);
         return 0;
     }
 
@@ -2259,8 +2263,10 @@ namespace dmGui
     {
         HNode hnode;
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
+        (void) n;
         int visible = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingVisible = visible;
+        Scene* scene = GuiScriptInstance_Check(L);
+        dmGui::SetNodeClippingVisible(scene, hnode, visible != 0);
         return 0;
     }
 
@@ -2290,8 +2296,10 @@ namespace dmGui
     {
         HNode hnode;
         InternalNode* n = LuaCheckNodeInternal(L, 1, &hnode);
+        (void) n;
         int inverted = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingInverted = inverted;
+        Scene* scene = GuiScriptInstance_Check(L);
+        dmGui::SetNodeClippingInverted(scene, hnode, inverted != 0);
         return 0;
     }
 
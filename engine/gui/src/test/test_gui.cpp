@@ -2097,6 +2097,7 @@ TEST_F(dmGuiTest, PostMessageToGuiEmptyLuaTable)
     message->m_Receiver = dmMessage::URL();
     message->m_Id = dmHashString64("amessage");
     message->m_Descriptor = 0;
+    message->m_External = 0;
     message->m_UserData1 = 0;
     message->m_UserData2 = 0;
     message->m_DataSize = 0;
@@ -2129,6 +2130,7 @@ TEST_F(dmGuiTest, PostMessageToGuiLuaTable)
     message->m_Receiver = dmMessage::URL();
     message->m_Id = dmHashString64("amessage");
     message->m_Descriptor = 0;
+    message->m_External = 0;
     message->m_UserData1 = 0;
     message->m_UserData2 = 0;
 
@@ -2399,6 +2401,7 @@ TEST_F(dmGuiTest, Bug352)
     message->m_Receiver = dmMessage::URL();
     message->m_Id = dmHashString64("inc_score");
     message->m_Descriptor = 0;
+    message->m_External = 0;
     message->m_UserData1 = 0;
     message->m_UserData2 = 0;
 
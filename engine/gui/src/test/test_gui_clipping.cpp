@@ -1145,6 +1145,47 @@ TEST_F(dmGuiClippingTest, TestOverflowClearEnd) {
     Render();
 }
 
+/* CACHED RENDER ORDER */
+
+/**
+ * The render entries are kept between frames, make sure they are rebuilt when
+ * the hierarchy, order, enabled state or clipping setup changes.
+ */
+TEST_F(dmGuiClippingTest, TestRenderOrderCached) {
+    dmGui::HNode a = AddBox("a");
+    dmGui::HNode b = AddClipperBox("b");
+    dmGui::HNode b_child = AddBox("b_child", b);
+
+    Render();
+    AssertRenderOrder(a, b, b_child);
+    ASSERT_TRUE(m_NodeToClipping.find(b_child) != m_NodeToClipping.end());
+
+    // Nothing changed
+    Render();
+    AssertRenderOrder(a, b, b_child);
+
+    dmGui::MoveNodeAbove(m_Scene, a, b);
+    Render();
+    AssertRenderOrder(b, b_child, a);
+
+    dmGui::SetNodeEnabled(m_Scene, a, false);
+    Render();
+    ASSERT_TRUE(m_NodeToRenderOrder.find(a) == m_NodeToRenderOrder.end());
+
+    dmGui::SetNodeEnabled(m_Scene, a, true);
+    Render();
+    AssertRenderOrder(b, b_child, a);
+
+    dmGui::SetNodeClippingMode(m_Scene, b, dmGui::CLIPPING_MODE_NONE);
+    Render();
+    ASSERT_TRUE(m_NodeToClipping.find(b_child) == m_NodeToClipping.end());
+
+    dmGui::DeleteNode(m_Scene, b);
+    Render();
+    ASSERT_EQ(1u, m_NodeToRenderOrder.size());
+    ASSERT_TRUE(m_NodeToRenderOrder.find(a) != m_NodeToRenderOrder.end());
+}
+
 #undef BITS
 
 int main(int argc, char **argv)
@@ -247,6 +247,8 @@ namespace dmPhysics
         uint32_t m_RayCastLimit3D;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
+        /// Number of worker threads running batched queries, see RayCastBatch2D. 0 runs them on the calling thread
+        uint32_t m_QueryThreadCount;
         /// If true, the collision objects will retrieve the position of its game object
         uint8_t m_AllowDynamicTransforms:1;
         uint8_t :7;
@@ -396,6 +398,37 @@ namespace dmPhysics
      */
     void StepWorld2D(HWorld2D world, const StepWorldContext& context);
 
+    /**
+     * First part of a 2D step that is split up, to let the simulation run on another thread.
+     * Copies the transforms of the kinematic bodies from their user data, so it must be called
+     * on the thread owning the user data.
+     *
+     * @param world Physics world
+     * @param context Function parameter struct
+     */
+    void BeginStepWorld2D(HWorld2D world, const StepWorldContext& context);
+
+    /**
+     * Simulate 2D physics without calling any of the callbacks. The contacts are recorded and
+     * reported by EndStepWorld2D instead, except for the collision objects deleted in between.
+     * May be called from any thread, as long as no other function is called for the world until
+     * it has returned.
+     *
+     * @param world Physics world
+     * @param context Function parameter struct, must be the same as for BeginStepWorld2D
+     */
+    void SimulateWorld2D(HWorld2D world, const StepWorldContext& context);
+
+    /**
+     * Last part of a split 2D step. Copies the simulated transforms to the user data, performs the
+     * requested ray casts and calls the callbacks. Calling BeginStepWorld2D, SimulateWorld2D and
+     * EndStepWorld2D in order is equivalent to calling StepWorld2D.
+     *
+     * @param world Physics world
+     * @param context Function parameter struct, must be the same as for BeginStepWorld2D
+     */
+    void EndStepWorld2D(HWorld2D world, const StepWorldContext& context);
+
     /**
      * Enable/disable debug-draw
      * @param world Physics world
@@ -1175,6 +1208,75 @@ namespace dmPhysics
      */
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results);
 
+    /**
+     * Synchronous ray casts of a batch of rays, reporting the closest hit of each ray.
+     * The batch is spread over the query threads of the context, see NewContextParams::m_QueryThreadCount.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Requests of the batch. m_ReturnAllResults is ignored
+     * @param responses Receives one response per request. m_Hit is 0 if the ray missed
+     * @param count Number of requests
+     */
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count);
+
+    /**
+     * Synchronous ray casts of a batch of rays, reporting the closest hit of each ray.
+     * The batch is spread over the query threads of the context, see NewContextParams::m_QueryThreadCount.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Requests of the batch. m_ReturnAllResults is ignored
+     * @param responses Receives one response per request. m_Hit is 0 if the ray missed
+     * @param count Number of requests
+     */
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count);
+
+    /**
+     * Container of data for overlap queries.
+     */
+    struct OverlapRequest
+    {
+        OverlapRequest();
+
+        /// Minimum corner of the box to test against
+        dmVMath::Point3 m_Min;
+        /// Maximum corner of the box to test against
+        dmVMath::Point3 m_Max;
+        /// All collision objects with this user data will be ignored in the query
+        void* m_IgnoredUserData;
+        /// Bit field to filter out collision objects of the corresponding groups
+        uint16_t m_Mask;
+    };
+
+    /**
+     * Synchronous overlap queries of a batch of boxes, reporting the collision objects whose bounding
+     * boxes overlap each box. Triggers are not reported.
+     * The batch is spread over the query threads of the context, see NewContextParams::m_QueryThreadCount.
+     *
+     * @param world Physics world in which to perform the queries
+     * @param requests Requests of the batch
+     * @param count Number of requests
+     * @param results Receives the user data of the overlapping collision objects, max_results per request.
+     *                The results of request i start at results[i * max_results]
+     * @param max_results Maximum number of results per request, any further overlaps are dropped
+     * @param result_counts Receives the number of results of each request
+     */
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts);
+
+    /**
+     * Synchronous overlap queries of a batch of boxes, reporting the collision objects whose bounding
+     * boxes overlap each box. Triggers are not reported. The z components of the boxes are ignored.
+     * The batch is spread over the query threads of the context, see NewContextParams::m_QueryThreadCount.
+     *
+     * @param world Physics world in which to perform the queries
+     * @param requests Requests of the batch
+     * @param count Number of requests
+     * @param results Receives the user data of the overlapping collision objects, max_results per request.
+     *                The results of request i start at results[i * max_results]
+     * @param max_results Maximum number of results per request, any further overlaps are dropped
+     * @param result_counts Receives the number of results of each request
+     */
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts);
+
     /**
      * Set the gravity for a 2D physics world.
      *
@@ -42,6 +42,7 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_QueryWorkers(0x0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -134,6 +135,8 @@ namespace dmPhysics
 
     ContactListener::ContactListener(HWorld2D world)
     : m_World(world)
+    , m_TempStepWorldContext(0x0)
+    , m_DeferCallbacks(false)
     {
 
     }
@@ -161,7 +164,23 @@ namespace dmPhysics
                 int32_t index_a = contact->GetChildIndexA();
                 int32_t index_b = contact->GetChildIndexB();
 
-                if (collision_callback)
+                DeferredContact2D* deferred = 0x0;
+                if (m_DeferCallbacks)
+                {
+                    // Recorded and reported by EndStepWorld2D, on the thread owning the user data
+                    dmArray<DeferredContact2D>& contacts = m_World->m_DeferredContacts;
+                    if (contacts.Full())
+                        contacts.OffsetCapacity(32);
+                    contacts.SetSize(contacts.Size() + 1);
+                    deferred = &contacts.Back();
+                    deferred->m_UserDataA = fixture_a->GetUserData();
+                    deferred->m_UserDataB = fixture_b->GetUserData();
+                    deferred->m_GroupA = fixture_a->GetFilterData(index_a).categoryBits;
+                    deferred->m_GroupB = fixture_b->GetFilterData(index_b).categoryBits;
+                    deferred->m_FirstContactPoint = m_World->m_DeferredContactPoints.Size();
+                    deferred->m_ContactPointCount = 0;
+                }
+                else if (collision_callback)
                 {
                     collision_callback(fixture_a->GetUserData(),
                                        fixture_a->GetFilterData(index_a).categoryBits,
@@ -191,7 +210,18 @@ namespace dmPhysics
                         cp.m_MassB = fixture_b->GetBody()->GetMass();
                         cp.m_GroupA = fixture_a->GetFilterData(index_a).categoryBits;
                         cp.m_GroupB = fixture_b->GetFilterData(index_b).categoryBits;
-                        contact_point_callback(cp, m_TempStepWorldContext->m_ContactPointUserData);
+                        if (deferred)
+                        {
+                            dmArray<ContactPoint>& points = m_World->m_DeferredContactPoints;
+                            if (points.Full())
+                                points.OffsetCapacity(64);
+                            points.Push(cp);
+                            ++deferred->m_ContactPointCount;
+                        }
+                        else
+                        {
+                            contact_point_callback(cp, m_TempStepWorldContext->m_ContactPointUserData);
+                        }
                     }
                 }
             }
@@ -203,6 +233,11 @@ namespace dmPhysics
         m_TempStepWorldContext = context;
     }
 
+    void ContactListener::SetDeferCallbacks(bool defer)
+    {
+        m_DeferCallbacks = defer;
+    }
+
     HContext2D NewContext2D(const NewContextParams& params)
     {
         if (params.m_Scale < MIN_SCALE || params.m_Scale > MAX_SCALE)
@@ -221,6 +256,7 @@ namespace dmPhysics
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
         context->m_VelocityThreshold = params.m_VelocityThreshold;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
+        context->m_QueryWorkers = NewQueryWorkers(params.m_QueryThreadCount);
         b2ContactSolver::setVelocityThreshold(params.m_VelocityThreshold * params.m_Scale); // overrides fixed b2_velocityThreshold in b2Settings.h. Includes compensation for the scale factor so that velocityThreshold corresponds to the velocity values used in the game.
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
@@ -242,6 +278,8 @@ namespace dmPhysics
         }
         if (context->m_Socket != 0)
             dmMessage::DeleteSocket(context->m_Socket);
+        if (context->m_QueryWorkers != 0x0)
+            DeleteQueryWorkers(context->m_QueryWorkers);
         delete context;
     }
 
@@ -407,9 +445,8 @@ namespace dmPhysics
         }
     }
 
-    void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
+    void BeginStepWorld2D(HWorld2D world, const StepWorldContext& step_context)
     {
-        float dt = step_context.m_DT;
         HContext2D context = world->m_Context;
         float scale = context->m_Scale;
         // Epsilon defining what transforms are considered noise and not
@@ -459,25 +496,68 @@ namespace dmPhysics
                 }
             }
         }
+    }
+
+    static void Simulate(HWorld2D world, const StepWorldContext& step_context, bool defer_callbacks)
+    {
+        DM_PROFILE("StepSimulation");
+        world->m_DeferredContacts.SetSize(0);
+        world->m_DeferredContactPoints.SetSize(0);
+        world->m_ContactListener.SetStepWorldContext(&step_context);
+        world->m_ContactListener.SetDeferCallbacks(defer_callbacks);
+        world->m_World.Step(step_context.m_DT, 10, 10);
+        world->m_ContactListener.SetDeferCallbacks(false);
+    }
+
+    void SimulateWorld2D(HWorld2D world, const StepWorldContext& step_context)
+    {
+        Simulate(world, step_context, true);
+    }
+
+    void EndStepWorld2D(HWorld2D world, const StepWorldContext& step_context)
+    {
+        HContext2D context = world->m_Context;
+        float scale = context->m_Scale;
+        // Report the contacts recorded by SimulateWorld2D
+        uint32_t deferred_count = world->m_DeferredContacts.Size();
+        if (deferred_count > 0)
         {
-            DM_PROFILE("StepSimulation");
-            world->m_ContactListener.SetStepWorldContext(&step_context);
-            world->m_World.Step(dt, 10, 10);
-            float inv_scale = world->m_Context->m_InvScale;
-            // Update transforms of dynamic bodies
-            if (world->m_SetWorldTransformCallback)
+            DM_PROFILE("ContactCallbacks");
+            for (uint32_t i = 0; i < deferred_count; ++i)
             {
-                for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+                const DeferredContact2D& contact = world->m_DeferredContacts[i];
+                if (step_context.m_CollisionCallback)
+                {
+                    step_context.m_CollisionCallback(contact.m_UserDataA, contact.m_GroupA,
+                                                     contact.m_UserDataB, contact.m_GroupB,
+                                                     step_context.m_CollisionUserData);
+                }
+                if (step_context.m_ContactPointCallback)
                 {
-                    if (body->GetType() == b2_dynamicBody && body->IsActive())
+                    for (uint32_t j = 0; j < contact.m_ContactPointCount; ++j)
                     {
-                        Point3 position;
-                        FromB2(body->GetPosition(), position, inv_scale);
-                        Quat rotation = Quat::rotationZ(body->GetAngle());
-                        (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+                        step_context.m_ContactPointCallback(world->m_DeferredContactPoints[contact.m_FirstContactPoint + j], step_context.m_ContactPointUserData);
                     }
                 }
             }
+            world->m_DeferredContacts.SetSize(0);
+            world->m_DeferredContactPoints.SetSize(0);
+        }
+        // Update transforms of dynamic bodies
+        if (world->m_SetWorldTransformCallback)
+        {
+            DM_PROFILE("UpdateDynamic");
+            float inv_scale = world->m_Context->m_InvScale;
+            for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
+            {
+                if (body->GetType() == b2_dynamicBody && body->IsActive())
+                {
+                    Point3 position;
+                    FromB2(body->GetPosition(), position, inv_scale);
+                    Quat rotation = Quat::rotationZ(body->GetAngle());
+                    (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+                }
+            }
         }
         // Perform requested ray casts
         uint32_t size = world->m_RayCastRequests.Size();
@@ -526,6 +606,13 @@ namespace dmPhysics
         world->m_World.DrawDebugData();
     }
 
+    void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
+    {
+        BeginStepWorld2D(world, step_context);
+        Simulate(world, step_context, false);
+        EndStepWorld2D(world, step_context);
+    }
+
     void UpdateOverlapCache(OverlapCache* cache, HContext2D context, b2Contact* contact_list, const StepWorldContext& step_context)
     {
         DM_PROFILE("TriggerCallbacks");
@@ -985,6 +1072,21 @@ namespace dmPhysics
         return body;
     }
 
+    // The contacts recorded by SimulateWorld2D can't be reported for a deleted body
+    static void RemoveDeferredContacts(HWorld2D world, void* user_data)
+    {
+        dmArray<DeferredContact2D>& contacts = world->m_DeferredContacts;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < contacts.Size(); ++i)
+        {
+            if (contacts[i].m_UserDataA != user_data && contacts[i].m_UserDataB != user_data)
+            {
+                contacts[count++] = contacts[i];
+            }
+        }
+        contacts.SetSize(count);
+    }
+
     void DeleteCollisionObject2D(HWorld2D world, HCollisionObject2D collision_object)
     {
         // NOTE: This code assumes stuff about internals in box2d.
@@ -994,6 +1096,10 @@ namespace dmPhysics
 
         OverlapCacheRemove(&world->m_TriggerOverlaps, collision_object);
         b2Body* body = (b2Body*)collision_object;
+        if (!world->m_DeferredContacts.Empty())
+        {
+            RemoveDeferredContacts(world, body->GetUserData());
+        }
         b2Fixture* fixture = body->GetFixtureList();
         while (fixture)
         {
@@ -1410,6 +1516,137 @@ namespace dmPhysics
         }
     }
 
+    struct RayCastBatchContext2D
+    {
+        HWorld2D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    static void RayCastBatchJob2D(void* _context, uint32_t begin, uint32_t end)
+    {
+        DM_PROFILE("RayCastBatch2D");
+        RayCastBatchContext2D* context = (RayCastBatchContext2D*)_context;
+        HWorld2D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = context->m_Requests[i];
+            ProcessRayCastResultCallback2D query;
+            query.m_Request = &request;
+            query.m_Context = world->m_Context;
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_CollisionMask = request.m_Mask;
+            query.m_Response.m_Hit = 0;
+
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            // Zero length rays miss, same as RayCast2D but without the warning
+            if ((to - from).LengthSquared() > 0.0f)
+            {
+                world->m_World.RayCast(&query, from, to);
+            }
+            context->m_Responses[i] = query.m_Response;
+        }
+    }
+
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count)
+    {
+        DM_PROFILE("RayCastBatch2D");
+        RayCastBatchContext2D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Responses = responses;
+        RunQueryJobs(world->m_Context->m_QueryWorkers, RayCastBatchJob2D, &context, count);
+    }
+
+    // Broad phase callback collecting the bodies overlapping a box
+    struct OverlapQuery2D
+    {
+        bool QueryCallback(int32 proxy_id)
+        {
+            b2FixtureProxy* proxy = (b2FixtureProxy*)m_BroadPhase->GetUserData(proxy_id);
+            b2Fixture* fixture = proxy->fixture;
+            // Never report triggers
+            if (fixture->IsSensor())
+                return true;
+            // The broad phase tests against the fattened boxes
+            if (!b2TestOverlap(proxy->aabb, m_AABB))
+                return true;
+            if ((fixture->GetFilterData(proxy->childIndex).categoryBits & m_Mask) == 0)
+                return true;
+            void* user_data = fixture->GetBody()->GetUserData();
+            if (user_data == m_IgnoredUserData)
+                return true;
+            // Bodies with several fixtures, or grid shapes with one proxy per cell, are reported once
+            for (uint32_t i = 0; i < m_Count; ++i)
+            {
+                if (m_Results[i] == user_data)
+                    return true;
+            }
+            m_Results[m_Count++] = user_data;
+            return m_Count < m_MaxResults;
+        }
+
+        const b2BroadPhase* m_BroadPhase;
+        b2AABB              m_AABB;
+        void*               m_IgnoredUserData;
+        void**              m_Results;
+        uint32_t            m_MaxResults;
+        uint32_t            m_Count;
+        uint16_t            m_Mask;
+    };
+
+    struct OverlapBatchContext2D
+    {
+        HWorld2D                m_World;
+        const OverlapRequest*   m_Requests;
+        void**                  m_Results;
+        uint32_t*               m_ResultCounts;
+        uint32_t                m_MaxResults;
+    };
+
+    static void OverlapBatchJob2D(void* _context, uint32_t begin, uint32_t end)
+    {
+        DM_PROFILE("OverlapBatch2D");
+        OverlapBatchContext2D* context = (OverlapBatchContext2D*)_context;
+        HWorld2D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+
+        OverlapQuery2D query;
+        query.m_BroadPhase = &world->m_World.GetContactManager().m_broadPhase;
+        query.m_MaxResults = context->m_MaxResults;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const OverlapRequest& request = context->m_Requests[i];
+            ToB2(request.m_Min, query.m_AABB.lowerBound, scale);
+            ToB2(request.m_Max, query.m_AABB.upperBound, scale);
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_Results = context->m_Results + i * context->m_MaxResults;
+            query.m_Count = 0;
+            query.m_Mask = request.m_Mask;
+            if (query.m_MaxResults > 0)
+            {
+                query.m_BroadPhase->Query(&query, query.m_AABB);
+            }
+            context->m_ResultCounts[i] = query.m_Count;
+        }
+    }
+
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts)
+    {
+        DM_PROFILE("OverlapBatch2D");
+        OverlapBatchContext2D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Results = results;
+        context.m_ResultCounts = result_counts;
+        context.m_MaxResults = max_results;
+        RunQueryJobs(world->m_Context->m_QueryWorkers, OverlapBatchJob2D, &context, count);
+    }
+
     void SetGravity2D(HWorld2D world, const Vector3& gravity)
     {
         b2Vec2 gravity_b;
@@ -34,10 +34,25 @@ namespace dmPhysics
 
         void SetStepWorldContext(const StepWorldContext* context);
 
+        /// Record the contacts in the world instead of calling the callbacks, see SimulateWorld2D
+        void SetDeferCallbacks(bool defer);
+
     private:
         HWorld2D m_World;
         /// Temporary context to be set before each stepping of the world
         const StepWorldContext* m_TempStepWorldContext;
+        bool m_DeferCallbacks;
+    };
+
+    /// Contact recorded by SimulateWorld2D, reported along with its contact points by EndStepWorld2D
+    struct DeferredContact2D
+    {
+        void*       m_UserDataA;
+        void*       m_UserDataB;
+        uint32_t    m_FirstContactPoint;
+        uint16_t    m_ContactPointCount;
+        uint16_t    m_GroupA;
+        uint16_t    m_GroupB;
     };
 
     struct World2D
@@ -48,6 +63,8 @@ namespace dmPhysics
         HContext2D                  m_Context;
         b2World                     m_World;
         dmArray<RayCastRequest>     m_RayCastRequests;
+        dmArray<DeferredContact2D>  m_DeferredContacts;
+        dmArray<ContactPoint>       m_DeferredContactPoints;
         DebugDraw2D                 m_DebugDraw;
         ContactListener             m_ContactListener;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
@@ -71,6 +88,7 @@ namespace dmPhysics
         float                       m_VelocityThreshold;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        HQueryWorkers               m_QueryWorkers;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -49,6 +49,18 @@ namespace dmPhysics
     {
     }
 
+    void BeginStepWorld2D(HWorld2D world, const StepWorldContext& context)
+    {
+    }
+
+    void SimulateWorld2D(HWorld2D world, const StepWorldContext& context)
+    {
+    }
+
+    void EndStepWorld2D(HWorld2D world, const StepWorldContext& context)
+    {
+    }
+
     void SetDrawDebug2D(HWorld2D world, bool draw_debug)
     {
     }
@@ -265,6 +277,18 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch2D(HWorld2D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            responses[i] = RayCastResponse();
+    }
+
+    void OverlapBatch2D(HWorld2D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            result_counts[i] = 0;
+    }
+
     void SetGravity2D(HWorld2D world, const dmVMath::Vector3& gravity)
     {
     }
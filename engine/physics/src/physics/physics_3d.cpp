@@ -123,6 +123,7 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_QueryWorkers(0x0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -291,6 +292,7 @@ namespace dmPhysics
         context->m_RayCastLimit = params.m_RayCastLimit3D;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
+        context->m_QueryWorkers = NewQueryWorkers(params.m_QueryThreadCount);
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
         if (result != dmMessage::RESULT_OK)
         {
@@ -311,6 +313,8 @@ namespace dmPhysics
         }
         if (context->m_Socket != 0)
             dmMessage::DeleteSocket(context->m_Socket);
+        if (context->m_QueryWorkers != 0x0)
+            DeleteQueryWorkers(context->m_QueryWorkers);
         delete context;
     }
 
@@ -1255,6 +1259,131 @@ namespace dmPhysics
         }
     }
 
+    struct RayCastBatchContext3D
+    {
+        HWorld3D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    static void RayCastBatchJob3D(void* _context, uint32_t begin, uint32_t end)
+    {
+        DM_PROFILE("RayCastBatch3D");
+        RayCastBatchContext3D* context = (RayCastBatchContext3D*)_context;
+        HWorld3D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const RayCastRequest& request = context->m_Requests[i];
+            RayCastResponse& response = context->m_Responses[i];
+            response = RayCastResponse();
+            // Zero length rays miss, same as RayCast3D but without the warning
+            if (lengthSqr(request.m_To - request.m_From) <= 0.0f)
+                continue;
+
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+            if (result_callback.hasHit())
+            {
+                ResponseFromRayCastResult(response, inv_scale, result_callback.m_closestHitFraction, result_callback.m_hitPointWorld, result_callback.m_hitNormalWorld, result_callback.m_collisionObject);
+            }
+        }
+    }
+
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count)
+    {
+        DM_PROFILE("RayCastBatch3D");
+        RayCastBatchContext3D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Responses = responses;
+        RunQueryJobs(world->m_Context->m_QueryWorkers, RayCastBatchJob3D, &context, count);
+    }
+
+    // Broad phase callback collecting the collision objects overlapping a box
+    struct OverlapQuery3D : public btBroadphaseAabbCallback
+    {
+        virtual bool process(const btBroadphaseProxy* proxy)
+        {
+            // The broadphase doesn't stop the query when this returns false
+            if (m_Count >= m_MaxResults)
+                return false;
+            if ((proxy->m_collisionFilterGroup & m_Mask) == 0)
+                return true;
+            const btCollisionObject* co = (const btCollisionObject*)proxy->m_clientObject;
+            // Never report triggers
+            if (!co->hasContactResponse())
+                return true;
+            void* user_data = co->getUserPointer();
+            if (user_data == m_IgnoredUserData)
+                return true;
+            m_Results[m_Count++] = user_data;
+            return m_Count < m_MaxResults;
+        }
+
+        void*               m_IgnoredUserData;
+        void**              m_Results;
+        uint32_t            m_MaxResults;
+        uint32_t            m_Count;
+        uint16_t            m_Mask;
+    };
+
+    struct OverlapBatchContext3D
+    {
+        HWorld3D                m_World;
+        const OverlapRequest*   m_Requests;
+        void**                  m_Results;
+        uint32_t*               m_ResultCounts;
+        uint32_t                m_MaxResults;
+    };
+
+    static void OverlapBatchJob3D(void* _context, uint32_t begin, uint32_t end)
+    {
+        DM_PROFILE("OverlapBatch3D");
+        OverlapBatchContext3D* context = (OverlapBatchContext3D*)_context;
+        HWorld3D world = context->m_World;
+        float scale = world->m_Context->m_Scale;
+        btBroadphaseInterface* broadphase = world->m_DynamicsWorld->getBroadphase();
+
+        OverlapQuery3D query;
+        query.m_MaxResults = context->m_MaxResults;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const OverlapRequest& request = context->m_Requests[i];
+            query.m_IgnoredUserData = request.m_IgnoredUserData;
+            query.m_Results = context->m_Results + i * context->m_MaxResults;
+            query.m_Count = 0;
+            query.m_Mask = request.m_Mask;
+            if (query.m_MaxResults > 0)
+            {
+                btVector3 aabb_min;
+                ToBt(request.m_Min, aabb_min, scale);
+                btVector3 aabb_max;
+                ToBt(request.m_Max, aabb_max, scale);
+                broadphase->aabbTest(aabb_min, aabb_max, query);
+            }
+            context->m_ResultCounts[i] = query.m_Count;
+        }
+    }
+
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts)
+    {
+        DM_PROFILE("OverlapBatch3D");
+        OverlapBatchContext3D context;
+        context.m_World = world;
+        context.m_Requests = requests;
+        context.m_Results = results;
+        context.m_ResultCounts = result_counts;
+        context.m_MaxResults = max_results;
+        RunQueryJobs(world->m_Context->m_QueryWorkers, OverlapBatchJob3D, &context, count);
+    }
+
     void SetGravity3D(HWorld3D world, const Vector3& gravity)
     {
         HContext3D context = world->m_Context;
@@ -59,6 +59,7 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        HQueryWorkers               m_QueryWorkers;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -217,6 +217,18 @@ namespace dmPhysics
     {
     }
 
+    void RayCastBatch3D(HWorld3D world, const RayCastRequest* requests, RayCastResponse* responses, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            responses[i] = RayCastResponse();
+    }
+
+    void OverlapBatch3D(HWorld3D world, const OverlapRequest* requests, uint32_t count, void** results, uint32_t max_results, uint32_t* result_counts)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            result_counts[i] = 0;
+    }
+
     void SetGravity3D(HWorld3D world, const dmVMath::Vector3& gravity)
     {
     }
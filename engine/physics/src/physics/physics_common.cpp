@@ -17,6 +17,11 @@
 
 #include <string.h>
 
+#include <dlib/array.h>
+#include <dlib/job_thread.h>
+#include <dlib/math.h>
+#include <dlib/thread.h>
+
 namespace dmPhysics
 {
     const char* PHYSICS_SOCKET_NAME = "@physics";
@@ -31,6 +36,7 @@ namespace dmPhysics
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
     , m_TriggerOverlapCapacity(0)
+    , m_QueryThreadCount(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -91,6 +97,15 @@ namespace dmPhysics
 
     }
 
+    OverlapRequest::OverlapRequest()
+    : m_Min(0.0f, 0.0f, 0.0f)
+    , m_Max(0.0f, 0.0f, 0.0f)
+    , m_IgnoredUserData((void*)~0) // unlikely user data to ignore
+    , m_Mask(~0)
+    {
+
+    }
+
     DebugCallbacks::DebugCallbacks()
     : m_DrawLines(0x0)
     , m_DrawTriangles(0x0)
@@ -119,4 +134,90 @@ namespace dmPhysics
         memset(this, 0, sizeof(*this));
     }
 
+
+    // The queries [m_Begin, m_End) of a batch
+    struct QueryJob
+    {
+        QueryJobFunction    m_Function;
+        void*               m_Context;
+        uint32_t            m_Begin;
+        uint32_t            m_End;
+    };
+
+    struct QueryWorkers
+    {
+        dmJobThread::HContext       m_JobContext;
+        dmArray<QueryJob>           m_QueryJobs;
+        dmArray<dmJobThread::Job>   m_Jobs;
+    };
+
+    static int ProcessQueryJob(void* context, void* data)
+    {
+        QueryJob* job = (QueryJob*) data;
+        job->m_Function(job->m_Context, job->m_Begin, job->m_End);
+        return 0;
+    }
+
+    HQueryWorkers NewQueryWorkers(uint32_t thread_count)
+    {
+        if (thread_count == 0 || !dmThread::PlatformHasThreadSupport())
+            return 0x0;
+
+        QueryWorkers* workers = new QueryWorkers;
+        dmJobThread::JobThreadCreationParams job_thread_create_params;
+        job_thread_create_params.m_ThreadCount = (uint8_t) dmMath::Min(thread_count, (uint32_t) dmJobThread::DM_MAX_JOB_THREAD_COUNT);
+        for (uint32_t i = 0; i < job_thread_create_params.m_ThreadCount; ++i)
+        {
+            job_thread_create_params.m_ThreadNames[i] = "PhysicsQuery";
+        }
+        workers->m_JobContext = dmJobThread::Create(job_thread_create_params);
+        return workers;
+    }
+
+    void DeleteQueryWorkers(HQueryWorkers workers)
+    {
+        dmJobThread::Destroy(workers->m_JobContext);
+        delete workers;
+    }
+
+    void RunQueryJobs(HQueryWorkers workers, QueryJobFunction function, void* context, uint32_t count)
+    {
+        // Not worth waking the workers for a single job
+        if (workers == 0x0 || count <= QUERY_JOB_SIZE)
+        {
+            if (count > 0)
+                function(context, 0, count);
+            return;
+        }
+
+        uint32_t job_count = (count + QUERY_JOB_SIZE - 1) / QUERY_JOB_SIZE;
+        workers->m_QueryJobs.SetSize(0);
+        workers->m_Jobs.SetSize(0);
+        if (workers->m_Jobs.Capacity() < job_count)
+        {
+            workers->m_QueryJobs.SetCapacity(job_count);
+            workers->m_Jobs.SetCapacity(job_count);
+        }
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            QueryJob query_job;
+            query_job.m_Function = function;
+            query_job.m_Context = context;
+            query_job.m_Begin = i * QUERY_JOB_SIZE;
+            query_job.m_End = dmMath::Min(query_job.m_Begin + QUERY_JOB_SIZE, count);
+            workers->m_QueryJobs.Push(query_job);
+        }
+        for (uint32_t i = 0; i < job_count; ++i)
+        {
+            dmJobThread::Job job;
+            job.m_Process = ProcessQueryJob;
+            job.m_Context = 0x0;
+            job.m_Data = &workers->m_QueryJobs[i];
+            job.m_Result = 0;
+            workers->m_Jobs.Push(job);
+        }
+
+        dmJobThread::HGroup group = dmJobThread::PushGroup(workers->m_JobContext, workers->m_Jobs.Begin(), job_count);
+        dmJobThread::WaitGroup(workers->m_JobContext, group);
+    }
 }
@@ -125,6 +125,33 @@ namespace dmPhysics
      * if it is the last known occurrence of overlap.
      */
     void OverlapCachePrune(OverlapCache* cache, const OverlapCachePruneData& data);
+
+    typedef struct QueryWorkers* HQueryWorkers;
+
+    /**
+     * Runs the queries [begin, end) of a batch.
+     */
+    typedef void (*QueryJobFunction)(void* context, uint32_t begin, uint32_t end);
+
+    /**
+     * Number of queries a worker picks up at a time.
+     */
+    const uint32_t QUERY_JOB_SIZE = 32;
+
+    /**
+     * Create the job threads used to run batched queries.
+     * @return the workers, or 0x0 if thread_count is 0 or the platform has no thread support
+     */
+    HQueryWorkers NewQueryWorkers(uint32_t thread_count);
+
+    void DeleteQueryWorkers(HQueryWorkers workers);
+
+    /**
+     * Run a batch of queries and return when all of them are done. The calling thread helps the workers,
+     * and runs all of the queries by itself if there are no workers.
+     * Must not be called concurrently with the same workers.
+     */
+    void RunQueryJobs(HQueryWorkers workers, QueryJobFunction function, void* context, uint32_t count);
 }
 
 #endif // PHYSICS_PRIVATE_H
@@ -128,6 +128,8 @@ Test3D::Test3D()
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch3D)
+, m_OverlapBatchFunc(dmPhysics::OverlapBatch3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
 , m_SetGravityFunc(dmPhysics::SetGravity3D)
@@ -186,6 +188,8 @@ Test2D::Test2D()
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
+, m_RayCastBatchFunc(dmPhysics::RayCastBatch2D)
+, m_OverlapBatchFunc(dmPhysics::OverlapBatch2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
 , m_SetGravityFunc(dmPhysics::SetGravity2D)
@@ -1062,6 +1066,119 @@ TYPED_TEST(PhysicsTest, RayCasting)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+TYPED_TEST(PhysicsTest, BatchQueries)
+{
+    float box_half_ext = 0.5f;
+    VisualObject vo;
+    dmPhysics::CollisionObjectData data;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    data.m_Mass = 0.0f;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    data.m_UserData = &vo;
+    typename TypeParam::CollisionObjectType box_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+
+    // More rays than a single job, so that the query threads pick up some of them
+    const uint32_t count = 100;
+    dmPhysics::RayCastRequest requests[count];
+    dmPhysics::RayCastResponse responses[count];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Every other ray passes beside the box
+        float x = (i % 2) ? 2.0f : 0.0f;
+        requests[i].m_From = Point3(x, 1.0f, 0.0f);
+        requests[i].m_To = Point3(x, 0.0f, 0.0f);
+    }
+    // Zero length rays miss
+    requests[count - 2].m_To = requests[count - 2].m_From;
+
+    (*TestFixture::m_Test.m_RayCastBatchFunc)(TestFixture::m_World, requests, responses, count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i % 2 || i == count - 2)
+        {
+            ASSERT_FALSE(responses[i].m_Hit);
+            continue;
+        }
+        ASSERT_TRUE(responses[i].m_Hit);
+        ASSERT_NEAR(0.5f, responses[i].m_Fraction, 0.01f);
+        ASSERT_NEAR(0.5f, responses[i].m_Position.getY(), 0.01f);
+        ASSERT_NEAR(1.0f, responses[i].m_Normal.getY(), 0.00001f);
+        ASSERT_EQ((void*)&vo, (void*)responses[i].m_CollisionObjectUserData);
+    }
+
+    dmPhysics::OverlapRequest overlap_requests[3];
+    overlap_requests[0].m_Min = Point3(0.25f, 0.25f, -1.0f);
+    overlap_requests[0].m_Max = Point3(1.0f, 1.0f, 1.0f);
+    overlap_requests[1].m_Min = Point3(1.0f, 1.0f, -1.0f);
+    overlap_requests[1].m_Max = Point3(2.0f, 2.0f, 1.0f);
+    overlap_requests[2] = overlap_requests[0];
+    overlap_requests[2].m_IgnoredUserData = &vo;
+    void* overlap_results[3 * 2];
+    uint32_t overlap_counts[3];
+
+    (*TestFixture::m_Test.m_OverlapBatchFunc)(TestFixture::m_World, overlap_requests, 3, overlap_results, 2, overlap_counts);
+
+    ASSERT_EQ(1u, overlap_counts[0]);
+    ASSERT_EQ((void*)&vo, overlap_results[0]);
+    ASSERT_EQ(0u, overlap_counts[1]);
+    ASSERT_EQ(0u, overlap_counts[2]);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+TYPED_TEST(PhysicsTest, OverlapBatchMaxResults)
+{
+    float box_half_ext = 0.5f;
+    const uint32_t object_count = 5;
+    VisualObject vos[object_count];
+    typename TypeParam::CollisionObjectType cos[object_count];
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(box_half_ext, box_half_ext, box_half_ext));
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        dmPhysics::CollisionObjectData data;
+        data.m_Mass = 0.0f;
+        data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+        data.m_UserData = &vos[i];
+        cos[i] = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, data, &shape, 1u);
+    }
+
+    // More overlapping objects than results, followed by guard values that must not be written
+    const uint32_t max_results = 2;
+    const uint32_t guard_count = 4;
+    void* guard = (void*)0x1;
+    dmPhysics::OverlapRequest overlap_request;
+    overlap_request.m_Min = Point3(-1.0f, -1.0f, -1.0f);
+    overlap_request.m_Max = Point3(1.0f, 1.0f, 1.0f);
+    void* overlap_results[max_results + guard_count];
+    for (uint32_t i = 0; i < max_results + guard_count; ++i)
+    {
+        overlap_results[i] = guard;
+    }
+    uint32_t overlap_count = 0;
+
+    (*TestFixture::m_Test.m_OverlapBatchFunc)(TestFixture::m_World, &overlap_request, 1, overlap_results, max_results, &overlap_count);
+
+    ASSERT_EQ(max_results, overlap_count);
+    for (uint32_t i = 0; i < max_results; ++i)
+    {
+        ASSERT_GE((void*)&vos[object_count - 1], overlap_results[i]);
+        ASSERT_LE((void*)&vos[0], overlap_results[i]);
+    }
+    ASSERT_NE(overlap_results[0], overlap_results[1]);
+    for (uint32_t i = max_results; i < max_results + guard_count; ++i)
+    {
+        ASSERT_EQ(guard, overlap_results[i]);
+    }
+
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, cos[i]);
+    }
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
 TYPED_TEST(PhysicsTest, InsideRayCasting)
 {
     float box_half_ext = 0.5f;
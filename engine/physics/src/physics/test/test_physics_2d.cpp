@@ -1819,6 +1819,53 @@ TYPED_TEST(PhysicsTest, SetGridShapeEnable)
     dmPhysics::DeleteHullSet2D(hull_set);
 }
 
+TYPED_TEST(PhysicsTest, SplitStep)
+{
+    float ground_height_half_ext = 1.0f;
+    float box_half_ext = 0.5f;
+
+    VisualObject ground_visual_object;
+    dmPhysics::CollisionObjectData ground_data;
+    typename TypeParam::CollisionShapeType ground_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, dmVMath::Vector3(100, ground_height_half_ext, 100));
+    ground_data.m_Mass = 0.0f;
+    ground_data.m_Restitution = 0.0f;
+    ground_data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    ground_data.m_UserData = &ground_visual_object;
+    typename TypeParam::CollisionObjectType ground_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, ground_data, &ground_shape, 1u);
+
+    VisualObject box_visual_object;
+    box_visual_object.m_Position = dmVMath::Point3(0.0f, 2.0f, 0.0f);
+    dmPhysics::CollisionObjectData box_data;
+    box_data.m_Restitution = 0.0f;
+    typename TypeParam::CollisionShapeType box_shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, dmVMath::Vector3(box_half_ext, box_half_ext, box_half_ext));
+    box_data.m_UserData = &box_visual_object;
+    typename TypeParam::CollisionObjectType box_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(TestFixture::m_World, box_data, &box_shape, 1u);
+
+    int collision_count = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        dmPhysics::BeginStepWorld2D(TestFixture::m_World, TestFixture::m_StepWorldContext);
+        dmVMath::Point3 position = box_visual_object.m_Position;
+        dmPhysics::SimulateWorld2D(TestFixture::m_World, TestFixture::m_StepWorldContext);
+
+        // Nothing is reported until the step is ended
+        ASSERT_EQ(collision_count, TestFixture::m_CollisionCount);
+        ASSERT_EQ(position.getY(), box_visual_object.m_Position.getY());
+
+        dmPhysics::EndStepWorld2D(TestFixture::m_World, TestFixture::m_StepWorldContext);
+        collision_count = TestFixture::m_CollisionCount;
+    }
+
+    ASSERT_LT(0, collision_count);
+    ASSERT_LT(0, TestFixture::m_ContactPointCount);
+    ASSERT_NEAR(ground_height_half_ext + box_half_ext, box_visual_object.m_Position.getY(), 2.0f * TestFixture::m_Test.m_PolygonRadius / PHYSICS_SCALE);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, ground_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(TestFixture::m_World, box_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(ground_shape);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(box_shape);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
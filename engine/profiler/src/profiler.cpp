@@ -17,11 +17,13 @@
 #include <dlib/dlib.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
+#include <dlib/message.h>
 #include <dlib/profile.h>
 #include <dlib/time.h>
 #include <extension/extension.h>
 #include <render/render.h>
 #include <script/script.h>
+#include <script/sys_ddf.h>
 #include <dmsdk/dlib/vmath.h>
 
 #include "profiler_private.h"
@@ -55,6 +57,8 @@ static dmProfileRender::ProfilerFrame*  g_ProfilerCurrentFrame = 0;
 static dmMutex::HMutex                  g_ProfilerMutex = 0;
 static dmHashTable64<int>               g_ProfilerThreadSortOrder;
 
+static bool g_TraceExit = false; // Exit the engine when the trace capture is finished
+
 
 void SetUpdateFrequency(uint32_t update_frequency)
 {
@@ -693,8 +697,32 @@ static dmExtension::Result InitializeProfiler(dmExtension::Params* params)
     return dmExtension::RESULT_OK;
 }
 
+static void PostExit()
+{
+    dmMessage::HSocket socket;
+    if (dmMessage::GetSocket("@system", &socket) != dmMessage::RESULT_OK)
+    {
+        return;
+    }
+
+    dmMessage::URL url;
+    url.m_Socket = socket;
+    url.m_Path = 0;
+    url.m_Fragment = 0;
+
+    dmSystemDDF::Exit msg;
+    msg.m_Code = 0;
+    dmMessage::Post(0, &url, dmSystemDDF::Exit::m_DDFDescriptor->m_NameHash, 0, (uintptr_t) dmSystemDDF::Exit::m_DDFDescriptor, &msg, sizeof(msg), 0);
+}
+
 static dmExtension::Result UpdateProfiler(dmExtension::Params* params)
 {
+    if (g_TraceExit && dmProfile::IsTraceCaptureFinished())
+    {
+        g_TraceExit = false;
+        PostExit();
+    }
+
     if (g_TrackCpuUsage)
     {
         dmProfilerExt::SampleCpuUsage();
@@ -731,6 +759,10 @@ static dmExtension::Result AppInitializeProfiler(dmExtension::AppParams* params)
     dmProfile::Options options;
     options.m_Port = g_ProfilerPort;
     options.m_SleepBetweenServerUpdates = dmConfigFile::GetInt(params->m_ConfigFile, "profiler.sleep_between_server_updates", 0);
+    // Headless capture to a Chrome trace event file, e.g. --config=profiler.trace_file=trace.json
+    options.m_TraceFile = dmConfigFile::GetString(params->m_ConfigFile, "profiler.trace_file", 0);
+    options.m_TraceFrames = dmConfigFile::GetInt(params->m_ConfigFile, "profiler.trace_frames", 0);
+    g_TraceExit = options.m_TraceFile && dmConfigFile::GetInt(params->m_ConfigFile, "profiler.trace_exit", 0) != 0;
     dmProfile::Initialize(&options);
 
     if (!dmProfile::IsInitialized()) // We might use the null implementation
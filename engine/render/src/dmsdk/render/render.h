@@ -170,6 +170,7 @@ namespace dmRender
      * @member m_StencilTestParams [type: dmRender::StencilTestParams] the stencil test params
      * @member m_VertexStart [type: uint32_t] the vertex start
      * @member m_VertexCount [type: uint32_t] the vertex count
+     * @member m_InstanceCount [type: uint32_t] the number of instances to draw. Zero is treated as one instance.
      * @member m_SetBlendFactors [type: uint8_t:1] use the blend factors
      * @member m_SetStencilTest [type: uint8_t:1] use the stencil test
      */
@@ -206,6 +207,7 @@ namespace dmRender
         StencilTestParams               m_StencilTestParams;
         uint32_t                        m_VertexStart;
         uint32_t                        m_VertexCount;
+        uint32_t                        m_InstanceCount;
         uint8_t                         m_SetBlendFactors : 1;
         uint8_t                         m_SetStencilTest : 1;
         uint8_t                         m_SetFaceWinding : 1;
@@ -23,6 +23,7 @@
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/profile.h>
+#include <dlib/flat_hashtable.h>
 #include <dlib/hashtable.h>
 #include <dlib/utf8.h>
 #include <dlib/zlib.h>
@@ -87,6 +88,36 @@ namespace dmRender
 
     }
 
+    const uint32_t INVALID_CACHE_CELL = 0xffffffff;
+
+    // Max number of text layouts cached per font map
+    const uint32_t MAX_TEXT_LAYOUTS = 512;
+
+    struct TextLayoutLine
+    {
+        float       m_Width;
+        uint32_t    m_GlyphStart;
+        uint32_t    m_GlyphCount;
+    };
+
+    // The line breaking and glyph lookups of a text, which only depend on the text and
+    // the layout parameters. The glyph pointers stay valid until the glyphs of the font map are replaced.
+    struct TextLayout
+    {
+        dmArray<TextLayoutLine> m_Lines;
+        dmArray<Glyph*>         m_Glyphs;
+        // The text and parameters the layout was made from. The cache key is only a hash of them.
+        dmArray<char>           m_Text;
+        float                   m_MaxWidth;
+        float                   m_Tracking;
+        bool                    m_LineBreak;
+        float                   m_Width;
+        dmhash_t                m_Key;
+        // Least recently used list
+        TextLayout*             m_Prev;
+        TextLayout*             m_Next;
+    };
+
     struct FontMap
     {
         FontMap()
@@ -102,7 +133,14 @@ namespace dmRender
         , m_CacheHeight(0)
         , m_GlyphData(0)
         , m_Cache(0)
-        , m_CacheCursor(0)
+        , m_CacheData(0)
+        , m_CacheLruPrev(0)
+        , m_CacheLruNext(0)
+        , m_CacheLruHead(0)
+        , m_CacheLruTail(0)
+        , m_CacheDirtyStartY(0)
+        , m_CacheDirtyEndY(0)
+        , m_CacheChannels(0)
         , m_CacheColumns(0)
         , m_CacheRows(0)
         , m_CellTempData(0)
@@ -111,6 +149,8 @@ namespace dmRender
         , m_CacheCellMaxAscent(0)
         , m_CacheCellPadding(0)
         , m_LayerMask(FACE)
+        , m_TextLayoutHead(0)
+        , m_TextLayoutTail(0)
         {
 
         }
@@ -119,17 +159,21 @@ namespace dmRender
         {
             if (m_Cache) {
                 free(m_Cache);
+                free(m_CacheData);
+                free(m_CacheLruPrev);
+                free(m_CacheLruNext);
             }
             if (m_CellTempData) {
                 free(m_CellTempData);
             }
+            DeleteTextLayouts();
             dmGraphics::DeleteTexture(m_Texture);
         }
 
         void*                   m_UserData;
         dmGraphics::HTexture    m_Texture;
         HMaterial               m_Material;
-        dmHashTable32<Glyph>    m_Glyphs;
+        dmFlatHashTable32<Glyph> m_Glyphs;
         float                   m_ShadowX;
         float                   m_ShadowY;
         float                   m_MaxAscent;
@@ -147,7 +191,16 @@ namespace dmRender
         void*                   m_GlyphData;
 
         Glyph**                 m_Cache;
-        uint32_t                m_CacheCursor;
+        uint8_t*                m_CacheData;    // a copy of the cache texture, the glyphs are written here and then uploaded
+        // The cells in least recently used order, linked by index
+        uint32_t*               m_CacheLruPrev;
+        uint32_t*               m_CacheLruNext;
+        uint32_t                m_CacheLruHead; // most recently used
+        uint32_t                m_CacheLruTail; // least recently used
+        // The rows [start, end) of the cache that are modified since the last upload
+        uint32_t                m_CacheDirtyStartY;
+        uint32_t                m_CacheDirtyEndY;
+        uint8_t                 m_CacheChannels;
         dmGraphics::TextureFormat m_CacheFormat;
         dmGraphics::TextureFilter m_MinFilter;
         dmGraphics::TextureFilter m_MagFilter;
@@ -162,23 +215,56 @@ namespace dmRender
         uint32_t                m_CacheCellMaxAscent;
         uint8_t                 m_CacheCellPadding;
         uint8_t                 m_LayerMask;
+
+        dmHashTable64<TextLayout*> m_TextLayouts;
+        TextLayout*             m_TextLayoutHead; // most recently used
+        TextLayout*             m_TextLayoutTail; // least recently used
+
+        void DeleteTextLayouts()
+        {
+            TextLayout* layout = m_TextLayoutHead;
+            while (layout)
+            {
+                TextLayout* next = layout->m_Next;
+                delete layout;
+                layout = next;
+            }
+            m_TextLayoutHead = 0;
+            m_TextLayoutTail = 0;
+            m_TextLayouts.Clear();
+        }
     };
 
     static float GetLineTextMetrics(HFontMap font_map, float tracking, const char* text, int n, bool measure_trailing_space);
 
-    static void InitFontmap(FontMapParams& params, dmGraphics::TextureParams& tex_params, uint8_t init_val)
+    // Allocates the cache cells and clears the cache texture
+    static void InitGlyphCache(HFontMap font_map, FontMapParams& params, dmGraphics::TextureParams& tex_params)
     {
-        uint8_t bpp = params.m_GlyphChannels;
-        uint32_t data_size = tex_params.m_Width * tex_params.m_Height * bpp;
-        tex_params.m_Data = malloc(data_size);
-        tex_params.m_DataSize = data_size;
-        memset((void*)tex_params.m_Data, init_val, tex_params.m_DataSize);
-    }
+        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
 
-    static void CleanupFontmap(dmGraphics::TextureParams& tex_params)
-    {
-        free((void*)tex_params.m_Data);
-        tex_params.m_DataSize = 0;
+        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
+        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
+
+        // Initially the cells are used in order
+        font_map->m_CacheLruPrev = (uint32_t*)malloc(sizeof(uint32_t) * cell_count);
+        font_map->m_CacheLruNext = (uint32_t*)malloc(sizeof(uint32_t) * cell_count);
+        for (uint32_t i = 0; i < cell_count; ++i)
+        {
+            font_map->m_CacheLruPrev[i] = i + 1 < cell_count ? i + 1 : INVALID_CACHE_CELL;
+            font_map->m_CacheLruNext[i] = i > 0 ? i - 1 : INVALID_CACHE_CELL;
+        }
+        font_map->m_CacheLruHead = cell_count > 0 ? cell_count - 1 : INVALID_CACHE_CELL;
+        font_map->m_CacheLruTail = cell_count > 0 ? 0 : INVALID_CACHE_CELL;
+
+        font_map->m_CacheChannels = params.m_GlyphChannels;
+        uint32_t data_size = params.m_CacheWidth * params.m_CacheHeight * params.m_GlyphChannels;
+        font_map->m_CacheData = (uint8_t*)malloc(data_size);
+        memset(font_map->m_CacheData, 0, data_size);
+        font_map->m_CacheDirtyStartY = 0;
+        font_map->m_CacheDirtyEndY = 0;
+
+        tex_params.m_Data = font_map->m_CacheData;
+        tex_params.m_DataSize = data_size;
     }
 
     // Font maps have no mips, so we need to make sure we use a supported min filter
@@ -202,7 +288,7 @@ namespace dmRender
         font_map->m_Material = 0;
 
         const dmArray<Glyph>& glyphs = params.m_Glyphs;
-        font_map->m_Glyphs.SetCapacity((3 * glyphs.Size()) / 2, glyphs.Size());
+        font_map->m_Glyphs.SetCapacity(glyphs.Size());
         for (uint32_t i = 0; i < glyphs.Size(); ++i) {
             const Glyph& g = glyphs[i];
             font_map->m_Glyphs.Put(g.m_Character, g);
@@ -232,7 +318,6 @@ namespace dmRender
 
         font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
         font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
 
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
 
@@ -265,9 +350,6 @@ namespace dmRender
             font_map->m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         }
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         // create new texture to be used as a cache
         dmGraphics::TextureCreationParams tex_create_params;
         dmGraphics::TextureParams tex_params;
@@ -285,9 +367,8 @@ namespace dmRender
         tex_params.m_MagFilter = dmGraphics::TEXTURE_FILTER_LINEAR;
         font_map->m_Texture = dmGraphics::NewTexture(graphics_context, tex_create_params);
 
-        InitFontmap(params, tex_params, 0);
+        InitGlyphCache(font_map, params, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
 
         return font_map;
     }
@@ -299,9 +380,12 @@ namespace dmRender
 
     void SetFontMap(HFontMap font_map, FontMapParams& params)
     {
+        // The cached layouts point to the glyphs we're about to replace
+        font_map->DeleteTextLayouts();
+
         const dmArray<Glyph>& glyphs = params.m_Glyphs;
         font_map->m_Glyphs.Clear();
-        font_map->m_Glyphs.SetCapacity((3 * glyphs.Size()) / 2, glyphs.Size());
+        font_map->m_Glyphs.SetCapacity(glyphs.Size());
         for (uint32_t i = 0; i < glyphs.Size(); ++i) {
             const Glyph& g = glyphs[i];
             font_map->m_Glyphs.Put(g.m_Character, g);
@@ -310,6 +394,9 @@ namespace dmRender
         // release previous glyph data bank
         if (font_map->m_Cache) {
             free(font_map->m_Cache);
+            free(font_map->m_CacheData);
+            free(font_map->m_CacheLruPrev);
+            free(font_map->m_CacheLruNext);
             free(font_map->m_CellTempData);
         }
 
@@ -337,7 +424,6 @@ namespace dmRender
 
         font_map->m_CacheColumns = params.m_CacheWidth / params.m_CacheCellWidth;
         font_map->m_CacheRows = params.m_CacheHeight / params.m_CacheCellHeight;
-        uint32_t cell_count = font_map->m_CacheColumns * font_map->m_CacheRows;
 
         font_map->m_CellTempData = (uint8_t*)malloc(font_map->m_CacheCellWidth*font_map->m_CacheCellHeight*4);
 
@@ -358,9 +444,6 @@ namespace dmRender
                 return;
         };
 
-        font_map->m_Cache = (Glyph**)malloc(sizeof(Glyph*) * cell_count);
-        memset(font_map->m_Cache, 0, sizeof(Glyph*) * cell_count);
-
         dmGraphics::TextureParams tex_params;
         tex_params.m_Format = font_map->m_CacheFormat;
         tex_params.m_Data = 0x0;
@@ -368,9 +451,8 @@ namespace dmRender
         tex_params.m_Width = params.m_CacheWidth;
         tex_params.m_Height = params.m_CacheHeight;
 
-        InitFontmap(params, tex_params, 0);
+        InitGlyphCache(font_map, params, tex_params);
         dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-        CleanupFontmap(tex_params);
     }
 
     void SetFontMapUserData(HFontMap font_map, void* user_data)
@@ -623,6 +705,159 @@ namespace dmRender
         return g;
     }
 
+    static void UnlinkTextLayout(HFontMap font_map, TextLayout* layout)
+    {
+        if (layout->m_Prev)
+            layout->m_Prev->m_Next = layout->m_Next;
+        else
+            font_map->m_TextLayoutHead = layout->m_Next;
+        if (layout->m_Next)
+            layout->m_Next->m_Prev = layout->m_Prev;
+        else
+            font_map->m_TextLayoutTail = layout->m_Prev;
+        layout->m_Prev = 0;
+        layout->m_Next = 0;
+    }
+
+    static void LinkTextLayoutFirst(HFontMap font_map, TextLayout* layout)
+    {
+        layout->m_Prev = 0;
+        layout->m_Next = font_map->m_TextLayoutHead;
+        if (font_map->m_TextLayoutHead)
+            font_map->m_TextLayoutHead->m_Prev = layout;
+        else
+            font_map->m_TextLayoutTail = layout;
+        font_map->m_TextLayoutHead = layout;
+    }
+
+    static bool IsTextLayoutOf(const TextLayout* layout, const char* text, uint32_t text_length, float width, bool line_break, float tracking)
+    {
+        return layout->m_MaxWidth == width
+            && layout->m_Tracking == tracking
+            && layout->m_LineBreak == line_break
+            && layout->m_Text.Size() == text_length
+            && memcmp(layout->m_Text.Begin(), text, text_length) == 0;
+    }
+
+    // Returns the (possibly cached) layout of a text. The layout is only valid until the next call.
+    static TextLayout* GetTextLayout(HFontMap font_map, const char* text, float width, bool line_break, float tracking)
+    {
+        if (!line_break) {
+            width = FLT_MAX;
+        }
+
+        uint32_t text_length = strlen(text);
+
+        // The fixed size values go first, so that they cannot be confused with the text
+        HashState64 key_state;
+        dmHashInit64(&key_state, false);
+        dmHashUpdateBuffer64(&key_state, &width, sizeof(width));
+        dmHashUpdateBuffer64(&key_state, &tracking, sizeof(tracking));
+        dmHashUpdateBuffer64(&key_state, &line_break, sizeof(line_break));
+        dmHashUpdateBuffer64(&key_state, text, text_length);
+        dmhash_t key = dmHashFinal64(&key_state);
+
+        TextLayout* layout = 0;
+        TextLayout** cached = font_map->m_TextLayouts.Get(key);
+        if (cached)
+        {
+            layout = *cached;
+            UnlinkTextLayout(font_map, layout);
+            LinkTextLayoutFirst(font_map, layout);
+            if (IsTextLayoutOf(layout, text, text_length, width, line_break, tracking))
+            {
+                return layout;
+            }
+            // A different text with the same key. The layout is replaced below.
+        }
+        else
+        {
+            if (font_map->m_TextLayouts.Capacity() == 0)
+            {
+                font_map->m_TextLayouts.SetCapacity((3 * MAX_TEXT_LAYOUTS) / 2, MAX_TEXT_LAYOUTS);
+            }
+
+            if (font_map->m_TextLayouts.Full())
+            {
+                // Reuse the least recently used layout, along with its storage. Text that changes
+                // every frame then doesn't allocate once the cache is full.
+                layout = font_map->m_TextLayoutTail;
+                UnlinkTextLayout(font_map, layout);
+                font_map->m_TextLayouts.Erase(layout->m_Key);
+            }
+            else
+            {
+                layout = new TextLayout;
+            }
+            layout->m_Key = key;
+            font_map->m_TextLayouts.Put(key, layout);
+            LinkTextLayoutFirst(font_map, layout);
+        }
+
+        DM_PROFILE("LayoutText");
+
+        float line_height = font_map->m_MaxAscent + font_map->m_MaxDescent;
+
+        const uint32_t max_lines = 128;
+        TextLine lines[max_lines];
+
+        // Trailing space characters should be ignored when measuring and
+        // rendering multiline text.
+        // For single line text we still want to include spaces when the text
+        // layout is calculated (https://github.com/defold/defold/issues/5911)
+        bool measure_trailing_space = !line_break;
+
+        LayoutMetrics lm(font_map, tracking * line_height);
+        float layout_width;
+        uint32_t line_count = Layout(text, width, lines, max_lines, &layout_width, lm, measure_trailing_space);
+
+        uint32_t char_count = 0;
+        for (uint32_t i = 0; i < line_count; ++i)
+        {
+            char_count += lines[i].m_Count;
+        }
+
+        layout->m_Width = layout_width;
+        layout->m_MaxWidth = width;
+        layout->m_Tracking = tracking;
+        layout->m_LineBreak = line_break;
+
+        // The arrays only grow, so that a reused layout doesn't allocate
+        layout->m_Text.SetSize(0);
+        layout->m_Lines.SetSize(0);
+        layout->m_Glyphs.SetSize(0);
+        if (layout->m_Text.Capacity() < text_length)
+            layout->m_Text.SetCapacity(text_length);
+        if (layout->m_Lines.Capacity() < line_count)
+            layout->m_Lines.SetCapacity(line_count);
+        if (layout->m_Glyphs.Capacity() < char_count)
+            layout->m_Glyphs.SetCapacity(char_count);
+        layout->m_Text.PushArray(text, text_length);
+
+        for (uint32_t i = 0; i < line_count; ++i)
+        {
+            const TextLine& l = lines[i];
+            TextLayoutLine layout_line;
+            layout_line.m_Width = l.m_Width;
+            layout_line.m_GlyphStart = layout->m_Glyphs.Size();
+
+            const char* cursor = &text[l.m_Index];
+            for (int j = 0; j < l.m_Count; ++j)
+            {
+                uint32_t c = dmUtf8::NextChar(&cursor);
+                Glyph* g = GetGlyph(font_map, c);
+                if (g) {
+                    layout->m_Glyphs.Push(g);
+                }
+            }
+
+            layout_line.m_GlyphCount = layout->m_Glyphs.Size() - layout_line.m_GlyphStart;
+            layout->m_Lines.Push(layout_line);
+        }
+
+        return layout;
+    }
+
     struct FontGlyphInflaterContext {
         uint32_t m_Cursor;
         uint8_t* m_Output;
@@ -636,110 +871,174 @@ namespace dmRender
         return true;
     }
 
-    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g, int16_t g_offset_y) {
-        uint32_t prev_cache_cursor = font_map->m_CacheCursor;
-        dmGraphics::TextureParams tex_params;
-        tex_params.m_SubUpdate = true;
-        tex_params.m_MipMap = 0;
-        tex_params.m_Format = font_map->m_CacheFormat;
-        tex_params.m_MinFilter = font_map->m_MinFilter;
-        tex_params.m_MagFilter = font_map->m_MagFilter;
-
-        // Locate a cache cell candidate
-        do {
-            uint32_t cur = font_map->m_CacheCursor++;
-            Glyph* candidate = font_map->m_Cache[cur];
-            font_map->m_CacheCursor = font_map->m_CacheCursor % (font_map->m_CacheColumns * font_map->m_CacheRows);
-            if (candidate == 0x0 || text_context.m_Frame != candidate->m_Frame) {
+    // Moves a cache cell first in the least recently used list
+    static void TouchCacheCell(HFontMap font_map, uint32_t cell)
+    {
+        uint32_t head = font_map->m_CacheLruHead;
+        if (cell == head)
+            return;
 
-                if (candidate) {
-                    candidate->m_InCache = false;
-                }
-                font_map->m_Cache[cur] = g;
-
-                uint32_t col = cur % font_map->m_CacheColumns;
-                uint32_t row = cur / font_map->m_CacheColumns;
-
-                g->m_X = col * font_map->m_CacheCellWidth;
-                g->m_Y = row * font_map->m_CacheCellHeight;
-                g->m_Frame = text_context.m_Frame;
-                g->m_InCache = true;
-
-                // Upload glyph data to GPU
-                tex_params.m_Width = g->m_Width + font_map->m_CacheCellPadding*2;
-                tex_params.m_Height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
-
-                uint8_t* glyph_data = (uint8_t*)(uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
-                uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
-                uint8_t is_compressed = *glyph_data++;
-
-                if (is_compressed) {
-
-                    // When if came to choosing between the different algorithms, here are some speed/compression tests
-                    // Decoding 100 glyphs
-                    // lz4:     0.1060 ms  compression: 72%
-                    // deflate: 0.2190 ms  compression: 66%
-                    // png:     0.6930 ms  compression: 67%
-                    // webp:    1.5170 ms  compression: 55%
-                    // further improvements (different test, Android, 92 glyphs)
-                    // webp          2.9440 ms  compression: 55%
-                    // deflate       0.7110 ms  compression: 66%
-                    // deflate+delta 0.7680 ms  compression: 62%
-
-                    FontGlyphInflaterContext deflate_context;
-                    deflate_context.m_Output = font_map->m_CellTempData;
-                    deflate_context.m_Cursor = 0;
-                    dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
-                    if (zlib_result != dmZlib::RESULT_OK)
-                    {
-                        dmLogError("Failed to decompress glyph (%c)", g->m_Character);
-                        return;
-                    }
+        uint32_t* prev = font_map->m_CacheLruPrev;
+        uint32_t* next = font_map->m_CacheLruNext;
+
+        // unlink
+        uint32_t p = prev[cell];
+        uint32_t n = next[cell];
+        next[p] = n;
+        if (n != INVALID_CACHE_CELL)
+            prev[n] = p;
+        else
+            font_map->m_CacheLruTail = p;
+
+        // insert first
+        prev[cell] = INVALID_CACHE_CELL;
+        next[cell] = head;
+        prev[head] = cell;
+        font_map->m_CacheLruHead = cell;
+    }
 
-                    uint32_t uncompressed_size = deflate_context.m_Cursor;
-                    delta_decode(font_map->m_CellTempData, uncompressed_size);
+    // Marks a cached glyph as used this frame, so that it won't be evicted
+    static inline void TouchGlyph(HFontMap font_map, TextContext& text_context, Glyph* g)
+    {
+        if (g->m_Frame == text_context.m_Frame)
+            return;
+        g->m_Frame = text_context.m_Frame;
+        uint32_t col = g->m_X / font_map->m_CacheCellWidth;
+        uint32_t row = g->m_Y / font_map->m_CacheCellHeight;
+        TouchCacheCell(font_map, row * font_map->m_CacheColumns + col);
+    }
 
-                    tex_params.m_Data = font_map->m_CellTempData;
-                } else {
-                    tex_params.m_Data = glyph_data;
-                }
+    void AddGlyphToCache(HFontMap font_map, TextContext& text_context, Glyph* g, int16_t g_offset_y) {
+        // The least recently used cell is the candidate. If it is used this frame, so are all the others.
+        uint32_t cell = font_map->m_CacheLruTail;
+        if (cell == INVALID_CACHE_CELL) {
+            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+            return;
+        }
+        Glyph* candidate = font_map->m_Cache[cell];
+        if (candidate != 0x0 && text_context.m_Frame == candidate->m_Frame) {
+            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+            return;
+        }
 
-                tex_params.m_X = g->m_X;
-                tex_params.m_Y = g->m_Y + g_offset_y;
+        uint32_t col = cell % font_map->m_CacheColumns;
+        uint32_t row = cell / font_map->m_CacheColumns;
+        uint32_t x = col * font_map->m_CacheCellWidth;
+        uint32_t y = row * font_map->m_CacheCellHeight + g_offset_y;
+        uint32_t width = g->m_Width + font_map->m_CacheCellPadding*2;
+        uint32_t height = g->m_Ascent + g->m_Descent + font_map->m_CacheCellPadding*2;
+        if (g_offset_y < 0 || x + width > font_map->m_CacheWidth || y + height > font_map->m_CacheHeight)
+        {
+            dmLogError("Glyph (%c) doesn't fit in the cache", g->m_Character);
+            return;
+        }
 
-                dmGraphics::SetTexture(font_map->m_Texture, tex_params);
-                break;
+        uint8_t* glyph_data = (uint8_t*)(uint8_t*)font_map->m_GlyphData + g->m_GlyphDataOffset;
+        uint32_t glyph_data_size = g->m_GlyphDataSize-1; // The first byte is a header
+        uint8_t is_compressed = *glyph_data++;
+
+        if (is_compressed) {
+
+            // When if came to choosing between the different algorithms, here are some speed/compression tests
+            // Decoding 100 glyphs
+            // lz4:     0.1060 ms  compression: 72%
+            // deflate: 0.2190 ms  compression: 66%
+            // png:     0.6930 ms  compression: 67%
+            // webp:    1.5170 ms  compression: 55%
+            // further improvements (different test, Android, 92 glyphs)
+            // webp          2.9440 ms  compression: 55%
+            // deflate       0.7110 ms  compression: 66%
+            // deflate+delta 0.7680 ms  compression: 62%
+
+            FontGlyphInflaterContext deflate_context;
+            deflate_context.m_Output = font_map->m_CellTempData;
+            deflate_context.m_Cursor = 0;
+            dmZlib::Result zlib_result = dmZlib::InflateBuffer(glyph_data, glyph_data_size, &deflate_context, FontGlyphInflater);
+            if (zlib_result != dmZlib::RESULT_OK)
+            {
+                dmLogError("Failed to decompress glyph (%c)", g->m_Character);
+                return;
             }
 
-        } while (prev_cache_cursor != font_map->m_CacheCursor);
+            uint32_t uncompressed_size = deflate_context.m_Cursor;
+            delta_decode(font_map->m_CellTempData, uncompressed_size);
 
-        if (prev_cache_cursor == font_map->m_CacheCursor) {
-            dmLogError("Out of available cache cells! Consider increasing cache_width or cache_height for the font.");
+            glyph_data = font_map->m_CellTempData;
+        }
+
+        if (candidate) {
+            candidate->m_InCache = false;
+        }
+        font_map->m_Cache[cell] = g;
+        TouchCacheCell(font_map, cell);
+
+        g->m_X = x;
+        g->m_Y = row * font_map->m_CacheCellHeight;
+        g->m_Frame = text_context.m_Frame;
+        g->m_InCache = true;
+
+        // Write the glyph to the cache copy, it is uploaded with the other glyphs added before the batch is drawn
+        uint32_t channels = font_map->m_CacheChannels;
+        uint32_t src_stride = width * channels;
+        uint32_t dst_stride = font_map->m_CacheWidth * channels;
+        uint8_t* dst = font_map->m_CacheData + y * dst_stride + x * channels;
+        for (uint32_t i = 0; i < height; ++i)
+        {
+            memcpy(dst + i * dst_stride, glyph_data + i * src_stride, src_stride);
+        }
+
+        if (font_map->m_CacheDirtyStartY == font_map->m_CacheDirtyEndY)
+        {
+            font_map->m_CacheDirtyStartY = y;
+            font_map->m_CacheDirtyEndY = y + height;
+        }
+        else
+        {
+            font_map->m_CacheDirtyStartY = dmMath::Min(font_map->m_CacheDirtyStartY, y);
+            font_map->m_CacheDirtyEndY = dmMath::Max(font_map->m_CacheDirtyEndY, y + height);
         }
     }
 
+    // Uploads the rows of the cache that glyphs were added to, in one texture update
+    static void UploadGlyphCache(HFontMap font_map)
+    {
+        if (font_map->m_CacheDirtyStartY == font_map->m_CacheDirtyEndY)
+            return;
+
+        DM_PROFILE("UploadGlyphCache");
+
+        uint32_t start_y = font_map->m_CacheDirtyStartY;
+        uint32_t end_y = dmMath::Min(font_map->m_CacheDirtyEndY, font_map->m_CacheHeight);
+        uint32_t stride = font_map->m_CacheWidth * font_map->m_CacheChannels;
+
+        dmGraphics::TextureParams tex_params;
+        tex_params.m_SubUpdate = true;
+        tex_params.m_MipMap = 0;
+        tex_params.m_Format = font_map->m_CacheFormat;
+        tex_params.m_MinFilter = font_map->m_MinFilter;
+        tex_params.m_MagFilter = font_map->m_MagFilter;
+        tex_params.m_X = 0;
+        tex_params.m_Y = start_y;
+        tex_params.m_Width = font_map->m_CacheWidth;
+        tex_params.m_Height = end_y - start_y;
+        tex_params.m_Data = font_map->m_CacheData + start_y * stride;
+        tex_params.m_DataSize = (end_y - start_y) * stride;
+        dmGraphics::SetTexture(font_map->m_Texture, tex_params);
+
+        font_map->m_CacheDirtyStartY = 0;
+        font_map->m_CacheDirtyEndY = 0;
+    }
+
     static int CreateFontVertexDataInternal(TextContext& text_context, HFontMap font_map, const char* text, const TextEntry& te, float recip_w, float recip_h, GlyphVertex* vertices, uint32_t num_vertices)
     {
-        float width = te.m_Width;
-        if (!te.m_LineBreak) {
-            width = FLT_MAX;
-        }
         float line_height = font_map->m_MaxAscent + font_map->m_MaxDescent;
         float leading = line_height * te.m_Leading;
         float tracking = line_height * te.m_Tracking;
 
-        const uint32_t max_lines = 128;
-        TextLine lines[max_lines];
-
-        // Trailing space characters should be ignored when measuring and
-        // rendering multiline text.
-        // For single line text we still want to include spaces when the text
-        // layout is calculated (https://github.com/defold/defold/issues/5911)
-        bool measure_trailing_space = !te.m_LineBreak;
-
-        LayoutMetrics lm(font_map, tracking);
-        float layout_width;
-        int line_count = Layout(text, width, lines, max_lines, &layout_width, lm, measure_trailing_space);
+        const TextLayout* layout = GetTextLayout(font_map, text, te.m_Width, te.m_LineBreak, te.m_Tracking);
+        const TextLayoutLine* lines = layout->m_Lines.Begin();
+        Glyph* const* glyphs = layout->m_Glyphs.Begin();
+        int line_count = layout->m_Lines.Size();
         float x_offset = OffsetX(te.m_Align, te.m_Width);
         float y_offset = OffsetY(te.m_VAlign, te.m_Height, font_map->m_MaxAscent, font_map->m_MaxDescent, te.m_Leading, line_count);
 
@@ -786,19 +1085,12 @@ namespace dmRender
             // Calculate number of valid glyphs
             for (int line = 0; line < line_count; ++line)
             {
-                TextLine& l = lines[line];
-                const char* cursor = &text[l.m_Index];
+                const TextLayoutLine& l = lines[line];
                 bool inner_break = false;
 
-                for (int j = 0; j < l.m_Count; ++j)
+                for (uint32_t j = 0; j < l.m_GlyphCount; ++j)
                 {
-                    uint32_t c = dmUtf8::NextChar(&cursor);
-                    Glyph* g   = GetGlyph(font_map, c);
-
-                    if (!g)
-                    {
-                        continue;
-                    }
+                    Glyph* g = glyphs[l.m_GlyphStart + j];
 
                     if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
                     {
@@ -819,6 +1111,7 @@ namespace dmRender
 
                         if (g->m_InCache)
                         {
+                            TouchGlyph(font_map, text_context, g);
                             valid_glyph_count++;
 
                             vertexindex += vertices_per_quad;
@@ -836,19 +1129,12 @@ namespace dmRender
         }
 
         for (int line = 0; line < line_count; ++line) {
-            TextLine& l = lines[line];
+            const TextLayoutLine& l = lines[line];
             int16_t x = (int16_t)(x_offset - OffsetX(te.m_Align, l.m_Width) + 0.5f);
             int16_t y = (int16_t) (y_offset - line * leading + 0.5f);
-            const char* cursor = &text[l.m_Index];
-            int n = l.m_Count;
-            for (int j = 0; j < n; ++j)
+            for (uint32_t j = 0; j < l.m_GlyphCount; ++j)
             {
-                uint32_t c = dmUtf8::NextChar(&cursor);
-
-                Glyph* g =  GetGlyph(font_map, c);
-                if (!g) {
-                    continue;
-                }
+                Glyph* g = glyphs[l.m_GlyphStart + j];
 
                 // Look ahead and see if we can produce vertices for the next glyph or not
                 if ((vertexindex + vertices_per_quad) * layer_count > num_vertices)
@@ -871,7 +1157,7 @@ namespace dmRender
                     }
 
                     if (g->m_InCache) {
-                        g->m_Frame = text_context.m_Frame;
+                        TouchGlyph(font_map, text_context, g);
 
                         uint32_t face_index = vertexindex + vertices_per_quad * valid_glyph_count * (layer_count-1);
 
@@ -1089,6 +1375,8 @@ namespace dmRender
 
         ro->m_VertexCount = text_context.m_VertexIndex - ro->m_VertexStart;
 
+        UploadGlyphCache(font_map);
+
         dmRender::AddToRender(render_context, ro);
     }
 
@@ -1222,25 +1510,11 @@ namespace dmRender
         metrics->m_MaxAscent = font_map->m_MaxAscent;
         metrics->m_MaxDescent = font_map->m_MaxDescent;
 
-        if (!line_break) {
-            width = FLT_MAX;
-        }
-
-        const uint32_t max_lines = 128;
-        dmRender::TextLine lines[max_lines];
-
         float line_height = font_map->m_MaxAscent + font_map->m_MaxDescent;
 
-        // Trailing space characters should be ignored when measuring and
-        // rendering multiline text.
-        // For single line text we still want to include spaces when the text
-        // layout is calculated (https://github.com/defold/defold/issues/5911)
-        bool measure_trailing_space = !line_break;
-
-        LayoutMetrics lm(font_map, tracking * line_height);
-        float layout_width;
-        uint32_t num_lines = Layout(text, width, lines, max_lines, &layout_width, lm, measure_trailing_space);
-        metrics->m_Width = layout_width;
+        const TextLayout* layout = GetTextLayout(font_map, text, width, line_break, tracking);
+        uint32_t num_lines = layout->m_Lines.Size();
+        metrics->m_Width = layout->m_Width;
         metrics->m_Height = num_lines * (line_height * leading) - line_height * (leading - 1.0f);
         metrics->m_LineCount = num_lines;
     }
@@ -1268,5 +1542,28 @@ namespace dmRender
     {
         return font_map->m_GlyphData;
     }
+
+    Glyph* GetFontMapGlyph(HFontMap font_map, uint32_t c)
+    {
+        return font_map->m_Glyphs.Get(c);
+    }
+
+    const uint8_t* GetGlyphCacheData(HFontMap font_map)
+    {
+        return font_map->m_CacheData;
+    }
+
+    bool CacheGlyph(HFontMap font_map, TextContext& text_context, Glyph* g)
+    {
+        if (!g->m_InCache)
+        {
+            AddGlyphToCache(font_map, text_context, g, font_map->m_CacheCellMaxAscent - (int16_t)g->m_Ascent);
+        }
+        if (g->m_InCache)
+        {
+            TouchGlyph(font_map, text_context, g);
+        }
+        return g->m_InCache;
+    }
     // Test functions end
 }
@@ -162,10 +162,16 @@ namespace dmRender
         }
     }
 
+    struct TextContext;
+
     // Used in unit tests
     bool VerifyFontMapMinFilter(dmRender::HFontMap font_map, dmGraphics::TextureFilter filter);
     bool VerifyFontMapMagFilter(dmRender::HFontMap font_map, dmGraphics::TextureFilter filter);
     const void* GetGlyphData(dmRender::HFontMap font_map);
+    Glyph* GetFontMapGlyph(HFontMap font_map, uint32_t c);
+    const uint8_t* GetGlyphCacheData(HFontMap font_map);
+    // Adds the glyph to the cache if needed and marks it as used, as when it's rendered. Returns true if the glyph is cached.
+    bool CacheGlyph(HFontMap font_map, TextContext& text_context, Glyph* g);
 }
 
 #endif // #ifndef DM_FONT_RENDERER_PRIVATE
@@ -31,13 +31,15 @@ namespace dmRender
 
     static dmGraphics::VertexAttribute::SemanticType GetAttributeSemanticType(dmhash_t from_hash)
     {
-        if      (from_hash == VERTEX_STREAM_POSITION)   return dmGraphics::VertexAttribute::SEMANTIC_TYPE_POSITION;
-        else if (from_hash == VERTEX_STREAM_TEXCOORD0)  return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD;
-        else if (from_hash == VERTEX_STREAM_TEXCOORD1)  return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD;
-        else if (from_hash == VERTEX_STREAM_COLOR)      return dmGraphics::VertexAttribute::SEMANTIC_TYPE_COLOR;
-        else if (from_hash == VERTEX_STREAM_PAGE_INDEX) return dmGraphics::VertexAttribute::SEMANTIC_TYPE_PAGE_INDEX;
-        else if (from_hash == VERTEX_STREAM_NORMAL)     return dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL;
-        else if (from_hash == VERTEX_STREAM_TANGENT)    return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TANGENT;
+        if      (from_hash == VERTEX_STREAM_POSITION)      return dmGraphics::VertexAttribute::SEMANTIC_TYPE_POSITION;
+        else if (from_hash == VERTEX_STREAM_TEXCOORD0)     return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD;
+        else if (from_hash == VERTEX_STREAM_TEXCOORD1)     return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TEXCOORD;
+        else if (from_hash == VERTEX_STREAM_COLOR)         return dmGraphics::VertexAttribute::SEMANTIC_TYPE_COLOR;
+        else if (from_hash == VERTEX_STREAM_PAGE_INDEX)    return dmGraphics::VertexAttribute::SEMANTIC_TYPE_PAGE_INDEX;
+        else if (from_hash == VERTEX_STREAM_NORMAL)        return dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL;
+        else if (from_hash == VERTEX_STREAM_TANGENT)       return dmGraphics::VertexAttribute::SEMANTIC_TYPE_TANGENT;
+        else if (from_hash == VERTEX_STREAM_WORLD_MATRIX)  return dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX;
+        else if (from_hash == VERTEX_STREAM_NORMAL_MATRIX) return dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL_MATRIX;
         return dmGraphics::VertexAttribute::SEMANTIC_TYPE_NONE;
     }
 
@@ -77,8 +79,14 @@ namespace dmRender
         {
             dmGraphics::DeleteVertexDeclaration(m->m_VertexDeclaration);
         }
+        if (m->m_InstanceVertexDeclaration != 0)
+        {
+            dmGraphics::DeleteVertexDeclaration(m->m_InstanceVertexDeclaration);
+            m->m_InstanceVertexDeclaration = 0;
+        }
 
         dmGraphics::HVertexStreamDeclaration stream_declaration = dmGraphics::NewVertexStreamDeclaration(graphics_context);
+        dmGraphics::HVertexStreamDeclaration instance_stream_declaration = 0;
 
         for (int i = 0; i < m->m_MaterialAttributes.Size(); ++i)
         {
@@ -89,10 +97,33 @@ namespace dmRender
                 graphics_attribute.m_ElementCount,
                 dmGraphics::GetGraphicsType(graphics_attribute.m_DataType),
                 graphics_attribute.m_Normalize);
+
+            // Per-instance attributes are also gathered in a separate declaration that is bound
+            // to its own vertex buffer when a component issues instanced draw calls.
+            if (graphics_attribute.m_StepFunction == dmGraphics::VertexAttribute::STEP_FUNCTION_INSTANCE)
+            {
+                if (instance_stream_declaration == 0)
+                {
+                    instance_stream_declaration = dmGraphics::NewVertexStreamDeclaration(graphics_context);
+                }
+
+                dmGraphics::AddVertexStream(instance_stream_declaration,
+                    graphics_attribute.m_NameHash,
+                    graphics_attribute.m_ElementCount,
+                    dmGraphics::GetGraphicsType(graphics_attribute.m_DataType),
+                    graphics_attribute.m_Normalize);
+            }
         }
 
         m->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, stream_declaration);
         dmGraphics::DeleteVertexStreamDeclaration(stream_declaration);
+
+        if (instance_stream_declaration != 0)
+        {
+            m->m_InstanceVertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, instance_stream_declaration);
+            dmGraphics::SetVertexDeclarationStepFunction(graphics_context, m->m_InstanceVertexDeclaration, dmGraphics::VERTEX_STEP_FUNCTION_INSTANCE);
+            dmGraphics::DeleteVertexStreamDeclaration(instance_stream_declaration);
+        }
     }
 
     static void CreateAttributes(dmGraphics::HContext graphics_context, Material* m)
@@ -122,6 +153,14 @@ namespace dmRender
             vertex_attribute.m_ElementCount    = element_count;
             vertex_attribute.m_Normalize       = false;
             vertex_attribute.m_CoordinateSpace = dmGraphics::COORDINATE_SPACE_WORLD;
+            vertex_attribute.m_StepFunction    = dmGraphics::VertexAttribute::STEP_FUNCTION_VERTEX;
+
+            // Transform matrices are per-instance data unless the material says otherwise
+            if (vertex_attribute.m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX ||
+                vertex_attribute.m_SemanticType == dmGraphics::VertexAttribute::SEMANTIC_TYPE_NORMAL_MATRIX)
+            {
+                vertex_attribute.m_StepFunction = dmGraphics::VertexAttribute::STEP_FUNCTION_INSTANCE;
+            }
 
             MaterialAttribute& material_attribute = m->m_MaterialAttributes[i];
             material_attribute.m_Location         = location;
@@ -185,6 +224,7 @@ namespace dmRender
         m->m_FragmentProgram   = fragment_program;
         m->m_Program           = program;
         m->m_VertexDeclaration = 0;
+        m->m_InstanceVertexDeclaration = 0;
 
         CreateAttributes(graphics_context, m);
         CreateVertexDeclaration(graphics_context, m);
@@ -198,6 +238,10 @@ namespace dmRender
         dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
         dmGraphics::DeleteProgram(graphics_context, material->m_Program);
         dmGraphics::DeleteVertexDeclaration(material->m_VertexDeclaration);
+        if (material->m_InstanceVertexDeclaration)
+        {
+            dmGraphics::DeleteVertexDeclaration(material->m_InstanceVertexDeclaration);
+        }
 
         for (uint32_t i = 0; i < material->m_Constants.Size(); ++i)
         {
@@ -564,6 +608,7 @@ namespace dmRender
             graphics_attribute.m_ElementCount               = graphics_attribute_in.m_ElementCount;
             graphics_attribute.m_SemanticType               = graphics_attribute_in.m_SemanticType;
             graphics_attribute.m_CoordinateSpace            = graphics_attribute_in.m_CoordinateSpace;
+            graphics_attribute.m_StepFunction               = graphics_attribute_in.m_StepFunction;
 
             update_attributes = true;
         }
@@ -685,6 +730,11 @@ namespace dmRender
         return material->m_VertexDeclaration;
     }
 
+    dmGraphics::HVertexDeclaration GetInstanceVertexDeclaration(HMaterial material)
+    {
+        return material->m_InstanceVertexDeclaration;
+    }
+
     HRenderContext GetMaterialRenderContext(HMaterial material)
     {
         return material->m_RenderContext;
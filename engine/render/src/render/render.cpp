@@ -21,6 +21,7 @@
 #include <dlib/hashtable.h>
 #include <dlib/profile.h>
 #include <dlib/math.h>
+#include <dlib/memprofile.h>
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/dlib/intersection.h>
 
@@ -76,6 +77,7 @@ namespace dmRender
     RenderContextParams::RenderContextParams()
     : m_ScriptContext(0x0)
     , m_SystemFontMap(0)
+    , m_FrameArena(0x0)
     , m_VertexShaderDesc(0x0)
     , m_FragmentShaderDesc(0x0)
     , m_MaxRenderTypes(0)
@@ -115,6 +117,7 @@ namespace dmRender
         context->m_ViewProj = context->m_Projection * context->m_View;
 
         context->m_ScriptContext = params.m_ScriptContext;
+        context->m_FrameArena = params.m_FrameArena;
         InitializeRenderScriptContext(context->m_RenderScriptContext, graphics_context, params.m_ScriptContext, params.m_CommandBufferSize);
         context->m_ScriptWorld = dmScript::NewScriptWorld(context->m_ScriptContext);
 
@@ -164,6 +167,10 @@ namespace dmRender
         return render_context->m_ScriptContext;
     }
 
+    dmFrameArena::HArena GetFrameArena(HRenderContext render_context) {
+        return render_context->m_FrameArena;
+    }
+
     void RenderListBegin(HRenderContext render_context)
     {
         render_context->m_RenderList.SetSize(0);
@@ -796,6 +803,7 @@ namespace dmRender
     Result DrawRenderList(HRenderContext context, HPredicate predicate, HNamedConstantBuffer constant_buffer, const FrustumOptions* frustum_options)
     {
         DM_PROFILE("DrawRenderList");
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RENDER);
 
         // This will add new entries for the most recent debug draw render objects.
         // The internal dispatch functions knows to only actually use the latest ones.
@@ -922,6 +930,8 @@ namespace dmRender
         if (render_context == 0x0)
             return RESULT_INVALID_CONTEXT;
 
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RENDER);
+
         dmGraphics::HContext context = dmRender::GetGraphicsContext(render_context);
         dmGraphics::HTexture render_context_textures[RenderObject::MAX_TEXTURE_COUNT];
         memset(render_context_textures, 0, sizeof(render_context_textures));
@@ -1010,10 +1020,11 @@ namespace dmRender
                 }
             }
 
+            uint32_t instance_count = dmMath::Max(ro->m_InstanceCount, 1u);
             if (ro->m_IndexBuffer)
-                dmGraphics::DrawElements(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer);
+                dmGraphics::DrawElements(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer, instance_count);
             else
-                dmGraphics::Draw(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount);
+                dmGraphics::Draw(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, instance_count);
 
             for (int i = 0; i < RenderObject::MAX_VERTEX_BUFFER_COUNT; ++i)
             {
@@ -21,6 +21,7 @@
 #include <dmsdk/render/render.h>
 
 #include <dlib/hash.h>
+#include <dlib/frame_arena.h>
 #include <script/script.h>
 #include <script/lua_source_ddf.h>
 #include <graphics/graphics.h>
@@ -32,13 +33,15 @@ namespace dmRender
 
     static const uint32_t MAX_MATERIAL_TAG_COUNT = 32; // Max tag count per material
 
-    static const dmhash_t VERTEX_STREAM_POSITION   = dmHashString64("position");
-    static const dmhash_t VERTEX_STREAM_NORMAL     = dmHashString64("normal");
-    static const dmhash_t VERTEX_STREAM_TANGENT    = dmHashString64("tangent");
-    static const dmhash_t VERTEX_STREAM_COLOR      = dmHashString64("color");
-    static const dmhash_t VERTEX_STREAM_TEXCOORD0  = dmHashString64("texcoord0");
-    static const dmhash_t VERTEX_STREAM_TEXCOORD1  = dmHashString64("texcoord1");
-    static const dmhash_t VERTEX_STREAM_PAGE_INDEX = dmHashString64("page_index");
+    static const dmhash_t VERTEX_STREAM_POSITION      = dmHashConstString64("position");
+    static const dmhash_t VERTEX_STREAM_NORMAL        = dmHashConstString64("normal");
+    static const dmhash_t VERTEX_STREAM_TANGENT       = dmHashConstString64("tangent");
+    static const dmhash_t VERTEX_STREAM_COLOR         = dmHashConstString64("color");
+    static const dmhash_t VERTEX_STREAM_TEXCOORD0     = dmHashConstString64("texcoord0");
+    static const dmhash_t VERTEX_STREAM_TEXCOORD1     = dmHashConstString64("texcoord1");
+    static const dmhash_t VERTEX_STREAM_PAGE_INDEX    = dmHashConstString64("page_index");
+    static const dmhash_t VERTEX_STREAM_WORLD_MATRIX  = dmHashConstString64("mtx_world");
+    static const dmhash_t VERTEX_STREAM_NORMAL_MATRIX = dmHashConstString64("mtx_normal");
 
     typedef struct RenderTargetSetup*       HRenderTargetSetup;
     typedef uint64_t                        HRenderType;
@@ -120,6 +123,8 @@ namespace dmRender
 
         dmScript::HContext              m_ScriptContext;
         HFontMap                        m_SystemFontMap;
+        /// Arena for transient data, reset after each frame. Optional.
+        dmFrameArena::HArena            m_FrameArena;
         void*                           m_VertexShaderDesc;
         void*                           m_FragmentShaderDesc;
         uint32_t                        m_MaxRenderTypes;
@@ -143,6 +148,13 @@ namespace dmRender
 
     dmScript::HContext GetScriptContext(HRenderContext render_context);
 
+    /**
+     * Get the arena for transient per frame data
+     * @param render_context Render context
+     * @return The frame arena, or 0 if there is none
+     */
+    dmFrameArena::HArena GetFrameArena(HRenderContext render_context);
+
     void RenderListBegin(HRenderContext render_context);
     void RenderListEnd(HRenderContext render_context);
 
@@ -248,6 +260,7 @@ namespace dmRender
     };
 
     dmGraphics::HVertexDeclaration  GetVertexDeclaration(HMaterial material);
+    dmGraphics::HVertexDeclaration  GetInstanceVertexDeclaration(HMaterial material);
     bool                            GetMaterialProgramAttributeInfo(HMaterial material, dmhash_t name_hash, MaterialProgramAttributeInfo& info);
     void                            GetMaterialProgramAttributes(HMaterial material, const dmGraphics::VertexAttribute** attributes, uint32_t* attribute_count);
     void                            GetMaterialProgramAttributeValues(HMaterial material, uint32_t index, const uint8_t** value_ptr, uint32_t* num_values);
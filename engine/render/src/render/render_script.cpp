@@ -3472,7 +3472,7 @@ bail:
                     }
                     if (message->m_DataSize > 0)
                     {
-                        dmScript::PushTable(L, (const char*)message->m_Data, message->m_DataSize);
+                        dmScript::PushTable(L, (const char*)dmMessage::GetData(message), message->m_DataSize);
                     }
                     else
                     {
@@ -217,6 +217,52 @@ TEST_F(dmRenderMaterialTest, TestMaterialVertexAttributes)
     dmRender::DeleteMaterial(m_RenderContext, material);
 }
 
+TEST_F(dmRenderMaterialTest, TestMaterialInstanceAttributes)
+{
+    const char* vs_src = \
+       "attribute vec4 position;\n \
+        attribute mat4 mtx_world;\n";
+
+    dmGraphics::ShaderDesc::Shader vp_shader = MakeDDFShader(vs_src, strlen(vs_src));
+    dmGraphics::HVertexProgram vp            = dmGraphics::NewVertexProgram(m_GraphicsContext, &vp_shader);
+
+    dmGraphics::ShaderDesc::Shader fp_shader = MakeDDFShader("foo", 3);
+    dmGraphics::HFragmentProgram fp          = dmGraphics::NewFragmentProgram(m_GraphicsContext, &fp_shader);
+    dmRender::HMaterial material             = dmRender::NewMaterial(m_RenderContext, vp, fp);
+
+    const dmGraphics::VertexAttribute* attributes;
+    uint32_t attribute_count;
+    dmRender::GetMaterialProgramAttributes(material, &attributes, &attribute_count);
+    ASSERT_EQ(2, attribute_count);
+
+    ASSERT_EQ(dmGraphics::VertexAttribute::SEMANTIC_TYPE_POSITION, attributes[0].m_SemanticType);
+    ASSERT_EQ(dmGraphics::VertexAttribute::STEP_FUNCTION_VERTEX, attributes[0].m_StepFunction);
+
+    // The world matrix is a per-instance attribute by default
+    ASSERT_EQ(dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX, attributes[1].m_SemanticType);
+    ASSERT_EQ(dmGraphics::VertexAttribute::STEP_FUNCTION_INSTANCE, attributes[1].m_StepFunction);
+    ASSERT_EQ(16, attributes[1].m_ElementCount);
+
+    dmGraphics::HVertexDeclaration instance_decl = dmRender::GetInstanceVertexDeclaration(material);
+    ASSERT_NE((dmGraphics::HVertexDeclaration) 0, instance_decl);
+    ASSERT_EQ(16 * sizeof(float), dmGraphics::GetVertexDeclarationStride(instance_decl));
+
+    // Overriding the step function moves the attribute back to the per-vertex declaration
+    dmGraphics::VertexAttribute attribute_override = {};
+    attribute_override.m_NameHash     = dmHashString64("mtx_world");
+    attribute_override.m_ElementCount = 16;
+    attribute_override.m_DataType     = dmGraphics::VertexAttribute::TYPE_FLOAT;
+    attribute_override.m_SemanticType = dmGraphics::VertexAttribute::SEMANTIC_TYPE_WORLD_MATRIX;
+    attribute_override.m_StepFunction = dmGraphics::VertexAttribute::STEP_FUNCTION_VERTEX;
+    dmRender::SetMaterialProgramAttributes(material, &attribute_override, 1);
+
+    ASSERT_EQ((dmGraphics::HVertexDeclaration) 0, dmRender::GetInstanceVertexDeclaration(material));
+
+    dmGraphics::DeleteVertexProgram(vp);
+    dmGraphics::DeleteFragmentProgram(fp);
+    dmRender::DeleteMaterial(m_RenderContext, material);
+}
+
 TEST_F(dmRenderMaterialTest, TestMaterialConstantsOverride)
 {
     // create default material
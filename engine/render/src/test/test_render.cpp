@@ -20,6 +20,7 @@
 #include <testmain/testmain.h>
 #include <dlib/hash.h>
 #include <dlib/math.h>
+#include <dlib/dstrings.h>
 
 #include <script/script.h>
 #include <algorithm> // std::stable_sort
@@ -135,6 +136,118 @@ TEST_F(dmRenderTest, TestFontMapTextureFiltering)
     dmRender::DeleteFontMap(bitmap_font_map);
 }
 
+static void AssertGlyphCacheCell(dmRender::HFontMap font_map, uint32_t cache_width, const dmRender::Glyph* g, uint8_t value)
+{
+    const uint8_t* data = dmRender::GetGlyphCacheData(font_map);
+    for (uint32_t y = 0; y < g->m_Ascent + g->m_Descent; ++y)
+    {
+        for (uint32_t x = 0; x < g->m_Width; ++x)
+        {
+            ASSERT_EQ(value, data[(g->m_Y + y) * cache_width + g->m_X + x]);
+        }
+    }
+}
+
+TEST_F(dmRenderTest, GlyphCache)
+{
+    // Four cache cells, and glyphs of 2x3 uncompressed pixels
+    const uint32_t cache_width = 16;
+    const uint32_t glyph_count = 6;
+    const uint32_t glyph_data_size = 1 + 2 * 3;
+    uint8_t glyph_data[glyph_count * glyph_data_size];
+
+    dmRender::FontMapParams font_map_params;
+    font_map_params.m_CacheWidth = cache_width;
+    font_map_params.m_CacheHeight = 16;
+    font_map_params.m_CacheCellWidth = 8;
+    font_map_params.m_CacheCellHeight = 8;
+    font_map_params.m_CacheCellMaxAscent = 2;
+    font_map_params.m_MaxAscent = 2;
+    font_map_params.m_MaxDescent = 1;
+    font_map_params.m_GlyphChannels = 1;
+    font_map_params.m_GlyphData = glyph_data;
+    font_map_params.m_Glyphs.SetCapacity(glyph_count);
+    font_map_params.m_Glyphs.SetSize(glyph_count);
+    memset((void*)&font_map_params.m_Glyphs[0], 0, sizeof(dmRender::Glyph)*glyph_count);
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        font_map_params.m_Glyphs[i].m_Character = 'a' + i;
+        font_map_params.m_Glyphs[i].m_Width = 2;
+        font_map_params.m_Glyphs[i].m_Advance = 3;
+        font_map_params.m_Glyphs[i].m_Ascent = 2;
+        font_map_params.m_Glyphs[i].m_Descent = 1;
+        font_map_params.m_Glyphs[i].m_GlyphDataOffset = i * glyph_data_size;
+        font_map_params.m_Glyphs[i].m_GlyphDataSize = glyph_data_size;
+
+        // Not compressed, and each glyph filled with its own value
+        glyph_data[i * glyph_data_size] = 0;
+        memset(&glyph_data[i * glyph_data_size + 1], i + 1, glyph_data_size - 1);
+    }
+    dmRender::HFontMap font_map = dmRender::NewFontMap(m_GraphicsContext, font_map_params);
+
+    dmRender::Glyph* glyphs[glyph_count];
+    for (uint32_t i = 0; i < glyph_count; ++i)
+    {
+        glyphs[i] = dmRender::GetFontMapGlyph(font_map, 'a' + i);
+        ASSERT_NE((dmRender::Glyph*)0, glyphs[i]);
+        ASSERT_FALSE(glyphs[i]->m_InCache);
+    }
+
+    dmRender::TextContext text_context;
+    text_context.m_Frame = 1;
+
+    // The glyphs are added to the free cells
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[i]));
+        AssertGlyphCacheCell(font_map, cache_width, glyphs[i], i + 1);
+        for (uint32_t j = 0; j < i; ++j)
+        {
+            ASSERT_FALSE(glyphs[i]->m_X == glyphs[j]->m_X && glyphs[i]->m_Y == glyphs[j]->m_Y);
+        }
+    }
+
+    // All cells are used this frame
+    ASSERT_FALSE(dmRender::CacheGlyph(font_map, text_context, glyphs[4]));
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(glyphs[i]->m_InCache);
+    }
+
+    // 'a' is the least recently used glyph, and is replaced
+    text_context.m_Frame = 2;
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[1]));
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[2]));
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[3]));
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[4]));
+    ASSERT_FALSE(glyphs[0]->m_InCache);
+    ASSERT_EQ(glyphs[0]->m_X, glyphs[4]->m_X);
+    ASSERT_EQ(glyphs[0]->m_Y, glyphs[4]->m_Y);
+    AssertGlyphCacheCell(font_map, cache_width, glyphs[4], 5);
+
+    // 'b' was used before 'd', and is replaced even though it was added later than 'e'
+    text_context.m_Frame = 3;
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[4]));
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[2]));
+    int32_t d_x = glyphs[3]->m_X;
+    int32_t d_y = glyphs[3]->m_Y;
+    ASSERT_TRUE(dmRender::CacheGlyph(font_map, text_context, glyphs[5]));
+    ASSERT_FALSE(glyphs[1]->m_InCache);
+    ASSERT_TRUE(glyphs[3]->m_InCache);
+    ASSERT_EQ(glyphs[1]->m_X, glyphs[5]->m_X);
+    ASSERT_EQ(glyphs[1]->m_Y, glyphs[5]->m_Y);
+    AssertGlyphCacheCell(font_map, cache_width, glyphs[5], 6);
+
+    // The glyphs that stay in the cache keep their cell and pixels
+    ASSERT_EQ(d_x, glyphs[3]->m_X);
+    ASSERT_EQ(d_y, glyphs[3]->m_Y);
+    AssertGlyphCacheCell(font_map, cache_width, glyphs[2], 3);
+    AssertGlyphCacheCell(font_map, cache_width, glyphs[3], 4);
+    AssertGlyphCacheCell(font_map, cache_width, glyphs[4], 5);
+
+    dmRender::DeleteFontMap(font_map);
+}
+
 TEST_F(dmRenderTest, TestGraphicsContext)
 {
     ASSERT_NE((void*)0x0, dmRender::GetGraphicsContext(m_Context));
@@ -1375,6 +1488,54 @@ TEST_F(dmRenderTest, GetTextMetrics)
     ASSERT_EQ(numlines, metrics.m_LineCount);
 }
 
+TEST_F(dmRenderTest, GetTextMetricsCached)
+{
+    dmRender::TextMetrics metrics;
+
+    const int charwidth     = 2;
+    const int lineheight    = 3;
+
+    // Same text, different layout parameters
+    dmRender::GetTextMetrics(m_SystemFontMap, "Hello World", 0, false, 1.0f, 0.0f, &metrics);
+    ASSERT_EQ(charwidth*11, metrics.m_Width);
+    ASSERT_EQ(1U, metrics.m_LineCount);
+
+    dmRender::GetTextMetrics(m_SystemFontMap, "Hello World", 8*charwidth, true, 1.0f, 0.0f, &metrics);
+    ASSERT_EQ(charwidth*5, metrics.m_Width);
+    ASSERT_EQ(2U, metrics.m_LineCount);
+
+    // Leading isn't part of the layout, only the height
+    dmRender::GetTextMetrics(m_SystemFontMap, "Hello World", 8*charwidth, true, 2.0f, 0.0f, &metrics);
+    ASSERT_EQ(charwidth*5, metrics.m_Width);
+    ASSERT_EQ(ExpectedHeight(lineheight, 2, 2.0f), metrics.m_Height);
+
+    // Fill the cache with more texts than it can hold, while a recently used text is kept
+    char text[32];
+    for (uint32_t i = 0; i < 2000; ++i)
+    {
+        dmSnPrintf(text, sizeof(text), "%u", i);
+        dmRender::GetTextMetrics(m_SystemFontMap, text, 0, false, 1.0f, 0.0f, &metrics);
+        ASSERT_EQ(charwidth*(float)strlen(text), metrics.m_Width);
+
+        dmRender::GetTextMetrics(m_SystemFontMap, "Hello World", 8*charwidth, true, 1.0f, 0.0f, &metrics);
+        ASSERT_EQ(charwidth*5, metrics.m_Width);
+        ASSERT_EQ(2U, metrics.m_LineCount);
+    }
+
+    // Evicted layouts are reused for longer texts
+    for (uint32_t i = 0; i < 600; ++i)
+    {
+        dmSnPrintf(text, sizeof(text), "Hello %u", i);
+        dmRender::GetTextMetrics(m_SystemFontMap, text, 0, false, 1.0f, 0.0f, &metrics);
+        ASSERT_EQ(charwidth*(float)strlen(text), metrics.m_Width);
+        ASSERT_EQ(1U, metrics.m_LineCount);
+    }
+
+    dmRender::GetTextMetrics(m_SystemFontMap, "Hello World", 0, false, 1.0f, 0.0f, &metrics);
+    ASSERT_EQ(charwidth*11, metrics.m_Width);
+    ASSERT_EQ(1U, metrics.m_LineCount);
+}
+
 TEST_F(dmRenderTest, GetTextMetricsMeasureTrailingSpace)
 {
     dmRender::TextMetrics metricsHello;
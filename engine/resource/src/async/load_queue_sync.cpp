@@ -18,6 +18,7 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
+#include <dlib/memprofile.h>
 
 namespace dmLoadQueue
 {
@@ -79,6 +80,7 @@ namespace dmLoadQueue
 
         if (load_result->m_LoadResult == dmResource::RESULT_OK && request->m_PreloadInfo.m_CompleteFunction)
         {
+            DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
             dmResource::ResourcePreloadParams params;
             params.m_Factory             = queue->m_Factory;
             params.m_Context             = request->m_PreloadInfo.m_Context;
@@ -19,6 +19,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/array.h>
+#include <dlib/memprofile.h>
 #include <dlib/thread.h>
 #include <dlib/mutex.h>
 #include <dlib/time.h>
@@ -148,6 +149,7 @@ namespace dmLoadQueue
                     assert(current->m_Buffer.Size() == size);
                     if (current->m_PreloadInfo.m_CompleteFunction)
                     {
+                        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
                         dmResource::ResourcePreloadParams params;
                         params.m_Factory       = queue->m_Factory;
                         params.m_Context       = current->m_PreloadInfo.m_Context;
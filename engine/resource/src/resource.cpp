@@ -27,11 +27,13 @@
 #include <dlib/crypt.h>
 #include <dlib/dalloca.h>
 #include <dlib/dstrings.h>
+#include <dlib/flat_hashtable.h>
 #include <dlib/hash.h>
 #include <dlib/hashtable.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
 #include <dlib/memory.h>
+#include <dlib/memprofile.h>
 #include <dlib/message.h>
 #include <dlib/mutex.h>
 #include <dlib/path.h>
@@ -88,10 +90,10 @@ struct SResourceFactory
 {
     // TODO: Arg... budget. Two hash-maps. Really necessary?
     dmHashTable64<SResourceDescriptor>*          m_Resources;
-    dmHashTable<uintptr_t, uint64_t>*            m_ResourceToHash;
+    dmFlatHashTable<uintptr_t, uint64_t>*        m_ResourceToHash;
     // Only valid if RESOURCE_FACTORY_FLAGS_RELOAD_SUPPORT is set
     // Used for reloading of resources
-    dmHashTable64<const char*>*                  m_ResourceHashToFilename;
+    dmFlatHashTable64<const char*>*              m_ResourceHashToFilename;
     // Only valid if RESOURCE_FACTORY_FLAGS_RELOAD_SUPPORT is set
     dmArray<ResourceReloadedCallbackPair>*       m_ResourceReloadedCallbacks;
     SResourceType                                m_ResourceTypes[MAX_RESOURCE_TYPES];
@@ -338,13 +340,13 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     factory->m_Resources = new dmHashTable64<SResourceDescriptor>();
     factory->m_Resources->SetCapacity(table_size, params->m_MaxResources);
 
-    factory->m_ResourceToHash = new dmHashTable<uintptr_t, uint64_t>();
-    factory->m_ResourceToHash->SetCapacity(table_size, params->m_MaxResources);
+    factory->m_ResourceToHash = new dmFlatHashTable<uintptr_t, uint64_t>();
+    factory->m_ResourceToHash->SetCapacity(params->m_MaxResources);
 
     if (params->m_Flags & RESOURCE_FACTORY_FLAGS_RELOAD_SUPPORT)
     {
-        factory->m_ResourceHashToFilename = new dmHashTable64<const char*>();
-        factory->m_ResourceHashToFilename->SetCapacity(table_size, params->m_MaxResources);
+        factory->m_ResourceHashToFilename = new dmFlatHashTable64<const char*>();
+        factory->m_ResourceHashToFilename->SetCapacity(params->m_MaxResources);
 
         factory->m_ResourceReloadedCallbacks = new dmArray<ResourceReloadedCallbackPair>();
         factory->m_ResourceReloadedCallbacks->SetCapacity(256);
@@ -589,6 +591,8 @@ const char* GetExtFromPath(const char* path)
 static Result DoCreateResource(HFactory factory, SResourceType* resource_type, const char* name, const char* canonical_path,
     dmhash_t canonical_path_hash, void* buffer, uint32_t buffer_size, void** resource_out)
 {
+    DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
+
     // TODO: We should *NOT* allocate SResource dynamically...
     SResourceDescriptor tmp_resource;
     memset(&tmp_resource, 0, sizeof(tmp_resource));
@@ -945,6 +949,7 @@ static Result DoReloadResource(HFactory factory, const char* name, SResourceDesc
     params.m_Resource = rd;
     params.m_Filename = name;
     rd->m_PrevResource = 0;
+    DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
     Result create_result = resource_type->m_RecreateFunction(params);
     if (create_result == RESULT_OK)
     {
@@ -1042,6 +1047,7 @@ Result SetResource(HFactory factory, uint64_t hashed_name, void* data, uint32_t
     params.m_Resource = rd;
     params.m_Filename = 0;
     params.m_NameHash = hashed_name;
+    DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
     Result create_result = resource_type->m_RecreateFunction(params);
     if (create_result == RESULT_OK)
     {
@@ -1094,6 +1100,7 @@ Result SetResource(HFactory factory, uint64_t hashed_name, void* message)
     params.m_Resource = rd;
     params.m_Filename = 0;
     params.m_NameHash = hashed_name;
+    DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
     Result create_result = resource_type->m_RecreateFunction(params);
     if (create_result == RESULT_OK)
     {
@@ -1259,10 +1266,12 @@ void Release(HFactory factory, void* resource)
 {
     DM_PROFILE(__FUNCTION__);
 
-    uint64_t* resource_hash = factory->m_ResourceToHash->Get((uintptr_t) resource);
-    assert(resource_hash);
+    uint64_t* resource_hash_ptr = factory->m_ResourceToHash->Get((uintptr_t) resource);
+    assert(resource_hash_ptr);
+    // Copied, since the entry is erased below
+    const uint64_t resource_hash = *resource_hash_ptr;
 
-    SResourceDescriptor* rd = factory->m_Resources->Get(*resource_hash);
+    SResourceDescriptor* rd = factory->m_Resources->Get(resource_hash);
     assert(rd);
     assert(rd->m_ReferenceCount > 0);
     rd->m_ReferenceCount--;
@@ -1280,13 +1289,13 @@ void Release(HFactory factory, void* resource)
         resource_type->m_DestroyFunction(params);
 
         factory->m_ResourceToHash->Erase((uintptr_t) resource);
-        factory->m_Resources->Erase(*resource_hash);
+        factory->m_Resources->Erase(resource_hash);
         if (factory->m_ResourceHashToFilename)
         {
-            const char** s = factory->m_ResourceHashToFilename->Get(*resource_hash);
-            factory->m_ResourceHashToFilename->Erase(*resource_hash);
+            const char** s = factory->m_ResourceHashToFilename->Get(resource_hash);
             assert(s);
             free((void*) *s);
+            factory->m_ResourceHashToFilename->Erase(resource_hash);
         }
     }
 }
@@ -22,6 +22,7 @@
 #include <dlib/hash.h>
 #include <dlib/hashtable.h>
 #include <dlib/log.h>
+#include <dlib/memprofile.h>
 #include <dlib/uri.h>
 #include <dlib/time.h>
 #include <dlib/spinlock.h>
@@ -518,6 +519,8 @@ namespace dmResource
 
         assert(req->m_PathDescriptor.m_ResourceType);
 
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
+
         SResourceDescriptor tmp_resource;
         memset(&tmp_resource, 0, sizeof(tmp_resource));
 
@@ -881,6 +884,7 @@ namespace dmResource
         ResourcePostCreateParams& params     = ip.m_Params;
         params.m_Resource                    = &ip.m_ResourceDesc;
         SResourceType* resource_type         = (SResourceType*)params.m_Resource->m_ResourceType;
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_RESOURCE);
         Result ret                           = resource_type->m_PostCreateFunction(params);
 
         if (ret == RESULT_PENDING)
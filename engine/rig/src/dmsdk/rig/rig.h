@@ -183,6 +183,9 @@ namespace dmRig
     uint8_t* GenerateVertexDataFromAttributes(dmRig::HRigContext context, dmRig::HRigInstance instance, dmRigDDF::Mesh* mesh, const dmVMath::Matrix4& world_matrix, const AttributeInfo* attributes, uint32_t attributes_count, uint32_t vertex_stride, uint8_t* vertex_data_out);
     RigModelVertex* GenerateVertexData(HRigContext context, dmRig::HRigInstance instance, dmRigDDF::Mesh* mesh, const dmVMath::Matrix4& world_matrix, RigModelVertex* vertex_data_out);
     uint32_t GetVertexCount(HRigInstance instance);
+    // Writes the skinning matrices of the current pose (bone model space transform * inverse bind pose), one per bone.
+    // Used to skin the vertices on the GPU instead of generating the vertex data. Returns the bone count.
+    uint32_t GeneratePoseMatrices(HRigInstance instance, dmArray<dmVMath::Matrix4>& out_pose_matrices);
 
     Result SetModel(HRigInstance instance, dmhash_t model_id);
     dmhash_t GetModel(HRigInstance instance);
@@ -25,11 +25,19 @@
 
 #include <stdio.h>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define DM_RIG_SKINNING_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define DM_RIG_SKINNING_NEON
+#endif
+
 namespace dmRig
 {
     using namespace dmVMath;
 
-    static const dmhash_t NULL_ANIMATION = dmHashString64("");
+    static const dmhash_t NULL_ANIMATION = dmHashConstString64("");
     static const float CURSOR_EPSILON = 0.0001f;
 
     static void DoAnimate(HRigContext context, RigInstance* instance, float dt);
@@ -41,6 +49,8 @@ namespace dmRig
         // Temporary scratch buffers used for store pose as transform and matrices
         // (avoids modifying the real pose transform data during rendering).
         dmArray<dmVMath::Matrix4>       m_ScratchPoseMatrixBuffer;
+        // Pose matrices premultiplied with the world (or normal) matrix, used by the skinning kernels
+        dmArray<dmVMath::Matrix4>       m_ScratchSkinMatrixBuffer;
         // Temporary scratch buffers used when transforming the vertex buffer,
         // used to creating primitives from indices.
         dmArray<dmVMath::Vector3>       m_ScratchPositionBuffer;
@@ -775,7 +785,90 @@ namespace dmRig
         return vertex_count;
     }
 
-    static void GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<Matrix4>& pose_matrices, float* normals_buffer, float* tangents_buffer)
+    static void PremultiplySkinMatrices(const Matrix4& matrix, const dmArray<Matrix4>& pose_matrices, dmArray<Matrix4>& out_matrices)
+    {
+        uint32_t bone_count = pose_matrices.Size();
+        if (out_matrices.Capacity() < bone_count) {
+            out_matrices.OffsetCapacity(bone_count - out_matrices.Capacity());
+        }
+        out_matrices.SetSize(bone_count);
+
+        for (uint32_t bi = 0; bi < bone_count; ++bi)
+        {
+            out_matrices[bi] = matrix * pose_matrices[bi];
+        }
+    }
+
+    // Skinning kernel for up to four bone influences per vertex. Each matrix is multiplied with the
+    // weighted input (x, y, z, w) * weight, and the results are summed. The input w is 1 for positions,
+    // and 0 for directions (normals and tangents). As before, the influences end at the first zero weight.
+    // Both the input and output streams are tightly packed xyz triplets.
+    static void SkinVertices(const float* in, const uint32_t* bone_indices, const float* bone_weights, uint32_t vertex_count, const Matrix4* skin_matrices, float in_w, float* out)
+    {
+        DM_STATIC_ASSERT(sizeof(Matrix4) == 16 * sizeof(float), Invalid_Matrix4_Size);
+        const float* matrices = (const float*) skin_matrices; // Column major
+
+#if defined(DM_RIG_SKINNING_SSE)
+        for (uint32_t i = 0; i < vertex_count; ++i, in += 3, out += 3, bone_indices += 4, bone_weights += 4)
+        {
+            __m128 acc = _mm_setzero_ps();
+            for (uint32_t b = 0; b < 4 && bone_weights[b]; ++b)
+            {
+                const float* m = matrices + bone_indices[b] * 16;
+                float w = bone_weights[b];
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(m + 0),  _mm_set1_ps(in[0] * w)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(m + 4),  _mm_set1_ps(in[1] * w)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(m + 8),  _mm_set1_ps(in[2] * w)));
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_set1_ps(in_w * w)));
+            }
+            float result[4];
+            _mm_storeu_ps(result, acc);
+            out[0] = result[0];
+            out[1] = result[1];
+            out[2] = result[2];
+        }
+#elif defined(DM_RIG_SKINNING_NEON)
+        for (uint32_t i = 0; i < vertex_count; ++i, in += 3, out += 3, bone_indices += 4, bone_weights += 4)
+        {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (uint32_t b = 0; b < 4 && bone_weights[b]; ++b)
+            {
+                const float* m = matrices + bone_indices[b] * 16;
+                float w = bone_weights[b];
+                acc = vmlaq_n_f32(acc, vld1q_f32(m + 0),  in[0] * w);
+                acc = vmlaq_n_f32(acc, vld1q_f32(m + 4),  in[1] * w);
+                acc = vmlaq_n_f32(acc, vld1q_f32(m + 8),  in[2] * w);
+                acc = vmlaq_n_f32(acc, vld1q_f32(m + 12), in_w * w);
+            }
+            out[0] = vgetq_lane_f32(acc, 0);
+            out[1] = vgetq_lane_f32(acc, 1);
+            out[2] = vgetq_lane_f32(acc, 2);
+        }
+#else
+        for (uint32_t i = 0; i < vertex_count; ++i, in += 3, out += 3, bone_indices += 4, bone_weights += 4)
+        {
+            float acc[3] = {0.0f, 0.0f, 0.0f};
+            for (uint32_t b = 0; b < 4 && bone_weights[b]; ++b)
+            {
+                const float* m = matrices + bone_indices[b] * 16;
+                float w = bone_weights[b];
+                float x = in[0] * w;
+                float y = in[1] * w;
+                float z = in[2] * w;
+                float t = in_w * w;
+                for (int c = 0; c < 3; ++c)
+                {
+                    acc[c] += m[c] * x + m[4 + c] * y + m[8 + c] * z + m[12 + c] * t;
+                }
+            }
+            out[0] = acc[0];
+            out[1] = acc[1];
+            out[2] = acc[2];
+        }
+#endif
+    }
+
+    static void GenerateNormalData(const dmRigDDF::Mesh* mesh, const Matrix4& normal_matrix, const dmArray<Matrix4>& pose_matrices, dmArray<Matrix4>& skin_matrices, float* normals_buffer, float* tangents_buffer)
     {
         const float* normals_in = mesh->m_Normals.m_Data;
         bool has_tangents = mesh->m_Tangents.m_Count > 0;
@@ -817,61 +910,18 @@ namespace dmRig
         // Skinned data
         const uint32_t* indices = mesh->m_BoneIndices.m_Data;
         const float* weights = mesh->m_Weights.m_Data;
-        for (uint32_t i = 0; i < vertex_count; ++i)
-        {
-            const Vector3 normal_in(normals_in[i*3+0], normals_in[i*3+1], normals_in[i*3+2]);
-            Vector4 normal_out(0.0f, 0.0f, 0.0f, 0.0f);
-
-            const Vector3 tangent_in = has_tangents ? Vector3(tangents_in[i*3+0], tangents_in[i*3+1], tangents_in[i*3+2]) : Vector3(0,0,0);
-            Vector4 tangent_out(0.0f, 0.0f, 0.0f, 0.0f);
 
-            const uint32_t bi_offset = i * 4;
-            const uint32_t* bone_indices = &indices[bi_offset];
-            const float* bone_weights = &weights[bi_offset];
+        // The normal matrix is linear, so it can be applied to the pose matrices once instead of to each vertex
+        PremultiplySkinMatrices(normal_matrix, pose_matrices, skin_matrices);
 
-            if (bone_weights[0])
-            {
-                normal_out += (pose_matrices[bone_indices[0]] * normal_in) * bone_weights[0];
-                tangent_out += (pose_matrices[bone_indices[0]] * tangent_in) * bone_weights[0];
-                if (bone_weights[1])
-                {
-                    normal_out += (pose_matrices[bone_indices[1]] * normal_in) * bone_weights[1];
-                    tangent_out += (pose_matrices[bone_indices[1]] * tangent_in) * bone_weights[1];
-                    if (bone_weights[2])
-                    {
-                        normal_out += (pose_matrices[bone_indices[2]] * normal_in) * bone_weights[2];
-                        tangent_out += (pose_matrices[bone_indices[2]] * tangent_in) * bone_weights[2];
-                        if (bone_weights[3])
-                        {
-                            normal_out += (pose_matrices[bone_indices[3]] * normal_in) * bone_weights[3];
-                            tangent_out += (pose_matrices[bone_indices[3]] * tangent_in) * bone_weights[3];
-                        }
-                    }
-                }
-            }
-
-            normal = normal_matrix * normal_out.getXYZ();
-            if (lengthSqr(normal) > 0.0f) {
-                normalize(normal);
-            }
-            *normals_buffer++ = normal[0];
-            *normals_buffer++ = normal[1];
-            *normals_buffer++ = normal[2];
-
-            if (has_tangents)
-            {
-                tangent = normal_matrix * tangent_out;
-                if (lengthSqr(tangent) > 0.0f) {
-                    normalize(tangent);
-                }
-                *tangents_buffer++ = tangent[0];
-                *tangents_buffer++ = tangent[1];
-                *tangents_buffer++ = tangent[2];
-            }
+        SkinVertices(normals_in, indices, weights, vertex_count, skin_matrices.Begin(), 0.0f, normals_buffer);
+        if (has_tangents)
+        {
+            SkinVertices(tangents_in, indices, weights, vertex_count, skin_matrices.Begin(), 0.0f, tangents_buffer);
         }
     }
 
-    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<Matrix4>& pose_matrices, float* out_buffer)
+    static float* GeneratePositionData(const dmRigDDF::Mesh* mesh, const Matrix4& model_matrix, const dmArray<Matrix4>& pose_matrices, dmArray<Matrix4>& skin_matrices, float* out_buffer)
     {
         const float* positions = mesh->m_Positions.m_Data;
         const uint32_t vertex_count = mesh->m_Positions.m_Count / 3;
@@ -895,42 +945,12 @@ namespace dmRig
 
         const uint32_t* indices = mesh->m_BoneIndices.m_Data;
         const float* weights = mesh->m_Weights.m_Data;
-        for (uint32_t i = 0; i < vertex_count; ++i)
-        {
-            Vector4 in_v;
-            in_v.setX(*positions++);
-            in_v.setY(*positions++);
-            in_v.setZ(*positions++);
-            in_v.setW(1.0f);
 
-            Vector4 out_p(0.0f, 0.0f, 0.0f, 0.0f);
-            const uint32_t bi_offset = i * 4;
-            const uint32_t* bone_indices = &indices[bi_offset];
-            const float* bone_weights = &weights[bi_offset];
+        // Transforming the pose matrices into world space once saves a matrix multiply per vertex
+        PremultiplySkinMatrices(model_matrix, pose_matrices, skin_matrices);
 
-            if(bone_weights[0])
-            {
-                out_p += pose_matrices[bone_indices[0]] * in_v * bone_weights[0];
-                if(bone_weights[1])
-                {
-                    out_p += pose_matrices[bone_indices[1]] * in_v * bone_weights[1];
-                    if(bone_weights[2])
-                    {
-                        out_p += pose_matrices[bone_indices[2]] * in_v * bone_weights[2];
-                        if(bone_weights[3])
-                        {
-                            out_p += pose_matrices[bone_indices[3]] * in_v * bone_weights[3];
-                        }
-                    }
-                }
-            }
-
-            v = model_matrix * Point3(out_p.getX(), out_p.getY(), out_p.getZ());
-            *out_buffer++ = v[0];
-            *out_buffer++ = v[1];
-            *out_buffer++ = v[2];
-        }
-        return out_buffer;
+        SkinVertices(positions, indices, weights, vertex_count, skin_matrices.Begin(), 1.0f, out_buffer);
+        return out_buffer + vertex_count * 3;
     }
 
     static uint8_t* WriteVertexDataByAttributes(const dmRigDDF::Mesh* mesh, const float* positions, const float* normals, const float* tangents, const AttributeInfo* attributes, uint32_t attributes_count, uint32_t vertex_stride, uint8_t* out_write_ptr)
@@ -1108,6 +1128,34 @@ namespace dmRig
         array.SetSize(size);
     }
 
+    uint32_t GeneratePoseMatrices(HRigInstance instance, dmArray<Matrix4>& pose_matrices)
+    {
+        uint32_t bone_count = GetBoneCount(instance);
+
+        // Make sure pose scratch buffers have enough space
+        if (pose_matrices.Capacity() < bone_count) {
+            uint32_t size_offset = bone_count - pose_matrices.Capacity();
+            pose_matrices.OffsetCapacity(size_offset);
+        }
+        pose_matrices.SetSize(bone_count);
+
+        if (!bone_count) {
+            return 0;
+        }
+
+        PoseToMatrix(instance->m_Pose, pose_matrices);
+
+        // Premultiply pose matrices with the bind pose inverse so they
+        // can be directly be used to transform each vertex.
+        const dmArray<RigBone>& bind_pose = *instance->m_BindPose;
+        for (uint32_t bi = 0; bi < bone_count; ++bi)
+        {
+            Matrix4& pose_matrix = pose_matrices[bi];
+            pose_matrix = pose_matrix * bind_pose[bi].m_ModelToLocal;
+        }
+        return bone_count;
+    }
+
     uint8_t* GenerateVertexDataFromAttributes(dmRig::HRigContext context, dmRig::HRigInstance instance, dmRigDDF::Mesh* mesh, const Matrix4& world_matrix, const AttributeInfo* attributes, uint32_t attributes_count, uint32_t vertex_stride, uint8_t* vertex_data_out)
     {
         const dmRigDDF::Model* model = instance->m_Model;
@@ -1122,7 +1170,6 @@ namespace dmRig
         dmArray<Vector3>& normals       = context->m_ScratchNormalBuffer;
         dmArray<Vector3>& tangents      = context->m_ScratchTangentBuffer;
 
-        uint32_t bone_count   = GetBoneCount(instance);
         uint32_t vertex_count = mesh->m_Positions.m_Count / 3;
 
         bool stream_position = false;
@@ -1143,32 +1190,12 @@ namespace dmRig
 
         if (stream_position)
         {
-            if (bone_count)
-            {
-                // Make sure pose scratch buffers have enough space
-                if (pose_matrices.Capacity() < bone_count)
-                {
-                    uint32_t size_offset = bone_count - pose_matrices.Capacity();
-                    pose_matrices.OffsetCapacity(size_offset);
-                }
-                pose_matrices.SetSize(bone_count);
-
-                PoseToMatrix(instance->m_Pose, pose_matrices);
-
-                // Premultiply pose matrices with the bind pose inverse so they
-                // can be directly be used to transform each vertex.
-                const dmArray<RigBone>& bind_pose = *instance->m_BindPose;
-                for (uint32_t bi = 0; bi < pose_matrices.Size(); ++bi)
-                {
-                    Matrix4& pose_matrix = pose_matrices[bi];
-                    pose_matrix = pose_matrix * bind_pose[bi].m_ModelToLocal;
-                }
-            }
+            GeneratePoseMatrices(instance, pose_matrices);
 
             EnsureSize(positions, vertex_count);
             positions_buffer = (float*) positions.Begin();
 
-            dmRig::GeneratePositionData(mesh, world_matrix, pose_matrices, positions_buffer);
+            dmRig::GeneratePositionData(mesh, world_matrix, pose_matrices, context->m_ScratchSkinMatrixBuffer, positions_buffer);
         }
         if (stream_normal && mesh->m_Normals.m_Count)
         {
@@ -1179,7 +1206,7 @@ namespace dmRig
 
             Matrix4 normal_matrix = Vectormath::Aos::inverse(world_matrix);
             normal_matrix = Vectormath::Aos::transpose(normal_matrix);
-            dmRig::GenerateNormalData(mesh, normal_matrix, pose_matrices, normals_buffer, tangents_buffer);
+            dmRig::GenerateNormalData(mesh, normal_matrix, pose_matrices, context->m_ScratchSkinMatrixBuffer, normals_buffer, tangents_buffer);
         }
 
         return WriteVertexDataByAttributes(mesh, positions_buffer, normals_buffer, tangents_buffer, attributes, attributes_count, vertex_stride, vertex_data_out);
@@ -1201,29 +1228,7 @@ namespace dmRig
         dmArray<Vector3>& tangents           = context->m_ScratchTangentBuffer;
 
         // If the rig has bones, update the pose to be local-to-model
-        uint32_t bone_count = GetBoneCount(instance);
-        if (bone_count)
-        {
-            // Make sure pose scratch buffers have enough space
-            if (pose_matrices.Capacity() < bone_count) {
-                uint32_t size_offset = bone_count - pose_matrices.Capacity();
-                pose_matrices.OffsetCapacity(size_offset);
-            }
-            pose_matrices.SetSize(bone_count);
-
-            PoseToMatrix(instance->m_Pose, pose_matrices);
-
-            // Premultiply pose matrices with the bind pose inverse so they
-            // can be directly be used to transform each vertex.
-            const dmArray<RigBone>& bind_pose = *instance->m_BindPose;
-            for (uint32_t bi = 0; bi < pose_matrices.Size(); ++bi)
-            {
-                Matrix4& pose_matrix = pose_matrices[bi];
-                pose_matrix = pose_matrix * bind_pose[bi].m_ModelToLocal;
-            }
-        } else {
-            pose_matrices.SetSize(0);
-        }
+        GeneratePoseMatrices(instance, pose_matrices);
 
         Matrix4 normal_matrix = dmVMath::Inverse(world_matrix);
         normal_matrix = dmVMath::Transpose(normal_matrix);
@@ -1241,9 +1246,9 @@ namespace dmRig
         float* tangents_buffer = (float*)tangents.Begin();
 
         // Transform the mesh data into world space
-        dmRig::GeneratePositionData(mesh, world_matrix, pose_matrices, positions_buffer);
+        dmRig::GeneratePositionData(mesh, world_matrix, pose_matrices, context->m_ScratchSkinMatrixBuffer, positions_buffer);
         if (mesh->m_Normals.m_Count) {
-            dmRig::GenerateNormalData(mesh, normal_matrix, pose_matrices, normals_buffer, tangents_buffer);
+            dmRig::GenerateNormalData(mesh, normal_matrix, pose_matrices, context->m_ScratchSkinMatrixBuffer, normals_buffer, tangents_buffer);
         }
 
         return WriteVertexData(mesh, positions_buffer, normals_buffer, tangents_buffer, vertex_data_out);
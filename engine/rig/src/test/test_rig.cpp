@@ -14,6 +14,7 @@
 
 #define _USE_MATH_DEFINES // for C
 #include <math.h>
+#include <string.h>
 
 #define JC_TEST_IMPLEMENTATION
 #include <jc_test/jc_test.h>
@@ -22,6 +23,7 @@
 #include <dlib/hashtable.h>
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/dlib/dstrings.h>
+#include <dmsdk/dlib/time.h>
 
 #include <../rig.h>
 
@@ -30,6 +32,8 @@ using namespace dmVMath;
 #define RIG_EPSILON_FLOAT 0.0001f
 #define RIG_EPSILON_BYTE (1.0f / 255.0f)
 
+static bool g_RunBenchmarks = false;
+
 
 template <> char* jc_test_print_value(char* buffer, size_t buffer_len, Vector3 v) {
     return buffer + dmSnPrintf(buffer, buffer_len, "Vector3(%.3f, %.3f, %.3f)", v.getX(), v.getY(), v.getZ());
@@ -1356,6 +1360,40 @@ TEST_F(RigInstanceTest, PoseAnim)
     ASSERT_EQ(Quat::identity(), pose[1].m_World.GetRotation());
 }
 
+TEST_F(RigInstanceTest, GeneratePoseMatrices)
+{
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(m_Instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+
+    dmArray<Matrix4> pose_matrices;
+    dmRig::RigModelVertex data[4];
+    const uint32_t* bone_indices = m_FirstMesh->m_BoneIndices.m_Data;
+    const float* bone_weights = m_FirstMesh->m_Weights.m_Data;
+    const float* positions = m_FirstMesh->m_Positions.m_Data;
+
+    // Skinning the bind pose positions with the pose matrices (as a vertex shader would)
+    // must match the vertices generated on the CPU
+    for (int sample = 0; sample < 3; ++sample)
+    {
+        ASSERT_EQ(dmRig::GetBoneCount(m_Instance), dmRig::GeneratePoseMatrices(m_Instance, pose_matrices));
+        ASSERT_EQ(dmRig::GetBoneCount(m_Instance), pose_matrices.Size());
+        ASSERT_EQ(data + 4, dmRig::GenerateVertexData(m_Context, m_Instance, m_FirstMesh, Matrix4::identity(), data));
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Vector4 in_p(positions[i*3+0], positions[i*3+1], positions[i*3+2], 1.0f);
+            Vector4 out_p(0.0f, 0.0f, 0.0f, 0.0f);
+            for (int w = 0; w < 4; ++w)
+            {
+                out_p += pose_matrices[bone_indices[i*4+w]] * in_p * bone_weights[i*4+w];
+            }
+            ASSERT_EQ(Vector3(data[i].pos[0], data[i].pos[1], data[i].pos[2]), out_p.getXYZ());
+        }
+
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
+    }
+}
+
 TEST_F(RigInstanceTest, PoseAnimCancel)
 {
     ASSERT_EQ(dmRig::RESULT_OK, dmRig::Update(m_Context, 1.0f));
@@ -1880,10 +1918,146 @@ TEST_F(RigContextTest, DEF_3121)
 #undef ASSERT_VERT_NORM
 #undef ASSERT_VERT_UV
 
+// Creates a mesh with four bone influences per vertex, to measure the cost of the skinning
+static void CreateSkinningBenchmarkMesh(dmRigDDF::Mesh& mesh, uint32_t vertex_count, uint32_t bone_count)
+{
+    memset(&mesh, 0, sizeof(mesh));
+    mesh.m_Positions.m_Data     = new float[vertex_count*3];
+    mesh.m_Positions.m_Count    = vertex_count*3;
+    mesh.m_Normals.m_Data       = new float[vertex_count*3];
+    mesh.m_Normals.m_Count      = vertex_count*3;
+    mesh.m_Tangents.m_Data      = new float[vertex_count*3];
+    mesh.m_Tangents.m_Count     = vertex_count*3;
+    mesh.m_BoneIndices.m_Data   = new uint32_t[vertex_count*4];
+    mesh.m_BoneIndices.m_Count  = vertex_count*4;
+    mesh.m_Weights.m_Data       = new float[vertex_count*4];
+    mesh.m_Weights.m_Count      = vertex_count*4;
+
+    for (uint32_t i = 0; i < vertex_count; ++i)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            mesh.m_Positions.m_Data[i*3+c] = (float) ((i + c) % 7);
+            mesh.m_Normals.m_Data[i*3+c]   = c == 1 ? 1.0f : 0.0f;
+            mesh.m_Tangents.m_Data[i*3+c]  = c == 2 ? 1.0f : 0.0f;
+        }
+        for (uint32_t b = 0; b < 4; ++b)
+        {
+            mesh.m_BoneIndices.m_Data[i*4+b] = (i + b) % bone_count;
+            mesh.m_Weights.m_Data[i*4+b]     = 0.25f;
+        }
+    }
+}
+
+static void DeleteSkinningBenchmarkMesh(dmRigDDF::Mesh& mesh)
+{
+    delete [] mesh.m_Positions.m_Data;
+    delete [] mesh.m_Normals.m_Data;
+    delete [] mesh.m_Tangents.m_Data;
+    delete [] mesh.m_BoneIndices.m_Data;
+    delete [] mesh.m_Weights.m_Data;
+}
+
+// The benchmark is only run when the test is started with --benchmark
+TEST(RigSkinning, Performance)
+{
+    if (!g_RunBenchmarks)
+    {
+        SKIP();
+    }
+
+    const uint32_t vertex_count = 4096;
+    const uint32_t frame_count = 10;
+    const uint32_t character_counts[] = {1, 10, 100};
+
+    dmRigDDF::Skeleton* skeleton          = new dmRigDDF::Skeleton();
+    dmRigDDF::MeshSet* mesh_set           = new dmRigDDF::MeshSet();
+    dmRigDDF::AnimationSet* animation_set = new dmRigDDF::AnimationSet();
+    dmArray<dmRig::RigBone> bind_pose;
+    dmHashTable64<uint32_t> bone_indices;
+    SetUpSimpleRig(bind_pose, bone_indices, skeleton, mesh_set, animation_set);
+
+    dmRigDDF::Mesh mesh;
+    CreateSkinningBenchmarkMesh(mesh, vertex_count, skeleton->m_Bones.m_Count);
+
+    dmArray<dmRig::RigModelVertex> vertices;
+    vertices.SetCapacity(vertex_count);
+
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(character_counts); ++c)
+    {
+        uint32_t character_count = character_counts[c];
+
+        dmRig::HRigContext context;
+        dmRig::NewContextParams params = {0};
+        params.m_MaxRigInstanceCount = character_count;
+        ASSERT_EQ(dmRig::RESULT_OK, dmRig::NewContext(params, &context));
+
+        dmArray<dmRig::HRigInstance> instances;
+        instances.SetCapacity(character_count);
+        for (uint32_t i = 0; i < character_count; ++i)
+        {
+            dmRig::InstanceCreateParams create_params = {0};
+            create_params.m_BindPose         = &bind_pose;
+            create_params.m_BoneIndices      = &bone_indices;
+            create_params.m_Skeleton         = skeleton;
+            create_params.m_MeshSet          = mesh_set;
+            create_params.m_AnimationSet     = animation_set;
+            create_params.m_ModelId          = dmHashString64("test");
+            create_params.m_DefaultAnimation = dmHashString64("valid");
+
+            dmRig::HRigInstance instance;
+            ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceCreate(context, create_params, &instance));
+            ASSERT_EQ(dmRig::RESULT_OK, dmRig::PlayAnimation(instance, dmHashString64("valid"), dmRig::PLAYBACK_LOOP_FORWARD, 0.0f, 0.0f, 1.0f));
+            instances.Push(instance);
+        }
+
+        uint64_t animate_time = 0;
+        uint64_t skinning_time = 0;
+        for (uint32_t f = 0; f < frame_count; ++f)
+        {
+            uint64_t start = dmTime::GetTime();
+            dmRig::Update(context, 1.0f / 60.0f);
+            uint64_t mid = dmTime::GetTime();
+            for (uint32_t i = 0; i < character_count; ++i)
+            {
+                ASSERT_EQ(vertices.Begin() + vertex_count, dmRig::GenerateVertexData(context, instances[i], &mesh, Matrix4::identity(), vertices.Begin()));
+            }
+            uint64_t end = dmTime::GetTime();
+            animate_time += mid - start;
+            skinning_time += end - mid;
+        }
+
+        dmLogInfo("Skinning %3u characters (%u vertices each): animate %.3f ms/frame, skinning %.3f ms/frame",
+            character_count, vertex_count, animate_time / (1000.0 * frame_count), skinning_time / (1000.0 * frame_count));
+
+        for (uint32_t i = 0; i < character_count; ++i)
+        {
+            ASSERT_EQ(dmRig::RESULT_OK, dmRig::InstanceDestroy(context, instances[i]));
+        }
+        dmRig::DeleteContext(context);
+    }
+
+    DeleteSkinningBenchmarkMesh(mesh);
+    DeleteRigData(mesh_set, skeleton, animation_set);
+}
+
 int main(int argc, char **argv)
 {
     dmHashEnableReverseHash(true);
 
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            g_RunBenchmarks = true;
+            // Remove the argument before the test framework parses the command line
+            for (int j = i; j < argc - 1; ++j)
+                argv[j] = argv[j + 1];
+            --argc;
+            break;
+        }
+    }
+
     jc_test_init(&argc, argv);
 
     int ret = jc_test_run_all();
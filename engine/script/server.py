@@ -20,13 +20,39 @@ import time
 import sys
 import socket
 
+# Content of /data, which supports range requests
+DATA = ''.join(chr(ord('a') + i % 26) for i in range(10000)).encode('ascii')
+
 class Handler(BaseHTTPRequestHandler):
 
     def version_string(self):
         return "Dynamo 1.0"
 
+    def send_data(self):
+        status = 200
+        start, end = 0, len(DATA) - 1
+        range = self.headers.get('Range', None)
+        if range and range.startswith('bytes='):
+            first, last = range[len('bytes='):].split('-')
+            start = int(first)
+            if last:
+                end = min(int(last), end)
+            status = 206
+
+        self.send_response(status)
+        self.send_header("Content-type", "application/octet-stream")
+        self.send_header("Content-Length", end - start + 1)
+        if status == 206:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, end, len(DATA)))
+        self.end_headers()
+        self.wfile.write(DATA[start:end + 1])
+
     def do_GET(self):
         to_send = ""
+        if self.path == "/data":
+            self.send_data()
+            return
+
         if self.path == "/":
             a,b = self.headers.get('X-A', None), self.headers.get('X-B', None)
             if a and b:
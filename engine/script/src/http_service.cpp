@@ -14,18 +14,19 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dlib/array.h>
 #include <dlib/dstrings.h>
 #include <dlib/thread.h>
 #include <dlib/time.h>
 #include <dlib/message.h>
-#include <dlib/http_client.h>
+#include <dlib/http_multi.h>
 #include <dlib/http_cache.h>
 #include <dlib/log.h>
 #include <dlib/sys.h>
-#include <dlib/uri.h>
 #include <dlib/math.h>
+#include <dlib/path.h>
 #include <ddf/ddf.h>
 #include "http_ddf.h"
 #include "http_service.h"
@@ -42,49 +43,87 @@ namespace dmHttpService
     const uint32_t DEFAULT_RESPONSE_BUFFER_SIZE = 64 * 1024;
     const uint32_t DEFAULT_HEADER_BUFFER_SIZE = 16 * 1024;
 
+    // All requests are multiplexed on the service thread. Requests beyond this are queued.
+    const uint32_t MAX_ACTIVE_REQUESTS = 16;
+    // Max time to wait for socket events, when there are active requests. New requests are picked up in between.
+    const uint64_t UPDATE_TIMEOUT = 10 * 1000;
 
     struct HttpService;
 
-    struct Worker
+    // An active request, and the response data accumulated so far.
+    // If a path is given, the response is streamed to a temporary file instead.
+    struct Transfer
     {
-        dmThread::Thread      m_Thread;
-        dmMessage::HSocket    m_Socket;
-        dmHttpClient::HClient m_Client;
-        dmURI::Parts          m_CurrentURL;
-        dmHttpDDF::HttpRequest*   m_Request;
-        const char*           m_Filepath;
+        dmMessage::URL        m_Requester;
+        uintptr_t             m_UserData2;
+        char*                 m_Path;
+        char*                 m_Url;
+        FILE*                 m_File;
+        const char*           m_Error;
+        Progress*             m_Progress;
+        uint64_t              m_Received;
         int                   m_Status;
         dmArray<char>         m_Response;
         dmArray<char>         m_Headers;
-        const HttpService*    m_Service;
-        bool                  m_CacheFlusher;
-        volatile bool         m_Run;
-        int                   m_Canceled;
+        HttpService*          m_Service;
     };
 
     struct HttpService
     {
         HttpService()
         {
-            m_Balancer = 0;
+            m_Thread = 0;
             m_Socket = 0;
             m_HttpCache = 0;
-            m_LoadBalanceCount = 0;
+            m_Multi = 0;
             m_Run = false;
         }
-        dmArray<Worker*>          m_Workers;
-        dmThread::Thread          m_Balancer;
+        dmThread::Thread          m_Thread;
         dmMessage::HSocket        m_Socket;
         dmHttpCache::HCache       m_HttpCache;
-        int                       m_LoadBalanceCount;
+        dmHttpMulti::HMulti       m_Multi;
+        dmArray<Transfer*>        m_Transfers;
         volatile bool             m_Run;
     };
 
-    void HttpHeader(dmHttpClient::HResponse response, void* user_data, int status_code, const char* key, const char* value)
+    static void GetTempPath(const char* path, char* buffer, uint32_t buffer_size)
     {
-        Worker* worker = (Worker*) user_data;
-        worker->m_Status = status_code;
-        dmArray<char>& h = worker->m_Headers;
+        dmStrlCpy(buffer, path, buffer_size);
+        dmStrlCat(buffer, "._httptmp", buffer_size);
+    }
+
+    static void CloseFile(Transfer* transfer, bool remove)
+    {
+        if (!transfer->m_File)
+            return;
+        fclose(transfer->m_File);
+        transfer->m_File = 0;
+        if (remove)
+        {
+            char tmp_path[DMPATH_MAX_PATH];
+            GetTempPath(transfer->m_Path, tmp_path, sizeof(tmp_path));
+            dmSys::Unlink(tmp_path);
+        }
+    }
+
+    static void DeleteTransfer(Transfer* transfer)
+    {
+        CloseFile(transfer, true);
+        if (transfer->m_Progress)
+        {
+            // The requester may free the progress after this
+            dmAtomicStore32(&transfer->m_Progress->m_Done, 1);
+        }
+        free(transfer->m_Path);
+        free(transfer->m_Url);
+        delete transfer;
+    }
+
+    void HttpHeader(dmHttpMulti::HRequest request, void* user_data, int status_code, const char* key, const char* value)
+    {
+        Transfer* transfer = (Transfer*) user_data;
+        transfer->m_Status = status_code;
+        dmArray<char>& h = transfer->m_Headers;
         uint32_t len = strlen(key) + strlen(value) + 2;
         uint32_t left = h.Capacity() - h.Size();
         if (left < len) {
@@ -94,71 +133,67 @@ namespace dmHttpService
         h.Push(':');
         h.PushArray(value, strlen(value));
         h.Push('\n');
+
+        if (transfer->m_Progress && dmStrCaseCmp(key, "Content-Length") == 0)
+        {
+            DM_SPINLOCK_SCOPED_LOCK(transfer->m_Progress->m_Lock);
+            transfer->m_Progress->m_Total = strtoull(value, 0, 10);
+        }
     }
 
-    void HttpContent(dmHttpClient::HResponse response, void* user_data, int status_code, const void* content_data, uint32_t content_data_size)
+    void HttpContent(dmHttpMulti::HRequest request, void* user_data, int status_code, const void* content_data, uint32_t content_data_size)
     {
-        Worker* worker = (Worker*) user_data;
-        worker->m_Status = status_code;
-        dmArray<char>& r = worker->m_Response;
+        Transfer* transfer = (Transfer*) user_data;
+        transfer->m_Status = status_code;
+        dmArray<char>& r = transfer->m_Response;
 
         if (!content_data && !content_data_size)
         {
+            // Start of the response. Also called again when a request is retried.
             r.SetSize(0);
+            transfer->m_Received = 0;
+            transfer->m_Error = 0;
+            if (transfer->m_Path)
+            {
+                CloseFile(transfer, false);
+                // Only successful responses overwrite the file
+                if (status_code == 200 || status_code == 206)
+                {
+                    char tmp_path[DMPATH_MAX_PATH];
+                    GetTempPath(transfer->m_Path, tmp_path, sizeof(tmp_path));
+                    transfer->m_File = fopen(tmp_path, "wb");
+                    if (!transfer->m_File)
+                    {
+                        transfer->m_Error = "Failed to write to temp file";
+                    }
+                }
+            }
             return;
         }
 
-        uint32_t left = r.Capacity() - r.Size();
-        if (left < content_data_size) {
-            r.OffsetCapacity((int32_t) dmMath::Max(content_data_size - left, 128U * 1024U));
+        transfer->m_Received += content_data_size;
+        if (transfer->m_Progress)
+        {
+            DM_SPINLOCK_SCOPED_LOCK(transfer->m_Progress->m_Lock);
+            transfer->m_Progress->m_Received = transfer->m_Received;
         }
-        r.PushArray((char*) content_data, content_data_size);
-    }
-
-    uint32_t HttpSendContentLength(dmHttpClient::HResponse response, void* user_data)
-    {
-        Worker* worker = (Worker*) user_data;
-        return worker->m_Request->m_RequestLength;
-    }
 
-    dmHttpClient::Result HttpWrite(dmHttpClient::HResponse response, uint32_t offset, uint32_t size, void* user_data)
-    {
-        Worker* worker = (Worker*) user_data;
-        uint8_t* request = (uint8_t*)worker->m_Request->m_Request;
-        uint32_t request_len = dmMath::Min(worker->m_Request->m_RequestLength - offset, size);
-        return dmHttpClient::Write(response, (const void*) &request[offset], request_len);
-    }
-
-    dmHttpClient::Result HttpWriteHeaders(dmHttpClient::HResponse response, void* user_data)
-    {
-        Worker* worker = (Worker*) user_data;
-        char* headers = 0;
-        if (worker->m_Request->m_HeadersLength > 0) {
-            headers = (char*) malloc(worker->m_Request->m_HeadersLength);
-            // NOTE: We must copy the buffer as retry might happen
-            // and dmStrTok is destructive
-            // We don't know the actual size inadvance, hence the malloc()
-            memcpy(headers, (char*) worker->m_Request->m_Headers, worker->m_Request->m_HeadersLength);
-            headers[worker->m_Request->m_HeadersLength-1] = '\0';
-
-            char* s, *last;
-            s = dmStrTok(headers, "\n", &last);
-            while (s) {
-                char* colon = strchr(s, ':');
-                *colon = '\0';
-                dmHttpClient::Result r = dmHttpClient::WriteHeader(response, s, colon + 1);
-                if (r != dmHttpClient::RESULT_OK) {
-                    free(headers);
-                    return r;
-                }
-                *colon = ':';
-                s = dmStrTok(0, "\n", &last);
+        if (transfer->m_Path)
+        {
+            if (transfer->m_File && fwrite(content_data, 1, content_data_size, transfer->m_File) != content_data_size)
+            {
+                dmLogError("Failed to write '%u' bytes to '%s'", content_data_size, transfer->m_Path);
+                transfer->m_Error = "Failed to write to temp file";
+                CloseFile(transfer, true);
             }
-
+            return;
         }
 
-        free(headers);
-        return dmHttpClient::RESULT_OK;
+        uint32_t left = r.Capacity() - r.Size();
+        if (left < content_data_size) {
+            r.OffsetCapacity((int32_t) dmMath::Max(content_data_size - left, 128U * 1024U));
+        }
+        r.PushArray((char*) content_data, content_data_size);
     }
 
     static void MessageDestroyCallback(dmMessage::Message* message)
@@ -171,20 +206,29 @@ namespace dmHttpService
     static void SendResponse(const dmMessage::URL* requester, uintptr_t userdata1, uintptr_t userdata2, int status,
                              const char* headers, uint32_t headers_length,
                              const char* response, uint32_t response_length,
-                             const char* filepath)
+                             const char* filepath, const char* error)
     {
-        dmHttpDDF::HttpResponse resp;
+        // The path is copied after the response, and stored as an offset
+        char buf[sizeof(dmHttpDDF::HttpResponse) + DMPATH_MAX_PATH];
+        uint32_t buf_size = sizeof(dmHttpDDF::HttpResponse);
+        dmHttpDDF::HttpResponse& resp = *(dmHttpDDF::HttpResponse*) buf;
         resp.m_Status = status;
         resp.m_HeadersLength = headers_length;
         resp.m_ResponseLength = response_length;
+        resp.m_Path = 0;
+        resp.m_Error = error;
+        if (filepath)
+        {
+            resp.m_Path = (const char*) (uintptr_t) buf_size;
+            buf_size += dmStrlCpy(buf + buf_size, filepath, DMPATH_MAX_PATH) + 1;
+        }
 
         resp.m_Headers = (uint64_t) malloc(headers_length);
         memcpy((void*) resp.m_Headers, headers, headers_length);
         resp.m_Response = (uint64_t) malloc(response_length);
         memcpy((void*) resp.m_Response, response, response_length);
-        resp.m_Path = filepath;
 
-        if (dmMessage::RESULT_OK != dmMessage::Post(0, requester, dmHttpDDF::HttpResponse::m_DDFHash, userdata1, userdata2, (uintptr_t) dmHttpDDF::HttpResponse::m_DDFDescriptor, &resp, sizeof(resp), MessageDestroyCallback) )
+        if (dmMessage::RESULT_OK != dmMessage::Post(0, requester, dmHttpDDF::HttpResponse::m_DDFHash, userdata1, userdata2, (uintptr_t) dmHttpDDF::HttpResponse::m_DDFDescriptor, buf, buf_size, MessageDestroyCallback) )
         {
             free((void*) resp.m_Headers);
             free((void*) resp.m_Response);
@@ -192,79 +236,117 @@ namespace dmHttpService
         }
     }
 
-    void HandleRequest(Worker* worker, const dmMessage::URL* requester, uintptr_t userdata1, uintptr_t userdata2, dmHttpDDF::HttpRequest* request)
+    void HttpDone(dmHttpMulti::HRequest request, void* user_data, dmHttpMulti::Result result, int status_code)
     {
-        dmURI::Parts url;
-        request->m_Method = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Method);
-        request->m_Url = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Url);
-        dmURI::Result ur =  dmURI::Parse(request->m_Url, &url);
-        if (ur != dmURI::RESULT_OK)
+        Transfer* transfer = (Transfer*) user_data;
+        int status = status_code;
+        if (result != dmHttpMulti::RESULT_OK)
         {
-            SendResponse(requester, 0, 0, 0, 0, 0, 0, 0, 0);
-            return;
-        }
-        if (url.m_Path[0] == '\0') {
-            // NOTE: Default to / for empty path
-            url.m_Path[0] = '/';
-            url.m_Path[1] = '\0';
+            dmLogError("HTTP request to '%s' failed (http result: %s)", transfer->m_Url, dmHttpMulti::ResultToString(result));
+            status = 0;
+            // Passed on to the response as 'error', unless a file error was already reported
+            if (!transfer->m_Error)
+            {
+                transfer->m_Error = dmHttpMulti::ResultToString(result);
+            }
         }
 
-        if (worker->m_Client == 0 || !(strcmp(url.m_Hostname, worker->m_CurrentURL.m_Hostname) == 0 &&
-                                       strcmp(url.m_Scheme, worker->m_CurrentURL.m_Scheme) == 0 &&
-                                       url.m_Port == worker->m_CurrentURL.m_Port)) {
-            if (worker->m_Client) {
-                dmHttpClient::Delete(worker->m_Client);
+        if (transfer->m_File)
+        {
+            bool ok = result == dmHttpMulti::RESULT_OK && fflush(transfer->m_File) == 0;
+            CloseFile(transfer, !ok);
+            if (ok)
+            {
+                char tmp_path[DMPATH_MAX_PATH];
+                GetTempPath(transfer->m_Path, tmp_path, sizeof(tmp_path));
+                if (dmSys::Rename(transfer->m_Path, tmp_path) != dmSys::RESULT_OK)
+                {
+                    dmLogError("Failed to rename '%s' to '%s'", tmp_path, transfer->m_Path);
+                    transfer->m_Error = "Failed to write to temp file";
+                }
             }
-            // New connection
-            dmHttpClient::NewParams params;
-            params.m_HttpContent = &HttpContent;
-            params.m_HttpHeader = &HttpHeader;
-            params.m_HttpSendContentLength = &HttpSendContentLength;
-            params.m_HttpWrite = &HttpWrite;
-            params.m_HttpWriteHeaders = &HttpWriteHeaders;
-            params.m_Userdata = worker;
-            params.m_HttpCache = worker->m_Service->m_HttpCache;
-            params.m_RequestTimeout = request->m_Timeout;
-
-            worker->m_Client = dmHttpClient::New(&params, url.m_Hostname, url.m_Port, strcmp(url.m_Scheme, "https") == 0, &worker->m_Canceled);
-
-            memcpy(&worker->m_CurrentURL, &url, sizeof(url));
         }
 
-        worker->m_Response.SetSize(0);
-        worker->m_Response.SetCapacity(DEFAULT_RESPONSE_BUFFER_SIZE);
-        worker->m_Headers.SetSize(0);
-        worker->m_Headers.SetCapacity(DEFAULT_HEADER_BUFFER_SIZE);
-        worker->m_Filepath = request->m_Path;
-
-        if (worker->m_Client) {
-            worker->m_Request = request;
-            dmHttpClient::SetOptionInt(worker->m_Client, dmHttpClient::OPTION_REQUEST_TIMEOUT, request->m_Timeout);
-            dmHttpClient::SetOptionInt(worker->m_Client, dmHttpClient::OPTION_REQUEST_IGNORE_CACHE, request->m_IgnoreCache);
-            dmHttpClient::SetOptionInt(worker->m_Client, dmHttpClient::OPTION_REQUEST_CHUNKED_TRANSFER, request->m_ChunkedTransfer);
-
-            dmHttpClient::Result r = dmHttpClient::Request(worker->m_Client, request->m_Method, url.m_Path);
-            if (r == dmHttpClient::RESULT_OK || r == dmHttpClient::RESULT_NOT_200_OK) {
-                SendResponse(requester, userdata1, userdata2, worker->m_Status, worker->m_Headers.Begin(), worker->m_Headers.Size(), worker->m_Response.Begin(), worker->m_Response.Size(), worker->m_Filepath);
-            } else {
-                // TODO: Error codes to lua?
-                dmLogError("HTTP request to '%s' failed (http result: %d  socket result: %d)", request->m_Url, r, GetLastSocketResult(worker->m_Client));
-                SendResponse(requester, userdata1, userdata2, 0, worker->m_Headers.Begin(), worker->m_Headers.Size(), worker->m_Response.Begin(), worker->m_Response.Size(), worker->m_Filepath);
+        SendResponse(&transfer->m_Requester, 0, transfer->m_UserData2, status, transfer->m_Headers.Begin(), transfer->m_Headers.Size(), transfer->m_Response.Begin(), transfer->m_Response.Size(), transfer->m_Path, transfer->m_Error);
+
+        dmArray<Transfer*>& transfers = transfer->m_Service->m_Transfers;
+        for (uint32_t i = 0; i < transfers.Size(); ++i)
+        {
+            if (transfers[i] == transfer)
+            {
+                transfers.EraseSwap(i);
+                break;
             }
-        } else {
-            // TODO: Error codes to lua?
-            SendResponse(requester, userdata1, userdata2, 0, worker->m_Headers.Begin(), worker->m_Headers.Size(), worker->m_Response.Begin(), worker->m_Response.Size(), worker->m_Filepath);
-            dmLogError("Unable to create HTTP connection to '%s'. No route to host?", request->m_Url);
         }
+        DeleteTransfer(transfer);
     }
 
-    void Dispatch(dmMessage::Message *message, void* user_ptr)
+    void HandleRequest(HttpService* service, const dmMessage::URL* requester, uintptr_t userdata1, uintptr_t userdata2, dmHttpDDF::HttpRequest* request)
     {
-        Worker* worker = (Worker*) user_ptr;
-        if (!worker->m_Run) {
+        request->m_Method = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Method);
+        request->m_Url = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Url);
+        if (request->m_Path) {
+            request->m_Path = (const char*) ((uintptr_t) request + (uintptr_t) request->m_Path);
+        }
+
+        // The headers are "key:value\n" lines, without null termination
+        char* headers = 0;
+        if (request->m_HeadersLength > 0) {
+            headers = (char*) malloc(request->m_HeadersLength + 1);
+            memcpy(headers, (char*) request->m_Headers, request->m_HeadersLength);
+            headers[request->m_HeadersLength] = '\0';
+        }
+
+        Transfer* transfer = new Transfer;
+        transfer->m_Requester = *requester;
+        transfer->m_UserData2 = userdata2;
+        transfer->m_Path = request->m_Path ? strdup(request->m_Path) : 0;
+        transfer->m_Url = strdup(request->m_Url);
+        transfer->m_File = 0;
+        transfer->m_Error = 0;
+        transfer->m_Progress = (Progress*) request->m_Progress;
+        transfer->m_Received = 0;
+        transfer->m_Status = 0;
+        // Streamed responses are never accumulated in memory
+        transfer->m_Response.SetCapacity(transfer->m_Path ? 0 : DEFAULT_RESPONSE_BUFFER_SIZE);
+        transfer->m_Headers.SetCapacity(DEFAULT_HEADER_BUFFER_SIZE);
+        transfer->m_Service = service;
+
+        dmHttpMulti::RequestParams params;
+        params.m_Method = request->m_Method;
+        params.m_Url = request->m_Url;
+        params.m_Headers = headers;
+        params.m_Body = (const void*) request->m_Request;
+        params.m_BodySize = request->m_RequestLength;
+        params.m_Timeout = request->m_Timeout;
+        params.m_HttpHeader = &HttpHeader;
+        params.m_HttpContent = &HttpContent;
+        params.m_HttpDone = &HttpDone;
+        params.m_Userdata = transfer;
+        params.m_IgnoreCache = request->m_IgnoreCache;
+        params.m_ChunkedTransfer = request->m_ChunkedTransfer;
+
+        dmHttpMulti::HRequest handle;
+        dmHttpMulti::Result r = dmHttpMulti::AddRequest(service->m_Multi, &params, &handle);
+        free(headers);
+        if (r != dmHttpMulti::RESULT_OK)
+        {
+            DeleteTransfer(transfer);
+            SendResponse(requester, 0, 0, 0, 0, 0, 0, 0, 0, 0);
             return;
         }
 
+        if (service->m_Transfers.Full())
+        {
+            service->m_Transfers.OffsetCapacity(16);
+        }
+        service->m_Transfers.Push(transfer);
+    }
+
+    void Dispatch(dmMessage::Message *message, void* user_ptr)
+    {
+        HttpService* service = (HttpService*) user_ptr;
+
         if (message->m_Descriptor)
         {
             dmDDF::Descriptor* descriptor = (dmDDF::Descriptor*)message->m_Descriptor;
@@ -272,13 +354,17 @@ namespace dmHttpService
             if (message->m_Descriptor == (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor)
             {
                 dmHttpDDF::HttpRequest* request = (dmHttpDDF::HttpRequest*) &message->m_Data[0];
-                HandleRequest(worker, &message->m_Sender, 0, message->m_UserData2, request);
+                if (service->m_Run) {
+                    HandleRequest(service, &message->m_Sender, 0, message->m_UserData2, request);
+                } else if (request->m_Progress) {
+                    dmAtomicStore32(&((Progress*) request->m_Progress)->m_Done, 1);
+                }
                 free((void*) request->m_Headers);
                 free((void*) request->m_Request);
             }
             else if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor)
             {
-                worker->m_Run = false;
+                service->m_Run = false;
             }
             else
             {
@@ -302,53 +388,35 @@ namespace dmHttpService
         }
     }
 
-    void LoadBalance(dmMessage::Message *message, void* user_ptr)
-    {
-        HttpService* service = (HttpService*) user_ptr;
-        if (message->m_Descriptor == (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor) {
-            service->m_Run = false;
-        } else {
-            dmMessage::URL r = message->m_Receiver;
-            r.m_Socket = service->m_Workers[service->m_LoadBalanceCount % service->m_Workers.Size()]->m_Socket;
-            dmMessage::Post(&message->m_Sender,
-                            &r,
-                            message->m_Id,
-                            message->m_UserData1,
-                            message->m_UserData2,
-                            message->m_Descriptor,
-                            message->m_Data,
-                            message->m_DataSize, 0);
-            service->m_LoadBalanceCount++;
-        }
-    }
-
     static void Loop(void* arg)
     {
-        Worker* worker = (Worker*) arg;
+        HttpService* service = (HttpService*) arg;
 
         uint64_t flush_period = 5 * 1000000U;
         uint64_t next_flush = dmTime::GetTime() + flush_period;
-        while (worker->m_Run)
+        while (service->m_Run)
         {
-            dmMessage::DispatchBlocking(worker->m_Socket, &Dispatch, worker);
-            if (!worker->m_Run)
+            if (dmHttpMulti::GetRequestCount(service->m_Multi) == 0)
+            {
+                // Idle, wait for new requests
+                dmMessage::DispatchBlocking(service->m_Socket, &Dispatch, service);
+            }
+            else
+            {
+                dmMessage::Dispatch(service->m_Socket, &Dispatch, service);
+            }
+            if (!service->m_Run)
                 break;
 
-            if (worker->m_CacheFlusher && dmTime::GetTime() > next_flush) {
-                dmHttpCache::Flush(worker->m_Service->m_HttpCache);
+            dmHttpMulti::Update(service->m_Multi, UPDATE_TIMEOUT);
+
+            if (service->m_HttpCache && dmTime::GetTime() > next_flush) {
+                dmHttpCache::Flush(service->m_HttpCache);
                 next_flush = dmTime::GetTime() + flush_period;
             }
         }
     }
 
-    static void LoadBalancer(void* arg)
-    {
-        HttpService* service = (HttpService*) arg;
-        while (service->m_Run) {
-            dmMessage::DispatchBlocking(service->m_Socket, &LoadBalance, service);
-        }
-    }
-
     HHttpService New(const Params* params)
     {
         HttpService* service = new HttpService;
@@ -379,38 +447,23 @@ namespace dmHttpService
             dmLogWarning("Http cache disabled");
         }
 
-        int threadcount = params->m_ThreadCount;
-#if defined(__NX__)
-        if (threadcount > 2)
-            threadcount = 2;
-#endif
+        dmHttpMulti::NewParams multi_params;
+        multi_params.m_MaxActiveRequests = MAX_ACTIVE_REQUESTS;
+        multi_params.m_MaxConnections = MAX_ACTIVE_REQUESTS * 2;
+        multi_params.m_HttpCache = service->m_HttpCache;
+        dmHttpMulti::Result multi_r = dmHttpMulti::New(&multi_params, &service->m_Multi);
+        if (multi_r != dmHttpMulti::RESULT_OK)
+        {
+            dmLogError("Unable to create http client (%s)", dmHttpMulti::ResultToString(multi_r));
+        }
 
         service->m_Run = true;
         dmMessage::NewSocket(HTTP_SOCKET_NAME, &service->m_Socket);
-        service->m_Workers.SetCapacity(threadcount);
-        for (uint32_t i = 0; i < threadcount; ++i)
+        if (service->m_Multi)
         {
-            Worker* worker = new Worker();
-            char tmp[128];
-            dmSnPrintf(tmp, sizeof(tmp), "@__http_worker_%d", i);
-            dmMessage::NewSocket(tmp, &worker->m_Socket);
-            worker->m_Client = 0;
-            memset(&worker->m_CurrentURL, 0, sizeof(worker->m_CurrentURL));
-            worker->m_Request = 0;
-            worker->m_Status = 0;
-            worker->m_Service = service;
-            worker->m_CacheFlusher = i == 0 && worker->m_Service->m_HttpCache != 0;
-            worker->m_Run = true;
-            worker->m_Canceled = 0;
-            service->m_Workers.Push(worker);
-
-            dmThread::Thread t = dmThread::New(&Loop, THREAD_STACK_SIZE, worker, "http");
-            worker->m_Thread = t;
+            service->m_Thread = dmThread::New(&Loop, THREAD_STACK_SIZE, service, "http");
         }
 
-        dmThread::Thread t = dmThread::New(&LoadBalancer, THREAD_STACK_SIZE, service, "http_balance");
-        service->m_Balancer = t;
-
         return service;
     }
 
@@ -425,38 +478,21 @@ namespace dmHttpService
         url.m_Socket = http_service->m_Socket;
         dmMessage::Post(0, &url, 0, 0, (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor, 0, 0, 0);
 
-        // Stop the balancer first, so we don't accept any new requests
-        dmThread::Join(http_service->m_Balancer);
-
-        // Cancel them all first, as opposed to one-by-one
-        for (uint32_t i = 0; i < http_service->m_Workers.Size(); ++i)
+        // The thread may be blocked establishing a connection (getaddrinfo), but
+        // requests already connected are aborted within UPDATE_TIMEOUT
+        if (http_service->m_Thread)
         {
-            dmHttpService::Worker* worker = http_service->m_Workers[i];
-
-            url.m_Socket = worker->m_Socket;
-            dmMessage::Post(0, &url, 0, 0, (uintptr_t) dmHttpDDF::StopHttp::m_DDFDescriptor, 0, 0, 0);
-
-            worker->m_Canceled = 1;
+            dmThread::Join(http_service->m_Thread);
         }
 
-        for (uint32_t i = 0; i < http_service->m_Workers.Size(); ++i)
+        // Unfinished requests are aborted without callbacks
+        if (http_service->m_Multi)
         {
-            dmHttpService::Worker* worker = http_service->m_Workers[i];
-
-            // DNS lookups using dmSocket::GetHostByName are using getaddrinfo which may block for an undefined
-            // amount of time. We do not wish to wait for the thread during shutdown
-            // We now use detach() on the thread on creation so that we don't have to wait for the thread
-            if (worker->m_Thread)
-            {
-                dmThread::Join(worker->m_Thread);
-            }
-
-            dmMessage::DeleteSocket(worker->m_Socket);
-            if (worker->m_Client)
-            {
-                dmHttpClient::Delete(worker->m_Client);
-            }
-            delete worker;
+            dmHttpMulti::Delete(http_service->m_Multi);
+        }
+        for (uint32_t i = 0; i < http_service->m_Transfers.Size(); ++i)
+        {
+            DeleteTransfer(http_service->m_Transfers[i]);
         }
 
         dmMessage::DeleteSocket(http_service->m_Socket);
@@ -16,6 +16,8 @@
 #define DM_HTTP_SERVICE
 
 #include <stdint.h>
+#include <dlib/atomic.h>
+#include <dmsdk/dlib/spinlock.h>
 
 namespace dmHttpService
 {
@@ -24,12 +26,29 @@ namespace dmHttpService
     struct Params
     {
     	Params() :
-    		m_ThreadCount(4),
             m_UseHttpCache(1)
     	{}
-    	uint32_t m_ThreadCount:4;
         uint32_t m_UseHttpCache:1;
     };
+
+    /**
+     * Progress of a request, updated by the service thread as the response is received.
+     * The sender of the request owns the struct, and may delete it once m_Done is set.
+     */
+    struct Progress
+    {
+        Progress() : m_Received(0), m_Total(0), m_Done(0) { dmSpinlock::Create(&m_Lock); }
+        ~Progress() { dmSpinlock::Destroy(&m_Lock); }
+        /// Protects m_Received and m_Total
+        dmSpinlock::Spinlock m_Lock;
+        /// Number of response bytes received
+        uint64_t       m_Received;
+        /// Expected number of response bytes. Zero if unknown.
+        uint64_t       m_Total;
+        /// Set when the service no longer accesses the struct
+        int32_atomic_t m_Done;
+    };
+
     HHttpService New(const Params* params);
     dmMessage::HSocket GetSocket(HHttpService http_service);
     void Delete(HHttpService http_service);
@@ -17,6 +17,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/memprofile.h>
 #include <dlib/pprint.h>
 #include <dlib/profile.h>
 
@@ -84,6 +85,7 @@ namespace dmScript
         context->m_LuaState = lua_open();
         context->m_ContextTableRef = LUA_NOREF;
         context->m_EnableExtensions = enable_extensions;
+        InitializeGC(context);
         return context;
     }
 
@@ -1379,6 +1381,7 @@ namespace dmScript
     }
 
     static int PCallInternal(lua_State* L, int nargs, int nresult, int in_error_handler) {
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_LUA);
         lua_pushcfunction(L, BacktraceErrorHandler);
         int err_index = lua_gettop(L) - nargs - 1;
         lua_insert(L, err_index);
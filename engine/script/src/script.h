@@ -252,6 +252,19 @@ namespace dmScript
      */
     uint32_t CheckDDF(lua_State* L, const dmDDF::Descriptor* descriptor, char* buffer, uint32_t buffer_size, int index);
 
+    /**
+     * Serialize a table in a single pass, growing the output buffer when needed.
+     * Unlike CheckTable, there's no need to call CheckTableSize beforehand.
+     * @param L Lua state
+     * @param buffer Initial buffer (must be DM_ALIGNED(16)). May be 0x0
+     * @param buffer_size Initial buffer size
+     * @param out_buffer Buffer holding the serialized table. If it differs from buffer, it was
+     *                   allocated with dmMemory::AlignedMalloc and must be freed with dmMemory::AlignedFree
+     * @param index Index of the table
+     * @return Number of bytes used in out_buffer
+     */
+    uint32_t CheckTableDynamic(lua_State* L, char* buffer, uint32_t buffer_size, char** out_buffer, int index);
+
     /**
      * Push DDF message to Lua stack
      * @param L Lua state
@@ -615,6 +628,54 @@ namespace dmScript
     */
     uint32_t GetLuaGCCount(lua_State* L);
 
+    /** Garbage collector statistics, see StepGC
+    */
+    struct GCStats
+    {
+        /// Time spent collecting in the last StepGC, in microseconds
+        uint32_t m_Time;
+        /// Number of incremental steps in the last StepGC
+        uint32_t m_Steps;
+        /// Size of each incremental step, in kilobytes
+        uint32_t m_StepSize;
+        /// Kilobytes allocated since the previous StepGC
+        uint32_t m_Allocated;
+        /// Size of the Lua heap after the last StepGC, in kilobytes
+        uint32_t m_HeapSize;
+        /// Number of completed collection cycles
+        uint32_t m_Cycles;
+    };
+
+    /** Sets the time budget for the garbage collection done by StepGC.
+    * While a budget is set, the automatic garbage collection is stopped and the collection
+    * is done incrementally by StepGC instead. A budget of 0 restores the automatic garbage collection.
+    * The initial budget is read from the project setting script.gc_budget. The budget is per context,
+    * so an engine running several contexts should split the frame budget between them.
+    * @param context script context
+    * @param budget time budget per call to StepGC, in microseconds
+    */
+    void SetGCBudget(HContext context, uint32_t budget);
+
+    /** Gets the time budget for the garbage collection done by StepGC
+    * @param context script context
+    * @return time budget in microseconds, 0 if the automatic garbage collection is used
+    */
+    uint32_t GetGCBudget(HContext context);
+
+    /** Runs incremental garbage collection steps until the time budget is used or the current
+    * collection cycle is finished. Meant to be called once per frame, when the frame is done.
+    * The step size follows the allocation rate, so that the collector keeps up even with a small budget.
+    * Does nothing if no budget is set.
+    * @param context script context
+    */
+    void StepGC(HContext context);
+
+    /** Gets the garbage collector statistics
+    * @param context script context
+    * @param stats [out] statistics
+    */
+    void GetGCStats(HContext context, GCStats* stats);
+
 // DEPRECATED
 // I really don't like this callback setup (mistake on my part). It's clunky.
 // Perhaps better to have a lambda function? (now that all compilers support C++11) /MAWE
@@ -0,0 +1,170 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include <string.h>
+#include <dlib/configfile.h>
+#include <dlib/math.h>
+#include <dlib/profile.h>
+#include <dlib/time.h>
+
+#include "script.h"
+#include "script_private.h"
+
+extern "C"
+{
+#include <lua/lua.h>
+}
+
+DM_PROPERTY_EXTERN(rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCTime, 0, FrameReset, "us spent in budgeted Lua garbage collection", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCSteps, 0, FrameReset, "# budgeted Lua garbage collection steps", &rmtp_Script);
+DM_PROPERTY_U32(rmtp_LuaGCHeap, 0, FrameReset, "kb in the Lua heaps after the budgeted Lua garbage collection", &rmtp_Script);
+
+namespace dmScript
+{
+    // Smallest incremental step, in kilobytes
+    static const uint32_t GC_MIN_STEP_SIZE = 16;
+
+    // A new cycle is started when the heap has grown this much (in percent) since the
+    // last cycle finished. Same as the default "pause" of the Lua collector.
+    static const uint32_t GC_PAUSE = 200;
+
+    // If the budget is too small to keep up and the heap grows past this (in percent of the heap
+    // after the last cycle), the automatic collection is left on until the cycle is finished.
+    static const uint32_t GC_EMERGENCY_PAUSE = 400;
+
+    // Heaps smaller than this (in kilobytes) never trigger the emergency collection
+    static const uint32_t GC_EMERGENCY_MIN_HEAP = 1024;
+
+    void InitializeGC(HContext context)
+    {
+        GCState& gc = context->m_GC;
+        memset(&gc, 0, sizeof(gc));
+        gc.m_Stats.m_StepSize = GC_MIN_STEP_SIZE;
+
+        uint32_t budget = 0;
+        if (context->m_ConfigFile)
+        {
+            budget = (uint32_t) dmMath::Max(0, dmConfigFile::GetInt(context->m_ConfigFile, "script.gc_budget", 0));
+        }
+        SetGCBudget(context, budget);
+    }
+
+    void SetGCBudget(HContext context, uint32_t budget)
+    {
+        GCState& gc = context->m_GC;
+        lua_State* L = context->m_LuaState;
+
+        gc.m_Budget = budget;
+        if (budget > 0)
+        {
+            lua_gc(L, LUA_GCSTOP, 0);
+            gc.m_HeapAfterStep = GetLuaGCCount(L);
+            if (gc.m_HeapAfterCycle == 0)
+            {
+                gc.m_HeapAfterCycle = gc.m_HeapAfterStep;
+            }
+        }
+        else
+        {
+            lua_gc(L, LUA_GCRESTART, 0);
+        }
+    }
+
+    uint32_t GetGCBudget(HContext context)
+    {
+        return context->m_GC.m_Budget;
+    }
+
+    void StepGC(HContext context)
+    {
+        GCState& gc = context->m_GC;
+        if (gc.m_Budget == 0)
+        {
+            return;
+        }
+
+        DM_PROFILE("LuaGC");
+        lua_State* L = context->m_LuaState;
+
+        // The automatic collection is stopped, so the heap only grows between the calls
+        uint32_t heap = GetLuaGCCount(L);
+        uint32_t allocated = heap > gc.m_HeapAfterStep ? heap - gc.m_HeapAfterStep : 0;
+        gc.m_AllocRate = (gc.m_AllocRate * 7 + allocated) / 8;
+
+        // Each step is sized to collect twice the allocation rate. The first step is always
+        // taken, so that the collector keeps up with the allocations even if the budget is small.
+        uint32_t step_size = dmMath::Max(GC_MIN_STEP_SIZE, gc.m_AllocRate * 2);
+
+        if (!gc.m_CycleActive && (uint64_t)heap * 100 >= (uint64_t)gc.m_HeapAfterCycle * GC_PAUSE)
+        {
+            gc.m_CycleActive = 1;
+        }
+
+        uint64_t start = dmTime::GetTime();
+        uint64_t now = start;
+        uint32_t steps = 0;
+        while (gc.m_CycleActive)
+        {
+            int cycle_done = lua_gc(L, LUA_GCSTEP, (int)step_size);
+            ++steps;
+            now = dmTime::GetTime();
+            if (cycle_done)
+            {
+                gc.m_CycleActive = 0;
+                gc.m_HeapAfterCycle = GetLuaGCCount(L);
+                ++gc.m_Stats.m_Cycles;
+            }
+            if (now - start >= gc.m_Budget)
+            {
+                break;
+            }
+        }
+
+        heap = GetLuaGCCount(L);
+
+        // Stepping re-enables the automatic collection, so stop it again unless we're falling behind
+        bool falling_behind = gc.m_CycleActive && heap > GC_EMERGENCY_MIN_HEAP &&
+                                (uint64_t)heap * 100 > (uint64_t)gc.m_HeapAfterCycle * GC_EMERGENCY_PAUSE;
+        if (falling_behind)
+        {
+            lua_gc(L, LUA_GCRESTART, 0);
+        }
+        else
+        {
+            lua_gc(L, LUA_GCSTOP, 0);
+        }
+
+        gc.m_HeapAfterStep = heap;
+        gc.m_Stats.m_Time = (uint32_t)(now - start);
+        gc.m_Stats.m_Steps = steps;
+        gc.m_Stats.m_StepSize = step_size;
+        gc.m_Stats.m_Allocated = allocated;
+        gc.m_Stats.m_HeapSize = heap;
+
+        DM_PROPERTY_ADD_U32(rmtp_LuaGCTime, gc.m_Stats.m_Time);
+        DM_PROPERTY_ADD_U32(rmtp_LuaGCSteps, steps);
+        DM_PROPERTY_ADD_U32(rmtp_LuaGCHeap, heap);
+    }
+
+    void GetGCStats(HContext context, GCStats* stats)
+    {
+        *stats = context->m_GC.m_Stats;
+        if (context->m_GC.m_Budget == 0)
+        {
+            stats->m_HeapSize = GetLuaGCCount(context->m_LuaState);
+        }
+    }
+}
@@ -19,13 +19,16 @@
 #include <string.h>
 
 #include <ddf/ddf.h>
+#include <dlib/array.h>
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/path.h>
 #include <dlib/uri.h>
 
 #include "script.h"
+#include "script_private.h"
 #include "http_ddf.h"
 
 #include "script_http.h"
@@ -50,9 +53,20 @@ namespace dmScript
      * @namespace http
      */
 
+    // A request with a progress callback. The callback is invoked from the update of the script context
+    // that made the request. It's 0 if that context has been finalized before the request was done.
+    struct HttpProgress
+    {
+        dmHttpService::Progress m_Progress;
+        HContext                m_Context;
+        LuaCallbackInfo*        m_Callback;
+        uint64_t                m_Reported;
+    };
+
     dmHttpService::HHttpService g_Service = 0;
     int g_ServiceRefCount = 0;
     uint64_t g_Timeout = 0;
+    dmArray<HttpProgress*> g_Progress;
 
     /*# perform a HTTP/HTTPS request
      * Perform a HTTP/HTTPS request.
@@ -77,14 +91,17 @@ namespace dmScript
      * - [type:string] `response`: the response data (if not saved on disc)
      * - [type:table] `headers`: all the returned headers
      * - [type:string] `path`: the stored path (if saved to disc)
-     * - [type:string] `error`: if any unforeseen errors occurred (e.g. file I/O)
+     * - [type:string] `error`: if the request failed (e.g. `TIMEOUT`), or any unforeseen errors occurred (e.g. file I/O)
      *
      * @param [headers] [type:table] optional table with custom headers
      * @param [post_data] [type:string] optional data to send
      * @param [options] [type:table] optional table with request parameters. Supported entries:
      *
      * - [type:number] `timeout`: timeout in seconds
-     * - [type:string] `path`: path on disc where to download the file. Only overwrites the path if status is 200. [icon:attention] Not available in HTML5 build
+     * - [type:string] `path`: path on disc where to download the file. Only overwrites the path if status is 200 (or 206 for range requests). The response is written to the file as it is received, and is never held in memory. [icon:attention] Not available in HTML5 build
+     * - [type:number] `range_start`: request a byte range of the resource, starting at this offset. Sends a `Range` header. [icon:attention] Not available in HTML5 build
+     * - [type:number] `range_end`: last byte (inclusive) of the requested range. Defaults to the end of the resource. [icon:attention] Not available in HTML5 build
+     * - [type:function(self, received, total)] `progress`: called at most once per frame while the response is received, with the number of bytes received so far and the expected total (0 if unknown). [icon:attention] Not available in HTML5 build
      * - [type:boolean] `ignore_cache`: don't return cached data if we get a 304. [icon:attention] Not available in HTML5 build
      * - [type:boolean] `chunked_transfer`: use chunked transfer encoding for https requests larger than 16kb. Defaults to true. [icon:attention] Not available in HTML5 build
      *
@@ -105,6 +122,25 @@ namespace dmScript
      *     http.request("http://www.google.com", "GET", http_result)
      * end
      * ```
+     *
+     * Download a large file straight to disc, with progress reports.
+     *
+     * ```lua
+     * local function http_progress(self, received, total)
+     *     print("received " .. received .. " of " .. total .. " bytes")
+     * end
+     *
+     * local function http_result(self, _, response)
+     *     if response.status == 200 and not response.error then
+     *         print("saved to " .. response.path)
+     *     end
+     * end
+     *
+     * function init(self)
+     *     local path = sys.get_save_file("mygame", "content.zip")
+     *     http.request("https://example.com/content.zip", "GET", http_result, nil, nil, { path = path, progress = http_progress })
+     * end
+     * ```
      */
     int Http_Request(lua_State* L)
     {
@@ -186,6 +222,9 @@ namespace dmScript
             const char* path = 0;
             bool ignore_cache = false;
             bool chunked_transfer = true;
+            double range_start = -1;
+            double range_end = -1;
+            bool has_progress = false;
             if (top > 5 && !lua_isnil(L, 6)) {
                 luaL_checktype(L, 6, LUA_TTABLE);
                 lua_pushvalue(L, 6);
@@ -208,17 +247,72 @@ namespace dmScript
                     {
                         chunked_transfer = lua_toboolean(L, -1);
                     }
+                    else if (strcmp(attr, "range_start") == 0)
+                    {
+                        range_start = luaL_checknumber(L, -1);
+                    }
+                    else if (strcmp(attr, "range_end") == 0)
+                    {
+                        range_end = luaL_checknumber(L, -1);
+                    }
+                    else if (strcmp(attr, "progress") == 0)
+                    {
+                        luaL_checktype(L, -1, LUA_TFUNCTION);
+                        has_progress = true;
+                    }
 
                     lua_pop(L, 1);
                 }
                 lua_pop(L, 1);
             }
 
-            // ddf + max method and url string lengths incl. null character
-            char buf[sizeof(dmHttpDDF::HttpRequest) + max_method_len + 1 + max_url_len + 1];
+            const uint32_t path_len = path ? (uint32_t)strlen(path) : 0;
+            if (path_len >= DMPATH_MAX_PATH) {
+                free(headers);
+                free(request_data);
+                assert(top == lua_gettop(L));
+                return luaL_error(L, "http.request does not support paths longer than %d characters.", DMPATH_MAX_PATH - 1);
+            }
+
+            if (range_start >= 0) {
+                char range[64];
+                if (range_end >= 0) {
+                    dmSnPrintf(range, sizeof(range), "Range:bytes=%llu-%llu\n", (unsigned long long) range_start, (unsigned long long) range_end);
+                } else {
+                    dmSnPrintf(range, sizeof(range), "Range:bytes=%llu-\n", (unsigned long long) range_start);
+                }
+                uint32_t range_len = strlen(range);
+                headers = (char*) realloc(headers, headers_length + range_len);
+                memcpy(headers + headers_length, range, range_len);
+                headers_length += range_len;
+            }
+
+            // The service reports the progress, and we invoke the callback from HttpUpdate
+            HttpProgress* progress = 0;
+            if (has_progress) {
+                lua_getfield(L, 6, "progress");
+                LuaCallbackInfo* callback = dmScript::CreateCallback(L, lua_gettop(L));
+                lua_pop(L, 1);
+                if (callback) {
+                    progress = new HttpProgress;
+                    progress->m_Context = dmScript::GetScriptContext(L);
+                    progress->m_Callback = callback;
+                    progress->m_Reported = 0;
+                    if (g_Progress.Full()) {
+                        g_Progress.OffsetCapacity(16);
+                    }
+                    g_Progress.Push(progress);
+                }
+            }
+
+            // ddf + max method, url and path string lengths incl. null character
+            char buf[sizeof(dmHttpDDF::HttpRequest) + max_method_len + 1 + max_url_len + 1 + DMPATH_MAX_PATH];
             char* string_buf = buf + sizeof(dmHttpDDF::HttpRequest);
             dmStrlCpy(string_buf, method, method_len + 1);
             dmStrlCpy(string_buf + method_len + 1, url, url_len + 1);
+            if (path) {
+                dmStrlCpy(string_buf + method_len + 1 + url_len + 1, path, path_len + 1);
+            }
 
             dmHttpDDF::HttpRequest* request = (dmHttpDDF::HttpRequest*) buf;
             request->m_Method = (const char*) (sizeof(*request));
@@ -228,11 +322,13 @@ namespace dmScript
             request->m_Request = (uint64_t) request_data;
             request->m_RequestLength = request_data_length;
             request->m_Timeout = timeout;
-            request->m_Path = path;
+            // NOTE: The path is copied, as the Lua string may be collected before the request is handled
+            request->m_Path = path ? (const char*) (sizeof(*request) + method_len + 1 + url_len + 1) : 0;
             request->m_IgnoreCache = ignore_cache;
             request->m_ChunkedTransfer = chunked_transfer;
+            request->m_Progress = (uint64_t) (progress ? &progress->m_Progress : 0);
 
-            uint32_t post_len = sizeof(dmHttpDDF::HttpRequest) + method_len + 1 + url_len + 1;
+            uint32_t post_len = sizeof(dmHttpDDF::HttpRequest) + method_len + 1 + url_len + 1 + (path ? path_len + 1 : 0);
             dmMessage::URL receiver;
             dmMessage::ResetURL(&receiver);
             receiver.m_Socket = dmHttpService::GetSocket(g_Service);
@@ -240,6 +336,9 @@ namespace dmScript
             dmMessage::Result r = dmMessage::Post(&sender, &receiver, dmHttpDDF::HttpRequest::m_DDFHash, 0, (uintptr_t)callback, (uintptr_t) dmHttpDDF::HttpRequest::m_DDFDescriptor, buf, post_len, 0);
             if (r != dmMessage::RESULT_OK) {
                 dmLogError("Failed to create HTTP request");
+                if (progress) {
+                    dmAtomicStore32(&progress->m_Progress.m_Done, 1);
+                }
             }
             assert(top == lua_gettop(L));
             return 0;
@@ -273,7 +372,6 @@ namespace dmScript
 
             dmHttpService::Params params;
             if (config_file) {
-                params.m_ThreadCount = dmConfigFile::GetInt(config_file, "network.http_thread_count", params.m_ThreadCount);
                 params.m_UseHttpCache = dmConfigFile::GetInt(config_file, "network.http_cache_enabled", params.m_UseHttpCache);
             }
 #if defined(DM_NO_HTTP_CACHE)
@@ -295,13 +393,95 @@ namespace dmScript
         assert(top == lua_gettop(L));
     }
 
+    static void InvokeProgressCallback(LuaCallbackInfo* callback, uint64_t received, uint64_t total)
+    {
+        if (!dmScript::IsCallbackValid(callback))
+            return;
+
+        lua_State* L = dmScript::GetCallbackLuaContext(callback);
+        int top = lua_gettop(L);
+
+        if (!dmScript::SetupCallback(callback))
+        {
+            dmLogError("Failed to setup http progress callback");
+            return;
+        }
+
+        lua_pushnumber(L, (lua_Number) received);
+        lua_pushnumber(L, (lua_Number) total);
+        dmScript::PCall(L, 3, 0); // self + 2
+
+        dmScript::TeardownCallback(callback);
+        assert(top == lua_gettop(L));
+    }
+
+    static void HttpUpdate(HContext context)
+    {
+        uint32_t i = 0;
+        while (i < g_Progress.Size())
+        {
+            HttpProgress* progress = g_Progress[i];
+            // Requests of other contexts are handled in their own update
+            if (progress->m_Context != context && progress->m_Context != 0)
+            {
+                ++i;
+                continue;
+            }
+            // Read m_Done first, the counters are final once it's set
+            bool done = dmAtomicGet32(&progress->m_Progress.m_Done) != 0;
+            uint64_t received, total;
+            {
+                DM_SPINLOCK_SCOPED_LOCK(progress->m_Progress.m_Lock);
+                received = progress->m_Progress.m_Received;
+                total = progress->m_Progress.m_Total;
+            }
+            if (progress->m_Callback && received != progress->m_Reported)
+            {
+                progress->m_Reported = received;
+                InvokeProgressCallback(progress->m_Callback, received, total);
+            }
+
+            if (done)
+            {
+                if (progress->m_Callback)
+                    dmScript::DestroyCallback(progress->m_Callback);
+                delete progress;
+                g_Progress.EraseSwap(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
     static void HttpFinalize(HContext context)
     {
+        // The service may still report the progress of unfinished requests, so they are kept
+        // without a callback, and released by the update of another context
+        for (uint32_t i = 0; i < g_Progress.Size(); ++i)
+        {
+            HttpProgress* progress = g_Progress[i];
+            if (progress->m_Context == context)
+            {
+                dmScript::DestroyCallback(progress->m_Callback);
+                progress->m_Callback = 0;
+                progress->m_Context = 0;
+            }
+        }
+
         assert(g_ServiceRefCount > 0);
         g_ServiceRefCount--;
         if (g_ServiceRefCount == 0) {
             dmHttpService::Delete(g_Service);
             g_Service = 0;
+
+            // The service no longer accesses the progress of unfinished requests
+            for (uint32_t i = 0; i < g_Progress.Size(); ++i)
+            {
+                delete g_Progress[i];
+            }
+            g_Progress.SetSize(0);
         }
     }
 
@@ -309,7 +489,7 @@ namespace dmScript
     {
         static ScriptExtension sl;
         sl.Initialize = HttpInitialize;
-        sl.Update = 0x0;
+        sl.Update = HttpUpdate;
         sl.Finalize = HttpFinalize;
         sl.NewScriptWorld = 0x0;
         sl.DeleteScriptWorld = 0x0;
@@ -14,38 +14,9 @@
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
-#include <dlib/path.h>
-#include <dlib/sys.h>
 
 namespace dmScript
 {
-    static bool WriteResponseToFile(const char* path, const void* data, uint32_t data_len)
-    {
-        char tmpname[DMPATH_MAX_PATH];
-        dmStrlCpy(tmpname, path, sizeof(tmpname));
-        dmStrlCat(tmpname, "._httptmp", sizeof(tmpname));
-        FILE* f = fopen(tmpname, "wb");
-        if (!f) {
-            return false;
-        }
-        size_t nwritten = fwrite(data, 1, data_len, f);
-        fflush(f);
-        fclose(f);
-        if (nwritten != data_len)
-        {
-            dmLogError("Failed to write '%u' bytes to '%s'", data_len, path);
-            return false;
-        }
-
-        dmSys::Result result = dmSys::Rename(path, tmpname);
-        if (dmSys::RESULT_OK != result)
-        {
-            dmLogError("Failed to rename '%s' to '%s'", tmpname, path);
-            return false;
-        }
-        return true;
-    }
-
     Result HttpResponseDecoder(lua_State* L, const dmDDF::Descriptor* desc, const char* data)
     {
         assert(desc == dmHttpDDF::HttpResponse::m_DDFDescriptor);
@@ -59,17 +30,16 @@ namespace dmScript
         lua_pushinteger(L, resp->m_Status);
         lua_setfield(L, -2, "status");
 
-        if (resp->m_Path)
+        if (resp->m_Error)
         {
-            if (resp->m_Status == 200) {
-                if (!WriteResponseToFile(resp->m_Path, response, resp->m_ResponseLength))
-                {
-                    lua_pushstring(L, "Failed to write to temp file");
-                    lua_setfield(L, -2, "error");
-                }
-            }
+            lua_pushstring(L, resp->m_Error);
+            lua_setfield(L, -2, "error");
+        }
 
-            lua_pushstring(L, resp->m_Path);
+        if (resp->m_Path)
+        {
+            // The response was streamed to the file by the http service
+            lua_pushstring(L, (const char*) ((uintptr_t) resp + (uintptr_t) resp->m_Path));
             lua_setfield(L, -2, "path");
         } else {
             lua_pushlstring(L, response, resp->m_ResponseLength);
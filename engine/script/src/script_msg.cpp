@@ -22,6 +22,7 @@
 #include <dlib/dlib.h>
 #include <dlib/dstrings.h>
 #include <dlib/math.h>
+#include <dlib/memory.h>
 #include <dlib/message.h>
 
 #include <ddf/ddf.h>
@@ -51,6 +52,13 @@ namespace dmScript
 
     const uint32_t MAX_MESSAGE_DATA_SIZE = 2048;
 
+    // Tables that don't fit in MAX_MESSAGE_DATA_SIZE are serialized into a separate allocation
+    // that is referenced by the message rather than copied into the socket's message pages
+    static void FreeExternalMessageData(dmMessage::Message* message)
+    {
+        dmMemory::AlignedFree((void*)dmMessage::GetData(message));
+    }
+
     bool IsURL(lua_State *L, int index)
     {
         return (dmMessage::URL*)dmScript::ToUserType(L, index, SCRIPT_URL_TYPE_HASH);
@@ -457,7 +465,8 @@ namespace dmScript
      * - `"."` the current game object
      * - `"#"` the current component
      *
-     * [icon:attention] There is a 2 kilobyte limit to the message parameter table size.
+     * [icon:attention] There is a 2 kilobyte limit to the size of messages with a predefined message id (e.g. "play_animation").
+     * Custom messages may be larger, but large tables are more expensive to serialize and should be avoided in hot paths.
      *
      * @name msg.post
      * @param receiver [type:string|url|hash] The receiver must be a string in URL-format, a URL object or a hashed string.
@@ -501,6 +510,7 @@ namespace dmScript
         }
 
         char DM_ALIGNED(16) data[MAX_MESSAGE_DATA_SIZE];
+        char* payload = data;
         uint32_t data_size = 0;
 
 
@@ -527,13 +537,25 @@ namespace dmScript
         {
             if (!lua_isnil(L, 3))
             {
-                data_size = dmScript::CheckTable(L, data, MAX_MESSAGE_DATA_SIZE, 3);
+                data_size = dmScript::CheckTableDynamic(L, data, MAX_MESSAGE_DATA_SIZE, &payload, 3);
             }
         }
 
         assert(top == lua_gettop(L));
 
-        dmMessage::Result result = dmMessage::Post(&sender, &receiver, message_id, 0, (uintptr_t) desc, data, data_size, 0);
+        dmMessage::Result result;
+        if (payload != data)
+        {
+            result = dmMessage::PostExternal(&sender, &receiver, message_id, 0, 0, (uintptr_t) desc, payload, data_size, FreeExternalMessageData);
+            if (result != dmMessage::RESULT_OK)
+            {
+                dmMemory::AlignedFree(payload);
+            }
+        }
+        else
+        {
+            result = dmMessage::Post(&sender, &receiver, message_id, 0, (uintptr_t) desc, data, data_size, 0);
+        }
         if (result == dmMessage::RESULT_SOCKET_NOT_FOUND)
         {
             char receiver_buffer[64];
@@ -67,6 +67,17 @@ namespace dmScript
 
     typedef struct ScriptExtension* HScriptExtension;
 
+    // State of the budgeted garbage collection, see StepGC
+    struct GCState
+    {
+        GCStats     m_Stats;
+        uint32_t    m_Budget;           // Microseconds per StepGC, 0 when the automatic collection is used
+        uint32_t    m_AllocRate;        // Smoothed allocation rate, kilobytes per StepGC
+        uint32_t    m_HeapAfterStep;    // Heap size after the previous StepGC, in kilobytes
+        uint32_t    m_HeapAfterCycle;   // Heap size after the last completed cycle, in kilobytes
+        uint8_t     m_CycleActive : 1;
+    };
+
     struct Context
     {
         dmConfigFile::HConfig       m_ConfigFile;
@@ -77,11 +88,14 @@ namespace dmScript
         dmArray<HScriptExtension>   m_ScriptExtensions;
         lua_State*                  m_LuaState;
         int                         m_ContextTableRef;
+        GCState                     m_GC;
         bool                        m_EnableExtensions;
     };
 
     HContext GetScriptContext(lua_State* L);
 
+    void InitializeGC(HContext context);
+
     bool ResolvePath(lua_State* L, const char* path, uint32_t path_size, dmhash_t& out_hash);
 
     bool GetURL(lua_State* L, dmMessage::URL& out_url);
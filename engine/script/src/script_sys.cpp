@@ -134,14 +134,8 @@ union SaveLoadBuffer
 
         luaL_checktype(L, 2, LUA_TTABLE);
 
-        uint32_t table_size = CheckTableSize(L, 2);
-
-        char* buffer = Sys_SetupTableSerializationBuffer(table_size);
-        if (!buffer)
-        {
-            return luaL_error(L, "Could not allocate %d bytes for table serialization.", table_size);
-        }
-        uint32_t n_used = CheckTable(L, buffer, table_size, 2);
+        char* buffer = 0;
+        uint32_t n_used = CheckTableDynamic(L, g_saveload.m_buffer, MAX_BUFFER_SIZE, &buffer, 2);
 
 #if !defined(__EMSCRIPTEN__)
 
@@ -1339,14 +1333,8 @@ union SaveLoadBuffer
         DM_LUA_STACK_CHECK(L, 1);
         luaL_checktype(L, 1, LUA_TTABLE);
 
-        uint32_t table_size = CheckTableSize(L, 1);
-        char* buffer = Sys_SetupTableSerializationBuffer(table_size);
-        if (!buffer)
-        {
-            return luaL_error(L, "Could not allocate %d bytes for table serialization.", table_size);
-        }
-
-        uint32_t n_used = CheckTable(L, buffer, table_size, 1);
+        char* buffer = 0;
+        uint32_t n_used = CheckTableDynamic(L, g_saveload.m_buffer, MAX_BUFFER_SIZE, &buffer, 1);
         lua_pushlstring(L, (const char*)buffer, n_used);
         Sys_FreeTableSerializationBuffer(buffer);
         return 1;
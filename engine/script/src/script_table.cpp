@@ -16,6 +16,7 @@
 #include <string.h>
 #include <dlib/array.h>
 #include <dlib/log.h>
+#include <dlib/memory.h>
 #include <dlib/dstrings.h>
 #include <dlib/static_assert.h>
 #include "script.h"
@@ -191,17 +192,94 @@ namespace dmScript
         return supported;
     }
 
-    static char* WriteEncodedIndex(lua_State* L, lua_Number index, const TableHeader& header, char* buffer, const char* buffer_end)
+    /*
+     * Output buffer used when serializing a table.
+     * All positions are kept as offsets from m_Buffer, since a growable writer
+     * may move the data to a larger allocation while serializing.
+     */
+    struct TableWriter
+    {
+        char*    m_Buffer;
+        char*    m_InitialBuffer;   // Caller owned buffer, never freed by the writer
+        uint32_t m_Capacity;
+        uint32_t m_Cursor;
+        uint8_t  m_CanGrow : 1;
+    };
+
+    static void InitTableWriter(TableWriter& writer, char* buffer, uint32_t buffer_size, bool can_grow)
+    {
+        writer.m_Buffer = buffer;
+        writer.m_InitialBuffer = buffer;
+        writer.m_Capacity = buffer ? buffer_size : 0;
+        writer.m_Cursor = 0;
+        writer.m_CanGrow = can_grow;
+    }
+
+    // Returns a pointer to at least 'size' writable bytes at the cursor, or 0x0 if they don't fit
+    static char* ReserveTableBuffer(TableWriter& writer, uint32_t size)
+    {
+        if (writer.m_Capacity - writer.m_Cursor >= size)
+        {
+            return writer.m_Buffer + writer.m_Cursor;
+        }
+        if (!writer.m_CanGrow)
+        {
+            return 0;
+        }
+
+        uint32_t capacity = writer.m_Capacity < 1024 ? 1024 : writer.m_Capacity;
+        while (capacity - writer.m_Cursor < size)
+        {
+            capacity *= 2;
+        }
+
+        char* buffer = 0;
+        if (dmMemory::AlignedMalloc((void**)&buffer, 16, capacity) != dmMemory::RESULT_OK)
+        {
+            return 0;
+        }
+        if (writer.m_Cursor > 0)
+        {
+            memcpy(buffer, writer.m_Buffer, writer.m_Cursor);
+        }
+        if (writer.m_Buffer != writer.m_InitialBuffer)
+        {
+            dmMemory::AlignedFree(writer.m_Buffer);
+        }
+        writer.m_Buffer = buffer;
+        writer.m_Capacity = capacity;
+        return writer.m_Buffer + writer.m_Cursor;
+    }
+
+    // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
+    static bool AlignTableBuffer(TableWriter& writer)
+    {
+        uint32_t aligned_cursor = (writer.m_Cursor + sizeof(float)-1) & ~(sizeof(float)-1);
+        uint32_t align_size = aligned_cursor - writer.m_Cursor;
+        char* buffer = ReserveTableBuffer(writer, align_size);
+        if (!buffer)
+        {
+            return false;
+        }
+#ifndef NDEBUG
+        memset(buffer, 0, align_size);
+#endif
+        writer.m_Cursor = aligned_cursor;
+        return true;
+    }
+
+    static void WriteEncodedIndex(lua_State* L, lua_Number index, const TableHeader& header, TableWriter& writer)
     {
         if (0 == header.m_Version)
         {
-            if (buffer_end - buffer < 2)
+            char* buffer = ReserveTableBuffer(writer, sizeof(uint16_t));
+            if (!buffer)
                 luaL_error(L, "table too large");
             if (index > 0xffff)
                 luaL_error(L, "index out of bounds, max is %d", 0xffff);
             uint16_t key = (uint16_t)index;
             memcpy(buffer, &key, sizeof(uint16_t));
-            buffer += sizeof(uint16_t);
+            writer.m_Cursor += sizeof(uint16_t);
         }
         else if ((1 == header.m_Version) || (2 == header.m_Version))
         {
@@ -209,15 +287,23 @@ namespace dmScript
                 luaL_error(L, "index out of bounds, max is %d", 0xffffffff);
             }
             uint32_t key = (uint32_t)index;
-            bool encoded = EncodeMSB(key, buffer, buffer_end);
+            uint32_t encoded_size = 1;
+            for (uint32_t v = key; 0x7f < v; v >>= 7)
+            {
+                ++encoded_size;
+            }
+            char* buffer = ReserveTableBuffer(writer, encoded_size);
+            bool encoded = buffer != 0 && EncodeMSB(key, buffer, buffer + encoded_size);
             if (!encoded)
             {
                 luaL_error(L, "table too large");
             }
+            writer.m_Cursor += encoded_size;
         }
         else if ((3 == header.m_Version) || (4 == header.m_Version))
         {
-            if (buffer_end - buffer < 4)
+            char* buffer = ReserveTableBuffer(writer, 4);
+            if (!buffer)
                 luaL_error(L, "table too large");
             if (index < 0)
                 index = -index;
@@ -228,32 +314,32 @@ namespace dmScript
             *buffer++ = (uint8_t)((key >> 8) & 0xFF);
             *buffer++ = (uint8_t)((key >> 16) & 0xFF);
             *buffer++ = (uint8_t)((key >> 24) & 0xFF);
+            writer.m_Cursor += 4;
         }
         else
         {
             assert(0);
         }
-        return buffer;
     }
 
     // When storing/packing lua data to a byte array, we now use the binary lua string interface
-    static uint32_t SaveTSTRING(lua_State* L, int index, char* buffer, uint32_t buffer_size, const char* buffer_end, uint32_t count)
+    static void SaveTSTRING(lua_State* L, int index, TableWriter& writer, uint32_t count)
     {
         size_t value_len = 0;
         const char* value = lua_tolstring(L, index, &value_len);
         uint32_t total_size = value_len + sizeof(uint32_t);
-        if (buffer_end - buffer < (intptr_t)total_size)
+        char* buffer = ReserveTableBuffer(writer, total_size);
+        if (!buffer)
         {
-            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at '%s' for element #%d", buffer_size, value, count);
+            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at '%s' for element #%d", writer.m_Capacity, value, count);
         }
 
         uint32_t len = (uint32_t)value_len;
         memcpy(buffer, &len, sizeof(uint32_t));
         buffer += sizeof(uint32_t);
         memcpy(buffer, value, value_len);
-        return total_size;
+        writer.m_Cursor += total_size;
     }
-
     // When loading older save games, we will use the old unpack method (with truncated c strings)
     static uint32_t LoadOldTSTRING(lua_State* L, const char* buffer, const char* buffer_end, uint32_t count, PushTableLogger& logger)
     {
@@ -448,13 +534,17 @@ namespace dmScript
         return size;
     }
 
-    uint32_t DoCheckTable(lua_State* L, const TableHeader& header, const char* original_buffer, char* buffer, uint32_t buffer_size, int index, dmArray<const void*>& table_stack)
+    static void TableBufferFullError(lua_State* L, const TableWriter& writer, int key_type, uint32_t count)
+    {
+        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", writer.m_Capacity, lua_typename(L, key_type), count);
+    }
+
+    static uint32_t DoCheckTable(lua_State* L, const TableHeader& header, TableWriter& writer, int index, dmArray<const void*>& table_stack)
     {
         int top = lua_gettop(L);
         (void)top;
 
-        char* buffer_start = buffer;
-        char* buffer_end = buffer + buffer_size;
+        uint32_t table_start = writer.m_Cursor;
         luaL_checktype(L, index, LUA_TTABLE);
 
         const void* table_data = (const void*)lua_topointer(L, index);
@@ -467,12 +557,12 @@ namespace dmScript
         lua_pushvalue(L, index);
         lua_pushnil(L);
 
-        if (buffer_size < 4)
+        // Make room for count (4 bytes)
+        if (!ReserveTableBuffer(writer, 4))
         {
             luaL_error(L, "table too large");
         }
-        // Make room for count (4 bytes)
-        buffer += 4;
+        writer.m_Cursor += 4;
 
         uint32_t count = 0;
         while (lua_next(L, -2) != 0)
@@ -492,57 +582,53 @@ namespace dmScript
                 luaL_error(L, "keys in table must be of type number or string (found %s)", lua_typename(L, key_type));
             }
 
-            if (buffer_end - buffer < 2)
+            char* buffer = ReserveTableBuffer(writer, 2);
+            if (!buffer)
             {
-                luaL_error(L, "buffer (%d bytes) too small for table, exceeded at key for element #%d", buffer_size, count);
+                luaL_error(L, "buffer (%d bytes) too small for table, exceeded at key for element #%d", writer.m_Capacity, count);
             }
 
             if (key_type == LUA_TSTRING)
             {
-                (*buffer++) = (char) LUA_TSTRING;
-                (*buffer++) = (char) value_type;
-                buffer += SaveTSTRING(L, -2, buffer, buffer_size, buffer_end, count);
+                buffer[0] = (char) LUA_TSTRING;
+                buffer[1] = (char) value_type;
+                writer.m_Cursor += 2;
+                SaveTSTRING(L, -2, writer, count);
             }
             else if (key_type == LUA_TNUMBER)
             {
                 lua_Number key = lua_tonumber(L, -2);
-                (*buffer++) = (char) (key >= 0 ? LUA_TNUMBER : LUA_TNEGATIVENUMBER);
-                (*buffer++) = (char) value_type;
-                buffer = WriteEncodedIndex(L, key, header, buffer, buffer_end);
+                buffer[0] = (char) (key >= 0 ? LUA_TNUMBER : LUA_TNEGATIVENUMBER);
+                buffer[1] = (char) value_type;
+                writer.m_Cursor += 2;
+                WriteEncodedIndex(L, key, header, writer);
             }
 
             switch (value_type)
             {
                 case LUA_TBOOLEAN:
                 {
-                    if (buffer_end - buffer < 1)
+                    buffer = ReserveTableBuffer(writer, 1);
+                    if (!buffer)
                     {
-                        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                        TableBufferFullError(L, writer, key_type, count);
                     }
-                    (*buffer++) = (char) lua_toboolean(L, -1);
+                    *buffer = (char) lua_toboolean(L, -1);
+                    writer.m_Cursor += 1;
                 }
                 break;
 
                 case LUA_TNUMBER:
                 {
-                    // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
-                    intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
-                    intptr_t align_size = aligned_buffer - (intptr_t) offset;
-
-                    if (buffer_end - buffer < align_size)
+                    if (!AlignTableBuffer(writer))
                     {
-                        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                        TableBufferFullError(L, writer, key_type, count);
                     }
 
-#ifndef NDEBUG
-                    memset(buffer, 0, align_size);
-#endif
-                    buffer += align_size;
-
-                    if (buffer_end - buffer < int32_t(sizeof(lua_Number)) || buffer_end - buffer < align_size)
+                    buffer = ReserveTableBuffer(writer, sizeof(lua_Number));
+                    if (!buffer)
                     {
-                        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                        TableBufferFullError(L, writer, key_type, count);
                     }
 
                     union
@@ -553,144 +639,143 @@ namespace dmScript
 
                     x = lua_tonumber(L, -1);
                     memcpy(buffer, buf, sizeof(lua_Number));
-                    buffer += sizeof(lua_Number);
+                    writer.m_Cursor += sizeof(lua_Number);
                 }
                 break;
 
                 case LUA_TSTRING:
                 {
-                    buffer += SaveTSTRING(L, -1, buffer, buffer_size, buffer_end, count);
+                    SaveTSTRING(L, -1, writer, count);
                 }
                 break;
 
                 case LUA_TUSERDATA:
                 {
-                    if (buffer_end - buffer < 1)
+                    if (!ReserveTableBuffer(writer, 1))
                     {
-                        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                        TableBufferFullError(L, writer, key_type, count);
                     }
 
-                    char* sub_type = buffer++;
+                    // The buffer may move when reserving space for the value, so the sub type is written last
+                    uint32_t sub_type_offset = writer.m_Cursor++;
 
-                    // NOTE: We align lua_Number to sizeof(float) even if lua_Number probably is of double type
-                    intptr_t offset = buffer - original_buffer;
-                    intptr_t aligned_buffer = ((intptr_t) offset + sizeof(float)-1) & ~(sizeof(float)-1);
-                    intptr_t align_size = aligned_buffer - (intptr_t) offset;
-
-                    if (buffer_end - buffer < align_size)
+                    if (!AlignTableBuffer(writer))
                     {
-                        luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                        TableBufferFullError(L, writer, key_type, count);
                     }
 
-#ifndef NDEBUG
-                    memset(buffer, 0, align_size);
-#endif
-                    buffer += align_size;
-
-                    float* f = (float*) (buffer);
+                    SubType sub_type;
                     dmVMath::Vector3* v3;
                     dmVMath::Vector4* v4;
                     dmVMath::Quat* q;
                     dmVMath::Matrix4* m;
                     if ((v3 = ToVector3(L, -1)))
                     {
-                        if (buffer_end - buffer < int32_t(sizeof(float) * 3))
+                        float* f = (float*) ReserveTableBuffer(writer, sizeof(float) * 3);
+                        if (!f)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_VECTOR3;
+                        sub_type = SUB_TYPE_VECTOR3;
                         *f++ = v3->getX();
                         *f++ = v3->getY();
                         *f++ = v3->getZ();
 
-                        buffer += sizeof(float) * 3;
+                        writer.m_Cursor += sizeof(float) * 3;
                     }
                     else if ((v4 = ToVector4(L, -1)))
                     {
-                        if (buffer_end - buffer < int32_t(sizeof(float) * 4))
+                        float* f = (float*) ReserveTableBuffer(writer, sizeof(float) * 4);
+                        if (!f)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_VECTOR4;
+                        sub_type = SUB_TYPE_VECTOR4;
                         *f++ = v4->getX();
                         *f++ = v4->getY();
                         *f++ = v4->getZ();
                         *f++ = v4->getW();
 
-                        buffer += sizeof(float) * 4;
+                        writer.m_Cursor += sizeof(float) * 4;
                     }
                     else if ((q = ToQuat(L, -1)))
                     {
-                        if (buffer_end - buffer < int32_t(sizeof(float) * 4))
+                        float* f = (float*) ReserveTableBuffer(writer, sizeof(float) * 4);
+                        if (!f)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_QUAT;
+                        sub_type = SUB_TYPE_QUAT;
                         *f++ = q->getX();
                         *f++ = q->getY();
                         *f++ = q->getZ();
                         *f++ = q->getW();
 
-                        buffer += sizeof(float) * 4;
+                        writer.m_Cursor += sizeof(float) * 4;
                     }
                     else if ((m = ToMatrix4(L, -1)))
                     {
-                        if (buffer_end - buffer < int32_t(sizeof(float) * 16))
+                        float* f = (float*) ReserveTableBuffer(writer, sizeof(float) * 16);
+                        if (!f)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_MATRIX4;
+                        sub_type = SUB_TYPE_MATRIX4;
                         for (uint32_t i = 0; i < 4; ++i)
                             for (uint32_t j = 0; j < 4; ++j)
                                 *f++ = m->getElem(i, j);
 
-                        buffer += sizeof(float) * 16;
+                        writer.m_Cursor += sizeof(float) * 16;
                     }
                     else if (IsHash(L, -1))
                     {
                         dmhash_t hash = *(dmhash_t*)lua_touserdata(L, -1);
                         const uint32_t hash_size = sizeof(dmhash_t);
 
-                        if (buffer_end - buffer < int32_t(hash_size))
+                        buffer = ReserveTableBuffer(writer, hash_size);
+                        if (!buffer)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_HASH;
+                        sub_type = SUB_TYPE_HASH;
 
                         memcpy(buffer, (const void*)&hash, hash_size);
-                        buffer += hash_size;
+                        writer.m_Cursor += hash_size;
                     }
                     else if (IsURL(L, -1))
                     {
                         dmMessage::URL* url = (dmMessage::URL*)lua_touserdata(L, -1);
                         const uint32_t url_size = sizeof(dmMessage::URL);
 
-                        if (buffer_end - buffer < int32_t(url_size))
+                        buffer = ReserveTableBuffer(writer, url_size);
+                        if (!buffer)
                         {
-                            luaL_error(L, "buffer (%d bytes) too small for table, exceeded at value (%s) for element #%d", buffer_size, lua_typename(L, key_type), count);
+                            TableBufferFullError(L, writer, key_type, count);
                         }
 
-                        *sub_type = (char) SUB_TYPE_URL;
+                        sub_type = SUB_TYPE_URL;
 
                         memcpy(buffer, (const void*)url, url_size);
-                        buffer += url_size;
+                        writer.m_Cursor += url_size;
                     }
                     else
                     {
+                        sub_type = SUB_TYPE_MAX;
                         luaL_error(L, "unsupported value type in table: %s", lua_typename(L, value_type));
                     }
+
+                    writer.m_Buffer[sub_type_offset] = (char) sub_type;
                 }
                 break;
 
                 case LUA_TTABLE:
                 {
-                    uint32_t n_used = DoCheckTable(L, header, original_buffer, buffer, buffer_end - buffer, -1, table_stack);
-                    buffer += n_used;
+                    DoCheckTable(L, header, writer, -1, table_stack);
                 }
                 break;
 
@@ -706,32 +791,91 @@ namespace dmScript
         const void* p = StackPop(table_stack);
         assert(p == table_data);
 
-        memcpy(buffer_start, &count, sizeof(uint32_t));
+        memcpy(writer.m_Buffer + table_start, &count, sizeof(uint32_t));
 
         assert(top == lua_gettop(L));
-        return buffer - buffer_start;
+        return writer.m_Cursor - table_start;
+    }
+
+    static uint32_t DoCheckTableWithHeader(lua_State* L, TableWriter& writer, int index, dmArray<const void*>& table_stack)
+    {
+        TableHeader* buffered_header = (TableHeader*)ReserveTableBuffer(writer, sizeof(TableHeader));
+        if (!buffered_header)
+        {
+            luaL_error(L, "buffer (%d bytes) too small for header (%zu bytes)", writer.m_Capacity, sizeof(TableHeader));
+        }
+
+        TableHeader header;
+        header.m_Magic = TABLE_MAGIC;
+        header.m_Version = TABLE_VERSION_CURRENT;
+        *buffered_header = header;
+        writer.m_Cursor += sizeof(TableHeader);
+
+        return sizeof(TableHeader) + DoCheckTable(L, header, writer, index, table_stack);
     }
 
     uint32_t CheckTable(lua_State* L, char* buffer, uint32_t buffer_size, int index)
     {
         assert((intptr_t)buffer % 16 == 0);
         if (buffer_size > sizeof(TableHeader)) {
-            char* original_buffer = buffer;
-
-            TableHeader* header = (TableHeader*)buffer;
-            header->m_Magic = TABLE_MAGIC;
-            header->m_Version = TABLE_VERSION_CURRENT;
-            buffer += sizeof(TableHeader);
-            buffer_size -= (buffer - original_buffer);
-
+            TableWriter writer;
+            InitTableWriter(writer, buffer, buffer_size, false);
             dmArray<const void*> table_stack;
-            return sizeof(TableHeader) + DoCheckTable(L, *header, original_buffer, buffer, buffer_size, index, table_stack);
+            return DoCheckTableWithHeader(L, writer, index, table_stack);
         } else {
             luaL_error(L, "buffer (%d bytes) too small for header (%zu bytes)", buffer_size, sizeof(TableHeader));
             return 0;
         }
     }
 
+    struct CheckTableDynamicContext
+    {
+        TableWriter          m_Writer;
+        dmArray<const void*> m_TableStack;
+        uint32_t             m_Used;
+    };
+
+    // Called in protected mode with the table as the first argument and the context as the second
+    static int DoCheckTableDynamic(lua_State* L)
+    {
+        CheckTableDynamicContext* ctx = (CheckTableDynamicContext*) lua_touserdata(L, 2);
+        lua_pop(L, 1);
+        ctx->m_Used = DoCheckTableWithHeader(L, ctx->m_Writer, 1, ctx->m_TableStack);
+        return 0;
+    }
+
+    uint32_t CheckTableDynamic(lua_State* L, char* buffer, uint32_t buffer_size, char** out_buffer, int index)
+    {
+        assert((intptr_t)buffer % 16 == 0);
+        if (index < 0 && index > LUA_REGISTRYINDEX)
+        {
+            index = lua_gettop(L) + index + 1;
+        }
+
+        CheckTableDynamicContext ctx;
+        InitTableWriter(ctx.m_Writer, buffer, buffer_size, true);
+        ctx.m_Used = 0;
+
+        // The writer may own a grown buffer when an error is raised. Catch the error so that the
+        // buffer can be freed before the error is propagated to the caller
+        lua_pushcfunction(L, DoCheckTableDynamic);
+        lua_pushvalue(L, index);
+        lua_pushlightuserdata(L, &ctx);
+        if (lua_pcall(L, 2, 0, 0) != 0)
+        {
+            if (ctx.m_Writer.m_Buffer != ctx.m_Writer.m_InitialBuffer)
+            {
+                dmMemory::AlignedFree(ctx.m_Writer.m_Buffer);
+            }
+            // lua_error doesn't return, so the destructor won't run
+            ctx.m_TableStack.SetCapacity(0);
+            lua_error(L);
+            return 0;
+        }
+
+        *out_buffer = ctx.m_Writer.m_Buffer;
+        return ctx.m_Used;
+    }
     static const char* ReadHeader(const char* buffer, TableHeader& header)
     {
         TableHeader* buffered_header = (TableHeader*)buffer;
@@ -43,6 +43,9 @@ namespace dmScript
      * - The matrix type (`vmath.matrix4`) can be multiplied with numbers, other matrices
      *   and `vmath.vector4` values.
      * - All types performs equality comparison by each component value.
+     * - The operators and most functions return new values. In tight loops, the garbage created
+     *   can be avoided by reusing values with `v:set()`, `vmath.add()`, `vmath.sub()`,
+     *   `vmath.mul_to()` and `vmath.normalize_to()`, which write the result to an existing value.
      *
      * The following components are available for the various types:
      *
@@ -116,6 +119,15 @@ namespace dmScript
         return dmScript::GetUserType(L, index) == TYPE_HASHES[SCRIPT_TYPE_VECTOR];
     }
 
+    // Pushes a method stored in the metatable of the value at index 1, eg for v:set(...)
+    // NOTE: Looking up the function doesn't allocate, as opposed to pushing a new C closure
+    static int PushMetatableMethod(lua_State* L, const char* name)
+    {
+        lua_getmetatable(L, 1);
+        lua_getfield(L, -1, name);
+        return 1;
+    }
+
     static const luaL_reg Vector_methods[] =
     {
         {0,0}
@@ -232,6 +244,10 @@ namespace dmScript
             lua_pushnumber(L, v->getZ());
             return 1;
         }
+        else if (strcmp(key, "set") == 0)
+        {
+            return PushMetatableMethod(L, key);
+        }
         else
         {
             return luaL_error(L, "%s.%s only has fields x, y, z.", SCRIPT_LIB_NAME, SCRIPT_TYPE_NAME_VECTOR3);
@@ -324,6 +340,23 @@ namespace dmScript
         return 1;
     }
 
+    static int Vector3_set(lua_State *L)
+    {
+        Vector3* v = (Vector3*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR3], 0);
+        if (IsVector3(L, 2))
+        {
+            *v = *CheckVector3(L, 2);
+        }
+        else
+        {
+            v->setX((float) luaL_checknumber(L, 2));
+            v->setY((float) luaL_checknumber(L, 3));
+            v->setZ((float) luaL_checknumber(L, 4));
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static int Vector3_eq(lua_State *L)
     {
         Vector3* v1 = ToVector3(L, 1);
@@ -348,6 +381,7 @@ namespace dmScript
         {"__unm", Vector3_unm},
         {"__concat", Vector3_concat},
         {"__eq", Vector3_eq},
+        {"set", Vector3_set},
         {0,0}
     };
 
@@ -393,6 +427,10 @@ namespace dmScript
             lua_pushnumber(L, v->getW());
             return 1;
         }
+        else if (strcmp(key, "set") == 0)
+        {
+            return PushMetatableMethod(L, key);
+        }
         else
         {
             return luaL_error(L, "%s.%s only has fields x, y, z, w.", SCRIPT_LIB_NAME, SCRIPT_TYPE_NAME_VECTOR4);
@@ -489,6 +527,24 @@ namespace dmScript
         return 1;
     }
 
+    static int Vector4_set(lua_State *L)
+    {
+        Vector4* v = (Vector4*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_VECTOR4], 0);
+        if (IsVector4(L, 2))
+        {
+            *v = *CheckVector4(L, 2);
+        }
+        else
+        {
+            v->setX((float) luaL_checknumber(L, 2));
+            v->setY((float) luaL_checknumber(L, 3));
+            v->setZ((float) luaL_checknumber(L, 4));
+            v->setW((float) luaL_checknumber(L, 5));
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static int Vector4_eq(lua_State *L)
     {
         Vector4* v1 = ToVector4(L, 1);
@@ -513,6 +569,7 @@ namespace dmScript
         {"__unm",       Vector4_unm},
         {"__concat",    Vector4_concat},
         {"__eq",        Vector4_eq},
+        {"set",         Vector4_set},
         {0,0}
     };
 
@@ -558,6 +615,10 @@ namespace dmScript
             lua_pushnumber(L, q->getW());
             return 1;
         }
+        else if (strcmp(key, "set") == 0)
+        {
+            return PushMetatableMethod(L, key);
+        }
         else
         {
             return luaL_error(L, "%s.%s only has fields x, y, z, w.", SCRIPT_LIB_NAME, SCRIPT_TYPE_NAME_QUAT);
@@ -615,6 +676,24 @@ namespace dmScript
         return 1;
     }
 
+    static int Quat_set(lua_State *L)
+    {
+        Quat* q = (Quat*)CheckUserType(L, 1, TYPE_HASHES[SCRIPT_TYPE_QUAT], 0);
+        if (IsQuat(L, 2))
+        {
+            *q = *CheckQuat(L, 2);
+        }
+        else
+        {
+            q->setX((float) luaL_checknumber(L, 2));
+            q->setY((float) luaL_checknumber(L, 3));
+            q->setZ((float) luaL_checknumber(L, 4));
+            q->setW((float) luaL_checknumber(L, 5));
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static int Quat_eq(lua_State *L)
     {
         Quat* q1 = ToQuat(L, 1);
@@ -635,6 +714,7 @@ namespace dmScript
         {"__mul",       Quat_mul},
         {"__concat",    Quat_concat},
         {"__eq",        Quat_eq},
+        {"set",         Quat_set},
         {0,0}
     };
 
@@ -2299,6 +2379,205 @@ namespace dmScript
         return 1;
     }
 
+    /*# sets the components of a vector or quaternion
+     *
+     * Sets the components of a vector or quaternion, or copies them from another value of the same type.
+     * No new value is created.
+     *
+     * @name v:set
+     * @param x [type:number|vector3|vector4|quat] x component, or the value to copy
+     * @param [y] [type:number] y component
+     * @param [z] [type:number] z component
+     * @param [w] [type:number] w component, for `vector4` and `quat`
+     * @return v [type:vector3|vector4|quat] the modified value
+     * @examples
+     *
+     * ```lua
+     * local v = vmath.vector3()
+     * v:set(1, 2, 3)
+     * v:set(go.get_position())
+     * ```
+     */
+
+    /*# adds two vectors, storing the result in an existing vector
+     *
+     * Adds two vectors and writes the result to `out`. The output may be one of the inputs.
+     * No new vector is created, which avoids garbage in tight loops.
+     *
+     * @name vmath.add
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the output vector
+     * @examples
+     *
+     * ```lua
+     * -- equivalent to self.position = self.position + self.velocity, without the new vector
+     * vmath.add(self.position, self.position, self.velocity)
+     * ```
+     */
+    static int Add(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)lua_touserdata(L, 1);
+            *out = *CheckVector3(L, 2) + *CheckVector3(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)lua_touserdata(L, 1);
+            *out = *CheckVector4(L, 2) + *CheckVector4(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, "add", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# subtracts two vectors, storing the result in an existing vector
+     *
+     * Subtracts `v2` from `v1` and writes the result to `out`. The output may be one of the inputs.
+     * No new vector is created, which avoids garbage in tight loops.
+     *
+     * @name vmath.sub
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the output vector
+     * @examples
+     *
+     * ```lua
+     * vmath.sub(self.to_target, target_position, self.position)
+     * ```
+     */
+    static int Sub(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)lua_touserdata(L, 1);
+            *out = *CheckVector3(L, 2) - *CheckVector3(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)lua_touserdata(L, 1);
+            *out = *CheckVector4(L, 2) - *CheckVector4(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, "sub", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# multiplies two values, storing the result in an existing value
+     *
+     * Performs the same multiplication as the `*` operator and writes the result to `out`.
+     * The output may be one of the inputs. No new value is created, which avoids garbage in tight loops.
+     * The supported combinations are:
+     *
+     * - `vector3` or `vector4` multiplied by a number
+     * - `quat` multiplied by a `quat`
+     * - `matrix4` multiplied by a `matrix4`
+     * - `matrix4` multiplied by a `vector4`, with the result stored in a `vector4`
+     *
+     * @name vmath.mul_to
+     * @param out [type:vector3|vector4|quat|matrix4] value to store the result in
+     * @param v1 [type:vector3|vector4|quat|matrix4] first value
+     * @param v2 [type:number|vector4|quat|matrix4] second value
+     * @return out [type:vector3|vector4|quat|matrix4] the output value
+     * @examples
+     *
+     * ```lua
+     * -- self.position = self.position + self.direction * self.speed * dt, without new vectors
+     * vmath.mul_to(self.velocity, self.direction, self.speed * dt)
+     * vmath.add(self.position, self.position, self.velocity)
+     * ```
+     */
+    static int MulTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)lua_touserdata(L, 1);
+            Vector3* v = CheckVector3(L, 2);
+            *out = *v * (float) luaL_checknumber(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4 && IsMatrix4(L, 2))
+        {
+            Vector4* out = (Vector4*)lua_touserdata(L, 1);
+            Matrix4* m = CheckMatrix4(L, 2);
+            *out = *m * *CheckVector4(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)lua_touserdata(L, 1);
+            Vector4* v = CheckVector4(L, 2);
+            *out = *v * (float) luaL_checknumber(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_QUAT)
+        {
+            Quat* out = (Quat*)lua_touserdata(L, 1);
+            *out = *CheckQuat(L, 2) * *CheckQuat(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_MATRIX4)
+        {
+            Matrix4* out = (Matrix4*)lua_touserdata(L, 1);
+            *out = *CheckMatrix4(L, 2) * *CheckMatrix4(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s|%s|%s) as first argument.", SCRIPT_LIB_NAME, "mul_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4, SCRIPT_TYPE_NAME_QUAT, SCRIPT_TYPE_NAME_MATRIX4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# normalizes a vector, storing the result in an existing vector
+     *
+     * Normalizes `v1` and writes the result to `out`, see `vmath.normalize`.
+     * The output may be the input. No new value is created, which avoids garbage in tight loops.
+     *
+     * @name vmath.normalize_to
+     * @param out [type:vector3|vector4|quat] value to store the result in
+     * @param v1 [type:vector3|vector4|quat] value to normalize
+     * @return out [type:vector3|vector4|quat] the output value
+     * @examples
+     *
+     * ```lua
+     * vmath.normalize_to(self.direction, self.direction)
+     * ```
+     */
+    static int NormalizeTo(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vector3* out = (Vector3*)lua_touserdata(L, 1);
+            *out = dmVMath::Normalize(*CheckVector3(L, 2));
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vector4* out = (Vector4*)lua_touserdata(L, 1);
+            *out = dmVMath::Normalize(*CheckVector4(L, 2));
+        }
+        else if (type == SCRIPT_TYPE_QUAT)
+        {
+            Quat* out = (Quat*)lua_touserdata(L, 1);
+            *out = dmVMath::Normalize(*CheckQuat(L, 2));
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s|%s) as arguments.", SCRIPT_LIB_NAME, "normalize_to", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4, SCRIPT_TYPE_NAME_QUAT);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static const luaL_reg methods[] =
     {
         {SCRIPT_TYPE_NAME_VECTOR, Vector_new},
@@ -2335,6 +2614,10 @@ namespace dmScript
         {"inv", Inverse},
         {"ortho_inv", OrthoInverse},
         {"mul_per_elem", MulPerElem},
+        {"add", Add},
+        {"sub", Sub},
+        {"mul_to", MulTo},
+        {"normalize_to", NormalizeTo},
         {0, 0}
     };
 
@@ -15,7 +15,17 @@
 function callback(response)
 end
 
-requests_left = 7
+requests_left = 11
+
+-- Same content as /data in server.py
+local DATA_SIZE = 10000
+local function data(first, last)
+    local t = {}
+    for i = first, last do
+        t[#t + 1] = string.char(string.byte("a") + i % 26)
+    end
+    return table.concat(t)
+end
 
 function test_http()
     local headers = {}
@@ -80,9 +90,56 @@ function test_http()
         end,
     headers)
 
+    local path = "test_http_download.tmp"
+    http.request(ADDRESS, "GET",
+        function(response)
+            assert(response.status == 200)
+            assert(response.path == path)
+            assert(response.response == nil)
+            assert(response.error == nil)
+            local f = io.open(path, "rb")
+            assert(f:read("*a") == "Hello Defold!")
+            f:close()
+            os.remove(path)
+            requests_left = requests_left - 1
+        end,
+    headers, nil, { path = path })
+
+    local progress_received = 0
+    http.request(ADDRESS .. "/data", "GET",
+        function(response)
+            assert(response.status == 200)
+            assert(response.response == data(0, DATA_SIZE - 1))
+            requests_left = requests_left - 1
+        end,
+    nil, nil, { progress = function(self, received, total)
+            assert(total == DATA_SIZE)
+            assert(received > progress_received and received <= total)
+            progress_received = received
+            if received == total then
+                requests_left = requests_left - 1
+            end
+        end })
+
+    local range_path = "test_http_range.tmp"
+    http.request(ADDRESS .. "/data", "GET",
+        function(response)
+            assert(response.status == 206)
+            assert(response.path == range_path)
+            assert(response.error == nil)
+            assert(response.headers["content-range"] == "bytes 100-199/" .. DATA_SIZE)
+            local f = io.open(range_path, "rb")
+            assert(f:read("*a") == data(100, 199))
+            f:close()
+            os.remove(range_path)
+            requests_left = requests_left - 1
+        end,
+    nil, nil, { path = range_path, range_start = 100, range_end = 199 })
+
     http.request("http://foo.___", "GET",
         function(response)
             assert(response.status == 0)
+            assert(response.error == "SOCKET_ERROR")
             assert(response.response == "")
             assert(#response.response == 0)
             requests_left = requests_left - 1
@@ -29,6 +29,7 @@ function test_http_timeout()
     http.request("http://127.0.0.1:" .. PORT .. "/sleep/1.5", "GET",
         function(response)
             assert(response.status == 0)
+            assert(response.error == "TIMEOUT")
             requests_left = requests_left - 1
         end,
     headers, '', options)
@@ -0,0 +1,107 @@
+// Copyright 2020-2024 The Defold Foundation
+// Copyright 2014-2020 King
+// Copyright 2009-2014 Ragnar Svensson, Christian Murray
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+// 
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+// 
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include <dlib/math.h>
+
+#include "../script.h"
+#include "test_script.h"
+
+#include <testmain/testmain.h>
+
+extern "C"
+{
+#include <lua/lua.h>
+}
+
+class ScriptGCTest : public dmScriptTest::ScriptTest
+{
+};
+
+// Allocates roughly 100kb of garbage, and keeps a small part of it alive
+static const char* GARBAGE_SCRIPT =
+    "keep = keep or {}\n"
+    "for i = 1, 1000 do\n"
+    "    local t = { i, i, i, i, i, i, i, i }\n"
+    "    if i % 100 == 0 then keep[#keep % 50 + 1] = t end\n"
+    "end\n";
+
+TEST_F(ScriptGCTest, TestDefaultBudget)
+{
+    // No script.gc_budget in the test config
+    ASSERT_EQ(0u, dmScript::GetGCBudget(m_Context));
+
+    // Nothing is collected by StepGC when the automatic collection is used
+    ASSERT_TRUE(RunString(L, GARBAGE_SCRIPT));
+    dmScript::StepGC(m_Context);
+
+    dmScript::GCStats stats;
+    dmScript::GetGCStats(m_Context, &stats);
+    ASSERT_EQ(0u, stats.m_Steps);
+    ASSERT_EQ(0u, stats.m_Cycles);
+    ASSERT_EQ(dmScript::GetLuaGCCount(L), stats.m_HeapSize);
+}
+
+TEST_F(ScriptGCTest, TestBudget)
+{
+    // A full collection re-enables the automatic collection, so do it before setting the budget
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    uint32_t start_heap = dmScript::GetLuaGCCount(L);
+
+    dmScript::SetGCBudget(m_Context, 2000);
+    ASSERT_EQ(2000u, dmScript::GetGCBudget(m_Context));
+
+    // The automatic collection is stopped, so the heap only grows without StepGC
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        ASSERT_TRUE(RunString(L, GARBAGE_SCRIPT));
+    }
+    ASSERT_GT(dmScript::GetLuaGCCount(L), start_heap + 1000);
+
+    // With one StepGC per "frame", the heap stays bounded
+    uint32_t max_heap = 0;
+    for (uint32_t frame = 0; frame < 500; ++frame)
+    {
+        ASSERT_TRUE(RunString(L, GARBAGE_SCRIPT));
+        dmScript::StepGC(m_Context);
+        if (frame >= 100)
+        {
+            max_heap = dmMath::Max(max_heap, dmScript::GetLuaGCCount(L));
+        }
+    }
+
+    dmScript::GCStats stats;
+    dmScript::GetGCStats(m_Context, &stats);
+    ASSERT_LT(0u, stats.m_Cycles);
+    ASSERT_LE(16u, stats.m_StepSize);
+    ASSERT_LT(0u, stats.m_Allocated);
+    ASSERT_EQ(dmScript::GetLuaGCCount(L), stats.m_HeapSize);
+    ASSERT_GT(start_heap + 4000, max_heap);
+
+    // Restore the automatic collection
+    dmScript::SetGCBudget(m_Context, 0);
+    ASSERT_EQ(0u, dmScript::GetGCBudget(m_Context));
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        ASSERT_TRUE(RunString(L, GARBAGE_SCRIPT));
+    }
+    ASSERT_GT(start_heap + 4000, dmScript::GetLuaGCCount(L));
+}
+
+int main(int argc, char **argv)
+{
+    TestMainPlatformInit();
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -78,8 +78,16 @@ static int GetInstaceContextTableRef(lua_State* L)
     return 1;
 }
 
+static int ScriptInstanceIsValid(lua_State* L)
+{
+    ScriptInstance* i = (ScriptInstance*)lua_touserdata(L, 1);
+    lua_pushboolean(L, i != 0x0 && i->m_ContextTableReference != LUA_NOREF);
+    return 1;
+}
+
 static const luaL_reg META_TABLE[] =
 {
+    {dmScript::META_TABLE_IS_VALID,                 ScriptInstanceIsValid},
     {dmScript::META_TABLE_RESOLVE_PATH,             ResolvePathCallback},
     {dmScript::META_TABLE_GET_URL,                  GetURLCallback},
     {dmScript::META_GET_INSTANCE_CONTEXT_TABLE_REF, GetInstaceContextTableRef},
@@ -212,6 +220,8 @@ TEST_F(ScriptHttpTest, TestPost)
     while (1) {
         dmSys::PumpMessageQueue();
         dmMessage::Dispatch(m_DefaultURL.m_Socket, DispatchCallbackDDF, this);
+        // Invokes the progress callbacks
+        dmScript::Update(m_ScriptContext);
 
         lua_getglobal(L, "requests_left");
         int requests_left = lua_tointeger(L, -1);
@@ -243,6 +253,52 @@ TEST_F(ScriptHttpTest, TestPost)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+// The progress callbacks of a request are only invoked by the update of the script context that made the request
+TEST_F(ScriptHttpTest, TestProgressContext)
+{
+    int top = lua_gettop(L);
+
+    dmScript::HContext other_context = dmScript::NewContext(m_ConfigFile, 0, true);
+    dmScript::Initialize(other_context);
+
+    SetHttpAddress(L);
+    ASSERT_TRUE(dmScriptTest::RunString(L,
+        "requests_left = 1\n"
+        "progress_calls = 0\n"
+        "http.request(ADDRESS .. '/data', 'GET', function(response) requests_left = 0 end, nil, nil,\n"
+        "    { progress = function(self, received, total) progress_calls = progress_calls + 1 end })\n"));
+
+    uint64_t start = dmTime::GetTime();
+    while (1) {
+        dmMessage::Dispatch(m_DefaultURL.m_Socket, DispatchCallbackDDF, this);
+        dmScript::Update(other_context);
+
+        lua_getglobal(L, "requests_left");
+        int requests_left = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        if (requests_left == 0) {
+            break;
+        }
+
+        dmTime::Sleep(10 * 1000);
+        ASSERT_GT(8000000U, dmTime::GetTime() - start);
+    }
+
+    lua_getglobal(L, "progress_calls");
+    ASSERT_EQ(0, lua_tointeger(L, -1));
+    lua_pop(L, 1);
+
+    dmScript::Update(m_ScriptContext);
+    lua_getglobal(L, "progress_calls");
+    ASSERT_LT(0, lua_tointeger(L, -1));
+    lua_pop(L, 1);
+
+    dmScript::Finalize(other_context);
+    dmScript::DeleteContext(other_context);
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
 struct SHttpRequestTimeoutGuard // Makes sure it gets reset after gtest returns
 {
     SHttpRequestTimeoutGuard(uint64_t timeout)
@@ -572,7 +572,7 @@ void DispatchCallbackTable(dmMessage::Message *message, void* user_ptr)
 {
     assert(message->m_Id == dmHashString64("table"));
     TableUserData* user_data = (TableUserData*)user_ptr;
-    dmScript::PushTable(user_data->L, (const char*)message->m_Data, message->m_DataSize);
+    dmScript::PushTable(user_data->L, (const char*)dmMessage::GetData(message), message->m_DataSize);
     lua_getfield(user_data->L, -1, "uint_value");
     user_data->m_TestValue = (uint32_t) lua_tonumber(user_data->L, -1);
     lua_pop(user_data->L, 2);
@@ -656,6 +656,37 @@ TEST_F(ScriptMsgTest, TestPost)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+TEST_F(ScriptMsgTest, TestPostLargeTable)
+{
+    int top = lua_gettop(L);
+
+    dmMessage::HSocket socket;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("socket", &socket));
+
+    // Larger than a message page, so the payload is posted by reference
+    ASSERT_TRUE(dmScriptTest::RunString(L,
+        "local t = {uint_value = 3}\n"
+        "for i = 1,1000 do t[i] = i end\n"
+        "msg.post(\"socket:\", \"table\", t)\n"
+        ));
+    TableUserData user_data;
+    user_data.L = L;
+    user_data.m_TestValue = 0;
+    user_data.m_URL.m_Socket = socket;
+    ASSERT_EQ(1u, dmMessage::Dispatch(socket, DispatchCallbackTable, &user_data));
+    ASSERT_EQ(3u, user_data.m_TestValue);
+
+    // Pending large messages are released with the socket
+    ASSERT_TRUE(dmScriptTest::RunString(L,
+        "local t = {uint_value = 4}\n"
+        "for i = 1,1000 do t[i] = i end\n"
+        "msg.post(\"socket:\", \"table\", t)\n"
+        ));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(socket));
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
 TEST_F(ScriptMsgTest, TestFailPost)
 {
     int top = lua_gettop(L);
@@ -421,6 +421,104 @@ TEST_F(LuaTableTest, NestedTableSizeCheck)
     ASSERT_EQ(calculated_table_size, actual_table_size);
 }
 
+static void VerifyDynamicTable(lua_State* L, const char* buffer, uint32_t buffer_size)
+{
+    dmScript::PushTable(L, buffer, buffer_size);
+    ASSERT_EQ(64, (int)lua_objlen(L, -1));
+    lua_rawgeti(L, -1, 64);
+    ASSERT_EQ(32.0, lua_tonumber(L, -1));
+    lua_pop(L, 1);
+    lua_getfield(L, -1, "str");
+    ASSERT_STREQ("a string value", lua_tostring(L, -1));
+    lua_pop(L, 1);
+    lua_getfield(L, -1, "v4");
+    ASSERT_EQ(4.0f, dmScript::CheckVector4(L, -1)->getW());
+    lua_pop(L, 1);
+    lua_getfield(L, -1, "inner");
+    lua_getfield(L, -1, "flag");
+    ASSERT_TRUE(lua_toboolean(L, -1));
+    lua_pop(L, 3);
+}
+
+TEST_F(LuaTableTest, CheckTableDynamic)
+{
+    lua_newtable(L);
+    for (int i = 1; i <= 64; ++i)
+    {
+        lua_pushnumber(L, i * 0.5);
+        lua_rawseti(L, -2, i);
+    }
+    lua_pushstring(L, "a string value");
+    lua_setfield(L, -2, "str");
+    dmScript::PushVector4(L, dmVMath::Vector4(1.0f, 2.0f, 3.0f, 4.0f));
+    lua_setfield(L, -2, "v4");
+    lua_newtable(L);
+    lua_pushboolean(L, 1);
+    lua_setfield(L, -2, "flag");
+    lua_setfield(L, -2, "inner");
+
+    const uint32_t fixed_size = 4096;
+    char* fixed_buffer = 0;
+    ASSERT_EQ(dmMemory::RESULT_OK, dmMemory::AlignedMalloc((void**)&fixed_buffer, 16, fixed_size));
+    uint32_t fixed_used = dmScript::CheckTable(L, fixed_buffer, fixed_size, -1);
+    ASSERT_EQ(dmScript::CheckTableSize(L, -1), fixed_used);
+
+    // Start out with a buffer that is too small, forcing the writer to grow
+    char DM_ALIGNED(16) small_buffer[32];
+    char* dynamic_buffer = 0;
+    uint32_t dynamic_used = dmScript::CheckTableDynamic(L, small_buffer, sizeof(small_buffer), &dynamic_buffer, -1);
+    ASSERT_NE(small_buffer, dynamic_buffer);
+    ASSERT_EQ(fixed_used, dynamic_used);
+    VerifyDynamicTable(L, dynamic_buffer, dynamic_used);
+    dmMemory::AlignedFree(dynamic_buffer);
+
+    // Fits in the initial buffer
+    dynamic_used = dmScript::CheckTableDynamic(L, fixed_buffer, fixed_size, &dynamic_buffer, -1);
+    ASSERT_EQ(fixed_buffer, dynamic_buffer);
+    ASSERT_EQ(fixed_used, dynamic_used);
+    VerifyDynamicTable(L, dynamic_buffer, dynamic_used);
+
+    // No initial buffer
+    dynamic_used = dmScript::CheckTableDynamic(L, 0, 0, &dynamic_buffer, -1);
+    ASSERT_EQ(fixed_used, dynamic_used);
+    VerifyDynamicTable(L, dynamic_buffer, dynamic_used);
+    dmMemory::AlignedFree(dynamic_buffer);
+
+    dmMemory::AlignedFree(fixed_buffer);
+    lua_pop(L, 1);
+}
+
+static int CheckTableDynamicUnsupported(lua_State* L)
+{
+    char* buffer = 0;
+    dmScript::CheckTableDynamic(L, 0, 0, &buffer, 1);
+    dmMemory::AlignedFree(buffer);
+    return 0;
+}
+
+TEST_F(LuaTableTest, CheckTableDynamicError)
+{
+    int top = lua_gettop(L);
+
+    // Enough data to grow the buffer before the unsupported value is reached
+    lua_pushcfunction(L, CheckTableDynamicUnsupported);
+    lua_newtable(L);
+    for (int i = 1; i <= 1024; ++i)
+    {
+        lua_pushnumber(L, i);
+        lua_rawseti(L, -2, i);
+    }
+    lua_pushcfunction(L, CheckTableDynamicUnsupported);
+    lua_setfield(L, -2, "function");
+
+    // The grown buffer is freed before the error is propagated
+    ASSERT_NE(0, lua_pcall(L, 1, 0, 0));
+    ASSERT_NE((const char*)0, strstr(lua_tostring(L, -1), "unsupported value type in table"));
+    lua_pop(L, 1);
+
+    ASSERT_EQ(top, lua_gettop(L));
+}
+
 static int g_CustomPanicFunctionCalled = 0;
 static int CustomPanicFn(lua_State* L)
 {
@@ -280,6 +280,11 @@ TEST_F(ScriptVmathTest, TestMatrix4)
     ASSERT_TRUE(RunFile(L, "test_matrix4.luac"));
 }
 
+TEST_F(ScriptVmathTest, TestInPlace)
+{
+    ASSERT_TRUE(RunFile(L, "test_vmath_inplace.luac"));
+}
+
 TEST_F(ScriptVmathTest, TestMatrix4Fail)
 {
     // constructor
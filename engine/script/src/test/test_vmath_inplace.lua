@@ -0,0 +1,134 @@
+-- Copyright 2020-2024 The Defold Foundation
+-- Copyright 2014-2020 King
+-- Copyright 2009-2014 Ragnar Svensson, Christian Murray
+-- Licensed under the Defold License version 1.0 (the "License"); you may not use
+-- this file except in compliance with the License.
+-- 
+-- You may obtain a copy of the License, together with FAQs at
+-- https://www.defold.com/license
+-- 
+-- Unless required by applicable law or agreed to in writing, software distributed
+-- under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+-- CONDITIONS OF ANY KIND, either express or implied. See the License for the
+-- specific language governing permissions and limitations under the License.
+
+
+local function near(a, b)
+    return math.abs(a - b) < 0.0001
+end
+
+-- set
+local v = vmath.vector3()
+assert(v:set(1, 2, 3) == v, "v:set does not return v")
+assert(v.x == 1 and v.y == 2 and v.z == 3, "v:set(1, 2, 3) failed")
+v:set(vmath.vector3(4, 5, 6))
+assert(v == vmath.vector3(4, 5, 6), "v:set(vector3) failed")
+
+local v4 = vmath.vector4()
+v4:set(1, 2, 3, 4)
+assert(v4 == vmath.vector4(1, 2, 3, 4), "v4:set(1, 2, 3, 4) failed")
+v4:set(vmath.vector4(5, 6, 7, 8))
+assert(v4 == vmath.vector4(5, 6, 7, 8), "v4:set(vector4) failed")
+
+local q = vmath.quat()
+q:set(1, 2, 3, 4)
+assert(q == vmath.quat(1, 2, 3, 4), "q:set(1, 2, 3, 4) failed")
+q:set(vmath.quat())
+assert(q == vmath.quat(), "q:set(quat) failed")
+
+-- add/sub, also with the output aliasing an input
+local a = vmath.vector3(1, 2, 3)
+local b = vmath.vector3(10, 20, 30)
+local out = vmath.vector3()
+assert(vmath.add(out, a, b) == out, "vmath.add does not return out")
+assert(out == a + b, "vmath.add failed")
+vmath.sub(out, b, a)
+assert(out == b - a, "vmath.sub failed")
+vmath.add(a, a, a)
+assert(a == vmath.vector3(2, 4, 6), "vmath.add with aliased output failed")
+
+local out4 = vmath.vector4()
+vmath.add(out4, vmath.vector4(1, 2, 3, 4), vmath.vector4(1))
+assert(out4 == vmath.vector4(2, 3, 4, 5), "vmath.add vector4 failed")
+vmath.sub(out4, out4, vmath.vector4(1))
+assert(out4 == vmath.vector4(1, 2, 3, 4), "vmath.sub vector4 failed")
+
+-- mul_to
+vmath.mul_to(out, vmath.vector3(1, 2, 3), 2)
+assert(out == vmath.vector3(2, 4, 6), "vmath.mul_to vector3 failed")
+vmath.mul_to(out4, out4, 0.5)
+assert(out4 == vmath.vector4(0.5, 1, 1.5, 2), "vmath.mul_to vector4 failed")
+
+local m = vmath.matrix4_rotation_z(math.pi * 0.5)
+vmath.mul_to(out4, m, vmath.vector4(1, 0, 0, 1))
+local expected = m * vmath.vector4(1, 0, 0, 1)
+assert(near(out4.x, expected.x) and near(out4.y, expected.y) and near(out4.z, expected.z) and near(out4.w, expected.w), "vmath.mul_to matrix4 * vector4 failed")
+
+local q1 = vmath.quat_rotation_z(0.5)
+local q2 = vmath.quat_rotation_x(0.25)
+vmath.mul_to(q, q1, q2)
+assert(q == q1 * q2, "vmath.mul_to quat failed")
+
+local m2 = vmath.matrix4()
+vmath.mul_to(m2, m, m)
+assert(m2 == m * m, "vmath.mul_to matrix4 failed")
+
+-- normalize_to
+vmath.normalize_to(out, vmath.vector3(3, 0, 4))
+assert(near(out.x, 0.6) and near(out.y, 0) and near(out.z, 0.8), "vmath.normalize_to vector3 failed")
+vmath.normalize_to(out4, vmath.vector4(0, 2, 0, 0))
+assert(out4 == vmath.vector4(0, 1, 0, 0), "vmath.normalize_to vector4 failed")
+q:set(0, 0, 2, 0)
+vmath.normalize_to(q, q)
+assert(q == vmath.quat(0, 0, 1, 0), "vmath.normalize_to quat failed")
+
+-- errors
+assert(not pcall(vmath.add, 1, a, b), "vmath.add accepted a number as output")
+assert(not pcall(vmath.add, out, a, out4), "vmath.add accepted mixed types")
+assert(not pcall(vmath.mul_to, out, a, b), "vmath.mul_to accepted vector3 * vector3")
+assert(not pcall(v.set, v, 1), "v:set accepted too few components")
+
+-- Simulate a movement update, comparing the garbage created by the operators with the in-place functions
+local FRAMES = 100
+local OBJECTS = 100
+local dt = 1 / 60
+
+local function simulate(update)
+    local objects = {}
+    for i = 1, OBJECTS do
+        objects[i] = { position = vmath.vector3(i, 0, 0), velocity = vmath.vector3(1, 2, 0), tmp = vmath.vector3() }
+    end
+    collectgarbage("collect")
+    collectgarbage("stop")
+    local before = collectgarbage("count")
+    local start = os.clock()
+    for frame = 1, FRAMES do
+        for i = 1, OBJECTS do
+            update(objects[i])
+        end
+    end
+    local elapsed = os.clock() - start
+    local allocated = collectgarbage("count") - before
+    collectgarbage("restart")
+    return objects, allocated, elapsed
+end
+
+local objects_op, kb_op, time_op = simulate(function(o)
+    o.position = o.position + o.velocity * dt
+end)
+
+local objects_inplace, kb_inplace, time_inplace = simulate(function(o)
+    vmath.mul_to(o.tmp, o.velocity, dt)
+    vmath.add(o.position, o.position, o.tmp)
+end)
+
+for i = 1, OBJECTS do
+    local p1 = objects_op[i].position
+    local p2 = objects_inplace[i].position
+    assert(near(p1.x, p2.x) and near(p1.y, p2.y) and near(p1.z, p2.z), "in-place simulation differs")
+end
+
+print(string.format("vmath movement update, %d objects: operators %.2f kb/frame (%.3f ms/frame), in-place %.2f kb/frame (%.3f ms/frame)",
+    OBJECTS, kb_op / FRAMES, time_op * 1000 / FRAMES, kb_inplace / FRAMES, time_inplace * 1000 / FRAMES))
+assert(kb_inplace < kb_op, "in-place functions allocated as much as the operators")
+assert(kb_inplace < 1, "in-place functions allocated memory")
@@ -19,6 +19,7 @@
 #include <dlib/index_pool.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/memprofile.h>
 #include <dlib/mutex.h>
 #include <dlib/profile.h>
 #include <dlib/thread.h>
@@ -49,7 +50,7 @@ namespace dmSound
     // TODO: How many bits?
     const uint32_t RESAMPLE_FRACTION_BITS = 31;
 
-    const dmhash_t MASTER_GROUP_HASH = dmHashString64("master");
+    const dmhash_t MASTER_GROUP_HASH = dmHashConstString64("master");
     const uint32_t GROUP_MEMORY_BUFFER_COUNT = 64;
 
     static void SoundThread(void* ctx);
@@ -1386,6 +1387,7 @@ namespace dmSound
     static Result UpdateInternal(SoundSystem* sound)
     {
         DM_PROFILE(__FUNCTION__);
+        DM_MEMPROFILE_TAG_SCOPE(dmMemProfile::TAG_SOUND);
         if (!sound->m_Device)
         {
             return RESULT_OK;